@@ -0,0 +1,99 @@
+#ifndef ED_ROWS_H
+#define ED_ROWS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/*
+ * Edit distance between a query and all keys along the paths of a trie,
+ * for "did you mean" lookups within a distance bound k.
+ *
+ * It keeps one row of the DP table in ed.cc per depth: appending a
+ * character c to the key (walking down an edge) computes
+ *     d(i, j), 0 <= j <= |query|, for key[1..i] = key[1..i-1] + c
+ * from row i-1 in O(|query|), and walking back up just drops the row.
+ * This is the Levenshtein automaton of the query, run one state per
+ * depth, so a whole subtree is skipped once no entry of its row is <= k
+ * (a row minimum never decreases further down).
+ *
+ * Only the band |i - j| <= k is computed, and entries are capped at k+1
+ * since anything beyond k is just "too far", so a step costs O(k).
+ *
+ * With transpositions, swapping two adjacent characters counts as one
+ * edit too (optimal string alignment, a restricted Damerau-Levenshtein
+ * distance), e.g. distance("hte", "the") = 1 instead of 2.
+ */
+class EditDistanceRows {
+public:
+    EditDistanceRows(const std::string& query, int k, bool transpositions = false)
+        : _query(query), _k(k < 0 ? -1 : k), _transpositions(transpositions), _cols(query.size() + 1)
+    {
+        _d.reserve(_cols * (query.size() + _k + 2));
+        for (size_t j = 0; j < _cols; ++j)
+            _d.push_back(cap(j)); // d(0, j) = j, insert query[1..j]
+        _mins.push_back(0);
+    }
+
+    // appends c to the key, false if no key starting with it can be within k
+    bool push(char c)
+    {
+        _key.push_back(c);
+        const size_t i = _key.size();
+        _d.resize(_d.size() + _cols, _k + 1);
+        int* row = &_d[i * _cols];
+        const int* up = row - _cols;
+        const int* up2 = i > 1 ? up - _cols : nullptr;
+        const size_t lo = i > size_t(_k) ? i - _k : 0;
+        const size_t hi = std::min(_cols - 1, i + _k);
+        int row_min = _k + 1;
+        if (lo == 0) row[0] = cap(i); // d(i, 0) = i, delete key[1..i]
+        for (size_t j = std::max<size_t>(lo, 1); j <= hi; ++j) {
+            int v = up[j-1] + (c == _query[j-1] ? 0 : 1); // match or subs
+            v = std::min(v, up[j] + 1);                     // delete key[i]
+            v = std::min(v, row[j-1] + 1);                  // insert query[j]
+            if (_transpositions && up2 && j > 1 &&
+                c == _query[j-2] && _key[i-2] == _query[j-1])
+                v = std::min(v, up2[j-2] + 1);              // swap
+            row[j] = std::min(v, _k + 1);
+        }
+        for (size_t j = lo; j <= hi; ++j)
+            row_min = std::min(row_min, row[j]);
+        _mins.push_back(row_min);
+        return row_min <= _k;
+    }
+
+    // removes the last character of the key
+    void pop()
+    {
+        _key.pop_back();
+        _d.resize(_d.size() - _cols);
+        _mins.pop_back();
+    }
+
+    // the key walked so far
+    const std::string& key() const { return _key; }
+
+    // edit distance of query and key(), k+1 if it's beyond k
+    int distance() const { return _d.back(); }
+
+    bool matches() const { return distance() <= _k; }
+
+    // false if no key starting with key() can be within k
+    bool viable() const { return _mins.back() <= _k; }
+
+    int max_distance() const { return _k; }
+
+private:
+    int cap(size_t v) const { return int(std::min(v, size_t(_k + 1))); }
+
+    std::string _query;
+    int _k;
+    bool _transpositions;
+    size_t _cols;           // |query| + 1
+    std::string _key;
+    std::vector<int> _d;    // rows 0..|key|, _cols entries each
+    std::vector<int> _mins; // row minima
+};
+
+#endif
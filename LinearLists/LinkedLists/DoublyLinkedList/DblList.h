@@ -7,6 +7,7 @@
 #include<fstream>
 #include<string>
 #include<cstdlib>
+#include<memory>
 #include"LinearList.h"
 #include"List.h"
 #include"CircList.h"
@@ -21,18 +22,19 @@ struct DLLNode {
 	DLLNode(const T& val, DLLNode<T>* previous = nullptr, DLLNode<T>* next = nullptr) : data(val), prev(previous), next(next) {};
 };
 
-template<typename T>
+// nodes are obtained from Alloc (rebound to DLLNode<T>), std::allocator by default
+template<typename T, typename Alloc = std::allocator<T>>
 class DblList : public LinearList<T> {
 public:
-	DblList();										// constructor with no infomation in data zone of head node
-	DblList(const T& Info_for_head_node);			// constructor, & store info in head node
-	DblList(const DblList<T>& L); 					// copy constructor
-	DblList(const List<T>& L);						// copy constructor by class List<T>
-	DblList(const CircList<T>& L);					// copy constructor by class CircList<T>
-	DblList<T>& operator=(const DblList<T>& L);		// assignment operator= overloading	
-	DblList<T>& operator=(const List<T>& L);		// assign via class List<T>
-	DblList<T>& operator=(const CircList<T>& L);	// assign via class CircList<T>
-	virtual ~DblList() { clear(); delete head; }	// virtual destructor
+	DblList(const Alloc& alloc = Alloc());			// constructor with no infomation in data zone of head node
+	DblList(const T& Info_for_head_node, const Alloc& alloc = Alloc());	// constructor, & store info in head node
+	DblList(const DblList& L); 						// copy constructor
+	DblList(const List<T>& L, const Alloc& alloc = Alloc());	// copy constructor by class List<T>
+	DblList(const CircList<T>& L, const Alloc& alloc = Alloc());	// copy constructor by class CircList<T>
+	DblList& operator=(const DblList& L);			// assignment operator= overloading	
+	DblList& operator=(const List<T>& L);			// assign via class List<T>
+	DblList& operator=(const CircList<T>& L);		// assign via class CircList<T>
+	virtual ~DblList() { clear(); destroyNode(head); }	// virtual destructor
 	virtual void clear();							// erase all
 	virtual T& operator[](int index)const;			// access list items via []
 	virtual void swap(int i, int j);				// exchange the value of i-th item with that of j-th item 
@@ -54,10 +56,10 @@ public:
 	virtual void Import(const std::string& filename, const std::string& mode_selection_text_or_binary);	    // Read corresponding data from a local host file
 	virtual void Export(const std::string& filename, const std::string& mode_selection_text_or_binary)const;// Write corresponding data into a local host file	
 		
-	void Union(const DblList<T>& L2);				// union of two lists, and store the result in *this
+	void Union(const DblList& L2);					// union of two lists, and store the result in *this
 	void Union(const List<T>& L2);					// union of List L2 and DblList "this", & store the result in *this
 	void Union(const CircList<T>& L2);				// union of CircList L2 and DblList "this", & store the result in *this
-	void Intersection(const DblList<T>& L2);		// intersection of two lists, and store the result in *this
+	void Intersection(const DblList& L2);			// intersection of two lists, and store the result in *this
 	void Intersection(const List<T>& L2);			// intersection of List L2 and DblList "this", & store the result in *this
 	void Intersection(const CircList<T>& L2);		// intersection of CircList L2 and DblList "this", & store the result in *this
 	DLLNode<T>* getHead()const { return head; }		// get the pointer to head node
@@ -67,39 +69,55 @@ public:
 	DLLNode<T>* shift(DLLNode<T>* ptr, int distance);// move backward "distance" nodes after ptr
 
 private:
+	using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<DLLNode<T>>;
+	using NodeTraits = std::allocator_traits<NodeAl>;
+
+	NodeAl alloc;									// allocator of the nodes
 	DLLNode<T>* head;								// pointer to the head node of the list 
+
+	template<typename... Args>
+	DLLNode<T>* createNode(Args&&... args) {
+		DLLNode<T>* p = NodeTraits::allocate(alloc, 1);
+		try { NodeTraits::construct(alloc, p, std::forward<Args>(args)...); }
+		catch (...) { NodeTraits::deallocate(alloc, p, 1); throw; }
+		return p;
+	}
+	void destroyNode(DLLNode<T>* p) {
+		NodeTraits::destroy(alloc, p);
+		NodeTraits::deallocate(alloc, p, 1);
+	}
 };
 
 
-template<typename T>
-DblList<T>::DblList() {
+template<typename T, typename Alloc>
+DblList<T, Alloc>::DblList(const Alloc& alloc) : alloc(alloc) {
 	/* constructor with no infomation in data zone of head node */
 	// build a self-circled head node
-	head = new DLLNode<T>;
+	head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	head->next = head;
 	head->prev = head;
 }
 
-template<typename T>
-DblList<T>::DblList(const T& Info_for_head_node) {
+template<typename T, typename Alloc>
+DblList<T, Alloc>::DblList(const T& Info_for_head_node, const Alloc& alloc) : alloc(alloc) {
 	/* constructor, & store some info in head node */
 	// build a self-circled head node
-	head = new DLLNode<T>(Info_for_head_node);
+	head = createNode(Info_for_head_node);
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	head->next = head;
 	head->prev = head;
 }
 
-template<typename T>
-DblList<T>::DblList(const DblList<T>& L) {
+template<typename T, typename Alloc>
+DblList<T, Alloc>::DblList(const DblList& L) : alloc(NodeTraits::select_on_container_copy_construction(L.alloc)) {
 	/* copy constructor */
 	DLLNode<T>* srcptr = L.getHead();
-	DLLNode<T>* desptr = head = new DLLNode<T>;
+	DLLNode<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != L.head) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new DLLNode<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 		// build prev link
@@ -114,15 +132,15 @@ DblList<T>::DblList(const DblList<T>& L) {
 	head->prev = desptr;
 }
 
-template<typename T>
-DblList<T>::DblList(const CircList<T>& L) {
+template<typename T, typename Alloc>
+DblList<T, Alloc>::DblList(const CircList<T>& L, const Alloc& alloc) : alloc(alloc) {
 	/* copy constructor by class CircList<T> */
 	CLLNode<T>* srcptr = L.getHead(), *L_head = srcptr;
-	DLLNode<T>* desptr = head = new DLLNode<T>;
+	DLLNode<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != L_head) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new DLLNode<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 		// build prev link
@@ -137,15 +155,15 @@ DblList<T>::DblList(const CircList<T>& L) {
 	head->prev = desptr;
 }
 
-template<typename T>
-DblList<T>::DblList(const List<T>& L) {
+template<typename T, typename Alloc>
+DblList<T, Alloc>::DblList(const List<T>& L, const Alloc& alloc) : alloc(alloc) {
 	/* copy constructor by class List<T> */ 
 	Node<T>* srcptr = L.getHead();
-	DLLNode<T>* desptr = head = new DLLNode<T>;
+	DLLNode<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != nullptr) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new DLLNode<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 		// build prev link
@@ -160,16 +178,18 @@ DblList<T>::DblList(const List<T>& L) {
 	head->prev = desptr;
 }
 
-template<typename T>
-DblList<T>& DblList<T>::operator=(const DblList<T>& L) {
+template<typename T, typename Alloc>
+DblList<T, Alloc>& DblList<T, Alloc>::operator=(const DblList& L) {
 	/* assignment operator= overloading */
+	if (this == &L) return *this;
 	clear();										// clear existing nodes
+	destroyNode(head);
 	DLLNode<T>* srcptr = L.getHead();
-	DLLNode<T>* desptr = head = new DLLNode<T>;
+	DLLNode<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != L.head) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new DLLNode<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 		// build prev link
@@ -185,16 +205,17 @@ DblList<T>& DblList<T>::operator=(const DblList<T>& L) {
 	return *this;
 }
 
-template<typename T>
-DblList<T>& DblList<T>::operator=(const CircList<T>& L) {
+template<typename T, typename Alloc>
+DblList<T, Alloc>& DblList<T, Alloc>::operator=(const CircList<T>& L) {
 	/* assign via class CircList<T> */
 	clear();										// clear existing nodes
+	destroyNode(head);
 	CLLNode<T>* srcptr = L.getHead(), *L_head = srcptr;
-	DLLNode<T>* desptr = head = new DLLNode<T>;
+	DLLNode<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != L_head) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new DLLNode<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 		// build prev link
@@ -210,16 +231,17 @@ DblList<T>& DblList<T>::operator=(const CircList<T>& L) {
 	return *this;
 }
 
-template<typename T>
-DblList<T>& DblList<T>::operator=(const List<T>& L) {
+template<typename T, typename Alloc>
+DblList<T, Alloc>& DblList<T, Alloc>::operator=(const List<T>& L) {
 	/* assign via class List<T> */
 	clear();										// clear existing nodes
+	destroyNode(head);
 	Node<T>* srcptr = L.getHead();
-	DLLNode<T>* desptr = head = new DLLNode<T>;
+	DLLNode<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != nullptr) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new DLLNode<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 		// build prev link
@@ -235,8 +257,8 @@ DblList<T>& DblList<T>::operator=(const List<T>& L) {
 	return *this;
 }
 
-template<typename T>
-T& DblList<T>::operator[](int index)const {
+template<typename T, typename Alloc>
+T& DblList<T, Alloc>::operator[](int index)const {
 	/* access list items via [], 0<=index<=length(), equivalent to getVal(int i)
 	 * i=0, return head node info(may be null)
 	**/
@@ -252,8 +274,8 @@ T& DblList<T>::operator[](int index)const {
 	return curr->data;
 }
 
-template<typename T>
-void DblList<T>::swap(int i, int j) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::swap(int i, int j) {
 	/* exchange the value of i-th item with that of j-th item,
 	 * implementation by exchanging their links while not their values
 	**/
@@ -294,8 +316,8 @@ void DblList<T>::swap(int i, int j) {
 	}	
 }
 
-template<typename T>
-DLLNode<T>* DblList<T>::shift(DLLNode<T>* ptr, int distance) {
+template<typename T, typename Alloc>
+DLLNode<T>* DblList<T, Alloc>::shift(DLLNode<T>* ptr, int distance) {
 	/* Please make sure that ptr is valid ( I mean it points to a
 	 * particular node in the list) before invoking this function.
 	 * Why create this function?
@@ -311,8 +333,8 @@ DLLNode<T>* DblList<T>::shift(DLLNode<T>* ptr, int distance) {
 	return curr;
 }
 
-template<typename T>
-void DblList<T>::setHead(DLLNode<T>* p) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::setHead(DLLNode<T>* p) {
 	/* make head->next point to some node that is also pointed by p */
 	if (p == head)									// the same, no need to change
 		return;
@@ -329,20 +351,20 @@ void DblList<T>::setHead(DLLNode<T>* p) {
 	p->prev = head;
 }
 
-template<typename T>
-void DblList<T>::clear() {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::clear() {
 	/* erase all nodes but head node */
 	DLLNode<T>* curr = head->next, *del;
 	head->next = head;
 	while (curr != head) {
 		del = curr;
 		curr = curr->next;
-		delete del;
+		destroyNode(del);
 	}
 }
 
-template<typename T>
-int DblList<T>::length()const {
+template<typename T, typename Alloc>
+int DblList<T, Alloc>::length()const {
 	/* get the list's length */
 	DLLNode<T>* curr = head->next;
 	int count = 0;
@@ -353,8 +375,8 @@ int DblList<T>::length()const {
 	return count;
 }
 
-template<typename T>
-DLLNode<T>* DblList<T>::locate(int i)const {
+template<typename T, typename Alloc>
+DLLNode<T>* DblList<T, Alloc>::locate(int i)const {
 	/* locate the i-th node & return its pointer, i>=0
 	 * In particular,	 i=0,	  return head(i.e. the pointer to head node)
 	 *				  i>length(), i := i-length()-1, then go on and on like this
@@ -372,8 +394,8 @@ DLLNode<T>* DblList<T>::locate(int i)const {
 	return curr;
 }
 
-template<typename T>
-DLLNode<T>* DblList<T>::find(const T& x)const {
+template<typename T, typename Alloc>
+DLLNode<T>* DblList<T, Alloc>::find(const T& x)const {
 	/* find val x in the list & return its pointer. If cannot find return nullptr */
 	DLLNode<T>* curr = head->next;
 	while (curr != head) {
@@ -387,8 +409,8 @@ DLLNode<T>* DblList<T>::find(const T& x)const {
 	return nullptr;
 }
 
-template<typename T>
-int DblList<T>::search(const T& x)const {
+template<typename T, typename Alloc>
+int DblList<T, Alloc>::search(const T& x)const {
 	/* search val x in the list & return its index. If cannot find return 0 */
 	DLLNode<T>* curr = head->next;
 	int index = 1;
@@ -399,33 +421,33 @@ int DblList<T>::search(const T& x)const {
 	return 0;										// not found
 }
 
-template<typename T>
-T& DblList<T>::getVal(int i)const {
+template<typename T, typename Alloc>
+T& DblList<T, Alloc>::getVal(int i)const {
 	/* return the value of i-th item, i>=0.  i=0,     return head node info(may be null)
 	 *								      i>length(), i:=i-length()-1, go on and on like this
 	**/
 	return locate(i)->data;
 }
 
-template<typename T>
-bool DblList<T>::getVal(int i, T& x)const {
+template<typename T, typename Alloc>
+bool DblList<T, Alloc>::getVal(int i, T& x)const {
 	/* assign the value of i-th item to x, i>=0 */
 	x = locate(i)->data;
 	return true;
 }
 
-template<typename T>
-void DblList<T>::setVal(int i, const T& x) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::setVal(int i, const T& x) {
 	/* set i-th item the value x. If i>length(), i:=i-length()-1, go on and on like this */
 	locate(i)->data = x;
 }
 
-template<typename T>
-bool DblList<T>::insert(int i, const T& x) {
+template<typename T, typename Alloc>
+bool DblList<T, Alloc>::insert(int i, const T& x) {
 	/* Insert a new element x after the i-th node, i>=0
 	 * In particular, i=0, insert x after head node.
 	**/
-	DLLNode<T>* curr = locate(i), *newNode = new DLLNode<T>(x);
+	DLLNode<T>* curr = locate(i), *newNode = createNode(x);
 	if (newNode == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 	// build new links
@@ -437,10 +459,10 @@ bool DblList<T>::insert(int i, const T& x) {
 	return true;
 }
 
-template<typename T>
-bool DblList<T>::append(const T& x) {
+template<typename T, typename Alloc>
+bool DblList<T, Alloc>::append(const T& x) {
 	/* add a new element x after the last node(before head node) */ 
-	DLLNode<T>* newNode = new DLLNode<T>(x);
+	DLLNode<T>* newNode = createNode(x);
 	if (newNode == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 
 	// insert x between head and tail
@@ -452,8 +474,8 @@ bool DblList<T>::append(const T& x) {
 	return true;
 }
 
-template<typename T>
-bool DblList<T>::remove(int i, T& x) {
+template<typename T, typename Alloc>
+bool DblList<T, Alloc>::remove(int i, T& x) {
 	/* remove the i-th node & store the value to be removed */
 	if (i < 1) { std::cout << "Deletion error! Reason: Invalid argument i, i must be no less than 1." << std::endl; exit(1); }
 	DLLNode<T>* del = locate(i);
@@ -466,13 +488,13 @@ bool DblList<T>::remove(int i, T& x) {
 	del->prev->next = del->next;
 	del->next->prev = del->prev;
 	x = del->data;
-	delete del;
+	destroyNode(del);
 
 	return true;
 }
 
-template<typename T>
-bool DblList<T>::remove(int i) {
+template<typename T, typename Alloc>
+bool DblList<T, Alloc>::remove(int i) {
 	/* remove the i-th node without storing it */
 	if (i < 1) { std::cout << "Deletion error! Reason: Invalid argument i, i must be no less than 1." << std::endl; exit(1); }
 	DLLNode<T>* del = locate(i);
@@ -484,13 +506,13 @@ bool DblList<T>::remove(int i) {
 	// build new links & delete the i-th node
 	del->prev->next = del->next;
 	del->next->prev = del->prev;
-	delete del;
+	destroyNode(del);
 
 	return true;
 }
 
-template<typename T>
-void DblList<T>::Union(const DblList<T>& L2) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Union(const DblList& L2) {
 	/* union of two lists & store the result in *this */
 	DLLNode<T>* curr = L2.head->next;
 	T x;
@@ -502,8 +524,8 @@ void DblList<T>::Union(const DblList<T>& L2) {
 	}
 }
 
-template<typename T>
-void DblList<T>::Union(const CircList<T>& L2) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Union(const CircList<T>& L2) {
 	/* union of CircList L2 and DblList "this", & store the result in *this */
 	CLLNode<T>* curr = L2.getHead()->next, *L2_head = L2.getHead();
 	T x;
@@ -515,8 +537,8 @@ void DblList<T>::Union(const CircList<T>& L2) {
 	}
 }
 
-template<typename T>
-void DblList<T>::Union(const List<T>& L2) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Union(const List<T>& L2) {
 	/* union of List L2 and DblList "this", & store the result in *this */
 	Node<T>* curr = L2.getHead()->next;
 	T x;
@@ -528,8 +550,8 @@ void DblList<T>::Union(const List<T>& L2) {
 	}	
 }
 
-template<typename T>
-void DblList<T>::Intersection(const DblList<T>& L2) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Intersection(const DblList& L2) {
 	/* intersection of two lists & store the result in *this */
 	DLLNode<T>* curr = head->next, *del;
 	T x;
@@ -541,15 +563,15 @@ void DblList<T>::Intersection(const DblList<T>& L2) {
 			curr->next->prev = curr->prev;
 			del = curr;
 			curr = curr->next;
-			delete del;
+			destroyNode(del);
 		}
 		else  										// retain nodes with identical data
 			curr = curr->next;
 	}
 }
 
-template<typename T>
-void DblList<T>::Intersection(const CircList<T>& L2) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Intersection(const CircList<T>& L2) {
 	/* intersection of CircList L2 and DblList "this", & store the result in *this */
 	DLLNode<T>* curr = head->next, *del;
 	T x;
@@ -561,15 +583,15 @@ void DblList<T>::Intersection(const CircList<T>& L2) {
 			curr->next->prev = curr->prev;
 			del = curr;
 			curr = curr->next;
-			delete del;
+			destroyNode(del);
 		}
 		else  										// retain nodes with identical data
 			curr = curr->next;
 	}
 }
 
-template<typename T>
-void DblList<T>::Intersection(const List<T>& L2) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Intersection(const List<T>& L2) {
 	/* intersection of List L2 and DblList "this", & store the result in *this */
 	DLLNode<T>* curr = head->next, *del;
 	T x;
@@ -581,15 +603,15 @@ void DblList<T>::Intersection(const List<T>& L2) {
 			curr->next->prev = curr->prev;
 			del = curr;
 			curr = curr->next;
-			delete del;
+			destroyNode(del);
 		}
 		else  										// retain nodes with identical data
 			curr = curr->next;
 	}
 }
 
-template<typename T>
-void DblList<T>::input() {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::input() {
 	if (head->next != head) {						// this list has at least one node
 		std::cout << "Warning, the list is not null. Input new data will cover the original data\n";
 		std::cout << "Are you sure to go on?(y or n)\n";
@@ -608,7 +630,7 @@ void DblList<T>::input() {
 	T tmp;
 	std::cout << "Please input data. (end up with Ctrl+Z)" << std::endl;
 	while (std::cin >> tmp) {
-		curr->next = new DLLNode<T>(tmp);
+		curr->next = createNode(tmp);
 		if (curr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 		curr->next->prev = curr;
 		curr = curr->next;
@@ -619,8 +641,8 @@ void DblList<T>::input() {
 	std::cin.clear();								// reset the iostate of cin to good
 }
 
-template<typename T>
-void DblList<T>::output()const {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::output()const {
 	DLLNode<T>* curr = head->next;
 	int i = 1;
 	while (curr != head) {
@@ -631,8 +653,8 @@ void DblList<T>::output()const {
 	}
 }
 
-template<typename T>
-void DblList<T>::Import(const std::string& filename, const std::string& mode_selection_text_or_binary) {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Import(const std::string& filename, const std::string& mode_selection_text_or_binary) {
 	if (head->next != head) {						// this list has at least one node
 		std::cout << "Warning, the list is not null. Input new data will cover the original data\n";
 		std::cout << "Are you sure to go on?(y or n)\n";
@@ -662,7 +684,7 @@ void DblList<T>::Import(const std::string& filename, const std::string& mode_sel
 		// read data
 		T tmp; DLLNode<T>* curr = head;
 		while (ifs >> tmp) {
-			curr->next = new DLLNode<T>(tmp);
+			curr->next = createNode(tmp);
 			if (curr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 			curr->next->prev = curr;
 			curr = curr->next;
@@ -696,7 +718,7 @@ void DblList<T>::Import(const std::string& filename, const std::string& mode_sel
 			// read data
 			T tmp; DLLNode<T>* curr = head;
 			while (ifs.read((char*)&tmp, sizeof(tmp))) {
-				curr->next = new DLLNode<T>(tmp);
+				curr->next = createNode(tmp);
 				if (curr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 				curr->next->prev = curr;
 				curr = curr->next;
@@ -722,8 +744,8 @@ void DblList<T>::Import(const std::string& filename, const std::string& mode_sel
 		}
 }
 
-template<typename T>
-void DblList<T>::Export(const std::string& filename, const std::string& mode_selection_text_or_binary)const {
+template<typename T, typename Alloc>
+void DblList<T, Alloc>::Export(const std::string& filename, const std::string& mode_selection_text_or_binary)const {
 	// match export mode
 	if (mode_selection_text_or_binary == "text") {
 		// write in ASCII text format
@@ -7,6 +7,7 @@
 #include<fstream>
 #include<string>
 #include<cstdlib>
+#include<memory>
 #include"LinearList.h"
 
 template<typename T>
@@ -17,14 +18,15 @@ struct Node {
 	Node(const T& val, Node<T>* ptr = nullptr) { data = val; next = ptr; }
 };
 
-template<typename T>
+// nodes are obtained from Alloc (rebound to Node<T>), std::allocator by default
+template<typename T, typename Alloc = std::allocator<T>>
 class List: public LinearList<T> {
 public:	
-	List() { head = new Node<T>; }					// constructor with no infomation in data zone of head node
-	List(const T& Info_for_head_node) { head = new Node<T>(Info_for_head_node); }	// constructor, & store info in head node
-	List(const List<T>& L); 						// copy constructor
-	List<T>& operator=(const List<T>& L);			// assignment operator= overloading	
-	virtual ~List() { clear(); delete head; }		// virtual destructor		
+	List(const Alloc& alloc = Alloc()) : alloc(alloc) { head = createNode(); }	// constructor with no infomation in data zone of head node
+	List(const T& Info_for_head_node, const Alloc& alloc = Alloc()) : alloc(alloc) { head = createNode(Info_for_head_node); }	// constructor, & store info in head node
+	List(const List& L); 							// copy constructor
+	List& operator=(const List& L);					// assignment operator= overloading	
+	virtual ~List() { clear(); destroyNode(head); }	// virtual destructor		
 	virtual int size()const { return length(); }	// get the size of the list
 	virtual int length()const;						// get the number of pactical existing items	
 	virtual int search(const T& x)const;			// search specified item x and return its logical sequence number 	
@@ -47,27 +49,43 @@ public:
 	virtual void Export(const std::string& filename, const std::string& mode_selection_text_or_binary)const;// Write corresponding data into a local host file	
 	
 	// new functions in derived class List	
-	void Union(const List<T>& L2);					// union of two lists, and store the result in *this
-	void Intersection(const List<T>& L2);			// intersection of two lists, and store the result in *this
+	void Union(const List& L2);						// union of two lists, and store the result in *this
+	void Intersection(const List& L2);				// intersection of two lists, and store the result in *this
 	Node<T>* getHead()const { return head; }		// get the pointer to head node
 	Node<T>* locate(int i)const;					// locate the i-th item	and return the pointer to this node	
 	Node<T>* find(const T& x)const;					// find specified item x and return the pointer to this node
 	Node<T>* shift(Node<T>* ptr, int distance);		// move backward "distance" nodes after ptr
 
 private:
+	using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<Node<T>>;
+	using NodeTraits = std::allocator_traits<NodeAl>;
+
+	NodeAl alloc;									// allocator of the nodes
 	Node<T>* head;									// pointer to the head node of the list 	
+
+	template<typename... Args>
+	Node<T>* createNode(Args&&... args) {
+		Node<T>* p = NodeTraits::allocate(alloc, 1);
+		try { NodeTraits::construct(alloc, p, std::forward<Args>(args)...); }
+		catch (...) { NodeTraits::deallocate(alloc, p, 1); throw; }
+		return p;
+	}
+	void destroyNode(Node<T>* p) {
+		NodeTraits::destroy(alloc, p);
+		NodeTraits::deallocate(alloc, p, 1);
+	}
 };
 
 
-template<typename T>
-List<T>::List(const List<T>& L) {
+template<typename T, typename Alloc>
+List<T, Alloc>::List(const List& L) : alloc(NodeTraits::select_on_container_copy_construction(L.alloc)) {
 	// copy constructor
 	Node<T>* srcptr = L.getHead();
-	Node<T>* desptr = head = new Node<T>;
+	Node<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != nullptr) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new Node<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 		// move pointers backward
 		srcptr = srcptr->next;
@@ -75,16 +93,18 @@ List<T>::List(const List<T>& L) {
 	}
 }
 
-template<typename T>
-List<T>& List<T>::operator=(const List<T>& L) {
+template<typename T, typename Alloc>
+List<T, Alloc>& List<T, Alloc>::operator=(const List& L) {
 	// assignment operator= overloading
+	if (this == &L) return *this;
 	clear();										// clear existing nodes
+	destroyNode(head);
 	Node<T>* srcptr = L.getHead();
-	Node<T>* desptr = head = new Node<T>;
+	Node<T>* desptr = head = createNode();
 	if (head == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	while (srcptr->next != nullptr) {
 		// copy data from L & construct dynamic linked list
-		desptr->next = new Node<T>(srcptr->next->data);
+		desptr->next = createNode(srcptr->next->data);
 		if (desptr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 		srcptr = srcptr->next;
 		desptr = desptr->next;
@@ -92,8 +112,8 @@ List<T>& List<T>::operator=(const List<T>& L) {
 	return *this;
 }
 
-template<typename T>
-T& List<T>::operator[](int index)const {
+template<typename T, typename Alloc>
+T& List<T, Alloc>::operator[](int index)const {
 	// access list items via [], 0<=index<=length(), equivalent to getVal(int i)
 	// i=0, return head node info(may be null)
 	if (index < 0) { std::cerr << "Using operator[] error! Reason: Invalid argument index, index must be no less than 0." << std::endl; exit(1); }
@@ -108,8 +128,8 @@ T& List<T>::operator[](int index)const {
 	return curr->data;
 }
 
-template<typename T>
-Node<T>* List<T>::shift(Node<T>* ptr, int distance) {
+template<typename T, typename Alloc>
+Node<T>* List<T, Alloc>::shift(Node<T>* ptr, int distance) {
 	/* Please make sure that ptr is valid ( I mean it points to a
 	 * particular node in the list) before invoking this function.
 	 * Why create this function?
@@ -125,8 +145,8 @@ Node<T>* List<T>::shift(Node<T>* ptr, int distance) {
 	return curr;
 }
 
-template<typename T>
-void List<T>::swap(int i, int j) {
+template<typename T, typename Alloc>
+void List<T, Alloc>::swap(int i, int j) {
 	/* exchange the value of i-th item with that of j-th item, 
 	 * implementation by exchanging their links while not their values
 	**/
@@ -158,20 +178,20 @@ void List<T>::swap(int i, int j) {
 	}
 }
 
-template<typename T>
-void List<T>::clear() {
+template<typename T, typename Alloc>
+void List<T, Alloc>::clear() {
 	// erase all nodes but head node
 	Node<T>* curr = head->next, *del;
 	head->next = nullptr;
 	while (curr != nullptr) {
 		del = curr;
 		curr = curr->next;
-		delete del;
+		destroyNode(del);
 	}
 }
 
-template<typename T>
-int List<T>::length()const {
+template<typename T, typename Alloc>
+int List<T, Alloc>::length()const {
 	// get the list's length 
 	Node<T>* curr = head->next;
 	int count = 0;
@@ -182,8 +202,8 @@ int List<T>::length()const {
 	return count;
 }
 
-template<typename T>
-Node<T>* List<T>::locate(int i)const {
+template<typename T, typename Alloc>
+Node<T>* List<T, Alloc>::locate(int i)const {
 	/* locate the i-th node & return its pointer, 0<=i<=length()
 	 * In particular,	 i=0,	  return head(i.e. the pointer to head node)
 	 *				  i>length(), return nullptr
@@ -195,8 +215,8 @@ Node<T>* List<T>::locate(int i)const {
 	return curr;
 }
 
-template<typename T>
-Node<T>* List<T>::find(const T& x)const {
+template<typename T, typename Alloc>
+Node<T>* List<T, Alloc>::find(const T& x)const {
 	// find val x in the list & return its pointer. If cannot find return nullptr
 	Node<T>* curr = head->next;
 	while (curr != nullptr) {
@@ -208,8 +228,8 @@ Node<T>* List<T>::find(const T& x)const {
 	return curr;
 }
 
-template<typename T>
-int List<T>::search(const T& x)const {
+template<typename T, typename Alloc>
+int List<T, Alloc>::search(const T& x)const {
 	// search val x in the list & return its index. If cannot find return 0
 	Node<T>* curr = head->next;
 	int index = 1;
@@ -220,16 +240,16 @@ int List<T>::search(const T& x)const {
 	return 0;										// not found
 }
 
-template<typename T>
-T& List<T>::getVal(int i)const {
+template<typename T, typename Alloc>
+T& List<T, Alloc>::getVal(int i)const {
 	// return the value of i-th item, i>=0, i=0 return head node info(may be null)
 	Node<T>* curr = locate(i);
 	if (curr != nullptr) { return curr->data; }
 	else { std::cerr << "Getting value error! Reason: Argument i exceeded the list's length." << std::endl; exit(1); }
 }
 
-template<typename T>
-bool List<T>::getVal(int i, T& x)const {
+template<typename T, typename Alloc>
+bool List<T, Alloc>::getVal(int i, T& x)const {
 	// assign the value of i-th item to x, i>=0, i=0 return head node info(may be null)
 	Node<T>* curr = locate(i);
 	if (curr != nullptr) {							// locate successfully
@@ -239,46 +259,46 @@ bool List<T>::getVal(int i, T& x)const {
 	else return false;								// i is too large, exceeding the list's length
 }
 
-template<typename T>
-void List<T>::setVal(int i, const T& x) {	
+template<typename T, typename Alloc>
+void List<T, Alloc>::setVal(int i, const T& x) {	
 	Node<T>* curr = locate(i);
 	if (curr != nullptr) 							// locate successfully
 		curr->data = x;
 	else { std::cerr << "Setting value error! Reason: Argument i exceeded the list's length." << std::endl; exit(1); }
 }
 
-template<typename T>
-bool List<T>::insert(int i, const T& x) {
+template<typename T, typename Alloc>
+bool List<T, Alloc>::insert(int i, const T& x) {
 	/* Insert a new element x after the i-th node, i>=0
 	 * In particular, i=0, insert x after head node. 
 	**/
 	Node<T>* curr = locate(i);
 	if (curr == nullptr) { std::cerr << "Insertion error! Reason: Argument i exceeded the list's length." << std::endl; return false; }
 
-	Node<T>* newNode = new Node<T>(x);
+	Node<T>* newNode = createNode(x);
 	if (newNode == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	newNode->next = curr->next;
 	curr->next = newNode;
 	return true;
 }
 
-template<typename T>
-bool List<T>::append(const T& x) {
+template<typename T, typename Alloc>
+bool List<T, Alloc>::append(const T& x) {
 	// add a new element x at the end of the list
 	Node<T>* curr = head;
 	// make pointer curr point to last node
 	while (curr->next != nullptr)
 		curr = curr->next;
 
-	Node<T>* newNode = new Node<T>(x);
+	Node<T>* newNode = createNode(x);
 	if (newNode == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 	newNode->next = curr->next;
 	curr->next = newNode;
 	return true;
 }
 
-template<typename T>
-bool List<T>::remove(int i, T& x) {
+template<typename T, typename Alloc>
+bool List<T, Alloc>::remove(int i, T& x) {
 	// remove the i-th node & store the value to be removed
 	if (i < 1) { std::cout << "Deletion error! Reason: Invalid argument i, i must be no less than 1." << std::endl; exit(1); }
 	Node<T>* delpre = locate(i - 1), *del = delpre->next;
@@ -289,12 +309,12 @@ bool List<T>::remove(int i, T& x) {
 
 	delpre->next = del->next;
 	x = del->data;
-	delete del;
+	destroyNode(del);
 	return true;
 }
 
-template<typename T>
-bool List<T>::remove(int i) {
+template<typename T, typename Alloc>
+bool List<T, Alloc>::remove(int i) {
 	// remove the i-th node without storing it
 	if (i < 1) { std::cout << "Deletion error! Reason: Invalid argument i, i must be no less than 1." << std::endl; exit(1); }
 	Node<T>* delpre = locate(i - 1), *del = delpre->next;
@@ -304,12 +324,12 @@ bool List<T>::remove(int i) {
 	}
 
 	delpre->next = del->next;
-	delete del;
+	destroyNode(del);
 	return true;
 }
 
-template<typename T>
-void List<T>::Union(const List<T>& L2) {
+template<typename T, typename Alloc>
+void List<T, Alloc>::Union(const List& L2) {
 	// union of two lists & store the result in *this
 	Node<T>* curr = L2.head->next;
 	T x;
@@ -321,8 +341,8 @@ void List<T>::Union(const List<T>& L2) {
 	}		
 }
 
-template<typename T>
-void List<T>::Intersection(const List<T>& L2) {
+template<typename T, typename Alloc>
+void List<T, Alloc>::Intersection(const List& L2) {
 	// intersection of two lists & store the result in *this
 	Node<T>* curr = head->next, *prev = head;
 	T x;
@@ -333,7 +353,7 @@ void List<T>::Intersection(const List<T>& L2) {
 			prev->next = curr->next;
 			Node<T>* del = curr;
 			curr = curr->next;
-			delete del;			
+			destroyNode(del);			
 		}
 		else {
 			curr = curr->next;
@@ -342,8 +362,8 @@ void List<T>::Intersection(const List<T>& L2) {
 	}
 }
 
-template<typename T>
-void List<T>::input() {
+template<typename T, typename Alloc>
+void List<T, Alloc>::input() {
 	if (head->next != nullptr) {					// this list has at least one node
 		std::cout << "Warning, the list is not null. Input new data will cover the original data\n";
 		std::cout << "Are you sure to go on?(y or n)\n";
@@ -362,15 +382,15 @@ void List<T>::input() {
 	T tmp;
 	std::cout << "Please input data. (end up with Ctrl+Z)" << std::endl;
 	while (std::cin >> tmp) {
-		curr->next = new Node<T>(tmp);
+		curr->next = createNode(tmp);
 		if (curr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 		curr = curr->next;
 	}
 	std::cin.clear();								// reset the iostate of cin to good	
 }
 
-template<typename T>
-void List<T>::output()const {
+template<typename T, typename Alloc>
+void List<T, Alloc>::output()const {
 	Node<T>* curr = head->next;
 	int i = 1;
 	while (curr != nullptr) {
@@ -381,8 +401,8 @@ void List<T>::output()const {
 	}
 }
 
-template<typename T>
-void List<T>::Import(const std::string& filename, const std::string& mode_selection_text_or_binary) {
+template<typename T, typename Alloc>
+void List<T, Alloc>::Import(const std::string& filename, const std::string& mode_selection_text_or_binary) {
 	if (head->next != nullptr) {					// this list has at least one node
 		std::cout << "Warning, the list is not null. Input new data will cover the original data\n";
 		std::cout << "Are you sure to go on?(y or n)\n";
@@ -412,7 +432,7 @@ void List<T>::Import(const std::string& filename, const std::string& mode_select
 		// read data		
 		T tmp; Node<T>* curr = head;		
 		while (ifs >> tmp) {
-			curr->next = new Node<T>(tmp);
+			curr->next = createNode(tmp);
 			if (curr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 			curr = curr->next;
 		}
@@ -443,7 +463,7 @@ void List<T>::Import(const std::string& filename, const std::string& mode_select
 			// read data
 			T tmp; Node<T>* curr = head;
 			while (ifs.read((char*)&tmp, sizeof(tmp))) {
-				curr->next = new Node<T>(tmp);
+				curr->next = createNode(tmp);
 				if (curr->next == nullptr) { std::cerr << "Memory allocation error!" << std::endl; exit(1); }
 				curr = curr->next;
 			}
@@ -466,8 +486,8 @@ void List<T>::Import(const std::string& filename, const std::string& mode_select
 		}
 }
 
-template<typename T>
-void List<T>::Export(const std::string& filename, const std::string& mode_selection_text_or_binary)const {
+template<typename T, typename Alloc>
+void List<T, Alloc>::Export(const std::string& filename, const std::string& mode_selection_text_or_binary)const {
 	// match export mode
 	if (mode_selection_text_or_binary == "text") {
 		// write in ASCII text form
@@ -0,0 +1,140 @@
+/*
+ *  node arena for skip list (multi) map/set
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/Randomized/SkipListArena.h
+ *
+ *  usage:
+ *      using Arena = mySymbolTable::SkipListArenaAllocator<std::pair<const int, int>>;
+ *      mySymbolTable::SkiplistMap<int, int, std::less<int>, Arena> st;
+ */
+
+#ifndef SKIPLISTARENA_H
+#define SKIPLISTARENA_H 1
+
+#include <memory>      // std::shared_ptr
+#include <new>         // ::operator new
+#include <vector>
+#include <type_traits> // std::true_type
+#include <cstddef>     // std::max_align_t
+#include <cassert>
+
+namespace mySymbolTable {
+
+// Skip list nodes come in only a handful of sizes (one per level), so we carve
+// them out of big chunks and recycle freed ones through a free list per size.
+// A node costs exactly its own bytes (rounded up to 16) instead of a malloc
+// call plus its bookkeeping, and neighbouring nodes are likely to be adjacent
+// in memory. All chunks are given back at once when the last allocator
+// sharing the arena goes away. Not thread-safe.
+class SkipListArena {
+public:
+    static constexpr size_t Granularity = alignof(std::max_align_t);
+    static constexpr size_t ChunkSize = 64 * 1024;
+    static constexpr size_t MaxBlockSize = ChunkSize / 16; // bigger ones go to ::operator new
+
+    SkipListArena() = default;
+    SkipListArena(const SkipListArena&) = delete;
+    SkipListArena& operator=(const SkipListArena&) = delete;
+
+    ~SkipListArena() {
+        for (void* chunk : _chunks)
+            ::operator delete(chunk);
+    }
+
+    void* allocate(size_t bytes) {
+        if (bytes > MaxBlockSize)
+            return ::operator new(bytes);
+        size_t cls = size_class(bytes);
+        if (cls >= _free_lists.size())
+            _free_lists.resize(cls + 1, nullptr);
+        if (FreeBlock* blk = _free_lists[cls]) {
+            _free_lists[cls] = blk->next;
+            return blk;
+        }
+        size_t sz = (cls + 1) * Granularity;
+        if (_left < sz) {
+            // the tail of the current chunk is simply abandoned
+            _cur = static_cast<char*>(::operator new(ChunkSize));
+            _chunks.push_back(_cur);
+            _left = ChunkSize;
+        }
+        void* p = _cur;
+        _cur += sz; _left -= sz;
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (bytes > MaxBlockSize) {
+            ::operator delete(p);
+            return;
+        }
+        size_t cls = size_class(bytes);
+        assert(cls < _free_lists.size());
+        FreeBlock* blk = static_cast<FreeBlock*>(p);
+        blk->next = _free_lists[cls];
+        _free_lists[cls] = blk;
+    }
+
+    // # of chunks obtained from ::operator new so far
+    size_t chunk_count() const noexcept { return _chunks.size(); }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    static size_t size_class(size_t bytes) noexcept {
+        return (bytes + Granularity - 1) / Granularity - 1;
+    }
+
+    std::vector<void*> _chunks;
+    std::vector<FreeBlock*> _free_lists;
+    char*  _cur = nullptr;
+    size_t _left = 0;
+};
+
+// A standard-conforming allocator on top of SkipListArena. A default
+// constructed allocator brings its own arena, copies (and rebound copies)
+// share it, so every skip list gets an arena of its own by default.
+template<typename T>
+class SkipListArenaAllocator {
+    template<typename U> friend class SkipListArenaAllocator;
+    std::shared_ptr<SkipListArena> _arena;
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    static_assert(alignof(T) <= SkipListArena::Granularity,
+                  "over-aligned types are not supported by SkipListArena");
+
+    SkipListArenaAllocator() : _arena(std::make_shared<SkipListArena>()) {}
+
+    template<typename U>
+    SkipListArenaAllocator(const SkipListArenaAllocator<U>& other) noexcept
+        : _arena(other._arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        _arena->deallocate(p, n * sizeof(T));
+    }
+
+    const SkipListArena& arena() const noexcept { return *_arena; }
+
+    template<typename U>
+    friend bool operator==(const SkipListArenaAllocator& lhs, const SkipListArenaAllocator<U>& rhs) noexcept {
+        return &lhs.arena() == &rhs.arena();
+    }
+
+    template<typename U>
+    friend bool operator!=(const SkipListArenaAllocator& lhs, const SkipListArenaAllocator<U>& rhs) noexcept {
+        return &lhs.arena() != &rhs.arena();
+    }
+};
+
+} // namespace mySymbolTable
+
+#endif // !SKIPLISTARENA_H
@@ -9,13 +9,19 @@
 #ifndef SKIPLIST_IMPL_H
 #define SKIPLIST_IMPL_H 1
 
-#include <memory>   // std::addressof, std::allocator_tarits
+#include <memory>   // std::addressof, std::allocator_tarits, std::unique_ptr
 #include <utility>  // std::swap, std::pair
 #include <iterator> // std::reverse_iterator, std::distance
 #include <vector>
 #include <random>
+#include <stdexcept> // std::out_of_range
+#include <cstdint>
 #include <cassert>
+#if defined(_MSC_VER)
+#include <intrin.h>  // _BitScanForward
+#endif
 #include "my_map_traits.h"  // myst::get_map_key_t
+#include "../TreeMap/batch_lookup.h" // myst::interleave_lookups
 
 namespace mySymbolTable {
 
@@ -24,12 +30,16 @@ constexpr int SkipListMaxLevel = 32; // the probability to reach this is 1/(2^32
 template<typename T, typename Compare, typename Alloc, bool IsMap>
 class SkipList {
     struct SkipList_node;
+    struct SkipList_node_unit;
     class SkipList_iter;
     class SkipList_const_iter;
     using _self = SkipList<T, Compare, Alloc, IsMap>;
     using node = SkipList_node;
     using node_ptr = node*;
-    using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<node>;
+    // nodes are variable-sized (value + a tower of `level` links), so we
+    // allocate them in units of the node's alignment
+    using unit = SkipList_node_unit;
+    using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<unit>;
 public:
     using value_type = T;
     using key_type = typename get_map_key_t<T, IsMap>::key_type;
@@ -44,27 +54,45 @@ public:
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
     using node_type = SkipList_node;
 
+    // A finger remembers where the last operation through it ended up: the
+    // rightmost node visited at each level (and its position). Searching from
+    // there rather than from the top of the header costs O(log d), where d is
+    // the distance from the previous key, e.g. O(1) expected for sorted input.
+    // Any modification not made through the finger makes it stale, in which
+    // case the next search through it simply starts from the header again.
+    class Finger {
+        friend class SkipList;
+        node_ptr _update[SkipListMaxLevel];
+        size_t   _rank[SkipListMaxLevel];
+        node_ptr _owner = nullptr;  // header of the skip list it was used with
+        uint64_t _mod_count = 0;
+    public:
+        Finger() = default;
+        void reset() noexcept { _owner = nullptr; }
+    };
+
 private:
     node_ptr _header;
     size_t   _count = 0;
     Compare  _comp{};
     NodeAl   _alloc{};
+    uint64_t _rng_state = seed_rng();
+    uint64_t _mod_count = 0;  // bumped by every insertion/erasure
+    std::unique_ptr<Finger> _hint_finger; // for hinted insertion, made on first use
 
-    void set_default_header(bool init) noexcept {
+    void set_default_header() noexcept {
         _header->_level = 0;  // 0 suggests the skip list's empty
         _header->_prev = _header;
-        if (init) {
-            _header->_next = (node**) ::operator new(SkipListMaxLevel * sizeof(node_ptr));
-        }
         for (int i = 0; i < SkipListMaxLevel; ++i) {
-            _header->_next[i] = _header;
+            _header->next(i) = _header;
+            _header->width(i) = 1; // end() sits at position `size() + 1`
         }
     }
 
     // create & initialize the header node
     void create_header() {
-        _header = _alloc.allocate(1); // may throw
-        set_default_header(/*init=*/true);
+        _header = allocate_node(SkipListMaxLevel); // may throw
+        set_default_header();
         // leave the value field uninitialized
     }
 
@@ -85,8 +113,7 @@ public:
 
     ~SkipList() {
         clear_nodes();
-        ::operator delete(_header->_next);
-        _alloc.deallocate(_header, 1);
+        deallocate_node(_header, SkipListMaxLevel);
     }
 
     _self& operator=(const _self& rhs) {
@@ -103,11 +130,11 @@ public:
     /* iterators */
 
     iterator begin() noexcept {
-        return iterator(_header->_next[0]);
+        return iterator(_header->next(0));
     }
 
     const_iterator begin() const noexcept {
-        return const_iterator(_header->_next[0]);
+        return const_iterator(_header->next(0));
     }
 
     iterator end() noexcept {
@@ -157,7 +184,7 @@ public:
     size_t size() const noexcept { return _count; }
 
     size_t max_size() const noexcept {
-        return std::allocator_traits<NodeAl>::max_size(_alloc);
+        return std::allocator_traits<NodeAl>::max_size(_alloc) / node_units(1);
     }
 
     /* level interface */
@@ -185,6 +212,14 @@ public:
         return find_aux(key) != _header;
     }
 
+    // Writes find(key) of each key in the range to out[0], out[1], ... (a
+    // random access iterator to const_iterators), running the searches
+    // interleaved so that their cache misses overlap, see batch_lookup.h.
+    template<typename KeyRange, typename RandomIt>
+    void find_batch(const KeyRange& keys, RandomIt out) const {
+        interleave_lookups(find_probe{ this }, std::begin(keys), std::end(keys), out);
+    }
+
     iterator lower_bound(const key_type& key) {
         return iterator(find_aux(key, /*lower_bound=*/true));
     }
@@ -209,39 +244,129 @@ public:
         return { lower_bound(key), upper_bound(key) };
     }
 
+    /* order statistics */
+
+    // number of elements that compare less than `key`,
+    // i.e. the 0-based index of lower_bound(key)
+    size_t rank(const key_type& key) const {
+        size_t pos = 0;
+        node_ptr curr = _header, next;
+        for (int level = _header->_level - 1; level >= 0; --level) {
+            while ((next = curr->next(level)) != _header && _comp(get_key(next), key)) {
+                pos += curr->width(level);
+                curr = next;
+            }
+        }
+        return pos;
+    }
+
+    // number of elements that compare less than or equal to `key`,
+    // i.e. the 0-based index of upper_bound(key)
+    size_t upper_rank(const key_type& key) const {
+        size_t pos = 0;
+        node_ptr curr = _header, next;
+        for (int level = _header->_level - 1; level >= 0; --level) {
+            while ((next = curr->next(level)) != _header && !_comp(key, get_key(next))) {
+                pos += curr->width(level);
+                curr = next;
+            }
+        }
+        return pos;
+    }
+
+    // the i-th (0-based) element in order, end() if i >= size()
+    iterator nth(size_t i) {
+        return iterator(nth_aux(i));
+    }
+
+    const_iterator nth(size_t i) const {
+        return const_iterator(nth_aux(i));
+    }
+
+    // note that SkiplistMap::at(key) hides these two, use nth(i) there
+    reference at(size_t i) {
+        if (i >= _count) throw std::out_of_range("SkipList index out of range");
+        return nth_aux(i)->_val;
+    }
+
+    const_reference at(size_t i) const {
+        if (i >= _count) throw std::out_of_range("SkipList index out of range");
+        return nth_aux(i)->_val;
+    }
+
     /* modifiers */
 
     void clear() noexcept {
         if (!empty()) {
-            clear_nodes(); _count = 0;
-            set_default_header(/*init=*/false);
+            clear_nodes(); _count = 0; ++_mod_count;
+            set_default_header();
         }
     }
 
+    /* finger search */
+
+    iterator find(Finger& f, const key_type& key) {
+        node_ptr next = finger_search(key, f)->next(0);
+        if (next != _header && !_comp(key, get_key(next)))
+            return iterator(next);
+        return end();
+    }
+
+    iterator lower_bound(Finger& f, const key_type& key) {
+        return iterator(finger_search(key, f)->next(0));
+    }
+
 protected:
     // for non-duplicate hash map (set)
+    // consecutive keys tend to be close to each other (often sorted), so let
+    // a finger carry each search over to the next one
     template< typename InputIt >
     void insert_unique(InputIt first, InputIt last) {
+        Finger f;
         while (first != last) {
-            insert_unique(*first++);
+            insert_unique(f, *first++);
         }
     }
 
     // for hash multi map (set)
     template< typename InputIt >
     void insert_multi(InputIt first, InputIt last) {
+        Finger f;
         while (first != last) {
-            insert_multi(*first++);
+            insert_multi(f, *first++);
         }
     }
 
+    std::pair<iterator, bool> insert_unique(Finger& f, const T& val) {
+        return insert_unique_after(f, finger_search(get_key(val), f), val);
+    }
+
+    iterator insert_multi(Finger& f, const T& val) {
+        return insert_multi_after(f, finger_search(get_key(val), f), val);
+    }
+
+    // Nodes link back at level 0 only, so the hint alone can't tell us the
+    // nodes to relink above it (nor their positions). Hinted insertions share
+    // a finger instead: when it sits right before a correct hint, as it does
+    // for sorted input, there's nothing to search, otherwise the finger
+    // search goes on from wherever the previous hinted insertion went.
+    std::pair<iterator, bool> insert_unique(const_iterator hint, const T& val) {
+        Finger& f = hint_finger();
+        return insert_unique_after(f, hinted_search(get_key(val), f, hint.ptr()), val);
+    }
+
+    iterator insert_multi(const_iterator hint, const T& val) {
+        Finger& f = hint_finger();
+        return insert_multi_after(f, hinted_search(get_key(val), f, hint.ptr()), val);
+    }
+
 public:
     iterator erase(iterator pos) {
-        return iterator(erase_bottom_up(pos.ptr()));
+        return iterator(erase_node(pos.ptr()));
     }
 
     iterator erase(const_iterator pos) {
-        return iterator(erase_bottom_up(pos.ptr()));
+        return iterator(erase_node(pos.ptr()));
     }
 
     iterator erase(const_iterator first, const_iterator last) {
@@ -256,6 +381,23 @@ public:
         return iterator(first.ptr());
     }
 
+    // erase the i-th (0-based) element in order
+    iterator erase_at(size_t i) {
+        if (i >= _count) throw std::out_of_range("SkipList index out of range");
+        node_ptr update[SkipListMaxLevel];
+        size_t pos = 0;
+        node_ptr curr = _header;
+        for (int level = _header->_level - 1; level >= 0; --level) {
+            // stop right before position i + 1
+            while (pos + curr->width(level) <= i) {
+                pos += curr->width(level);
+                curr = curr->next(level);
+            }
+            update[level] = curr;
+        }
+        return iterator(unlink_node(curr->next(0), update));
+    }
+
     size_t erase(const key_type& key) {
         auto r = equal_range(key);
         size_t n = std::distance(r.first, r.second);
@@ -266,7 +408,8 @@ public:
     void swap(SkipList& rhs) noexcept(std::allocator_traits<Alloc>::is_always_equal::value
                                &&     std::is_nothrow_swappable<Compare>::value)
     {
-        assert(_alloc == rhs._alloc && "allocator must be the same");
+        assert((std::allocator_traits<allocator_type>::propagate_on_container_swap::value
+                || _alloc == rhs._alloc) && "allocator must be the same");
         if (std::allocator_traits<allocator_type>::propagate_on_container_swap::value) {
             std::swap(_alloc, rhs._alloc);
         } // otherwise the behavior is undefined
@@ -274,51 +417,167 @@ public:
         std::swap(_header, rhs._header);
         std::swap(_count, rhs._count);
         std::swap(_comp, rhs._comp);
+        std::swap(_rng_state, rhs._rng_state);
+        std::swap(_mod_count, rhs._mod_count);
+        std::swap(_hint_finger, rhs._hint_finger); // fingers know their header
     }
     
 private:
+    // node header immediately followed by its tower of links
+    static constexpr size_t node_units(int level) noexcept {
+        return (sizeof(node) + level * sizeof(typename node::link) + sizeof(unit) - 1) / sizeof(unit);
+    }
+
+    node_ptr allocate_node(int level) {
+        return reinterpret_cast<node_ptr>(_alloc.allocate(node_units(level)));
+    }
+
+    void deallocate_node(node_ptr x, int level) noexcept {
+        _alloc.deallocate(reinterpret_cast<unit*>(x), node_units(level));
+    }
+
     node_ptr new_node(const T& val, int level, node_ptr prev, node_ptr update[])
     {
-        node_ptr p = _alloc.allocate(1);
+        node_ptr p = allocate_node(level);
         try {
             ::new ((void*)p) node(val, level, prev, update);
         }
         catch (...) {
-            _alloc.deallocate(p, 1);
+            deallocate_node(p, level);
             throw;
         }
         return p;
     }
 
     void delete_node(node_ptr x) noexcept {
+        int level = x->_level;
         x->~node(); // don't forget
-        _alloc.deallocate(x, 1);
+        deallocate_node(x, level);
     }
 
     void copy_nodes_from(const _self& rhs) {
-        for (node_ptr x = rhs._header->_next[0]; x != rhs._header; x = x->_next[0]) {
-            insert_multi(x->_val);
+        Finger f; // appending in order, O(1) expected per node
+        for (node_ptr x = rhs._header->next(0); x != rhs._header; x = x->next(0)) {
+            insert_multi(f, x->_val);
         }
     }
 
     void clear_nodes() noexcept {
-        for (node_ptr x = _header->_next[0], del; x != _header;) {
-            del = x; x = x->_next[0];
+        for (node_ptr x = _header->next(0), del; x != _header;) {
+            del = x; x = x->next(0);
             delete_node(del);
         }
     }
 
+    node_ptr nth_aux(size_t i) const {
+        if (i >= _count) return _header;
+        size_t pos = 0; // position of curr, _header is at 0
+        node_ptr curr = _header;
+        for (int level = _header->_level - 1; level >= 0; --level) {
+            while (pos + curr->width(level) <= i + 1) {
+                pos += curr->width(level);
+                curr = curr->next(level);
+            }
+        }
+        return curr;
+    }
+
+    Finger& hint_finger() {
+        if (!_hint_finger) _hint_finger = std::make_unique<Finger>();
+        return *_hint_finger;
+    }
+
+    // curr: the finger's last node before val
+    std::pair<iterator, bool> insert_unique_after(Finger& f, node_ptr curr, const T& val) {
+        node_ptr next = curr->next(0);
+        if (next != _header && !_comp(get_key(val), get_key(next))/* && !_comp(get_key(next), key)*/) {
+            return { next, false };
+        }
+        iterator it = insert_after(curr, val, f._update, f._rank);
+        f._mod_count = _mod_count;
+        return { it, true };
+    }
+
+    iterator insert_multi_after(Finger& f, node_ptr curr, const T& val) {
+        iterator it = insert_after(curr, val, f._update, f._rank);
+        f._mod_count = _mod_count;
+        return it;
+    }
+
+    // finger_search(), unless the finger is current and right before
+    // `hint`, with hint->_prev < key <= hint: it brackets key at every level
+    node_ptr hinted_search(const key_type& key, Finger& f, node_ptr hint) const {
+        node_ptr prev = hint->_prev;
+        if (f._owner == _header && f._mod_count == _mod_count && _header->_level > 0
+            && f._update[0] == prev && (prev == _header || _comp(get_key(prev), key))
+            && (hint == _header || !_comp(get_key(hint), key)))
+            return prev;
+        return finger_search(key, f);
+    }
+
+    // search the last node whose key is less than `key`, recording at each
+    // level the rightmost node visited (update) and its position (rank)
+    node_ptr search_update(const key_type& key, node_ptr update[], size_t rank[]) const {
+        size_t pos = 0;
+        node_ptr curr = _header, next;
+        for (int level = _header->_level - 1; level >= 0; --level) {
+            while ((next = curr->next(level)) != _header && _comp(get_key(next), key)) {
+                pos += curr->width(level);
+                curr = next;
+            }
+            update[level] = curr;
+            rank[level] = pos;
+        }
+        return curr;
+    }
+
+    // same as search_update() but starts from the finger's position:
+    //     f._update[i] < (previous key) <= f._update[i]->next(i)
+    // climb up until the level that still brackets `key`, then descend as usual
+    node_ptr finger_search(const key_type& key, Finger& f) const {
+        const int top = _header->_level;
+        if (f._owner != _header || f._mod_count != _mod_count || top == 0) {
+            f._owner = _header; f._mod_count = _mod_count;
+            return search_update(key, f._update, f._rank);
+        }
+        int level = 0;
+        node_ptr next;
+        if (f._update[0] == _header || _comp(get_key(f._update[0]), key)) {
+            // moving forward: the successors at higher levels are farther away
+            while (level + 1 < top && (next = f._update[level + 1]->next(level + 1)) != _header
+                   && _comp(get_key(next), key))
+                ++level;
+        }
+        else {
+            // moving backward: the predecessors at higher levels are farther away
+            while (f._update[level] != _header && !_comp(get_key(f._update[level]), key)) {
+                if (++level == top) return search_update(key, f._update, f._rank);
+            }
+        }
+        size_t pos = f._rank[level];
+        node_ptr curr = f._update[level];
+        for (; level >= 0; --level) {
+            while ((next = curr->next(level)) != _header && _comp(get_key(next), key)) {
+                pos += curr->width(level);
+                curr = next;
+            }
+            f._update[level] = curr;
+            f._rank[level] = pos;
+        }
+        return curr;
+    }
+
     // find the first key that compares equivalent to `key`
     node_ptr find_aux(const key_type& key, bool lower_bound = false) const {
         if (empty()) return _header;
         node_ptr curr = _header, next;
         for (int level = _header->_level - 1; level >= 0; --level) {
-            while ((next = curr->_next[level]) != _header && _comp(get_key(next), key))
+            while ((next = curr->next(level)) != _header && _comp(get_key(next), key))
             {
                 curr = next;
             }
         }
-        curr = curr->_next[0];
+        curr = curr->next(0);
         if (curr == _header) return _header; // not found, key too large
         if (!_comp(key, get_key(curr))/* && !_comp(get_key(curr), key)*/)
             return curr; // found
@@ -326,12 +585,51 @@ private:
             return lower_bound ? curr : _header;
     }
 
+    // find_aux(key) one link at a time, for find_batch()
+    struct find_probe {
+        const SkipList* _list;
+
+        struct state_type {
+            node_ptr curr;
+            int level;
+            const key_type* key;
+        };
+        using result_type = const_iterator;
+
+        bool start(const key_type& key, state_type& s) const {
+            s = { _list->_header, _list->_header->_level - 1, &key };
+            if (s.level < 0) return false; // empty
+            batch_prefetch(s.curr->next(s.level));
+            return true;
+        }
+
+        bool step(state_type& s) const {
+            node_ptr next = s.curr->next(s.level);
+            if (next != _list->_header && _list->_comp(get_key(next), *s.key)) {
+                s.curr = next;
+            }
+            else if (s.level > 0) {
+                --s.level;
+            }
+            else { // s.curr < key <= next
+                if (next == _list->_header || _list->_comp(*s.key, get_key(next)))
+                    next = _list->_header; // not found
+                s.curr = next;
+                return false;
+            }
+            batch_prefetch(s.curr->next(s.level));
+            return true;
+        }
+
+        result_type result(const state_type& s) const { return const_iterator(s.curr); }
+    };
+
 #if 0
     // lazy version
     node_ptr upper_bound_aux(const key_type& key) const {
         node_ptr curr = find_aux(key, /*lower_bound=*/true);
         while (curr != _header && !_comp(key, get_key(curr)))
-            curr = curr->_next[0];
+            curr = curr->next(0);
         return curr;
     }
 #endif
@@ -340,7 +638,7 @@ private:
         if (empty()) return _header;
         node_ptr curr = _header, next = _header;
         for (int level = _header->_level - 1; level >= 0; --level) {
-            while ((next = curr->_next[level]) != _header && !_comp(key, get_key(next)))
+            while ((next = curr->next(level)) != _header && !_comp(key, get_key(next)))
             {
                 curr = next;
             }
@@ -377,196 +675,201 @@ private:
         return get_key_via_t(val, std::bool_constant<IsMap>{});
     }
 
-    static bool coin_flip_is_heads() {
-        // c++ version
+    static uint64_t seed_rng() {
         static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_int_distribution<std::mt19937::result_type> distrib(0, 1);
-        return distrib(gen) == 1;
-#if 0
-        // In c, we can do in this way (see below), but here's the problem:
-        // every time we start the program we always get the same random
-        // numbers so all class instances (can be of different types as we
-        // change the template arguments) have the same sequence of random
-        // numbers thus their levels are the same, which might be a little
-        // undesirable (but on the other side for one single instance this
-        // property makes it very stable, always getting the same levels
-        // when inserting same values, which's good)??
-        // Note that we cannot add `srand(time(NULL))` here, since it will
-        // render the results almost always identical during insertion
-        // because the computer's executing the instructions way too fast,
-        // and each time this subroutine is getting invoked, current time
-        // ( `time(NULL)` ) remains unchanged thus we always getting heads
-        // or tails which in turn leds to identical levels (either 1 or 32)
-        // for all nodes. A possible workaround is to put srand(time(NULL))
-        // in constructor so that the random levels for nodes can be
-        // instance specific.
-
-        int n = rand() / (RAND_MAX + 1.0) * 2; // rand() % 2 is BAD, see below
-        return n == 1;
-        /* generate a random number from range [min, max]:
-         * random_num = min + (int) (rand() / (RAND_MAX + 1.0) * (max - min + 1))
-         * NOTE that `min+rand()%(max-min+1)` is biased towards small numbers, for example,
-         * RAND_MAX == 4, and we want a number from range [0, 2], then
-         *    rand()  |  rand() % 3
-         * -----------+-------------
-         *      0     |     0
-         *      1     |     1
-         *      2     |     2
-         *      3     |     0
-         */
+        uint64_t seed = (uint64_t(rd()) << 32) | rd();
+        return seed ? seed : 0x9E3779B97F4A7C15ULL; // xorshift state must be non-zero
+    }
+
+    // xorshift64*, see https://en.wikipedia.org/wiki/Xorshift#xorshift*
+    uint64_t next_random() noexcept {
+        _rng_state ^= _rng_state >> 12;
+        _rng_state ^= _rng_state << 25;
+        _rng_state ^= _rng_state >> 27;
+        return _rng_state * 0x2545F4914F6CDD1DULL;
+    }
+
+    static int count_trailing_zeros(uint32_t x) noexcept {
+        assert(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(x);
+#elif defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return static_cast<int>(index);
+#else
+        int n = 0;
+        while ((x & 1) == 0) { x >>= 1; ++n; }
+        return n;
 #endif
     }
 
-    static int random_level() {
-        int level = 1;
-        while (coin_flip_is_heads() && level < SkipListMaxLevel)
-            ++level;
-        return level;
+    // Each trailing zero bit of a uniform random number is a coin flip that
+    // came up heads, so one draw decides the whole level: P(level > k) = 1/2^k.
+    // We used to flip a coin (std::mt19937 + uniform_int_distribution) per level.
+    int random_level() noexcept {
+        // use the high (better mixed) bits, bit 31 caps the level at SkipListMaxLevel
+        uint32_t r = static_cast<uint32_t>(next_random() >> 32) | (1u << (SkipListMaxLevel - 1));
+        return count_trailing_zeros(r) + 1;
     }
 
-    node_ptr insert_after(node_ptr x, const T& val, node_ptr update[]) {
+    node_ptr insert_after(node_ptr x, const T& val, node_ptr update[], size_t rank[]) {
         int level = random_level();
         if (level > _header->_level) {
-            for (int i = _header->_level; i < level; ++i)
+            for (int i = _header->_level; i < level; ++i) {
                 update[i] = _header;
+                rank[i] = 0;
+                _header->width(i) = _count + 1;
+            }
             _header->_level = level;
         }
         node_ptr newnode = new_node(val, level, x, update);
-        ++_count;
+        // a link spanning the new node's position grows by one, and one
+        // being split shares its width with the new node
+        size_t pos = rank[0] + 1;
+        for (int i = 0; i < level; ++i) {
+            newnode->width(i) = rank[i] + update[i]->width(i) + 1 - pos;
+            update[i]->width(i) = pos - rank[i];
+        }
+        for (int i = level; i < _header->_level; ++i) {
+            ++update[i]->width(i);
+        }
+        ++_count; ++_mod_count;
         return newnode;
     }
 
+    // update[i] is the rightmost node before x at level i
+    node_ptr unlink_node(node_ptr x, node_ptr update[]) {
+        assert(x != _header && "cannot erase end() iterator");
+        node_ptr x_next = x->next(0);
+        x_next->_prev = x->_prev;
+        for (int i = 0; i < _header->_level; ++i) {
+            if (update[i]->next(i) == x) {
+                update[i]->width(i) += x->width(i) - 1;
+                update[i]->next(i) = x->next(i);
+            }
+            else {
+                --update[i]->width(i);
+            }
+        }
+        delete_node(x); --_count; ++_mod_count;
+        for (int i = _header->_level - 1; i >= 0 && _header->next(i) == _header; --i)
+            --_header->_level;
+        return x_next;
+    }
+
 protected:
     // only for map
     std::pair<iterator, bool> insert_or_assign(const T& val) {
         const key_type& key = get_key(val);
         node_ptr update[SkipListMaxLevel];
-        node_ptr curr = _header, next;
-        for (int level = _header->_level - 1; level >= 0; --level) {
-            while ((next = curr->_next[level]) != _header && _comp(get_key(next), key))
-                curr = next;
-            update[level] = curr;
-        }
-        next = curr->_next[0];
+        size_t rank[SkipListMaxLevel];
+        node_ptr curr = search_update(key, update, rank), next;
+        next = curr->next(0);
         if (next != _header && !_comp(key, get_key(next))/* && !_comp(get_key(next), key)*/) {
             next->_val.second = val.second;
             return { next, false };
         }
-        else return { insert_after(curr, val, update), true };
+        else return { insert_after(curr, val, update, rank), true };
     }
 
     std::pair<iterator, bool> insert_unique(const T& val) {
         const key_type& key = get_key(val);
         node_ptr update[SkipListMaxLevel];
-        node_ptr curr = _header, next;
-        for (int level = _header->_level - 1; level >= 0; --level) {
-            while ((next = curr->_next[level]) != _header && _comp(get_key(next), key))
-                curr = next;
-            update[level] = curr;
-        }
-        next = curr->_next[0];
+        size_t rank[SkipListMaxLevel];
+        node_ptr curr = search_update(key, update, rank), next;
+        next = curr->next(0);
         if (next != _header && !_comp(key, get_key(next))/* && !_comp(get_key(next), key)*/) {
             return { next, false };
         }
-        else return { insert_after(curr, val, update), true };
+        else return { insert_after(curr, val, update, rank), true };
     }
 
     iterator insert_multi(const T& val) {
         const key_type& key = get_key(val);
         node_ptr update[SkipListMaxLevel];
-        node_ptr curr = _header, next;
-        for (int level = _header->_level - 1; level >= 0; --level) {
-            while ((next = curr->_next[level]) != _header && _comp(get_key(next), key))
-                curr = next;
-            update[level] = curr;
-        }
-        return insert_after(curr, val, update);
+        size_t rank[SkipListMaxLevel];
+        node_ptr curr = search_update(key, update, rank);
+        return insert_after(curr, val, update, rank);
     }
 
-    iterator insert_before_bottom_up(node_ptr x, const T& val) {
-        int level = random_level();
-        node_ptr newnode = new_node(val, level, x->_prev, nullptr);
-        newnode->_next[0] = x;
-        x->_prev->_next[0] = newnode;
-        x->_prev = newnode;
-        node_ptr curr = newnode->_prev;
-        for (int i = 1; i < level; ++i) {
-            while (curr != _header && curr->_level <= i)
-                curr = curr->_prev;
-            newnode->_next[i] = curr->_next[i];
-            curr->_next[i] = newnode;
-        }
-        if (level > _header->_level) _header->_level = level;
-        ++_count;
-        return newnode;
+    // only for map, value-initialize the mapped value if `key` is absent
+    iterator find_or_insert(const key_type& key) {
+        node_ptr update[SkipListMaxLevel];
+        size_t rank[SkipListMaxLevel];
+        node_ptr curr = search_update(key, update, rank), next;
+        next = curr->next(0);
+        if (next != _header && !_comp(key, get_key(next))/* && !_comp(get_key(next), key)*/) {
+            return next;
+        }
+        else return insert_after(curr, { key, typename T::second_type() }, update, rank);
     }
 
     // quick erasure for non-duplicate map/set or for
     // multi map/set when only wanting to delete one key
     size_t erase_one_top_down(const key_type& key) {
         node_ptr update[SkipListMaxLevel];
-        node_ptr curr = _header, next;
-        for (int level = _header->_level - 1; level >= 0; --level) {
-            while ((next = curr->_next[level]) != _header && _comp(get_key(next), key))
-                curr = next;
-            update[level] = curr;
-        }
-        curr = curr->_next[0];
+        size_t rank[SkipListMaxLevel];
+        node_ptr curr = search_update(key, update, rank)->next(0);
         if (curr == _header || _comp(key, get_key(curr))) {
             return 0;
         }
-        curr->_next[0]->_prev = curr->_prev;
-        for (int i = 0; i < curr->_level; ++i) {
-            update[i]->_next[i] = curr->_next[i];
-        }
-        delete_node(curr); --_count;
-        for (int i = _header->_level - 1; i >= 0 && _header->_next[i] == _header; --i)
-            --_header->_level;
+        unlink_node(curr, update);
         return 1;
     }
 
 private:
-    node_ptr erase_bottom_up(node_ptr x) {
+    // Links above x that jump over it must shrink as well, so we can no longer
+    // fix up only x's own tower bottom-up. Search top-down for the first key
+    // equivalent to x's, then walk the duplicates (if any) until reaching x.
+    node_ptr erase_node(node_ptr x) {
         assert(x != _header && "cannot erase end() iterator");
-        node_ptr x_next = x->_next[0];
-        x->_prev->_next[0] = x_next;
-        x_next->_prev = x->_prev;
-        // move left then up, left up, ...
-        // until reach the first node with the same level
-        int level = x->_level;
-        node_ptr curr = x->_prev;
-        for (int i = 1; i < level; ++i) {
-            while (curr->_level <= i)
-                curr = curr->_prev;
-            curr->_next[i] = x->_next[i];
-        }
-        delete_node(x); --_count;
-        for (int i = _header->_level - 1; i >= 0 && _header->_next[i] == _header; --i)
-            --_header->_level;
-        return x_next;
+        node_ptr update[SkipListMaxLevel];
+        size_t rank[SkipListMaxLevel];
+        node_ptr curr = search_update(get_key(x), update, rank);
+        while ((curr = curr->next(0)) != x) {
+            for (int i = 0; i < curr->_level; ++i)
+                update[i] = curr;
+        }
+        return unlink_node(x, update);
     }
 
+    // A node and its forward links live in one allocation:
+    //     | _val | _level | _prev | link[0] | link[1] | ... | link[_level-1] |
+    // the header node owns a full tower of SkipListMaxLevel links.
     struct SkipList_node {
+        struct link {
+            node_ptr next;
+            size_t   width; // # of level-0 steps from here to next
+        };
+
         T _val;
         int      _level;
         node_ptr _prev;
-        node**   _next;
 
         SkipList_node(const T& val, int level, node_ptr prev, node_ptr update[])
             : _val(val), _level(level), _prev(prev)
         {
-            _next = (node**) ::operator new(level * sizeof(node_ptr));
             if (update) {
                 for (int i = 0; i < level; ++i) {
-                    _next[i] = update[i]->_next[i];
-                    update[i]->_next[i] = this;
+                    next(i) = update[i]->next(i);
+                    update[i]->next(i) = this;
                 }
-                _next[0]->_prev = this;
+                next(0)->_prev = this;
             }
         }
 
-        ~SkipList_node() { ::operator delete(_next); }
+        link* tower() noexcept {
+            return reinterpret_cast<link*>(this + 1);
+        }
+        const link* tower() const noexcept {
+            return reinterpret_cast<const link*>(this + 1);
+        }
+
+        node_ptr& next(int i) noexcept { return tower()[i].next; }
+        node_ptr  next(int i) const noexcept { return tower()[i].next; }
+        size_t& width(int i) noexcept { return tower()[i].width; }
+        size_t  width(int i) const noexcept { return tower()[i].width; }
 
         // in case operator& is overloaded
         T* val_ptr() {
@@ -577,6 +880,10 @@ private:
         }
     };
 
+    struct alignas(SkipList_node) SkipList_node_unit {
+        unsigned char _bytes[alignof(SkipList_node)];
+    };
+
     class SkipList_iter
     {
         using _self = SkipList_iter;
@@ -603,13 +910,13 @@ private:
         }
 
         _self& operator++() {
-            _ptr = _ptr->_next[0];
+            _ptr = _ptr->next(0);
             return *this;
         }
 
         _self operator++(int) {
             _self tmp{ *this };
-            _ptr = _ptr->_next[0];
+            _ptr = _ptr->next(0);
             return tmp;
         }
 
@@ -660,13 +967,13 @@ private:
         }
 
         _self& operator++() {
-            _ptr = _ptr->_next[0];
+            _ptr = _ptr->next(0);
             return *this;
         }
 
         _self operator++(int) {
             _self tmp{ *this };
-            _ptr = _ptr->_next[0];
+            _ptr = _ptr->next(0);
             return tmp;
         }
 
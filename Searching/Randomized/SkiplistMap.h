@@ -34,6 +34,7 @@ public:
     using reverse_iterator = typename _base::reverse_iterator;
     using const_reverse_iterator = typename _base::const_reverse_iterator;
     using node_type = typename _base::node_type;
+    using Finger = typename _base::Finger;
 
     class value_compare {
         Compare _key_comp;
@@ -116,10 +117,7 @@ public:
     }
 
     T& operator[](const Key& key) {
-        iterator it = this->lower_bound(key); // it->first >= key
-        if (it == this->end() || key_comp()(key, it->first))
-            it = _base::insert_before_bottom_up(it.ptr(), { key, T() });
-        return it->second;
+        return _base::find_or_insert(key)->second;
     }
 
     /* unique insertion for map */
@@ -132,6 +130,16 @@ public:
         return _base::insert_unique({ key, val });
     }
 
+    // insert near the position of the previous insertion through `f`,
+    // O(log d) expected where d is the distance between the two keys
+    std::pair<iterator, bool> insert(Finger& f, const value_type& val) {
+        return _base::insert_unique(f, val);
+    }
+
+    iterator insert(const_iterator hint, const value_type& val) {
+        return _base::insert_unique(hint, val).first;
+    }
+
     template <typename InputIt>
     void insert(InputIt first, InputIt last) {
         return _base::insert_unique(first, last);
@@ -193,6 +201,7 @@ public:
     using reverse_iterator = typename _base::reverse_iterator;
     using const_reverse_iterator = typename _base::const_reverse_iterator;
     using node_type = typename _base::node_type;
+    using Finger = typename _base::Finger;
 
     class value_compare {
         Compare _key_comp;
@@ -270,6 +279,16 @@ public:
         return _base::insert_multi({ key, val });
     }
 
+    // insert near the position of the previous insertion through `f`,
+    // O(log d) expected where d is the distance between the two keys
+    iterator insert(Finger& f, const value_type& val) {
+        return _base::insert_multi(f, val);
+    }
+
+    iterator insert(const_iterator hint, const value_type& val) {
+        return _base::insert_multi(hint, val);
+    }
+
     template <typename InputIt>
     void insert(InputIt first, InputIt last) {
         return _base::insert_multi(first, last);
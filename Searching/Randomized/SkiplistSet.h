@@ -33,6 +33,7 @@ public:
     using reverse_iterator = typename _base::reverse_iterator;
     using const_reverse_iterator = typename _base::const_reverse_iterator;
     using node_type = typename _base::node_type;
+    using Finger = typename _base::Finger;
 
     /* I */
 
@@ -95,6 +96,16 @@ public:
         return _base::insert_unique(val);
     }
 
+    // insert near the position of the previous insertion through `f`,
+    // O(log d) expected where d is the distance between the two keys
+    std::pair<iterator, bool> insert(Finger& f, const value_type& val) {
+        return _base::insert_unique(f, val);
+    }
+
+    iterator insert(const_iterator hint, const value_type& val) {
+        return _base::insert_unique(hint, val).first;
+    }
+
     template <typename InputIt>
     void insert(InputIt first, InputIt last) {
         return _base::insert_unique(first, last);
@@ -148,6 +159,7 @@ public:
     using reverse_iterator = typename _base::reverse_iterator;
     using const_reverse_iterator = typename _base::const_reverse_iterator;
     using node_type = typename _base::node_type;
+    using Finger = typename _base::Finger;
 
     /* I */
 
@@ -210,6 +222,16 @@ public:
         return _base::insert_multi(val);
     }
 
+    // insert near the position of the previous insertion through `f`,
+    // O(log d) expected where d is the distance between the two keys
+    iterator insert(Finger& f, const value_type& val) {
+        return _base::insert_multi(f, val);
+    }
+
+    iterator insert(const_iterator hint, const value_type& val) {
+        return _base::insert_multi(hint, val);
+    }
+
     template <typename InputIt>
     void insert(InputIt first, InputIt last) {
         return _base::insert_multi(first, last);
@@ -0,0 +1,63 @@
+#include "../SkiplistSet.h"
+#include "../SkipListArena.h"
+#include <set>
+#include <string>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+// count every trip to the global allocator
+static size_t g_alloc_calls = 0;
+static size_t g_alloc_bytes = 0;
+
+void* operator new(size_t sz) {
+    ++g_alloc_calls;
+    g_alloc_bytes += sz;
+    if (void* p = std::malloc(sz ? sz : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+template<typename Set>
+void measure(const char* name, const vector<int>& keys)
+{
+    size_t calls0 = g_alloc_calls, bytes0 = g_alloc_bytes;
+    auto t0 = chrono::steady_clock::now();
+    {
+        Set st;
+        for (int k : keys) st.insert(k);
+        size_t calls = g_alloc_calls - calls0, bytes = g_alloc_bytes - bytes0;
+        auto t1 = chrono::steady_clock::now();
+        cout << name << ":\n"
+             << "  allocations per element: " << (double) calls / st.size() << '\n'
+             << "  bytes per element:       " << (double) bytes / st.size() << '\n'
+             << "  insert time:             "
+             << chrono::duration<double, milli>(t1 - t0).count() << " ms\n";
+    }
+    auto t2 = chrono::steady_clock::now();
+    cout << "  insert + destroy time:   "
+         << chrono::duration<double, milli>(t2 - t0).count() << " ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+    const int n = argc > 1 ? atoi(argv[1]) : 1'000'000;
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i) keys[i] = i;
+    shuffle(keys.begin(), keys.end(), mt19937(1234));
+
+    cout << "n = " << n << ", sizeof(int) = " << sizeof(int) << "\n\n";
+    measure<set<int>>("std::set<int>", keys);
+    measure<myst::SkiplistSet<int>>("myst::SkiplistSet<int>", keys);
+    measure<myst::SkiplistSet<int, less<int>, myst::SkipListArenaAllocator<int>>>(
+        "myst::SkiplistSet<int> + SkipListArena", keys);
+
+    return 0;
+}
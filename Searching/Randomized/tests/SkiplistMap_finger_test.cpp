@@ -0,0 +1,93 @@
+#include "../SkiplistMap.h"
+#include "../SkiplistSet.h"
+#include <map>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+template<typename Fn>
+double time_ms(Fn fn)
+{
+    auto t0 = chrono::steady_clock::now();
+    fn();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+template<typename Map1, typename Map2>
+bool same_contents(const Map1& m1, const Map2& m2)
+{
+    return m1.size() == m2.size() && std::equal(m1.begin(), m1.end(), m2.begin(),
+        [](const auto& a, const auto& b) { return a.first == b.first && a.second == b.second; });
+}
+
+void run(const char* name, const vector<int>& keys)
+{
+    using SkipList = myst::SkiplistMap<int, int>;
+    SkipList sl1, sl2, sl3;
+    std::map<int, int> mp1, mp2;
+
+    double t_sl = time_ms([&] { for (int k : keys) sl1.insert({ k, k }); });
+    double t_sl_finger = time_ms([&] {
+        SkipList::Finger f;
+        for (int k : keys) sl2.insert(f, { k, k });
+    });
+    double t_sl_hint = time_ms([&] { for (int k : keys) sl3.insert(sl3.end(), { k, k }); });
+    double t_mp = time_ms([&] { for (int k : keys) mp1.insert({ k, k }); });
+    double t_mp_hint = time_ms([&] { for (int k : keys) mp2.insert(mp2.end(), { k, k }); });
+
+    cout << name << ":\n"
+         << "  SkiplistMap::insert(val)         " << t_sl << " ms\n"
+         << "  SkiplistMap::insert(finger, val) " << t_sl_finger << " ms\n"
+         << "  SkiplistMap::insert(end(), val)  " << t_sl_hint << " ms\n"
+         << "  std::map::insert(val)            " << t_mp << " ms\n"
+         << "  std::map::insert(end(), val)     " << t_mp_hint << " ms\n";
+    if (!same_contents(sl1, mp1) || !same_contents(sl2, mp1) || !same_contents(sl3, mp1))
+        cout << "  MISMATCH!\n";
+}
+
+int main(int argc, char* argv[])
+{
+    const int n = argc > 1 ? atoi(argv[1]) : 1'000'000;
+    mt19937 gen(1234);
+
+    vector<int> keys(n);
+    for (int i = 0; i < n; ++i) keys[i] = i;
+    run("sorted", keys);
+
+    // every key is at most 8 places away from its sorted position
+    for (int i = 0; i + 8 < n; i += 8)
+        shuffle(keys.begin() + i, keys.begin() + i + 8, gen);
+    run("nearly sorted (shuffled in blocks of 8)", keys);
+
+    // 1% of the keys arrive late
+    for (int i = 0; i < n; ++i) keys[i] = i;
+    for (int i = 0; i < n / 100; ++i)
+        swap(keys[gen() % n], keys[gen() % n]);
+    run("nearly sorted (1% swapped)", keys);
+
+    shuffle(keys.begin(), keys.end(), gen);
+    run("random", keys);
+
+    // the sets take fingers and hints too; only hinted insertion makes a finger
+    myst::SkiplistSet<int> st1, st2;
+    myst::SkiplistMultiset<int> ms;
+    myst::SkiplistSet<int>::Finger f;
+    for (int k : keys) {
+        st1.insert(f, k);
+        st2.insert(st2.end(), k);
+        ms.insert(ms.begin(), k % 1000);
+    }
+    if (!std::equal(st1.begin(), st1.end(), st2.begin(), st2.end()) || st1.size() != size_t(n)
+        || !std::is_sorted(ms.begin(), ms.end()) || ms.size() != size_t(n))
+        cout << "set MISMATCH!\n";
+    cout << "\nsizeof(SkiplistMap<int, int>) = " << sizeof(myst::SkiplistMap<int, int>) << " bytes\n";
+
+    return 0;
+}
@@ -49,6 +49,17 @@ int main()
         print_set("\n\nst, after swapping with st2: \n", st);
 
         print_set("\n\nst2, after swapping with st: \n", st2);
+
+        // order statistics
+        cout << "\n\nst2, order statistics:\n";
+        for (size_t i = 0; i < st2.size(); ++i) {
+            cout << "st2.at(" << i << ") = " << st2.at(i) << ", rank = "
+                 << st2.rank(st2.at(i)) << ", upper_rank = " << st2.upper_rank(st2.at(i)) << '\n';
+        }
+        st2.erase_at(0);
+        st2.erase_at(st2.size() - 1);
+        st2.erase_at(st2.rank(70));
+        print_set("\nst2, after erasing the first, the last and 70 by index: \n", st2);
     }
     catch (const exception& e) {
         cout << e.what() << endl;
@@ -57,17 +57,48 @@ void test() {
         cout << x << " ";
     }
     cout << '\n';
+
+    for (auto x : rolling_rank_batch<double, asc>(arr, arr_size, window, method)) {
+        cout << x << " ";
+    }
+    cout << '\n';
 }
 
 constexpr int arr_size = 1024 * 1024;
 double arr[arr_size];
 double res_naive[arr_size];
 double res_tree[arr_size];
+double res_balanced[arr_size];
 
-void run_benchmark(int window) {
+void fill_random(double *arr, int size) {
     const double min = 100'000;
-    const double max = min + arr_size * 0.1;
-    fill_array(arr, arr_size, min, max);
+    fill_array(arr, size, min, min + size * 0.1);
+}
+
+// trending data (e.g. prices) arrives in nearly sorted order
+void fill_increasing(double *arr, int size) {
+    for (int i = 0; i < size; i++) {
+        arr[i] = i;
+    }
+}
+
+void fill_decreasing(double *arr, int size) {
+    for (int i = 0; i < size; i++) {
+        arr[i] = size - i;
+    }
+}
+
+// e.g. prices in ticks that hardly move, so most values have ties
+void fill_repeated(double *arr, int size) {
+    srand(time(NULL));
+
+    for (int i = 0; i < size; i++) {
+        arr[i] = rand() % 8;
+    }
+}
+
+void run_benchmark(const char *input, void (*fill)(double *, int), int window) {
+    fill(arr, arr_size);
 
     clock_t t1, t2;
 
@@ -81,10 +112,29 @@ void run_benchmark(int window) {
     t2 = clock();
     const double rank_tree_time = (t2 - t1) / (double)CLOCKS_PER_SEC;
 
+    t1 = clock();
+    rolling_rank<double, asc, BalancedRankTree>(res_balanced, method, arr,
+                                                arr_size, window);
+    t2 = clock();
+    const double balanced_time = (t2 - t1) / (double)CLOCKS_PER_SEC;
+
+    t1 = clock();
+    const auto res_batch =
+        rolling_rank_batch<double, asc>(arr, arr_size, window, method);
+    t2 = clock();
+    const double batch_time = (t2 - t1) / (double)CLOCKS_PER_SEC;
+
     const int unequal = unequal_size(res_naive, res_tree, arr_size);
-    cout << "unequal size = " << unequal << '\n'
+    const int unequal_balanced = unequal_size(res_naive, res_balanced, arr_size);
+    const int unequal_batch = unequal_size(res_naive, res_batch.data(), arr_size);
+    cout << '\n' << input << " input:\n"
+         << "unequal size = " << unequal << '\n'
+         << "unequal size (balanced) = " << unequal_balanced << '\n'
+         << "unequal size (batch) = " << unequal_batch << '\n'
          << "native time = " << native_time << '\n'
-         << "rank tree time = " << rank_tree_time << '\n';
+         << "rank tree time = " << rank_tree_time << '\n'
+         << "balanced rank tree time = " << balanced_time << '\n'
+         << "batch (Fenwick tree) time = " << batch_time << '\n';
 }
 
 int main(int argc, char *argv[]) {
@@ -96,7 +146,10 @@ int main(int argc, char *argv[]) {
     const int window = atoi(argv[1]);
 
     test();
-    run_benchmark(window);
+    run_benchmark("random", fill_random, window);
+    run_benchmark("increasing", fill_increasing, window);
+    run_benchmark("decreasing", fill_decreasing, window);
+    run_benchmark("repeated-value", fill_repeated, window);
 
     return EXIT_SUCCESS;
 }
@@ -1,154 +1,272 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../TreeMap/RbSet.h"
 
 namespace myRankingAlgo {
 
 enum class RankMethod { Min, Max, Average };
 
-template <typename T, typename Compare = std::less<T>>
+// An AVL tree whose nodes also keep the size of their subtree, so insert,
+// remove and the ranks are O(log(n)) worst case, also for the sorted or
+// trending input that degenerates an unbalanced BST into a linked list.
+// The nodes live in one array (a vector over Alloc, rebound to the node
+// type) and link to each other by index; removed ones go on a free list and
+// are reused, so after reserve(n) a tree of at most n elements, like the
+// window of a rolling rank, makes no allocation at all. nodes_[0] is the
+// nil node, of size and height 0, which is why T must be default
+// constructible.
+template <typename T, typename Compare = std::less<T>,
+          typename Alloc = std::allocator<T>>
 class RankTree {
 public:
-    RankTree(Compare comp = Compare()) : comp_(comp) {}
+    RankTree(Compare comp = Compare(), const Alloc &alloc = Alloc())
+        : comp_(comp), nodes_(NodeAlloc(alloc)) {
+        nodes_.push_back(Node{T(), 0, 0, 0, 0});
+    }
+
+    RankTree(const RankTree &) = delete;
+    RankTree &operator=(const RankTree &) = delete;
 
-    ~RankTree() { clear(); }
+    int size() const { return nodes_[root_].count; }
 
-    int size() const { return root_ ? root_->count : 0; }
+    // makes room for n elements in the pool
+    void reserve(int n) { nodes_.reserve(static_cast<size_t>(n) + 1); }
 
+    // keeps the pool
     void clear() {
-        clear(root_);
-        root_ = nullptr;
+        nodes_.erase(nodes_.begin() + 1, nodes_.end());
+        root_ = free_ = 0;
     }
 
     // return the highest rank (see rank_max) of the inserted element.
-    int insert(const T &value) { return insert_node(&root_, value); }
+    int insert(const T &value) {
+        int rank_max = 0;
+        root_ = insert_node(root_, value, rank_max);
+        return rank_max + 1;  // +1 for this inserted one
+    }
 
-    void remove(const T &value) { remove_node(&root_, value); }
+    // removes one element equal to value, if any
+    void remove(const T &value) { root_ = remove_node(root_, value); }
 
-    int rank_min(const T &value) const { return rank_min(root_, value); }
+    int rank_min(const T &value) const {
+        int x = root_;
+        int rank = nodes_[x].count;
+        while (x) {
+            const Node &node = nodes_[x];
+            if (comp_(node.value, value)) {
+                x = node.right;
+            } else {
+                rank -= 1 + nodes_[node.right].count;
+                x = node.left;
+            }
+        }
+        return rank + 1;
+    }
 
-    int rank_max(const T &value) const { return rank_max(root_, value); }
+    int rank_max(const T &value) const {
+        int x = root_;
+        int rank = 0;
+        while (x) {
+            const Node &node = nodes_[x];
+            if (comp_(value, node.value)) {
+                x = node.left;
+            } else {
+                rank += 1 + nodes_[node.left].count;
+                x = node.right;
+            }
+        }
+        return rank;
+    }
 
 private:
     struct Node {
         T value;
-        int count;
-        Node *left;
-        Node *right;
+        int count;   // # of nodes in the subtree
+        int height;  // of the subtree
+        int left;    // next free node, while on the free list
+        int right;
     };
 
-    Node *root_ = nullptr;
+    using NodeAlloc =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+
     Compare comp_;
+    std::vector<Node, NodeAlloc> nodes_;
+    int root_ = 0;
+    int free_ = 0;  // head of the free list, 0 if empty
 
-    void clear(Node *root) {
-        if (root) {
-            clear(root->left);
-            clear(root->right);
-            delete root;
+    int new_node(const T &value) {
+        if (free_) {
+            const int x = free_;
+            free_ = nodes_[x].left;
+            nodes_[x] = Node{value, 1, 1, 0, 0};
+            return x;
         }
+        nodes_.push_back(Node{value, 1, 1, 0, 0});
+        return static_cast<int>(nodes_.size()) - 1;
     }
 
-    int insert_node(Node **root, const T &value) {
-        int rank_max = 0;
-        while (*root) {
-            (*root)->count++;
-            if (comp_(value, (*root)->value)) {
-                root = &(*root)->left;
-            } else {
-                rank_max += 1 + ((*root)->left ? (*root)->left->count : 0);
-                root = &(*root)->right;
-            }
-        }
-        *root = new Node{value, 1, nullptr, nullptr};
-        return rank_max + 1;  // +1 for this inserted one
+    void free_node(int x) {
+        nodes_[x].left = free_;
+        free_ = x;
     }
 
-    void remove_node(Node **root, const T &value) {
-        if (*root == nullptr) {
-            return;
+    // Both walks recurse, which is fine as the height is < 1.45 * log2(n).
+    // nodes_ may grow while inserting, so no reference to a node is held
+    // across a call.
+    int insert_node(int x, const T &value, int &rank_max) {
+        if (x == 0) {
+            return new_node(value);
+        }
+        if (comp_(value, nodes_[x].value)) {
+            const int left = insert_node(nodes_[x].left, value, rank_max);
+            nodes_[x].left = left;
+        } else {
+            rank_max += 1 + nodes_[nodes_[x].left].count;
+            const int right = insert_node(nodes_[x].right, value, rank_max);
+            nodes_[x].right = right;
         }
+        return balance(x);
+    }
 
-        if (comp_(value, (*root)->value)) {
-            remove_node(&(*root)->left, value);
-        } else if (comp_((*root)->value, value)) {
-            remove_node(&(*root)->right, value);
+    int remove_node(int x, const T &value) {
+        if (x == 0) {
+            return 0;
+        }
+        if (comp_(value, nodes_[x].value)) {
+            nodes_[x].left = remove_node(nodes_[x].left, value);
+        } else if (comp_(nodes_[x].value, value)) {
+            nodes_[x].right = remove_node(nodes_[x].right, value);
         } else {
-            if ((*root)->left == nullptr) {
-                Node *tmp = (*root)->right;
-                delete *root;
-                *root = tmp;
-            } else if ((*root)->right == nullptr) {
-                Node *tmp = (*root)->left;
-                delete *root;
-                *root = tmp;
-            } else {
-                Node *min_node = find_min((*root)->right);
-                (*root)->value = min_node->value;
-                remove_node(&(*root)->right, min_node->value);
+            const int left = nodes_[x].left;
+            int right = nodes_[x].right;
+            free_node(x);
+            if (left == 0) {
+                return right;
+            }
+            if (right == 0) {
+                return left;
             }
+            // the successor takes x's place
+            right = remove_min(right, x);
+            nodes_[x].left = left;
+            nodes_[x].right = right;
         }
+        return balance(x);
+    }
 
-        if (*root) {
-            update_size(*root);
+    // detaches the minimum of subtree x into min
+    int remove_min(int x, int &min) {
+        if (nodes_[x].left == 0) {
+            min = x;
+            return nodes_[x].right;
         }
+        nodes_[x].left = remove_min(nodes_[x].left, min);
+        return balance(x);
     }
 
-    int rank_min(Node *root, const T &value) const {
-        int rank = root ? root->count : 0;
-        while (root) {
-            if (comp_(root->value, value)) {
-                root = root->right;
-            } else {
-                rank -= 1 + (root->right ? root->right->count : 0);
-                root = root->left;
-            }
-        }
-        return rank + 1;
+    void update(int x) {
+        Node &node = nodes_[x];
+        const Node &left = nodes_[node.left];
+        const Node &right = nodes_[node.right];
+        node.count = 1 + left.count + right.count;
+        node.height = 1 + std::max(left.height, right.height);
     }
 
-    int rank_max(Node *root, const T &value) const {
-// #define DO_RECURSIVE_RANKING
-#if defined(DO_RECURSIVE_RANKING)
-        if (root == nullptr) {
-            return 0;
-        }
+    int rotate_left(int x) {
+        const int y = nodes_[x].right;
+        nodes_[x].right = nodes_[y].left;
+        nodes_[y].left = x;
+        update(x);
+        update(y);
+        return y;
+    }
 
-        if (comp_(value, root->value)) {
-            return rank_max(root->left, value);
-        } else {
-            return 1 + (root->left ? root->left->count : 0) +
-                   rank_max(root->right, value);
+    int rotate_right(int x) {
+        const int y = nodes_[x].left;
+        nodes_[x].left = nodes_[y].right;
+        nodes_[y].right = x;
+        update(x);
+        update(y);
+        return y;
+    }
+
+    // restores the AVL property at x, whose subtrees are AVL trees with
+    // heights differing by at most 2, and returns the new subtree root
+    int balance(int x) {
+        update(x);
+        Node &node = nodes_[x];
+        const int diff = nodes_[node.left].height - nodes_[node.right].height;
+        if (diff > 1) {
+            const Node &left = nodes_[node.left];
+            if (nodes_[left.left].height < nodes_[left.right].height) {
+                node.left = rotate_left(node.left);
+            }
+            return rotate_right(x);
         }
-#else
-        int rank = 0;
-        while (root) {
-            if (comp_(value, root->value)) {
-                root = root->left;
-            } else {
-                rank += 1 + (root->left ? root->left->count : 0);
-                root = root->right;
+        if (diff < -1) {
+            const Node &right = nodes_[node.right];
+            if (nodes_[right.right].height < nodes_[right.left].height) {
+                node.right = rotate_right(node.right);
             }
+            return rotate_left(x);
         }
-        return rank;
-#endif
+        return x;
     }
+};
 
-    Node *find_min(Node *root) const {
-        if (root == nullptr) {
-            return nullptr;
-        }
-        while (root->left != nullptr) {
-            root = root->left;
+// Same interface as RankTree, on top of a red-black tree that keeps subtree
+// sizes. Every operation is O(log(n)) worst case too, but each node is
+// allocated on its own and insert() walks the tree twice.
+template <typename T, typename Compare = std::less<T>,
+          typename Alloc = std::allocator<T>>
+class BalancedRankTree {
+public:
+    BalancedRankTree(Compare comp = Compare(), const Alloc &alloc = Alloc())
+        : tree_(comp, alloc) {}
+
+    int size() const { return static_cast<int>(tree_.size()); }
+
+    // nothing to reserve, the nodes come from Alloc one by one
+    void reserve(int) {}
+
+    void clear() { tree_.clear(); }
+
+    // return the highest rank (see rank_max) of the inserted element.
+    int insert(const T &value) {
+        tree_.insert(value);
+        return rank_max(value);
+    }
+
+    void remove(const T &value) {
+        auto it = tree_.find(value);
+        if (it != tree_.end()) {
+            tree_.erase(it);
         }
-        return root;
     }
 
-    int size(Node *root) const { return root == nullptr ? 0 : root->count; }
+    int rank_min(const T &value) const {
+        return static_cast<int>(tree_.rank(value)) + 1;
+    }
 
-    // precondition: root != nullptr
-    void update_size(Node *root) {
-        root->count = 1 + size(root->left) + size(root->right);
+    int rank_max(const T &value) const {
+        return static_cast<int>(tree_.upper_rank(value));
     }
+
+private:
+    mySymbolTable::RbMultiset<T, Compare, Alloc,
+                              mySymbolTable::order_statistics_node_update>
+        tree_;
 };
 
 // -fcode-hoisting enabled by -O2 will move the if (asc) outside the loop :)
@@ -184,11 +302,13 @@ double rank_naive(const T *data, RankMethod method, bool asc, int row_idx,
     }
 }
 
-template <typename T, bool Asc = true>
+// Tree is RankTree or BalancedRankTree
+template <typename T, bool Asc = true,
+          template <typename, typename> class Tree = RankTree>
 void rolling_rank(double *res, RankMethod method, const T *arr, int arr_size,
                   int window) {
-    RankTree<T, std::conditional_t<Asc, std::less<T>, std::greater<T>>>
-        rank_tree;
+    Tree<T, std::conditional_t<Asc, std::less<T>, std::greater<T>>> rank_tree;
+    rank_tree.reserve(window);
 #if defined(IS_TALIB_RESULT)
     // for ta_res, the buffer is only of size `arr_size - window + 1`
     res -= window - 1;
@@ -228,4 +348,91 @@ void rolling_rank(double *res, RankMethod method, const T *arr, int arr_size,
     }
 }
 
+// Offline rolling rank, for when the whole column is at hand. The values are
+// compressed to their place among the distinct values by sorting once, then
+// a Fenwick tree over the U places, counting the values of the window, slides
+// along. It is O(n*log(U)) like rolling_rank(), but a step makes no
+// comparisons and no allocation: two updates and a prefix sum over a flat
+// array of counts. As with rolling_rank(), the first window - 1 ranks are -1.
+// NaNs can't be sorted, they throw std::invalid_argument.
+template <typename T, bool Asc = true>
+std::vector<double> rolling_rank_batch(const T *arr, size_t arr_size, size_t window,
+                                       RankMethod method) {
+    std::vector<double> res(arr_size, -1);
+    if (window == 0) {
+        return res;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        if (std::any_of(arr, arr + arr_size, [](T x) { return std::isnan(x); })) {
+            throw std::invalid_argument("rolling_rank_batch: NaN in the input");
+        }
+    }
+
+    // key[i] - 1 is the # of distinct values ranked before arr[i]
+    std::vector<size_t> key(arr_size);
+    size_t distinct = 0;
+    {
+        std::conditional_t<Asc, std::less<T>, std::greater<T>> comp;
+        std::vector<std::pair<T, size_t>> sorted(arr_size);
+        for (size_t i = 0; i < arr_size; ++i) {
+            sorted[i] = {arr[i], i};
+        }
+        std::sort(sorted.begin(), sorted.end(),
+                  [&comp](const std::pair<T, size_t> &a,
+                          const std::pair<T, size_t> &b) {
+                      return comp(a.first, b.first);
+                  });
+        for (size_t i = 0; i < arr_size; ++i) {
+            if (i == 0 || comp(sorted[i - 1].first, sorted[i].first)) {
+                ++distinct;
+            }
+            key[sorted[i].second] = distinct;
+        }
+    }
+
+    // tree is 1-based, equal[k] counts the values of key k alone so that a
+    // rank needs one prefix sum
+    std::vector<std::ptrdiff_t> tree(distinct + 1), equal(distinct + 1);
+    auto add = [&](size_t k, std::ptrdiff_t delta) {
+        equal[k] += delta;
+        for (; k <= distinct; k += k & (~k + 1)) {
+            tree[k] += delta;
+        }
+    };
+    auto count_before = [&tree](size_t k) {
+        std::ptrdiff_t count = 0;
+        for (--k; k > 0; k -= k & (~k + 1)) {
+            count += tree[k];
+        }
+        return count;
+    };
+
+    for (size_t i = 0; i < arr_size; i++) {
+        if (i >= window) {
+            add(key[i - window], -1);
+        }
+        add(key[i], 1);
+
+        if (i + 1 < window) {
+            continue;
+        }
+        const std::ptrdiff_t rank_min = count_before(key[i]) + 1;
+        const std::ptrdiff_t rank_max = rank_min + equal[key[i]] - 1;
+        switch (method) {
+        case RankMethod::Min:
+            res[i] = static_cast<double>(rank_min);
+            break;
+        case RankMethod::Max:
+            res[i] = static_cast<double>(rank_max);
+            break;
+        case RankMethod::Average:
+            res[i] = rank_min + (rank_max - rank_min) / 2.0;
+            break;
+        default:
+            break;
+        }
+    }
+    return res;
+}
+
 }  // namespace myRankingAlgo
@@ -12,24 +12,30 @@
 #include <type_traits> // std::enable_if
 #include <memory>   // std::addressof, std::allocator_tarits
 #include <utility>  // std::swap, std::pair, std::forward
-#include <iterator> // std::reverse_iterator, std::distance
+#include <iterator> // std::reverse_iterator, std::distance, std::next
 #ifndef NDEBUG
 #include <iostream> // std::cout
 #include <string>
 #endif
 #include <cassert>
 #include "my_map_traits.h"  // myst::get_map_key_t
+#include "tree_policy.h"    // myst::null_node_update, myst::order_statistics_node_update
+#include "fork_join_pool.h" // myst::ForkJoinPool
+#include "batch_lookup.h"   // myst::interleave_lookups
 
 namespace mySymbolTable {
 
 // Adelson-Velsky and Landis' self-balancing binary search tree
-template<typename T, typename Compare, typename Alloc, bool IsMap, bool IsMulti>
+template<typename T, typename Compare, typename Alloc, bool IsMap, bool IsMulti,
+         typename NodeUpdate = null_node_update>
 class AVLtree {
     struct AVLtree_node;
     class AVLtree_iter;
     class AVLtree_const_iter;
-    using _self = AVLtree<T, Compare, Alloc, IsMap, IsMulti>;
-    using node = AVLtree_node;
+    using _self = AVLtree<T, Compare, Alloc, IsMap, IsMulti, NodeUpdate>;
+    struct AVLtree_compact_node;
+    static constexpr bool Compact = is_compact_layout_v<NodeUpdate>;
+    using node = std::conditional_t<Compact, AVLtree_compact_node, AVLtree_node>;
     using node_ptr = node*;
     using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<node>;
 public:
@@ -44,7 +50,8 @@ public:
     using const_iterator = AVLtree_const_iter;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-    using node_type = AVLtree_node;
+    using node_type = node;
+    using metadata_type = typename node_update_metadata<NodeUpdate>::type;
 
 private:
     // _header->_parent points to root node
@@ -56,6 +63,10 @@ private:
     Compare  _comp;
     NodeAl   _alloc;
 
+    static constexpr bool OrderStatistics = has_order_statistics_v<NodeUpdate>;
+    static constexpr bool Augmented = has_metadata_v<NodeUpdate>;
+    using Policy = typename remove_node_layout<NodeUpdate>::type;
+
 #define ROOT _header->_parent
 
     void set_default_header() noexcept {
@@ -67,6 +78,8 @@ private:
     // create & initialize the header node
     void create_header() {
         _header = _alloc.allocate(1); // may throw
+        if constexpr (Compact) // assignments keep the tag bits, so set them up first
+            ::new ((void*)std::addressof(_header->_parent)) tagged_parent<node, 3>();
         set_default_header();
         // leave the value field uninitialized
     }
@@ -219,6 +232,14 @@ public:
         return find(ROOT, key) != _header;
     }
 
+    // Writes find(key) of each key in the range to out[0], out[1], ... (a
+    // random access iterator to const_iterators), running the lookups
+    // interleaved so that their cache misses overlap, see batch_lookup.h.
+    template<typename KeyRange, typename RandomIt>
+    void find_batch(const KeyRange& keys, RandomIt out) const {
+        interleave_lookups(find_probe{ this }, std::begin(keys), std::end(keys), out);
+    }
+
     iterator lower_bound(const key_type& key) {
         return iterator(lower_bound(ROOT, key));
     }
@@ -243,6 +264,58 @@ public:
         return equal_range_aux(key);
     }
 
+    /* order statistics (order_statistics_node_update only) */
+
+    // # of elements less than key
+    size_t rank(const key_type& key) const {
+        static_assert(OrderStatistics, "rank() requires order_statistics_node_update");
+        return rank_aux</*Upper=*/false>(key);
+    }
+
+    // # of elements not greater than key
+    size_t upper_rank(const key_type& key) const {
+        static_assert(OrderStatistics, "upper_rank() requires order_statistics_node_update");
+        return rank_aux</*Upper=*/true>(key);
+    }
+
+    // the k-th (0-based) smallest element, end() if k >= size()
+    iterator select(size_t k) {
+        static_assert(OrderStatistics, "select() requires order_statistics_node_update");
+        return iterator(select_aux(k));
+    }
+
+    const_iterator select(size_t k) const {
+        static_assert(OrderStatistics, "select() requires order_statistics_node_update");
+        return const_iterator(select_aux(k));
+    }
+
+    // # of elements in [lo, hi]
+    size_t count_range(const key_type& lo, const key_type& hi) const {
+        static_assert(OrderStatistics, "count_range() requires order_statistics_node_update");
+        if (_comp(hi, lo)) return 0;
+        return rank_aux</*Upper=*/true>(hi) - rank_aux</*Upper=*/false>(lo);
+    }
+
+    /* augmentation (NodeUpdate with a metadata_type, see tree_policy.h) */
+
+    // summary of the elements with keys in [lo, hi), in O(log n)
+    metadata_type fold(const key_type& lo, const key_type& hi) const {
+        static_assert(Augmented, "fold() requires a NodeUpdate with a metadata_type");
+        return fold_aux(lo, hi);
+    }
+
+    // summary of all elements
+    metadata_type fold() const {
+        static_assert(Augmented, "fold() requires a NodeUpdate with a metadata_type");
+        return empty() ? Policy::identity() : ROOT->_meta;
+    }
+
+    // Brings the summaries up to date after the element at pos was
+    // changed in place (e.g. through operator[]) in a way that matters.
+    void refresh(const_iterator pos) noexcept {
+        update_path(pos.ptr());
+    }
+
     /* modifiers */
 
     void clear() noexcept {
@@ -253,14 +326,14 @@ public:
 
     std::conditional_t<!IsMulti, std::pair<iterator, bool>, iterator>
     insert(const value_type& val) {
-        if constexpr (!IsMulti) return insert_aux(&ROOT, /*assign=*/false, val);
-        else return insert_aux(&ROOT, /*assign=*/false, val).first;
+        if constexpr (!IsMulti) return insert_aux(/*assign=*/false, val);
+        else return insert_aux(/*assign=*/false, val).first;
     }
 
     std::conditional_t<!IsMulti, std::pair<iterator, bool>, iterator>
     insert(value_type&& val) {
-        if constexpr (!IsMulti) return insert_aux(&ROOT, /*assign=*/false, std::move(val));
-        else return insert_aux(&ROOT, /*assign=*/false, std::move(val)).first;
+        if constexpr (!IsMulti) return insert_aux(/*assign=*/false, std::move(val));
+        else return insert_aux(/*assign=*/false, std::move(val)).first;
     }
 
 private:
@@ -271,7 +344,7 @@ private:
         if (hint == _header) { // end()
             if (_comp(get_key(_header->_right), key)) // max < key
                 return insert_leaf_at(&_header->_right->_right, _header->_right, std::move(val));
-            else return insert_aux(&ROOT, assign, std::move(val)).first;
+            else return insert_aux(assign, std::move(val)).first;
         }
         else if (_comp(key, get_key(hint))) { // key < hint
             if (hint == _header->_left)       // key < min
@@ -283,7 +356,7 @@ private:
                 else // otherwise hint->_left is null
                     return insert_leaf_at(&hint->_left, hint, std::move(val));
             }
-            return insert_aux(&ROOT, assign, std::move(val)).first;
+            return insert_aux(assign, std::move(val)).first;
         }
         else if (_comp(get_key(hint), key)) { // hint < key
             if (hint == _header->_right)      // max < key
@@ -295,7 +368,7 @@ private:
                 else // otherwise hint->_right is null
                     return insert_leaf_at(&hint->_right, hint, std::move(val));
             }
-            return insert_aux(&ROOT, assign, std::move(val)).first;
+            return insert_aux(assign, std::move(val)).first;
         }
         else // equivalent keys
             return iterator(hint);
@@ -308,7 +381,7 @@ private:
         if (hint == _header) { // end()
             if (!_comp(key, get_key(_header->_right))) // key >= max
                 return insert_leaf_at(&_header->_right->_right, _header->_right, std::move(val));
-            else return insert_aux(&ROOT, /*assign=*/false, std::move(val)).first;
+            else return insert_aux(/*assign=*/false, std::move(val)).first;
         }
         else if (!_comp(get_key(hint), key)) { // key <= hint
             if (hint == _header->_left)        // key <= min
@@ -320,7 +393,7 @@ private:
                 else // otherwise hint->_left is null
                     return insert_leaf_at(&hint->_left, hint, std::move(val));
             }
-            return insert_aux(&ROOT, /*assign=*/false, std::move(val)).first;
+            return insert_aux(/*assign=*/false, std::move(val)).first;
         }
         else { // hint < key
             if (hint == _header->_right)      // max < key
@@ -332,14 +405,14 @@ private:
                 else // otherwise hint->_right is null
                     return insert_leaf_at(&hint->_right, hint, std::move(val));
             }
-            return insert_aux(&ROOT, /*assign=*/false, std::move(val)).first;
+            return insert_aux(/*assign=*/false, std::move(val)).first;
         }
     }
 
 protected:
     template<typename... Args>
     iterator insert_hint(const_iterator hint, bool assign, Args&&... args) {
-        if (empty()) return insert_leaf_at(&ROOT, _header, std::forward<Args>(args)...);
+        if (empty()) return insert_leaf_at(nullptr, _header, std::forward<Args>(args)...);
         if constexpr (!IsMulti)
             return insert_hint_unique(hint.ptr(), assign, std::forward<Args>(args)...);
         else
@@ -349,7 +422,7 @@ protected:
     // only for map
     template<typename... Args>
     std::pair<iterator, bool> try_emplace(bool assign, Args&&... args) {
-        return insert_aux(&ROOT, assign, std::forward<Args>(args)...);
+        return insert_aux(assign, std::forward<Args>(args)...);
     }
 
 public:
@@ -366,8 +439,19 @@ public:
 
     template< typename InputIt >
     void insert(InputIt first, InputIt last) {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        using iter_key = std::remove_cv_t<std::remove_reference_t<decltype(key_of(*first))>>;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category> &&
+                      std::is_same_v<iter_key, std::remove_cv_t<key_type>>) {
+            if (empty() && is_sorted_range(first, last)) {
+                assign_sorted(first, last);
+                return;
+            }
+        }
+        // appending to the back costs only one comparison with the max,
+        // otherwise it falls back to the normal insertion
         while (first != last) {
-            insert(*first++);
+            insert(cend(), *first++);
         }
     }
 
@@ -375,13 +459,55 @@ public:
         return insert(ilist.begin(), ilist.end());
     }
 
+    // Replaces the contents with the sorted range [first, last), building
+    // a perfectly balanced tree bottom-up in linear time. For unique
+    // containers only the first of equivalent elements is kept.
+    template< typename InputIt >
+    void assign_sorted(InputIt first, InputIt last) {
+        clear();
+        // chain the nodes through _right first, then shape them into a tree
+        node_ptr head = nullptr, tail = nullptr;
+        size_t n = 0;
+        try {
+            for (; first != last; ++first) {
+                node_ptr x = new_node(nullptr, *first);
+                if (tail) {
+                    assert(!_comp(get_key(x), get_key(tail)) && "range must be sorted");
+                    if (!IsMulti && !_comp(get_key(tail), get_key(x))) {
+                        delete_node(x);
+                        continue;
+                    }
+                    tail->_right = x;
+                }
+                else head = x;
+                tail = x;
+                ++n;
+            }
+        }
+        catch (...) {
+            while (head) {
+                node_ptr next = head->_right;
+                delete_node(head);
+                head = next;
+            }
+            throw;
+        }
+        if (n == 0) return;
+        node_ptr list = head;
+        ROOT = build_sorted(list, n).root;
+        ROOT->_parent = _header;
+        _header->_left  = head;
+        _header->_right = tail;
+        _count = n;
+    }
+
     template<typename... Args>
     std::conditional_t<!IsMulti, std::pair<iterator, bool>, iterator>
     emplace(Args&&... args) {
         if constexpr (!IsMulti)
-            return insert_aux(&ROOT, /*assign=*/false, std::forward<Args>(args)...);
+            return insert_aux(/*assign=*/false, std::forward<Args>(args)...);
         else
-            return insert_aux(&ROOT, /*assign=*/false, std::forward<Args>(args)...).first;
+            return insert_aux(/*assign=*/false, std::forward<Args>(args)...).first;
     }
 
     template<typename... Args>
@@ -436,6 +562,68 @@ public:
         std::swap(_comp, rhs._comp);
     }
 
+    /* join-based bulk operations */
+
+    // Below, nodes are moved between trees rather than copied, so `rhs` must
+    // use the same allocator and it's left empty. The set operations take
+    // O(m log(n/m + 1)) time, m <= n being the sizes of the two trees, and
+    // split the work among the threads of ForkJoinPool::instance() for large
+    // trees, thus the allocator must be thread-safe (std::allocator is).
+
+    // append rhs, whose elements must all be greater than
+    // (for multi containers, not less than) those in *this
+    void join(_self&& rhs) {
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        if (rhs.empty()) return;
+        assert(empty() || (IsMulti ? !_comp(get_key(rhs._header->_left), get_key(_header->_right))
+                                   :  _comp(get_key(_header->_right), get_key(rhs._header->_left))));
+        size_t n = _count + rhs._count;
+        subtree t = join2(detach(), rhs.detach());
+        adopt(t, n);
+    }
+
+    // move all elements not less than key into `right` (its old elements are destroyed).
+    // O(log(n)) with order_statistics_node_update, otherwise O(n) as the
+    // nodes of the left half are counted to keep size() exact
+    void split(const key_type& key, _self& right) {
+        assert(_alloc == right._alloc && "allocator must be the same");
+        right.clear();
+        if (empty()) return;
+        size_t n = _count;
+        node_ptr found = nullptr;
+        split_result r = split_aux(detach(), key, found);
+        if (found) r.right = join_aux({ nullptr, 0 }, found, r.right);
+        adopt(r.left, count_nodes(r.left.root));
+        right.adopt(r.right, n - _count);
+    }
+
+    // *this = *this U rhs, values of *this win for equivalent keys
+    void set_union(_self&& rhs) {
+        static_assert(!IsMulti, "set operations require unique keys");
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        size_t n = _count + rhs._count, dropped = 0;
+        subtree t = union_aux(detach(), rhs.detach(), n, dropped);
+        adopt(t, n - dropped);
+    }
+
+    // *this = *this ^ rhs
+    void set_intersection(_self&& rhs) {
+        static_assert(!IsMulti, "set operations require unique keys");
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        size_t n = _count + rhs._count, dropped = 0;
+        subtree t = intersection_aux(detach(), rhs.detach(), n, dropped);
+        adopt(t, n - dropped);
+    }
+
+    // *this = *this - rhs
+    void set_difference(_self&& rhs) {
+        static_assert(!IsMulti, "set operations require unique keys");
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        size_t n = _count + rhs._count, dropped = 0;
+        subtree t = difference_aux(detach(), rhs.detach(), n, dropped);
+        adopt(t, n - dropped);
+    }
+
     /* tree height interface */
 
     // tree height (height of root),  i.e. the number of
@@ -475,10 +663,21 @@ public:
 
     bool is_balanced() const {
         if (empty()) return true;
+        if constexpr (OrderStatistics) {
+            if (checked_size(ROOT) != _count) return false;
+        }
         return is_balanced_aux(ROOT);
     }
 
 private:
+    // returns the actual size of x's subtree, or size_t(-1) if any is wrong
+    static size_t checked_size(node_ptr x) {
+        if (x == nullptr) return 0;
+        size_t l = checked_size(x->_left), r = checked_size(x->_right);
+        if (l == size_t(-1) || r == size_t(-1) || x->_size != l + r + 1) return size_t(-1);
+        return x->_size;
+    }
+
     static bool is_balanced_aux(node_ptr x) {
         if (x == nullptr) return true;
         int bf_x = bf(x);
@@ -493,9 +692,9 @@ private:
     static void check_bf_aux(node_ptr x, std::false_type) {
         if (x == nullptr) return;
         int bf_x = bf(x);
-        if (bf_x != x->_bf)
+        if (bf_x != balance_factor(x))
             std::cout << "\033[0;31mwrong BF at " << x->_val << " : bf = "
-                      << x->_bf << ", but should be " << bf_x << "\033[0;m\n";
+                      << balance_factor(x) << ", but should be " << bf_x << "\033[0;m\n";
         check_bf_aux(x->_left,  std::bool_constant<false>{});
         check_bf_aux(x->_right, std::bool_constant<false>{});
     }
@@ -503,9 +702,9 @@ private:
     static void check_bf_aux(node_ptr x, std::true_type) {
         if (x == nullptr) return;
         int bf_x = bf(x);
-        if (bf_x != x->_bf)
+        if (bf_x != balance_factor(x))
             std::cout << "\033[0;31mwrong BF at {" << (x->_val).first << ", " << (x->_val).second
-                      << "} : bf = " << x->_bf << ", but should be " << bf_x << "\033[0;m\n";
+                      << "} : bf = " << balance_factor(x) << ", but should be " << bf_x << "\033[0;m\n";
         check_bf_aux(x->_left,  std::bool_constant<true>{});
         check_bf_aux(x->_right, std::bool_constant<true>{});
     }
@@ -567,6 +766,7 @@ private:
             _alloc.deallocate(p, 1);
             throw;
         }
+        if constexpr (Augmented) update_node(p);
         return p;
     }
 
@@ -578,7 +778,9 @@ private:
     node_ptr copy_nodes(node_ptr x, node_ptr parent) {
         if (x != nullptr) {
             node_ptr t = new_node(parent, x->_val);
-            t->_bf = x->_bf;
+            balance_factor(t) = balance_factor(x);
+            if constexpr (OrderStatistics) t->_size = x->_size;
+            if constexpr (Augmented) t->_meta = x->_meta;
             t->_left  = copy_nodes(x->_left,  t);
             t->_right = copy_nodes(x->_right, t);
             return t;
@@ -633,6 +835,38 @@ private:
         return _header; // end(), not found
     }
 
+    // find(ROOT, key) one level at a time, for find_batch()
+    struct find_probe {
+        const AVLtree* _tree;
+
+        struct state_type {
+            node_ptr x;
+            const key_type* key;
+        };
+        using result_type = const_iterator;
+
+        bool start(const key_type& key, state_type& s) const {
+            s = { _tree->ROOT, &key };
+            if (s.x == _tree->_header) return false; // empty
+            batch_prefetch(s.x);
+            return true;
+        }
+
+        bool step(state_type& s) const {
+            if      (_tree->_comp(*s.key, get_key(s.x))) s.x = s.x->_left;
+            else if (_tree->_comp(get_key(s.x), *s.key)) s.x = s.x->_right;
+            else return false;
+            if (s.x == nullptr) {
+                s.x = _tree->_header; // end(), not found
+                return false;
+            }
+            batch_prefetch(s.x);
+            return true;
+        }
+
+        result_type result(const state_type& s) const { return const_iterator(s.x); }
+    };
+
     std::pair<node_ptr, node_ptr> equal_range_aux(const key_type& key) const {
         if constexpr (!IsMulti) {
             const_iterator first = lower_bound(key), second = first;
@@ -670,6 +904,118 @@ private:
         return parent; // _header if not found
     }
 
+    template<bool Upper>
+    size_t rank_aux(const key_type& key) const {
+        if (empty()) return 0;
+        size_t r = 0;
+        for (node_ptr x = ROOT; x != nullptr; ) {
+            if (Upper ? !_comp(key, get_key(x)) : _comp(get_key(x), key)) {
+                r += subtree_size(x->_left) + 1;
+                x = x->_right;
+            }
+            else x = x->_left;
+        }
+        return r;
+    }
+
+    node_ptr select_aux(size_t k) const {
+        if (k >= _count) return _header;
+        node_ptr x = ROOT;
+        for (;;) {
+            size_t left = subtree_size(x->_left);
+            if (k < left) x = x->_left;
+            else if (k == left) return x;
+            else {
+                k -= left + 1;
+                x = x->_right;
+            }
+        }
+    }
+
+    static size_t subtree_size(node_ptr x) noexcept {
+        return x ? x->_size : 0;
+    }
+
+    // recompute x's subtree size (summary) from its children
+    static void update_node(node_ptr x) noexcept {
+        if constexpr (OrderStatistics)
+            x->_size = 1 + subtree_size(x->_left) + subtree_size(x->_right);
+        if constexpr (Augmented) {
+            x->_meta = Policy::from_value(x->_val);
+            if (x->_left ) x->_meta = Policy::combine(x->_left->_meta, x->_meta);
+            if (x->_right) x->_meta = Policy::combine(x->_meta, x->_right->_meta);
+        }
+    }
+
+    // add `delta` (+1/-1) to the sizes of x and all its ancestors
+    void adjust_sizes_upwards(node_ptr x, int delta) noexcept {
+        if constexpr (OrderStatistics) {
+            for (; x != _header; x = x->_parent)
+                x->_size += delta;
+        }
+    }
+
+    // recompute the summaries of x and all its ancestors
+    void update_path(node_ptr x) noexcept {
+        if constexpr (Augmented) {
+            for (; x != _header; x = x->_parent)
+                update_node(x);
+        }
+    }
+
+    static metadata_type subtree_fold(node_ptr x) {
+        return x ? x->_meta : Policy::identity();
+    }
+
+    // Find the topmost node within [lo, hi), then the range is the part of
+    // its left subtree not less than lo, itself and the part of its right
+    // subtree less than hi. Going down towards lo, every node within the
+    // range comes with its whole right subtree, and symmetrically for hi.
+    metadata_type fold_aux(const key_type& lo, const key_type& hi) const {
+        node_ptr x = empty() ? nullptr : ROOT;
+        while (x != nullptr) {
+            if      (_comp(get_key(x), lo)) x = x->_right;
+            else if (!_comp(get_key(x), hi)) x = x->_left;
+            else break;
+        }
+        if (x == nullptr) return Policy::identity();
+        metadata_type left = Policy::identity(), right = Policy::identity();
+        for (node_ptr y = x->_left; y != nullptr; ) {
+            if (_comp(get_key(y), lo)) y = y->_right;
+            else {
+                left = Policy::combine(Policy::combine(Policy::from_value(y->_val), subtree_fold(y->_right)), left);
+                y = y->_left;
+            }
+        }
+        for (node_ptr y = x->_right; y != nullptr; ) {
+            if (!_comp(get_key(y), hi)) y = y->_left;
+            else {
+                right = Policy::combine(right, Policy::combine(subtree_fold(y->_left), Policy::from_value(y->_val)));
+                y = y->_right;
+            }
+        }
+        return Policy::combine(Policy::combine(left, Policy::from_value(x->_val)), right);
+    }
+
+protected:
+    // Walking an augmented tree, for the containers built on one (e.g.
+    // IntervalMap): a null const_iterator stands for an empty subtree.
+    const_iterator root_node() const noexcept {
+        return const_iterator(empty() ? nullptr : ROOT);
+    }
+
+    static const_iterator left_child(const_iterator pos) noexcept {
+        return const_iterator(pos.ptr()->_left);
+    }
+
+    static const_iterator right_child(const_iterator pos) noexcept {
+        return const_iterator(pos.ptr()->_right);
+    }
+
+    static const metadata_type& subtree_metadata(const_iterator pos) noexcept {
+        return pos.ptr()->_meta;
+    }
+
 protected:
     // I don't want to include the whole <tuple>,
     // plus using a struct is more convenient :)
@@ -683,8 +1029,9 @@ protected:
     // is smaller than this lower bound (suggests the key doesn't exist) then we
     // can use this cool lower bound's 2nd return value and insert exactly there.
     lower_bound_result cool_lower_bound(const key_type& key) {
-        node** x = &ROOT;
-        if (*x == _header) return { end(), x, _header }; // empty container
+        if (empty()) return { end(), nullptr, _header };
+        node_ptr root = ROOT;
+        node** x = &root; // never written through, we go down at least once
         node_ptr parent = _header, x_parent = _header;
         while (*x != nullptr) {
             x_parent = *x;
@@ -697,12 +1044,19 @@ protected:
         return { iterator(parent), x, x_parent }; // end() if not found
     }
 
+    // x: the null link to fill in, unused if the tree is empty
     template<typename... Args>
     node_ptr insert_leaf_at(node** x, node_ptr parent, Args&&... args) {
+        if (empty()) {
+            node_ptr z = new_node(_header, std::forward<Args>(args)...);
+            _count = 1;
+            adjust_sizes_upwards(parent, +1);
+            return ROOT = _header->_left = _header->_right = z;
+        }
         *x = new_node(parent, std::forward<Args>(args)...);
         ++_count;
-        if (_count == 1)
-            return _header->_parent = _header->_left = _header->_right = *x;
+        adjust_sizes_upwards(parent, +1);
+        update_path(parent);
 
         if      (*x == _header->_left->_left  ) _header->_left  = *x;
         else if (*x == _header->_right->_right) _header->_right = *x;
@@ -712,11 +1066,10 @@ protected:
     }
 
 private:
-    // precondition: *x != nullptr
     // Here args can be of type value_type or of a few types (to be forwarded)
     template<typename... Args>
-    std::pair<node_ptr, bool> insert_aux(node** x, bool assign, Args&&... args) {
-        if (empty()) return { insert_leaf_at(&ROOT, _header, std::forward<Args>(args)...), true };
+    std::pair<node_ptr, bool> insert_aux(bool assign, Args&&... args) {
+        if (empty()) return { insert_leaf_at(nullptr, _header, std::forward<Args>(args)...), true };
         // This is acctually a fake emplace routine as we will have an extra move operation.
         // But it does make life much easier because it can serve as the base implementation
         // of  insert( [const_iterator hint,] value_type&& value ),
@@ -724,7 +1077,9 @@ private:
         //     [try_]emplace[_hint]( [const_iterator hint,] Args&&... args ).  :)
         value_type val(std::forward<Args>(args)...);
         const key_type& key = get_key(val);
-        node_ptr parent = (*x)->_parent;
+        node_ptr root = ROOT;
+        node** x = &root; // never written through, we go down at least once
+        node_ptr parent = _header;
         while (*x != nullptr) {
             parent = *x;
             if      (_comp(key, get_key(*x))) x = &(*x)->_left;
@@ -740,7 +1095,10 @@ private:
                 }
                 else {
                     if constexpr (IsMap) {
-                        if (assign)  (*x)->_val.second = val.second;
+                        if (assign) {
+                            (*x)->_val.second = val.second;
+                            update_path(*x);
+                        }
                     }
                     return { *x, false };
                 }
@@ -765,12 +1123,14 @@ private:
         replace(a, b);
         b->_left = a;
         a->_parent = b;
-        if (b->_bf == 1) { // insertion at Z or deletion at X
-            a->_bf = b->_bf = 0;
+        update_node(a);
+        update_node(b);
+        if (balance_factor(b) == 1) { // insertion at Z or deletion at X
+            balance_factor(a) = balance_factor(b) = 0;
         }
         else { // b->_bf == 0, only happens with deletion at X
-            a->_bf = 1;
-            b->_bf = -1;
+            balance_factor(a) = 1;
+            balance_factor(b) = -1;
         }
         return b;
     }
@@ -783,12 +1143,14 @@ private:
         replace(a, b);
         b->_right = a;
         a->_parent = b;
-        if (b->_bf == -1) { // insertion or deletion
-            a->_bf = b->_bf = 0;
+        update_node(a);
+        update_node(b);
+        if (balance_factor(b) == -1) { // insertion or deletion
+            balance_factor(a) = balance_factor(b) = 0;
         }
         else { // b->_bf == 0, only happens with deletion
-            a->_bf = -1;
-            b->_bf = 1;
+            balance_factor(a) = -1;
+            balance_factor(b) = 1;
         }
         return b;
     }
@@ -809,23 +1171,23 @@ private:
     */
     node_ptr rotate_right_left(node_ptr a) noexcept { // RL shape
         node_ptr b = a->_right, c = b->_left;
-        int bf_c = c->_bf;
+        int bf_c = balance_factor(c);
         // The setups of balance factors are inaccurate and unnecessary since
         // we're rotating b while BF(b) isn't +/-2, but the cost is trivial.
         rotate_right(b);
         rotate_left(a);
-        c->_bf = 0;
+        balance_factor(c) = 0;
         if (bf_c == 0) { // only happens with deletion at X
-            a->_bf = b->_bf = 0;
+            balance_factor(a) = balance_factor(b) = 0;
         }
         else {
             if (bf_c == 1) { // insertion at Z or deletion at X
-                a->_bf = -1;
-                b->_bf = 0;
+                balance_factor(a) = -1;
+                balance_factor(b) = 0;
             }
             else { // bf_c == -1, insertion at Y or deletion at X
-                a->_bf = 0;
-                b->_bf = 1;
+                balance_factor(a) = 0;
+                balance_factor(b) = 1;
             }
         }
         return c;
@@ -834,21 +1196,21 @@ private:
     // mirror image of `rotate_right_left`
     node_ptr rotate_left_right(node_ptr a) noexcept { // LR shape
         node_ptr b = a->_left, c = b->_right;
-        int bf_c = c->_bf;
+        int bf_c = balance_factor(c);
         rotate_left(b);
         rotate_right(a);
-        c->_bf = 0;
+        balance_factor(c) = 0;
         if (bf_c == 0) { // only happens with deletion
-            a->_bf = b->_bf = 0;
+            balance_factor(a) = balance_factor(b) = 0;
         }
         else { // insertion or deletion
             if (bf_c == 1) {
-                a->_bf = 0;
-                b->_bf = -1;
+                balance_factor(a) = 0;
+                balance_factor(b) = -1;
             }
             else { // bf_c == -1
-                a->_bf = 1;
-                b->_bf = 0;
+                balance_factor(a) = 1;
+                balance_factor(b) = 0;
             }
         }
         return c;
@@ -858,26 +1220,26 @@ private:
     void rebalance_after_inserting(node_ptr x) noexcept {
         for (node_ptr parent = x->_parent; parent != _header;) {
             if (x == parent->_left)
-                --parent->_bf;
+                --balance_factor(parent);
             else if (x == parent->_right)
-                ++parent->_bf;
+                ++balance_factor(parent);
 
-            if (parent->_bf == 0) return; // H(parent) doesn't change
+            if (balance_factor(parent) == 0) return; // H(parent) doesn't change
 
-            if (parent->_bf == 1 || parent->_bf == -1) { // keep retracing & updating ancestors' BFs
+            if (balance_factor(parent) == 1 || balance_factor(parent) == -1) { // keep retracing & updating ancestors' BFs
                 x = parent;
                 parent = x->_parent;
                 continue;
             }
             else { // parent->_bf == +/-2, do some rotations
-                if (parent->_bf == 2) { // right-heavy
-                    if (x->_bf == 1) // RR shape
+                if (balance_factor(parent) == 2) { // right-heavy
+                    if (balance_factor(x) == 1) // RR shape
                         rotate_left(parent);
                     else // x->_bf == -1, RL shape
                         rotate_right_left(parent);
                 }
                 else { // parent->_bf == -2, left-heavy
-                    if (x->_bf == -1) // LL shape
+                    if (balance_factor(x) == -1) // LL shape
                         rotate_right(parent);
                     else // x->_bf == 1, LR shape
                         rotate_left_right(parent);
@@ -902,15 +1264,18 @@ private:
         if (!z->_left) { // z has at most one non-null child
             x = z->_right; // might be null
             x_parent = z->_parent;
+            adjust_sizes_upwards(x_parent, -1);
             replace(z, x);
         }
         else if (!z->_right) { // z has exactly one non-null child
             x = z->_left; // not null
             x_parent = z->_parent;
+            adjust_sizes_upwards(x_parent, -1);
             replace(z, x);
         }
         else { // has both children
             node_ptr y = tree_min(z->_right); // node to be actually deleted
+            adjust_sizes_upwards(y->_parent, -1); // including z
             x = y->_right; // might be null, y's left is null
             if (y == z->_right) {
                 x_parent = y;
@@ -924,13 +1289,15 @@ private:
             replace(z, y);
             y->_left = z->_left;
             z->_left->_parent = y;
-            y->_bf = z->_bf;
+            balance_factor(y) = balance_factor(z);
+            if constexpr (OrderStatistics) y->_size = z->_size;
         }
+        update_path(x_parent); // before any rotation
 
         if (!x_parent->_left && !x_parent->_right) { // both x and its sibling are null
             // in this case we can't tell if x is x_parent's left or right child
             // but we can set x_parent->_bf to 0 and start retracing from it
-            x_parent->_bf = 0;
+            balance_factor(x_parent) = 0;
             x = x_parent;
             x_parent = x->_parent;
         }
@@ -938,33 +1305,33 @@ private:
         // rebalance
         while (x_parent != _header) {
             if (x == x_parent->_left)
-                ++x_parent->_bf;
+                ++balance_factor(x_parent);
             else if (x == x_parent->_right)
-                --x_parent->_bf;
+                --balance_factor(x_parent);
 
-            if (x_parent->_bf == 1 || x_parent->_bf == -1) break; // deletion doesn't change H(x_parent)
+            if (balance_factor(x_parent) == 1 || balance_factor(x_parent) == -1) break; // deletion doesn't change H(x_parent)
 
-            if (x_parent->_bf == 0) { // keep retracing & updating ancestors' BFs
+            if (balance_factor(x_parent) == 0) { // keep retracing & updating ancestors' BFs
                 x = x_parent;
                 x_parent = x->_parent;
                 continue;
             }
             else { // x_parent->_bf == +/-2, do some rotations
                 node_ptr sibling = x == x_parent->_left ? x_parent->_right : x_parent->_left;
-                if (x_parent->_bf == 2) { // right-heavy
-                    if (sibling->_bf >= 0) // 0 or 1, RR shape
+                if (balance_factor(x_parent) == 2) { // right-heavy
+                    if (balance_factor(sibling) >= 0) // 0 or 1, RR shape
                         x = rotate_left(x_parent);
                     else // sibling->_bf == -1, RL shape
                         x = rotate_right_left(x_parent);
                 }
                 else { // x_parent->_bf == -2, left-heavy
-                    if (sibling->_bf <= 0) // -1 or 0, LL shape
+                    if (balance_factor(sibling) <= 0) // -1 or 0, LL shape
                         x = rotate_right(x_parent);
                     else // sibling->_bf == 1, LR shape
                         x = rotate_left_right(x_parent);
                 }
 
-                if (x->_bf == 0) x_parent = x->_parent; // keep retracing
+                if (balance_factor(x) == 0) x_parent = x->_parent; // keep retracing
                 else /* x->_bf == +/- 1 */ break;
             }
         }
@@ -975,6 +1342,280 @@ private:
         return next;
     }
 
+    /*
+     * Join-based algorithms, see Blelloch, Ferizovic & Sun, "Just Join for
+     * Parallel Ordered Sets" (SPAA 2016). They work on detached subtrees
+     * (whose root's parent link is meaningless) and everything is built on
+     *     join(L, k, R): a tree of L, node k, R, given L < k < R,
+     * which costs O(|h(L) - h(R)| + 1).
+     */
+
+    // a detached subtree with its height (null: 0)
+    struct subtree {
+        node_ptr root;
+        int h;
+    };
+
+    struct split_result {
+        subtree left, right;
+    };
+
+    // subtrees smaller than this are processed sequentially
+    static constexpr size_t ParallelCutoff = 1 << 14;
+
+    static int tree_height(node_ptr x) noexcept {
+        int h = 0;
+        for (; x != nullptr; x = balance_factor(x) < 0 ? x->_left : x->_right)
+            ++h;
+        return h;
+    }
+
+    // the children of t along with their heights, derived from t's height
+    // and balance factor (which may temporarily be +/-2 during a join)
+    static subtree left_child(subtree t) noexcept {
+        return { t.root->_left, t.h - 1 - max(int(balance_factor(t.root)), 0) };
+    }
+
+    static subtree right_child(subtree t) noexcept {
+        return { t.root->_right, t.h - 1 - max(-balance_factor(t.root), 0) };
+    }
+
+    subtree detach() noexcept {
+        if (empty()) return { nullptr, 0 };
+        subtree t{ ROOT, tree_height(ROOT) };
+        _count = 0;
+        set_default_header();
+        return t;
+    }
+
+    // precondition: *this is empty (detached)
+    void adopt(subtree t, size_t count) noexcept {
+        if (t.root == nullptr) return;
+        ROOT = t.root;
+        t.root->_parent = _header;
+        _header->_left  = tree_min(t.root);
+        _header->_right = tree_max(t.root);
+        _count = count;
+    }
+
+    static size_t count_nodes(node_ptr x) noexcept {
+        if constexpr (OrderStatistics) return subtree_size(x);
+        else return x ? 1 + count_nodes(x->_left) + count_nodes(x->_right) : 0;
+    }
+
+    // make l and r the children of x
+    static subtree attach(node_ptr x, subtree l, subtree r) noexcept {
+        x->_left = l.root;
+        x->_right = r.root;
+        balance_factor(x) = r.h - l.h;
+        if (l.root) l.root->_parent = x;
+        if (r.root) r.root->_parent = x;
+        update_node(x);
+        return { x, max(l.h, r.h) + 1 };
+    }
+
+    static subtree rotate_left_detached(subtree a) noexcept {
+        subtree b = right_child(a);
+        subtree t = attach(a.root, left_child(a), left_child(b));
+        return attach(b.root, t, right_child(b));
+    }
+
+    static subtree rotate_right_detached(subtree a) noexcept {
+        subtree b = left_child(a);
+        subtree t = attach(a.root, right_child(b), right_child(a));
+        return attach(b.root, left_child(b), t);
+    }
+
+    // precondition: h(t) > h(r) + 1
+    // Descend the right spine of t to the first node that is at most one
+    // taller than r and put k there, then rebalance on the way back up
+    // (at most one single/double rotation is needed in total).
+    static subtree join_right(subtree t, node_ptr k, subtree r) noexcept {
+        subtree l = left_child(t), c = right_child(t);
+        if (c.h <= r.h + 1) {
+            subtree t1 = attach(k, c, r);
+            if (t1.h <= l.h + 1)
+                return attach(t.root, l, t1);
+            return rotate_left_detached(attach(t.root, l, rotate_right_detached(t1)));
+        }
+        subtree t1 = join_right(c, k, r);
+        subtree t2 = attach(t.root, l, t1);
+        if (t1.h <= l.h + 1) return t2;
+        return rotate_left_detached(t2);
+    }
+
+    // mirror image of `join_right`
+    static subtree join_left(subtree l, node_ptr k, subtree t) noexcept {
+        subtree c = left_child(t), r = right_child(t);
+        if (c.h <= l.h + 1) {
+            subtree t1 = attach(k, l, c);
+            if (t1.h <= r.h + 1)
+                return attach(t.root, t1, r);
+            return rotate_right_detached(attach(t.root, rotate_left_detached(t1), r));
+        }
+        subtree t1 = join_left(l, k, c);
+        subtree t2 = attach(t.root, t1, r);
+        if (t1.h <= r.h + 1) return t2;
+        return rotate_right_detached(t2);
+    }
+
+    static subtree join_aux(subtree l, node_ptr k, subtree r) noexcept {
+        if (l.h > r.h + 1) return join_right(l, k, r);
+        if (r.h > l.h + 1) return join_left(l, k, r);
+        return attach(k, l, r);
+    }
+
+    // detach the largest node of t
+    static subtree split_last(subtree t, node_ptr& last) noexcept {
+        if (t.root->_right == nullptr) {
+            last = t.root;
+            return left_child(t);
+        }
+        subtree r = split_last(right_child(t), last);
+        return join_aux(left_child(t), t.root, r);
+    }
+
+    // join without a middle node
+    static subtree join2(subtree l, subtree r) noexcept {
+        if (l.root == nullptr) return r;
+        if (r.root == nullptr) return l;
+        node_ptr k;
+        l = split_last(l, k);
+        return join_aux(l, k, r);
+    }
+
+    // elements less than key go left, greater ones go right, and an
+    // equivalent one goes to `found` (for multi containers, equivalent
+    // ones go right, `found` remains null)
+    split_result split_aux(subtree t, const key_type& key, node_ptr& found) const noexcept {
+        node_ptr x = t.root;
+        if (x == nullptr) return { { nullptr, 0 }, { nullptr, 0 } };
+        subtree l = left_child(t), r = right_child(t);
+        if (_comp(key, get_key(x)) || (IsMulti && !_comp(get_key(x), key))) {
+            split_result s = split_aux(l, key, found);
+            return { s.left, join_aux(s.right, x, r) };
+        }
+        if (_comp(get_key(x), key)) {
+            split_result s = split_aux(r, key, found);
+            return { join_aux(l, x, s.left), s.right };
+        }
+        found = x;
+        return { l, r };
+    }
+
+    // shape the first n nodes of the list (chained through _right)
+    // into a perfectly balanced tree
+    static subtree build_sorted(node_ptr& list, size_t n) noexcept {
+        if (n == 0) return { nullptr, 0 };
+        size_t nl = (n - 1) / 2;
+        subtree l = build_sorted(list, nl);
+        node_ptr x = list;
+        list = list->_right;
+        subtree r = build_sorted(list, n - 1 - nl);
+        return attach(x, l, r);
+    }
+
+    // like get_key() but for whatever the input iterators point to,
+    // e.g. std::pair<Key, T> rather than std::pair<const Key, T>
+    template< typename V >
+    static const auto& key_of(const V& val) noexcept {
+        if constexpr (IsMap) return val.first;
+        else return val;
+    }
+
+    template< typename InputIt >
+    bool is_sorted_range(InputIt first, InputIt last) const {
+        if (first == last) return true;
+        for (InputIt next = std::next(first); next != last; first = next++) {
+            if (_comp(key_of(*next), key_of(*first))) return false;
+        }
+        return true;
+    }
+
+    // destroy the whole subtree, returns # of nodes destroyed
+    size_t destroy(node_ptr x) noexcept {
+        if (x == nullptr) return 0;
+        size_t n = 1 + destroy(x->_left) + destroy(x->_right);
+        delete_node(x);
+        return n;
+    }
+
+    // run f and g, in parallel if there's enough work
+    template<typename F, typename G>
+    static void fork_join(size_t work, F&& f, G&& g) {
+        if (work >= ParallelCutoff)
+            ForkJoinPool::instance().fork_join(f, g);
+        else {
+            f(); g();
+        }
+    }
+
+    // `work` estimates the total size, `dropped` counts the destroyed nodes
+    subtree union_aux(subtree a, subtree b, size_t work, size_t& dropped) noexcept {
+        if (a.root == nullptr) return b;
+        if (b.root == nullptr) return a;
+        node_ptr k = a.root;
+        node_ptr found = nullptr;
+        split_result s = split_aux(b, get_key(k), found);
+        if (found) {
+            delete_node(found);
+            ++dropped;
+        }
+        subtree l, r;
+        size_t dl = 0, dr = 0;
+        fork_join(work,
+            [&] { l = union_aux(left_child(a),  s.left,  work / 2, dl); },
+            [&] { r = union_aux(right_child(a), s.right, work / 2, dr); });
+        dropped += dl + dr;
+        return join_aux(l, k, r);
+    }
+
+    subtree intersection_aux(subtree a, subtree b, size_t work, size_t& dropped) noexcept {
+        if (a.root == nullptr || b.root == nullptr) {
+            dropped += destroy(a.root) + destroy(b.root);
+            return { nullptr, 0 };
+        }
+        node_ptr k = a.root;
+        node_ptr found = nullptr;
+        split_result s = split_aux(b, get_key(k), found);
+        subtree l, r;
+        size_t dl = 0, dr = 0;
+        fork_join(work,
+            [&] { l = intersection_aux(left_child(a),  s.left,  work / 2, dl); },
+            [&] { r = intersection_aux(right_child(a), s.right, work / 2, dr); });
+        dropped += dl + dr + 1;
+        if (found) {
+            delete_node(found);
+            return join_aux(l, k, r);
+        }
+        delete_node(k);
+        return join2(l, r);
+    }
+
+    subtree difference_aux(subtree a, subtree b, size_t work, size_t& dropped) noexcept {
+        if (a.root == nullptr) {
+            dropped += destroy(b.root);
+            return { nullptr, 0 };
+        }
+        if (b.root == nullptr) return a;
+        node_ptr k = a.root;
+        node_ptr found = nullptr;
+        split_result s = split_aux(b, get_key(k), found);
+        subtree l, r;
+        size_t dl = 0, dr = 0;
+        fork_join(work,
+            [&] { l = difference_aux(left_child(a),  s.left,  work / 2, dl); },
+            [&] { r = difference_aux(right_child(a), s.right, work / 2, dr); });
+        dropped += dl + dr;
+        if (found) {
+            delete_node(found);
+            delete_node(k);
+            dropped += 2;
+            return join2(l, r);
+        }
+        return join_aux(l, k, r);
+    }
+
     // replace node x with node y
     void replace(node_ptr x, node_ptr y) noexcept {
         if (x == ROOT) ROOT = y;
@@ -1069,7 +1710,7 @@ private:
 #undef END
 #undef ROOT
 
-    struct AVLtree_node {
+    struct AVLtree_node : node_metadata<NodeUpdate> {
         node_ptr _parent, _left = nullptr, _right = nullptr;
         int _bf = 0; // though acctually we will only need 3 bits, [-2, 2]
         T _val;
@@ -1087,6 +1728,52 @@ private:
         }
     };
 
+    // compact_node_layout: the balance factor is kept in the parent link
+    struct AVLtree_compact_node : node_metadata<NodeUpdate> {
+        tagged_parent<AVLtree_compact_node, 3> _parent;
+        node_ptr _left = nullptr, _right = nullptr;
+        T _val;
+
+        template<typename... Args>
+        AVLtree_compact_node(node_ptr parent, Args&&... args)
+            : _parent(parent, /*bf=0*/2), _val(std::forward<Args>(args)...) {}
+
+        value_type* val_ptr() {
+            return std::addressof(_val);
+        }
+        const value_type* val_ptr() const {
+            return std::addressof(_val);
+        }
+    };
+
+    // reference to the balance factor of x, in the compact layout
+    // it's the tag bits of x's parent link (bf + 2)
+    class balance_ref {
+        tagged_parent<node, 3>* _link;
+    public:
+        explicit balance_ref(tagged_parent<node, 3>* link) noexcept : _link(link) {}
+
+        operator int() const noexcept { return static_cast<int>(_link->tag()) - 2; }
+
+        balance_ref& operator=(int bf) noexcept {
+            _link->set_tag(static_cast<unsigned>(bf + 2));
+            return *this;
+        }
+
+        balance_ref& operator=(const balance_ref& rhs) noexcept { return *this = static_cast<int>(rhs); }
+
+        balance_ref& operator++() noexcept { return *this = *this + 1; }
+        balance_ref& operator--() noexcept { return *this = *this - 1; }
+    };
+
+    static decltype(auto) balance_factor(node_ptr x) noexcept {
+        if constexpr (Compact) {
+            static_assert(alignof(node) >= 8, "3 low bits of a node pointer are needed for the balance factor");
+            return balance_ref(&x->_parent);
+        }
+        else return (x->_bf);
+    }
+
     static bool is_header(node_ptr x) noexcept {
         if (x->_left == x) return true; // container's empty
         if (x->_left == nullptr || x->_right == nullptr) return false;
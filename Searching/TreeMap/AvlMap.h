@@ -9,6 +9,7 @@
 #define AVLMAP_H 1
 
 #include "AVLtree_impl.h"
+#include "StaticOrderedMap.h"
 #include <memory>     // std::allocator
 #include <functional> // std::less
 #include <stdexcept>  // std::out_of_range
@@ -16,9 +17,10 @@
 
 namespace mySymbolTable {
 
-template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>>
-class AvlMap : public AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false> {
-    using _base = AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false>;
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>,
+         typename NodeUpdate = null_node_update>
+class AvlMap : public AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false, NodeUpdate> {
+    using _base = AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false, NodeUpdate>;
 public:
     using key_type = Key;
     using mapped_type = T;
@@ -86,6 +88,18 @@ public:
     AvlMap(std::initializer_list<value_type> init, const Alloc& alloc)
         : AvlMap(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static AvlMap from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        AvlMap mp(comp, alloc);
+        mp.assign_sorted(first, last);
+        return mp;
+    }
+
     /* IV */
 
     AvlMap(const AvlMap& other) = default;
@@ -205,6 +219,13 @@ public:
         _base::swap(rhs);
     }
 
+    /* read-only phases */
+
+    // a contiguous copy with faster lookups, see StaticOrderedMap.h
+    StaticOrderedMap<Key, T, Compare> freeze() const {
+        return StaticOrderedMap<Key, T, Compare>(this->begin(), this->end(), key_comp());
+    }
+
     /* observers */
 
     key_compare key_comp() const {
@@ -217,17 +238,18 @@ public:
 
 }; // class AvlMap
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-void swap(AvlMap<Key, T, Compare, Alloc>& lhs,
-          AvlMap<Key, T, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename T, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(AvlMap<Key, T, Compare, Alloc, NodeUpdate>& lhs,
+          AvlMap<Key, T, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
 
-template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>>
-class AvlMultimap : public AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true> {
-    using _base = AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true>;
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>,
+         typename NodeUpdate = null_node_update>
+class AvlMultimap : public AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true, NodeUpdate> {
+    using _base = AVLtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true, NodeUpdate>;
 public:
     using key_type = Key;
     using mapped_type = T;
@@ -295,6 +317,18 @@ public:
     AvlMultimap(std::initializer_list<value_type> init, const Alloc& alloc)
         : AvlMultimap(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static AvlMultimap from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        AvlMultimap st(comp, alloc);
+        st.assign_sorted(first, last);
+        return st;
+    }
+
     /* IV */
 
     AvlMultimap(const AvlMultimap& other) = default;
@@ -325,9 +359,9 @@ public:
 
 }; // class AvlMultimap
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-void swap(AvlMultimap<Key, T, Compare, Alloc>& lhs,
-          AvlMultimap<Key, T, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename T, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(AvlMultimap<Key, T, Compare, Alloc, NodeUpdate>& lhs,
+          AvlMultimap<Key, T, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
@@ -15,9 +15,10 @@
 
 namespace mySymbolTable {
 
-template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>>
-class AvlSet : public AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false> {
-    using _base = AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false>;
+template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>,
+         typename NodeUpdate = null_node_update>
+class AvlSet : public AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false, NodeUpdate> {
+    using _base = AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false, NodeUpdate>;
 public:
     using key_type = Key;
     using value_type = Key;
@@ -74,6 +75,18 @@ public:
     AvlSet(std::initializer_list<value_type> init, const Alloc& alloc)
         : AvlSet(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static AvlSet from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        AvlSet st(comp, alloc);
+        st.assign_sorted(first, last);
+        return st;
+    }
+
     /* IV */
 
     AvlSet(const AvlSet& other) = default;
@@ -101,17 +114,18 @@ public:
 
 }; // class AvlSet
 
-template <typename Key, typename Compare, typename Alloc>
-void swap(AvlSet<Key, Compare, Alloc>& lhs,
-          AvlSet<Key, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(AvlSet<Key, Compare, Alloc, NodeUpdate>& lhs,
+          AvlSet<Key, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
 
-template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>>
-class AvlMultiset : public AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true> {
-    using _base = AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true>;
+template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>,
+         typename NodeUpdate = null_node_update>
+class AvlMultiset : public AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true, NodeUpdate> {
+    using _base = AVLtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true, NodeUpdate>;
 public:
     using key_type = Key;
     using value_type = Key;
@@ -168,6 +182,18 @@ public:
     AvlMultiset(std::initializer_list<value_type> init, const Alloc& alloc)
         : AvlMultiset(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static AvlMultiset from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        AvlMultiset st(comp, alloc);
+        st.assign_sorted(first, last);
+        return st;
+    }
+
     /* IV */
 
     AvlMultiset(const AvlMultiset& other) = default;
@@ -196,9 +222,9 @@ public:
 
 }; // class AvlMultiset
 
-template <typename Key, typename Compare, typename Alloc>
-void swap(AvlMultiset<Key, Compare, Alloc>& lhs,
-          AvlMultiset<Key, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(AvlMultiset<Key, Compare, Alloc, NodeUpdate>& lhs,
+          AvlMultiset<Key, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
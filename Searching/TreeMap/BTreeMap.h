@@ -0,0 +1,284 @@
+/*
+ *  ordered symbol tables:
+ *  B+ tree map and multimap
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/BTreeMap.h
+ */
+
+#ifndef BTREEMAP_H
+#define BTREEMAP_H 1
+
+#include "BTree_impl.h"
+#include <memory>     // std::allocator
+#include <functional> // std::less
+#include <stdexcept>  // std::out_of_range
+#include <initializer_list>
+
+namespace mySymbolTable {
+
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>,
+         size_t NodeBytes = BTreeDefaultNodeBytes>
+class BTreeMap : public BTree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false, NodeBytes> {
+    using _base = BTree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false, NodeBytes>;
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = typename _base::iterator;
+    using const_iterator = typename _base::const_iterator;
+    using reverse_iterator = typename _base::reverse_iterator;
+    using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+    class value_compare {
+        Compare _key_comp;
+    public:
+        value_compare() : _key_comp(Compare()) {}
+        value_compare(const Compare& comp) : _key_comp(comp) {}
+
+        bool operator()(const value_type& lhs, const value_type& rhs) const {
+            return _key_comp(lhs.first, rhs.first);
+        }
+    };
+
+    /* I */
+
+    // (1) a
+    BTreeMap() : _base() {}
+
+    // (1) b
+    explicit BTreeMap(const Compare& comp, const Alloc& alloc = Alloc())
+        : _base(comp, alloc) {}
+
+    // (1) c
+    explicit BTreeMap(const Alloc& alloc) : _base(alloc) {}
+
+    /* II */
+
+    // (2) a
+    template< class InputIt >
+    BTreeMap(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(first, last);
+    }
+
+    // (2) b
+    template< class InputIt >
+    BTreeMap(InputIt first, InputIt last, const Alloc& alloc)
+        : BTreeMap(first, last, Compare(), alloc) {}
+
+    /* III */
+
+    // (3) a
+    BTreeMap(std::initializer_list<value_type> init, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(init.begin(), init.end());
+    }
+
+    // (3) b
+    BTreeMap(std::initializer_list<value_type> init, const Alloc& alloc)
+        : BTreeMap(init, Compare(), alloc) {}
+
+    /* IV */
+
+    BTreeMap(const BTreeMap& other) : _base(other) {}
+
+    BTreeMap& operator=(const BTreeMap& other) {
+        _base::operator=(other);
+        return *this;
+    }
+
+    BTreeMap& operator=(std::initializer_list<value_type> ilist) {
+        BTreeMap tmp{ ilist };
+        this->swap(tmp);
+        return *this;
+    }
+
+    /* element access */
+
+    T& at(const Key& key) {
+        iterator it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("BTreeMap<K, T> key does not exist");
+        return it->second;
+    }
+
+    const T& at(const Key& key) const {
+        const_iterator it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("BTreeMap<K, T> key does not exist");
+        return it->second;
+    }
+
+    T& operator[](const Key& key) {
+        auto p = this->cool_lower_bound(key); // p.it->first >= key
+        iterator it = p.it;
+        if (it == this->end() || key_comp()(key, it->first))
+            it = _base::insert_at(p.leaf, p.pos, { key, T() });
+        return it->second;
+    }
+
+    /* modifiers */
+
+    using _base::insert;
+
+    std::pair<iterator, bool> insert(const Key& key, const T& val) {
+        return _base::insert({ key, val });
+    }
+
+    std::pair<iterator, bool> insert_or_assign(const value_type& val) {
+        return _base::insert_or_assign(val);
+    }
+
+    std::pair<iterator, bool> insert_or_assign(const Key& key, const T& val) {
+        return _base::insert_or_assign({ key, val });
+    }
+
+    void swap(BTreeMap& rhs) {
+        _base::swap(rhs);
+    }
+
+    /* observers */
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+
+}; // class BTreeMap
+
+template <typename Key, typename T, typename Compare, typename Alloc, size_t NodeBytes>
+void swap(BTreeMap<Key, T, Compare, Alloc, NodeBytes>& lhs,
+          BTreeMap<Key, T, Compare, Alloc, NodeBytes>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>,
+         size_t NodeBytes = BTreeDefaultNodeBytes>
+class BTreeMultimap : public BTree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true, NodeBytes> {
+    using _base = BTree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true, NodeBytes>;
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = typename _base::iterator;
+    using const_iterator = typename _base::const_iterator;
+    using reverse_iterator = typename _base::reverse_iterator;
+    using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+    class value_compare {
+        Compare _key_comp;
+    public:
+        value_compare() : _key_comp(Compare()) {}
+        value_compare(const Compare& comp) : _key_comp(comp) {}
+
+        bool operator()(const value_type& lhs, const value_type& rhs) const {
+            return _key_comp(lhs.first, rhs.first);
+        }
+    };
+
+    /* I */
+
+    // (1) a
+    BTreeMultimap() : _base() {}
+
+    // (1) b
+    explicit BTreeMultimap(const Compare& comp, const Alloc& alloc = Alloc())
+        : _base(comp, alloc) {}
+
+    // (1) c
+    explicit BTreeMultimap(const Alloc& alloc) : _base(alloc) {}
+
+    /* II */
+
+    // (2) a
+    template< class InputIt >
+    BTreeMultimap(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(first, last);
+    }
+
+    // (2) b
+    template< class InputIt >
+    BTreeMultimap(InputIt first, InputIt last, const Alloc& alloc)
+        : BTreeMultimap(first, last, Compare(), alloc) {}
+
+    /* III */
+
+    // (3) a
+    BTreeMultimap(std::initializer_list<value_type> init, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(init.begin(), init.end());
+    }
+
+    // (3) b
+    BTreeMultimap(std::initializer_list<value_type> init, const Alloc& alloc)
+        : BTreeMultimap(init, Compare(), alloc) {}
+
+    /* IV */
+
+    BTreeMultimap(const BTreeMultimap& other) : _base(other) {}
+
+    BTreeMultimap& operator=(const BTreeMultimap& other) {
+        _base::operator=(other);
+        return *this;
+    }
+
+    BTreeMultimap& operator=(std::initializer_list<value_type> ilist) {
+        BTreeMultimap tmp{ ilist };
+        this->swap(tmp);
+        return *this;
+    }
+
+    /* modifiers */
+
+    using _base::insert;
+
+    iterator insert(const Key& key, const T& val) {
+        return _base::insert({ key, val });
+    }
+
+    void swap(BTreeMultimap& rhs) {
+        _base::swap(rhs);
+    }
+
+    /* observers */
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+
+}; // class BTreeMultimap
+
+template <typename Key, typename T, typename Compare, typename Alloc, size_t NodeBytes>
+void swap(BTreeMultimap<Key, T, Compare, Alloc, NodeBytes>& lhs,
+          BTreeMultimap<Key, T, Compare, Alloc, NodeBytes>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+} // namespace mySymbolTable
+
+#endif // !BTREEMAP_H
\ No newline at end of file
@@ -0,0 +1,219 @@
+/*
+ *  ordered symbol tables:
+ *  B+ tree set and multiset
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/BTreeSet.h
+ */
+
+#ifndef BTREESET_H
+#define BTREESET_H 1
+
+#include "BTree_impl.h"
+#include <memory>     // std::allocator
+#include <functional> // std::less
+#include <initializer_list>
+
+namespace mySymbolTable {
+
+template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>,
+         size_t NodeBytes = BTreeDefaultNodeBytes>
+class BTreeSet : public BTree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false, NodeBytes> {
+    using _base = BTree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false, NodeBytes>;
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = typename _base::iterator;
+    using const_iterator = typename _base::const_iterator;
+    using reverse_iterator = typename _base::reverse_iterator;
+    using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+    /* I */
+
+    // (1) a
+    BTreeSet() : _base() {}
+
+    // (1) b
+    explicit BTreeSet(const Compare& comp, const Alloc& alloc = Alloc())
+        : _base(comp, alloc) {}
+
+    // (1) c
+    explicit BTreeSet(const Alloc& alloc) : _base(alloc) {}
+
+    /* II */
+
+    // (2) a
+    template< class InputIt >
+    BTreeSet(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(first, last);
+    }
+
+    // (2) b
+    template< class InputIt >
+    BTreeSet(InputIt first, InputIt last, const Alloc& alloc)
+        : BTreeSet(first, last, Compare(), alloc) {}
+
+    /* III */
+
+    // (3) a
+    BTreeSet(std::initializer_list<value_type> init, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(init.begin(), init.end());
+    }
+
+    // (3) b
+    BTreeSet(std::initializer_list<value_type> init, const Alloc& alloc)
+        : BTreeSet(init, Compare(), alloc) {}
+
+    /* IV */
+
+    BTreeSet(const BTreeSet& other) : _base(other) {}
+
+    BTreeSet& operator=(const BTreeSet& other) {
+        _base::operator=(other);
+        return *this;
+    }
+
+    BTreeSet& operator=(std::initializer_list<value_type> ilist) {
+        BTreeSet tmp{ ilist };
+        this->swap(tmp);
+        return *this;
+    }
+
+    /* modifiers */
+
+    void swap(BTreeSet& rhs) {
+        _base::swap(rhs);
+    }
+
+    /* observers */
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+
+}; // class BTreeSet
+
+template <typename Key, typename Compare, typename Alloc, size_t NodeBytes>
+void swap(BTreeSet<Key, Compare, Alloc, NodeBytes>& lhs,
+          BTreeSet<Key, Compare, Alloc, NodeBytes>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+
+template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>,
+         size_t NodeBytes = BTreeDefaultNodeBytes>
+class BTreeMultiset : public BTree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true, NodeBytes> {
+    using _base = BTree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true, NodeBytes>;
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = typename _base::iterator;
+    using const_iterator = typename _base::const_iterator;
+    using reverse_iterator = typename _base::reverse_iterator;
+    using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+    /* I */
+
+    // (1) a
+    BTreeMultiset() : _base() {}
+
+    // (1) b
+    explicit BTreeMultiset(const Compare& comp, const Alloc& alloc = Alloc())
+        : _base(comp, alloc) {}
+
+    // (1) c
+    explicit BTreeMultiset(const Alloc& alloc) : _base(alloc) {}
+
+    /* II */
+
+    // (2) a
+    template< class InputIt >
+    BTreeMultiset(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(first, last);
+    }
+
+    // (2) b
+    template< class InputIt >
+    BTreeMultiset(InputIt first, InputIt last, const Alloc& alloc)
+        : BTreeMultiset(first, last, Compare(), alloc) {}
+
+    /* III */
+
+    // (3) a
+    BTreeMultiset(std::initializer_list<value_type> init, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(init.begin(), init.end());
+    }
+
+    // (3) b
+    BTreeMultiset(std::initializer_list<value_type> init, const Alloc& alloc)
+        : BTreeMultiset(init, Compare(), alloc) {}
+
+    /* IV */
+
+    BTreeMultiset(const BTreeMultiset& other) : _base(other) {}
+
+    BTreeMultiset& operator=(const BTreeMultiset& other) {
+        _base::operator=(other);
+        return *this;
+    }
+
+    BTreeMultiset& operator=(std::initializer_list<value_type> ilist) {
+        BTreeMultiset tmp{ ilist };
+        this->swap(tmp);
+        return *this;
+    }
+
+    /* modifiers */
+
+    void swap(BTreeMultiset& rhs) {
+        _base::swap(rhs);
+    }
+
+    /* observers */
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+
+}; // class BTreeMultiset
+
+template <typename Key, typename Compare, typename Alloc, size_t NodeBytes>
+void swap(BTreeMultiset<Key, Compare, Alloc, NodeBytes>& lhs,
+          BTreeMultiset<Key, Compare, Alloc, NodeBytes>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+} // namespace mySymbolTable
+
+#endif // !BTREESET_H
\ No newline at end of file
@@ -0,0 +1,1121 @@
+/*
+ *  internal header file for implementing
+ *  ordered symbol tables:
+ *  B+ tree (multi) map/set
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/BTree_impl.h
+ */
+
+#ifndef BTREE_IMPL_H
+#define BTREE_IMPL_H 1
+
+#include <type_traits> // std::conditional_t, std::is_arithmetic
+#include <memory>   // std::addressof, std::allocator_traits
+#include <utility>  // std::swap, std::pair, std::move
+#include <iterator> // std::reverse_iterator, std::distance
+#include <functional> // std::less, std::greater
+#include <initializer_list>
+#include <new>
+#ifndef NDEBUG
+#include <iostream> // std::cout
+#include <vector>
+#endif
+#include <cassert>
+#include "my_map_traits.h"  // myst::get_map_key_t
+
+namespace mySymbolTable {
+
+constexpr size_t BTreeDefaultNodeBytes = 512;
+
+// B+ tree: all values are stored in sorted arrays in the leaves, which are
+// chained into a doubly linked list; internal nodes only hold separator keys
+// and child pointers. Each node is roughly `NodeBytes` large, so a lookup
+// touches a few cache lines per level rather than one per key compared, and
+// iterating is mostly a walk through contiguous arrays.
+//
+// Unlike the other trees here, inserting or erasing moves values around
+// within and between nodes, thus invalidates iterators (and references),
+// like absl::btree_map. Iterators returned by insert/erase are valid.
+template<typename T, typename Compare, typename Alloc, bool IsMap, bool IsMulti,
+         size_t NodeBytes = BTreeDefaultNodeBytes>
+class BTree {
+    struct node_base;
+    struct leaf_node;
+    struct internal_node;
+    class BTree_iter;
+    class BTree_const_iter;
+    using _self = BTree<T, Compare, Alloc, IsMap, IsMulti, NodeBytes>;
+    using node_ptr = node_base*;
+    using leaf_ptr = leaf_node*;
+    using internal_ptr = internal_node*;
+    using LeafAl = typename std::allocator_traits<Alloc>::template rebind_alloc<leaf_node>;
+    using InternalAl = typename std::allocator_traits<Alloc>::template rebind_alloc<internal_node>;
+public:
+    using value_type = T;
+    using key_type = typename get_map_key_t<T, IsMap>::key_type;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = BTree_iter;
+    using const_iterator = BTree_const_iter;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    // Values of a map are kept as pair<Key, T> with a mutable key so that they
+    // can be moved (not copied) around when shifting/splitting/merging nodes,
+    // and handed out as pair<const Key, T>& (as absl::btree_map and libc++ do).
+    template<typename V, bool>
+    struct slot_of { using type = V; };
+    template<typename V>
+    struct slot_of<V, true> { using type = std::pair<std::remove_const_t<typename V::first_type>, typename V::second_type>; };
+    using slot_type = typename slot_of<T, IsMap>::type;
+    using sep_type = std::remove_const_t<key_type>; // separators in internal nodes
+
+    struct node_header {
+        internal_ptr   _parent;
+        unsigned short _count;    // # of values (leaf) or # of children (internal)
+        unsigned short _pos;      // position in parent's children
+        bool           _is_leaf;
+    };
+
+    static constexpr size_t cap_or_min(size_t cap) noexcept { return cap < 3 ? 3 : cap; }
+
+    // one spare slot lets a node overflow by one before being split
+    static constexpr size_t LeafCap = cap_or_min(
+        (NodeBytes - sizeof(node_header) - 2 * sizeof(void*)) / sizeof(slot_type) - 1);
+    static constexpr size_t InternalCap = cap_or_min(  // max # of children
+        (NodeBytes - sizeof(node_header) - sizeof(void*)) / (sizeof(sep_type) + sizeof(void*)) - 1);
+    static constexpr size_t LeafMin = LeafCap / 2;
+    static constexpr size_t InternalMin = (InternalCap + 1) / 2;
+
+    static_assert(InternalCap < 65535 && LeafCap < 65535, "NodeBytes is too large");
+
+    // When keys are plain numbers compared by std::less/std::greater, count
+    // the keys ahead of `key` with a branchless linear scan, which compilers
+    // turn into SIMD compares (at -O3) and which beats binary search on arrays
+    // of a few dozen elements. Other keys use a binary search.
+    static constexpr bool LinearSearch = std::is_arithmetic<key_type>::value
+        && (std::is_same<Compare, std::less<sep_type>>::value
+            || std::is_same<Compare, std::greater<sep_type>>::value
+            || std::is_same<Compare, std::less<>>::value
+            || std::is_same<Compare, std::greater<>>::value);
+
+    node_ptr _root = nullptr;
+    leaf_ptr _leftmost = nullptr;
+    leaf_ptr _rightmost = nullptr;
+    size_t   _count = 0;
+    int      _height = -1;  // # of edges from root to leaves, -1 if empty
+    Compare  _comp;
+    LeafAl   _leaf_alloc;
+    InternalAl _internal_alloc;
+
+public:
+    BTree() : _comp(), _leaf_alloc(), _internal_alloc() {}
+
+    explicit BTree(const Compare& comp, const Alloc& alloc = Alloc())
+        : _comp(comp), _leaf_alloc(alloc), _internal_alloc(alloc) {}
+
+    explicit BTree(const Alloc& alloc) : _comp(), _leaf_alloc(alloc), _internal_alloc(alloc) {}
+
+    BTree(const _self& rhs)
+        : _comp(rhs._comp), _leaf_alloc(rhs._leaf_alloc), _internal_alloc(rhs._internal_alloc)
+    {
+        copy(rhs);
+    }
+
+    ~BTree() { clear(); }
+
+    _self& operator=(const _self& rhs) {
+        if (this == &rhs) return *this;
+        clear();
+        copy(rhs);
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(_leaf_alloc);
+    }
+
+    /* iterators */
+
+    iterator begin() noexcept {
+        return iterator(_leftmost, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(_leftmost, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(_rightmost, _rightmost ? _rightmost->_count : 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(_rightmost, _rightmost ? _rightmost->_count : 0);
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /* capacity */
+
+    bool empty() const noexcept { return _count == 0; }
+
+    size_t size() const noexcept { return _count; }
+
+    size_t max_size() const noexcept {
+        return std::allocator_traits<LeafAl>::max_size(_leaf_alloc) * LeafMin;
+    }
+
+    /* lookup */
+
+    size_t count(const key_type& key) const {
+        if constexpr (!IsMulti) {
+            return contains(key) ? 1 : 0;
+        }
+        else {
+            auto r = equal_range(key);
+            return std::distance(r.first, r.second);
+        }
+    }
+
+    iterator find(const key_type& key) {
+        auto p = find_aux(key);
+        return iterator(p.first, p.second);
+    }
+
+    const_iterator find(const key_type& key) const {
+        auto p = find_aux(key);
+        return const_iterator(p.first, p.second);
+    }
+
+    bool contains(const key_type& key) const {
+        auto p = find_aux(key);
+        return p.first != _rightmost || p.second != end_pos();
+    }
+
+    iterator lower_bound(const key_type& key) {
+        auto p = bound_aux</*Upper=*/false>(key);
+        return iterator(p.first, p.second);
+    }
+
+    const_iterator lower_bound(const key_type& key) const {
+        auto p = bound_aux</*Upper=*/false>(key);
+        return const_iterator(p.first, p.second);
+    }
+
+    iterator upper_bound(const key_type& key) {
+        auto p = bound_aux</*Upper=*/true>(key);
+        return iterator(p.first, p.second);
+    }
+
+    const_iterator upper_bound(const key_type& key) const {
+        auto p = bound_aux</*Upper=*/true>(key);
+        return const_iterator(p.first, p.second);
+    }
+
+    std::pair<iterator, iterator> equal_range(const key_type& key) {
+        iterator first = lower_bound(key);
+        if constexpr (!IsMulti) {
+            iterator second = first;
+            if (second != end() && !_comp(key, get_key(*second.slot()))) ++second;
+            return { first, second };
+        }
+        else return { first, upper_bound(key) };
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+        const_iterator first = lower_bound(key);
+        if constexpr (!IsMulti) {
+            const_iterator second = first;
+            if (second != end() && !_comp(key, get_key(*second.slot()))) ++second;
+            return { first, second };
+        }
+        else return { first, upper_bound(key) };
+    }
+
+    /* modifiers */
+
+    void clear() noexcept {
+        if (_root) {
+            clear_nodes(_root);
+            _root = nullptr;
+            _leftmost = _rightmost = nullptr;
+            _count = 0;
+            _height = -1;
+        }
+    }
+
+    std::conditional_t<!IsMulti, std::pair<iterator, bool>, iterator>
+    insert(const T& val) {
+        if constexpr (!IsMulti) return insert_unique(val);
+        else return insert_multi(val);
+    }
+
+    // Appending past the largest key (hint == end()) is amortized O(1) and
+    // fills the leaves completely; any other hint is ignored, a B+ tree search
+    // is only a handful of cache misses anyway.
+    iterator insert(const_iterator hint, const T& val) {
+        if (hint == cend() && !empty()) {
+            const key_type& key = get_key(val);
+            const key_type& max = get_key(_rightmost->slot(_rightmost->_count - 1));
+            if (IsMulti ? !_comp(key, max) : _comp(max, key))
+                return insert_at(_rightmost, _rightmost->_count, val);
+        }
+        if constexpr (!IsMulti) return insert_unique(val).first;
+        else return insert_multi(val);
+    }
+
+    template< typename InputIt >
+    void insert(InputIt first, InputIt last) {
+        while (first != last) {
+            insert(cend(), *first++);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        return insert(ilist.begin(), ilist.end());
+    }
+
+protected:
+    std::pair<iterator, bool> insert_or_assign(const T& val) {
+        auto r = insert_unique(val);
+        if (!r.second) {
+            if constexpr (IsMap) r.first->second = val.second;
+        }
+        return r;
+    }
+
+    struct lower_bound_result {
+        iterator it;   // lower bound
+        leaf_ptr leaf; // where to insert `key` if `it` turns out not to be it
+        size_t pos;
+    };
+
+    // used by map::operator[], see RBtree::cool_lower_bound
+    lower_bound_result cool_lower_bound(const key_type& key) {
+        if (empty()) return { end(), nullptr, 0 };
+        leaf_ptr leaf = descend</*Upper=*/false>(key);
+        size_t j = leaf_search</*Upper=*/false>(leaf, key);
+        return { normalize(leaf, j), leaf, j };
+    }
+
+    iterator insert_at(leaf_ptr leaf, size_t pos, const T& val) {
+        if (leaf == nullptr) { // empty tree
+            leaf = new_leaf();
+            _root = _leftmost = _rightmost = leaf;
+            _height = 0;
+            pos = 0;
+        }
+        leaf->insert_slot(pos, val);
+        ++_count;
+        if (leaf->_count > LeafCap)
+            return split_leaf(leaf, pos);
+        return iterator(leaf, pos);
+    }
+
+public:
+    iterator erase(iterator pos) {
+        return erase_aux(pos.leaf(), pos.pos());
+    }
+
+    iterator erase(const_iterator pos) {
+        return erase_aux(pos.leaf(), pos.pos());
+    }
+
+    // erasing may move values between leaves and invalidate `last`,
+    // so count how many to go first
+    iterator erase(const_iterator first, const_iterator last) {
+        if (first == cbegin() && last == cend()) {
+            clear();
+            return end();
+        }
+        size_t n = std::distance(first, last);
+        iterator it(first.leaf(), first.pos());
+        while (n--) {
+            it = erase(it);
+        }
+        return it;
+    }
+
+    size_t erase(const key_type& key) {
+        auto r = equal_range(key);
+        size_t n = std::distance(r.first, r.second);
+        iterator it = r.first;
+        for (size_t i = 0; i < n; ++i) {
+            it = erase(it);
+        }
+        return n;
+    }
+
+    void swap(BTree& rhs) noexcept(std::allocator_traits<Alloc>::is_always_equal::value
+                             &&    std::is_nothrow_swappable<Compare>::value)
+    {
+        assert(_leaf_alloc == rhs._leaf_alloc && "allocator must be the same");
+        if (std::allocator_traits<allocator_type>::propagate_on_container_swap::value) {
+            std::swap(_leaf_alloc, rhs._leaf_alloc);
+            std::swap(_internal_alloc, rhs._internal_alloc);
+        } // otherwise the behavior is undefined
+
+        std::swap(_root, rhs._root);
+        std::swap(_leftmost, rhs._leftmost);
+        std::swap(_rightmost, rhs._rightmost);
+        std::swap(_count, rhs._count);
+        std::swap(_height, rhs._height);
+        std::swap(_comp, rhs._comp);
+    }
+
+    /* tree height interface */
+
+    // # of edges from root to any leaf (they're all on the same level)
+    int height() const noexcept { return _height; }
+
+    static constexpr size_t leaf_capacity() noexcept { return LeafCap; }
+
+    static constexpr size_t internal_capacity() noexcept { return InternalCap; }
+
+#ifndef NDEBUG
+public:
+    /* visualization */
+
+    // print nodes level by level
+    void print() const {
+        if (empty()) return;
+        std::vector<node_ptr> level{ _root }, next_level;
+        while (!level.empty()) {
+            for (node_ptr x : level) {
+                std::cout << '[';
+                if (x->_is_leaf) {
+                    leaf_ptr leaf = static_cast<leaf_ptr>(x);
+                    for (size_t i = 0; i < leaf->_count; ++i)
+                        std::cout << (i ? " " : "") << get_key(leaf->slot(i));
+                }
+                else {
+                    internal_ptr in = static_cast<internal_ptr>(x);
+                    for (size_t i = 0; i + 1 < in->_count; ++i)
+                        std::cout << (i ? " " : "") << in->key(i);
+                    for (size_t i = 0; i < in->_count; ++i)
+                        next_level.push_back(in->child(i));
+                }
+                std::cout << "] ";
+            }
+            std::cout << '\n';
+            level.swap(next_level);
+            next_level.clear();
+        }
+    }
+
+    /* debug */
+
+    bool is_btree() const {
+        if (empty()) return _root == nullptr && _height == -1;
+        size_t n = 0;
+        leaf_ptr prev = nullptr;
+        if (!check(_root, nullptr, nullptr, 0, n, prev)) return false;
+        return n == _count && prev == _rightmost;
+    }
+
+private:
+    // all leaves on level _height, separators bracket their subtrees,
+    // parent/pos links and the leaf chain are consistent
+    bool check(node_ptr x, const key_type* lo, const key_type* hi, int depth,
+               size_t& n, leaf_ptr& prev) const {
+        if (x->_count == 0) return false;
+        if (x->_is_leaf) {
+            leaf_ptr leaf = static_cast<leaf_ptr>(x);
+            if (depth != _height || leaf->_prev != prev) return false;
+            if (prev == nullptr ? leaf != _leftmost : prev->_next != leaf) return false;
+            for (size_t i = 0; i < leaf->_count; ++i) {
+                const key_type& k = get_key(leaf->slot(i));
+                if (i > 0 && _comp(k, get_key(leaf->slot(i - 1)))) return false;
+                if ((lo && _comp(k, *lo)) || (hi && _comp(*hi, k))) return false;
+            }
+            n += leaf->_count;
+            prev = leaf;
+            return true;
+        }
+        internal_ptr in = static_cast<internal_ptr>(x);
+        if (in->_count < 2 && x == _root) return false;
+        for (size_t i = 0; i < in->_count; ++i) {
+            node_ptr c = in->child(i);
+            if (c->_parent != in || c->_pos != i) return false;
+            if (i > 0 && i + 1 < in->_count && _comp(in->key(i), in->key(i - 1))) return false;
+            if (!check(c, i > 0 ? &in->key(i - 1) : lo, i + 1 < in->_count ? &in->key(i) : hi,
+                       depth + 1, n, prev))
+                return false;
+        }
+        return true;
+    }
+#endif
+
+private:
+    /* key extraction */
+
+    // map
+    static const key_type& get_key_via_slot(const slot_type& s, std::true_type) {
+        return s.first;
+    }
+
+    // set
+    static const key_type& get_key_via_slot(const slot_type& s, std::false_type) {
+        return s;
+    }
+
+    static const key_type& get_key(const slot_type& s) {
+        return get_key_via_slot(s, std::bool_constant<IsMap>{});
+    }
+
+    // map (T is pair<const Key, V> rather than slot_type)
+    template<typename V, typename = std::enable_if_t<IsMap && !std::is_same<V, slot_type>::value>>
+    static const key_type& get_key(const V& val) {
+        return val.first;
+    }
+
+    /* in-node search */
+
+    // number of leading keys k such that k < key (Upper: !(key < k))
+    template<bool Upper, typename GetKey>
+    size_t node_search(size_t n, const key_type& key, GetKey k) const {
+        if constexpr (LinearSearch) {
+            size_t cnt = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if constexpr (Upper) cnt += !_comp(key, k(i));
+                else                 cnt +=  _comp(k(i), key);
+            }
+            return cnt;
+        }
+        else {
+            // plain binary search, ceil(log2(n + 1)) comparisons which is
+            // what matters when comparing keys is costly (e.g. strings)
+            size_t base = 0;
+            while (n > 0) {
+                size_t half = n / 2;
+                bool go_right = Upper ? !_comp(key, k(base + half)) : _comp(k(base + half), key);
+                if (go_right) {
+                    base += half + 1;
+                    n -= half + 1;
+                }
+                else n = half;
+            }
+            return base;
+        }
+    }
+
+    template<bool Upper>
+    size_t leaf_search(leaf_ptr leaf, const key_type& key) const {
+        return node_search<Upper>(leaf->_count, key,
+            [leaf](size_t i) -> const key_type& { return get_key(leaf->slot(i)); });
+    }
+
+    template<bool Upper>
+    size_t internal_search(internal_ptr x, const key_type& key) const {
+        // children: _count, separators: _count - 1
+        return node_search<Upper>(x->_count - 1, key,
+            [x](size_t i) -> const key_type& { return x->key(i); });
+    }
+
+    // Separators satisfy  child(i) <= key(i) <= child(i + 1)
+    // go to the first child whose separator is >= key (Upper: > key)
+    template<bool Upper>
+    leaf_ptr descend(const key_type& key) const {
+        node_ptr x = _root;
+        while (!x->_is_leaf) {
+            internal_ptr in = static_cast<internal_ptr>(x);
+            x = in->child(internal_search<Upper>(in, key));
+        }
+        return static_cast<leaf_ptr>(x);
+    }
+
+    size_t end_pos() const noexcept { return _rightmost ? _rightmost->_count : 0; }
+
+    // (leaf, leaf->_count) is only valid as end(), otherwise move on to the next leaf
+    std::pair<leaf_ptr, size_t> normalize_aux(leaf_ptr leaf, size_t j) const noexcept {
+        if (j < leaf->_count || leaf->_next == nullptr) return { leaf, j };
+        return { leaf->_next, 0 };
+    }
+
+    iterator normalize(leaf_ptr leaf, size_t j) noexcept {
+        auto p = normalize_aux(leaf, j);
+        return iterator(p.first, p.second);
+    }
+
+    template<bool Upper>
+    std::pair<leaf_ptr, size_t> bound_aux(const key_type& key) const {
+        if (empty()) return { nullptr, 0 };
+        leaf_ptr leaf = descend<Upper>(key);
+        return normalize_aux(leaf, leaf_search<Upper>(leaf, key));
+    }
+
+    std::pair<leaf_ptr, size_t> find_aux(const key_type& key) const {
+        auto p = bound_aux</*Upper=*/false>(key);
+        if (p.first == nullptr || p.second == p.first->_count
+            || _comp(key, get_key(p.first->slot(p.second))))
+            return { _rightmost, end_pos() };
+        return p;
+    }
+
+    /* insertion */
+
+    std::pair<iterator, bool> insert_unique(const T& val) {
+        if (empty()) return { insert_at(nullptr, 0, val), true };
+        const key_type& key = get_key(val);
+        leaf_ptr leaf = descend</*Upper=*/false>(key);
+        size_t j = leaf_search</*Upper=*/false>(leaf, key);
+        auto p = normalize_aux(leaf, j);
+        if (p.second < p.first->_count && !_comp(key, get_key(p.first->slot(p.second))))
+            return { iterator(p.first, p.second), false };
+        return { insert_at(leaf, j, val), true };
+    }
+
+    // after all equivalent keys, like RBtree
+    iterator insert_multi(const T& val) {
+        if (empty()) return insert_at(nullptr, 0, val);
+        const key_type& key = get_key(val);
+        leaf_ptr leaf = descend</*Upper=*/true>(key);
+        return insert_at(leaf, leaf_search</*Upper=*/true>(leaf, key), val);
+    }
+
+    // is x the last node on its level?
+    static bool is_rightmost(node_ptr x) noexcept {
+        for (; x->_parent; x = x->_parent) {
+            if (x->_pos + 1 != x->_parent->_count) return false;
+        }
+        return true;
+    }
+
+    // precondition: leaf->_count == LeafCap + 1, the new value is at `pos`
+    iterator split_leaf(leaf_ptr leaf, size_t pos) {
+        // appending to the rightmost leaf (sorted input) leaves it full
+        // rather than half full, like a bulk load
+        size_t left_count = (leaf == _rightmost && pos == LeafCap) ? LeafCap : (LeafCap + 1) / 2;
+        leaf_ptr right = new_leaf();
+        for (size_t i = left_count; i < leaf->_count; ++i)
+            move_slot(&right->slot(i - left_count), &leaf->slot(i));
+        right->_count = static_cast<unsigned short>(leaf->_count - left_count);
+        leaf->_count = static_cast<unsigned short>(left_count);
+        // link leaves
+        right->_next = leaf->_next;
+        right->_prev = leaf;
+        if (leaf->_next) leaf->_next->_prev = right;
+        else _rightmost = right;
+        leaf->_next = right;
+        insert_into_parent(leaf, get_key(right->slot(0)), right);
+        return pos < left_count ? iterator(leaf, pos) : iterator(right, pos - left_count);
+    }
+
+    // insert separator `key` and `right` right after `left` in their parent
+    void insert_into_parent(node_ptr left, const key_type& key, node_ptr right) {
+        internal_ptr parent = left->_parent;
+        if (parent == nullptr) { // grow a new root
+            parent = new_internal();
+            parent->set_child(0, left);
+            parent->_count = 1;
+            _root = parent;
+            ++_height;
+        }
+        size_t i = left->_pos;
+        parent->insert_child(i, key, right);
+        if (parent->_count > InternalCap)
+            split_internal(parent, i + 1);
+    }
+
+    // precondition: x->_count == InternalCap + 1, the new child is at `pos`
+    void split_internal(internal_ptr x, size_t pos) {
+        // keep at least two children on the right as well
+        size_t left_count = (pos == InternalCap && is_rightmost(x)) ? InternalCap - 1 : (InternalCap + 1) / 2;
+        internal_ptr right = new_internal();
+        // separator key(left_count - 1) moves up
+        for (size_t i = left_count; i < x->_count; ++i) {
+            right->set_child(i - left_count, x->child(i));
+            if (i + 1 < x->_count)
+                move_key(&right->key(i - left_count), &x->key(i));
+        }
+        right->_count = static_cast<unsigned short>(x->_count - left_count);
+        x->_count = static_cast<unsigned short>(left_count);
+        sep_type up(std::move(x->key(left_count - 1)));
+        x->key(left_count - 1).~sep_type();
+        insert_into_parent(x, up, right);
+    }
+
+    /* erasure */
+
+    iterator erase_aux(leaf_ptr leaf, size_t j) {
+        assert(leaf != nullptr && j < leaf->_count && "cannot erase end() iterator");
+        leaf->erase_slot(j);
+        --_count;
+        if (leaf == _root) {
+            if (leaf->_count == 0) {
+                delete_leaf(leaf);
+                _root = _leftmost = _rightmost = nullptr;
+                _height = -1;
+                return end();
+            }
+            return normalize(leaf, j);
+        }
+        if (leaf->_count >= LeafMin)
+            return normalize(leaf, j);
+
+        internal_ptr parent = leaf->_parent;
+        size_t i = leaf->_pos;
+        leaf_ptr left  = i > 0 ? static_cast<leaf_ptr>(parent->child(i - 1)) : nullptr;
+        leaf_ptr right = i + 1 < parent->_count ? static_cast<leaf_ptr>(parent->child(i + 1)) : nullptr;
+
+        if (left && left->_count > LeafMin) { // borrow from left
+            leaf->insert_slot_moved(0, &left->slot(left->_count - 1));
+            --left->_count;
+            parent->key(i - 1) = get_key(leaf->slot(0));
+            return normalize(leaf, j + 1);
+        }
+        if (right && right->_count > LeafMin) { // borrow from right
+            leaf->insert_slot_moved(leaf->_count, &right->slot(0));
+            right->shift_left_slots(0);
+            parent->key(i) = get_key(right->slot(0));
+            return normalize(leaf, j);
+        }
+
+        leaf_ptr kept;
+        size_t kept_pos;
+        if (left) { // merge into left
+            kept = left;
+            kept_pos = left->_count + j;
+            merge_leaves(left, leaf);
+        }
+        else {      // merge right into this
+            kept = leaf;
+            kept_pos = j;
+            merge_leaves(leaf, right);
+        }
+        rebalance_internal(parent);
+        return normalize(kept, kept_pos);
+    }
+
+    // move all of `right` into `left`, unlink and free it
+    void merge_leaves(leaf_ptr left, leaf_ptr right) {
+        for (size_t i = 0; i < right->_count; ++i)
+            move_slot(&left->slot(left->_count + i), &right->slot(i));
+        left->_count = static_cast<unsigned short>(left->_count + right->_count);
+        right->_count = 0;
+        left->_next = right->_next;
+        if (right->_next) right->_next->_prev = left;
+        else _rightmost = left;
+        right->_parent->erase_child(right->_pos);
+        delete_leaf(right);
+    }
+
+    void rebalance_internal(internal_ptr x) {
+        if (x == _root) {
+            if (x->_count == 1) { // shrink
+                _root = x->child(0);
+                _root->_parent = nullptr;
+                _root->_pos = 0;
+                x->_count = 0;
+                delete_internal(x);
+                --_height;
+            }
+            return;
+        }
+        if (x->_count >= InternalMin) return;
+
+        internal_ptr parent = x->_parent;
+        size_t i = x->_pos;
+        internal_ptr left  = i > 0 ? static_cast<internal_ptr>(parent->child(i - 1)) : nullptr;
+        internal_ptr right = i + 1 < parent->_count ? static_cast<internal_ptr>(parent->child(i + 1)) : nullptr;
+
+        if (left && left->_count > InternalMin) { // rotate right through parent
+            x->insert_child_front(parent->key(i - 1), left->child(left->_count - 1));
+            parent->key(i - 1) = std::move(left->key(left->_count - 2));
+            left->key(left->_count - 2).~sep_type();
+            --left->_count;
+        }
+        else if (right && right->_count > InternalMin) { // rotate left through parent
+            x->push_back_child(parent->key(i), right->child(0));
+            parent->key(i) = std::move(right->key(0));
+            right->erase_child_front();
+        }
+        else {
+            if (left) merge_internals(left, x);
+            else      merge_internals(x, right);
+            rebalance_internal(parent);
+        }
+    }
+
+    void merge_internals(internal_ptr left, internal_ptr right) {
+        internal_ptr parent = left->_parent;
+        left->push_back_child(parent->key(left->_pos), right->child(0));
+        for (size_t i = 1; i < right->_count; ++i)
+            left->push_back_child(std::move(right->key(i - 1)), right->child(i));
+        parent->erase_child(right->_pos);
+        delete_internal(right);
+    }
+
+    /* node management */
+
+    static void move_slot(slot_type* dst, slot_type* src) {
+        ::new ((void*)dst) slot_type(std::move(*src));
+        src->~slot_type();
+    }
+
+    static void move_key(sep_type* dst, sep_type* src) {
+        ::new ((void*)dst) sep_type(std::move(*src));
+        src->~sep_type();
+    }
+
+    leaf_ptr new_leaf() {
+        leaf_ptr p = _leaf_alloc.allocate(1);
+        ::new ((void*)p) leaf_node();
+        return p;
+    }
+
+    internal_ptr new_internal() {
+        internal_ptr p = _internal_alloc.allocate(1);
+        ::new ((void*)p) internal_node();
+        return p;
+    }
+
+    void delete_leaf(leaf_ptr x) noexcept {
+        x->~leaf_node();
+        _leaf_alloc.deallocate(x, 1);
+    }
+
+    void delete_internal(internal_ptr x) noexcept {
+        x->~internal_node();
+        _internal_alloc.deallocate(x, 1);
+    }
+
+    void clear_nodes(node_ptr x) noexcept {
+        if (x->_is_leaf) {
+            delete_leaf(static_cast<leaf_ptr>(x));
+            return;
+        }
+        internal_ptr in = static_cast<internal_ptr>(x);
+        for (size_t i = 0; i < in->_count; ++i)
+            clear_nodes(in->child(i));
+        delete_internal(in);
+    }
+
+    // same shape as rhs, leaves chained in order through `prev`
+    node_ptr copy_nodes(node_ptr x, leaf_ptr& prev) {
+        if (x->_is_leaf) {
+            leaf_ptr src = static_cast<leaf_ptr>(x), leaf = new_leaf();
+            for (size_t i = 0; i < src->_count; ++i) {
+                ::new ((void*)&leaf->slot(i)) slot_type(src->slot(i));
+                ++leaf->_count;
+            }
+            leaf->_prev = prev;
+            if (prev) prev->_next = leaf;
+            else _leftmost = leaf;
+            prev = leaf;
+            return leaf;
+        }
+        internal_ptr src = static_cast<internal_ptr>(x), in = new_internal();
+        for (size_t i = 0; i < src->_count; ++i) {
+            in->set_child(i, copy_nodes(src->child(i), prev));
+            if (i + 1 < src->_count)
+                ::new ((void*)&in->key(i)) sep_type(src->key(i));
+            ++in->_count;
+        }
+        return in;
+    }
+
+    void copy(const _self& rhs) {
+        if (!rhs.empty()) {
+            leaf_ptr prev = nullptr;
+            _root = copy_nodes(rhs._root, prev);
+            _rightmost = prev;
+            _count = rhs._count;
+            _height = rhs._height;
+        }
+    }
+
+    struct node_base : node_header {
+        node_base(bool is_leaf) noexcept : node_header{ nullptr, 0, 0, is_leaf } {}
+    };
+
+    struct leaf_node : node_base {
+        leaf_ptr _prev = nullptr;
+        leaf_ptr _next = nullptr;
+        alignas(slot_type) unsigned char _slots[(LeafCap + 1) * sizeof(slot_type)];
+
+        leaf_node() noexcept : node_base(/*is_leaf=*/true) {}
+
+        ~leaf_node() {
+            for (size_t i = 0; i < this->_count; ++i)
+                slot(i).~slot_type();
+        }
+
+        slot_type& slot(size_t i) noexcept {
+            return reinterpret_cast<slot_type*>(_slots)[i];
+        }
+
+        const slot_type& slot(size_t i) const noexcept {
+            return reinterpret_cast<const slot_type*>(_slots)[i];
+        }
+
+        // make room at `pos`
+        void shift_right_slots(size_t pos) {
+            for (size_t i = this->_count; i > pos; --i)
+                move_slot(&slot(i), &slot(i - 1));
+        }
+
+        // close the gap at `pos` (already destroyed)
+        void shift_left_slots(size_t pos) {
+            for (size_t i = pos + 1; i < this->_count; ++i)
+                move_slot(&slot(i - 1), &slot(i));
+            --this->_count;
+        }
+
+        void insert_slot(size_t pos, const T& val) {
+            shift_right_slots(pos);
+            ::new ((void*)&slot(pos)) slot_type(val);
+            ++this->_count;
+        }
+
+        void insert_slot_moved(size_t pos, slot_type* src) {
+            shift_right_slots(pos);
+            move_slot(&slot(pos), src);
+            ++this->_count;
+        }
+
+        void erase_slot(size_t pos) {
+            slot(pos).~slot_type();
+            shift_left_slots(pos);
+        }
+    };
+
+    struct internal_node : node_base {
+        node_ptr _children[InternalCap + 1];
+        alignas(sep_type) unsigned char _keys[InternalCap * sizeof(sep_type)];
+
+        internal_node() noexcept : node_base(/*is_leaf=*/false) {}
+
+        ~internal_node() {
+            for (size_t i = 0; i + 1 < this->_count; ++i)
+                key(i).~sep_type();
+        }
+
+        sep_type& key(size_t i) noexcept {
+            return reinterpret_cast<sep_type*>(_keys)[i];
+        }
+
+        const sep_type& key(size_t i) const noexcept {
+            return reinterpret_cast<const sep_type*>(_keys)[i];
+        }
+
+        node_ptr child(size_t i) const noexcept { return _children[i]; }
+
+        void set_child(size_t i, node_ptr c) noexcept {
+            _children[i] = c;
+            c->_parent = this;
+            c->_pos = static_cast<unsigned short>(i);
+        }
+
+        // insert key(i) and child(i + 1)
+        void insert_child(size_t i, const key_type& k, node_ptr c) {
+            size_t nkeys = this->_count - 1;
+            for (size_t j = nkeys; j > i; --j)
+                move_key(&key(j), &key(j - 1));
+            ::new ((void*)&key(i)) sep_type(k);
+            for (size_t j = this->_count; j > i + 1; --j)
+                set_child(j, _children[j - 1]);
+            set_child(i + 1, c);
+            ++this->_count;
+        }
+
+        void push_back_child(sep_type k, node_ptr c) {
+            ::new ((void*)&key(this->_count - 1)) sep_type(std::move(k));
+            set_child(this->_count, c);
+            ++this->_count;
+        }
+
+        void insert_child_front(const key_type& k, node_ptr c) {
+            for (size_t j = this->_count - 1; j > 0; --j)
+                move_key(&key(j), &key(j - 1));
+            ::new ((void*)&key(0)) sep_type(k);
+            for (size_t j = this->_count; j > 0; --j)
+                set_child(j, _children[j - 1]);
+            set_child(0, c);
+            ++this->_count;
+        }
+
+        // remove child(i) and the separator to its left (key(i - 1)),
+        // or key(0) if i == 0
+        void erase_child(size_t i) {
+            size_t k = i > 0 ? i - 1 : 0;
+            key(k).~sep_type();
+            for (size_t j = k + 1; j + 1 < this->_count; ++j)
+                move_key(&key(j - 1), &key(j));
+            for (size_t j = i + 1; j < this->_count; ++j)
+                set_child(j - 1, _children[j]);
+            --this->_count;
+        }
+
+        void erase_child_front() { erase_child(0); }
+    };
+
+    class BTree_iter
+    {
+        using _self = BTree_iter;
+        leaf_ptr _leaf;
+        size_t   _pos;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        BTree_iter() noexcept : _leaf(nullptr), _pos(0) {}
+        BTree_iter(leaf_ptr leaf, size_t pos) noexcept : _leaf(leaf), _pos(pos) {}
+
+        leaf_ptr leaf() const noexcept { return _leaf; }
+        size_t pos() const noexcept { return _pos; }
+        slot_type* slot() const noexcept { return &_leaf->slot(_pos); }
+
+        reference operator*() const {
+            return *reinterpret_cast<T*>(slot());
+        }
+
+        pointer operator->() const {
+            return reinterpret_cast<T*>(slot());
+        }
+
+        _self& operator++() {
+            if (++_pos == _leaf->_count && _leaf->_next) {
+                _leaf = _leaf->_next;
+                _pos = 0;
+            }
+            return *this;
+        }
+
+        _self operator++(int) {
+            _self tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        _self& operator--() {
+            if (_pos == 0) {
+                _leaf = _leaf->_prev;
+                _pos = _leaf->_count;
+            }
+            --_pos;
+            return *this;
+        }
+
+        _self operator--(int) {
+            _self tmp{ *this };
+            --*this;
+            return tmp;
+        }
+
+        friend bool operator==(const _self& lhs, const _self& rhs) {
+            return lhs._leaf == rhs._leaf && lhs._pos == rhs._pos;
+        }
+
+        friend bool operator!=(const _self& lhs, const _self& rhs) {
+            return !(lhs == rhs);
+        }
+    };
+
+    class BTree_const_iter
+    {
+        using _self = BTree_const_iter;
+        leaf_ptr _leaf;
+        size_t   _pos;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        BTree_const_iter() noexcept : _leaf(nullptr), _pos(0) {}
+        BTree_const_iter(leaf_ptr leaf, size_t pos) noexcept : _leaf(leaf), _pos(pos) {}
+        BTree_const_iter(const BTree_iter& other) noexcept : _leaf(other.leaf()), _pos(other.pos()) {}
+
+        leaf_ptr leaf() const noexcept { return _leaf; }
+        size_t pos() const noexcept { return _pos; }
+        const slot_type* slot() const noexcept { return &_leaf->slot(_pos); }
+
+        reference operator*() const {
+            return *reinterpret_cast<const T*>(slot());
+        }
+
+        pointer operator->() const {
+            return reinterpret_cast<const T*>(slot());
+        }
+
+        _self& operator++() {
+            if (++_pos == _leaf->_count && _leaf->_next) {
+                _leaf = _leaf->_next;
+                _pos = 0;
+            }
+            return *this;
+        }
+
+        _self operator++(int) {
+            _self tmp{ *this };
+            ++*this;
+            return tmp;
+        }
+
+        _self& operator--() {
+            if (_pos == 0) {
+                _leaf = _leaf->_prev;
+                _pos = _leaf->_count;
+            }
+            --_pos;
+            return *this;
+        }
+
+        _self operator--(int) {
+            _self tmp{ *this };
+            --*this;
+            return tmp;
+        }
+
+        friend bool operator==(const _self& lhs, const _self& rhs) {
+            return lhs._leaf == rhs._leaf && lhs._pos == rhs._pos;
+        }
+
+        friend bool operator!=(const _self& lhs, const _self& rhs) {
+            return !(lhs == rhs);
+        }
+    };
+}; // class BTree
+
+} // namespace mySymbolTable
+
+#endif // !BTREE_IMPL_H
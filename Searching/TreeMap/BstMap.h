@@ -9,6 +9,7 @@
 #define BSTMAP_H 1
 
 #include "BST_impl.h"
+#include "StaticOrderedMap.h"
 #include <memory>     // std::allocator
 #include <functional> // std::less
 #include <stdexcept>  // std::out_of_range
@@ -150,6 +151,11 @@ public:
         _base::swap(rhs);
     }
 
+    // a contiguous copy with faster lookups, see StaticOrderedMap.h
+    StaticOrderedMap<Key, T, Compare> freeze() const {
+        return StaticOrderedMap<Key, T, Compare>(this->begin(), this->end(), key_comp());
+    }
+
     key_compare key_comp() const {
         return key_compare{};
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "TST.h"
+#include "fork_join_pool.h" // myst::ForkJoinPool
 
 namespace mySymbolTable {
 
@@ -10,48 +11,158 @@ class RWayTST {
     static const size_t R = 256; // extended ascii
 
     T *inlined_values[R] = {};  // the values of one-letter keys
-    TST<T> tsts[R];
+    TST<T> tsts[R];             // the rest of the keys, by first letter
 public:
+    RWayTST() = default;
+
+    RWayTST(const RWayTST&) = delete;
+    RWayTST& operator=(const RWayTST&) = delete;
+
     ~RWayTST() {
         for (auto x : inlined_values)
             delete x;
     }
 
+    size_t size() const {
+        size_t n = 0;
+        for (size_t i = 0; i < R; i++)
+            n += (inlined_values[i] ? 1 : 0) + tsts[i].size();
+        return n;
+    }
+
     // returns nullptr if key does not exist
     T* get(const std::string &key) {
-        if (key.empty()) 
+        if (key.empty())
             return nullptr;
         if (key.size() == 1)
             return inlined_values[(uchar) key[0]];
         TST<T> &tst = tsts[(uchar) key[0]];
-        auto it = tst.find(key.substr(1));
+        auto it = tst.find(key, 1); // the first letter is implied by tst
         if (it != tst.end())
             return &it.val();
         return nullptr;
     }
 
+    const T* get(const std::string &key) const {
+        return const_cast<RWayTST*>(this)->get(key);
+    }
+
+    // no overwriting if key already exists, like TST::insert()
     T& insert(const std::string &key, const T &val) {
         if (key.empty())
             throw std::invalid_argument("insert() key cannot be empty");
         if (key.size() == 1) {
             auto &p = inlined_values[(uchar)key[0]];
-            if (p)
-                delete p;
-            p = new T(val);
+            if (!p)
+                p = new T(val);
             return *p;
         }
 
         TST<T> &tst = tsts[(uchar) key[0]];
-        return *tst.insert(key.substr(1), val)->pval;
+        return *tst.insert(key, 1, val)->pval;
     }
 
     T& operator[](const std::string& key) {
         return insert(key, T());
     }
 
+    // Inserts the (key, value) pairs in [first, last) like insert() one by
+    // one. The keys are bucketed by their first letter, and the TSTs of the
+    // buckets, which share nothing, are built concurrently on the pool.
+    template<typename ForwardIt>
+    void bulk_insert(ForwardIt first, ForwardIt last, ForkJoinPool &pool = ForkJoinPool::instance()) {
+        // counting sort of the iterators by first letter, stable
+        size_t offsets[R + 1] = {0};
+        for (auto it = first; it != last; ++it) {
+            if (it->first.empty())
+                throw std::invalid_argument("bulk_insert() key cannot be empty");
+            offsets[(uchar) it->first[0] + 1]++;
+        }
+        for (size_t i = 0; i < R; i++)
+            offsets[i + 1] += offsets[i];
+        std::vector<ForwardIt> order(offsets[R]);
+        size_t next[R];
+        std::copy(offsets, offsets + R, next);
+        for (auto it = first; it != last; ++it)
+            order[next[(uchar) it->first[0]]++] = it;
+        build_buckets(order, offsets, 0, R, pool);
+    }
+
+    // Calls fn(key, val) for every key in order. The key is a buffer that is
+    // only valid during the call.
+    template<typename Fn>
+    void for_each(Fn fn) const {
+        std::string key;
+        for (size_t i = 0; i < R; i++)
+            for_each_in_bucket(i, key, fn);
+    }
+
+    // The same as above, but fn is called concurrently for keys with
+    // different first letters, so it must be safe to run in parallel;
+    // the keys of each first letter still come in order.
+    template<typename Fn>
+    void parallel_for_each(Fn fn, ForkJoinPool &pool = ForkJoinPool::instance()) const {
+        size_t offsets[R + 1] = {0};
+        for (size_t i = 0; i < R; i++)
+            offsets[i + 1] = offsets[i] + (inlined_values[i] ? 1 : 0) + tsts[i].size();
+        for_each_bucket(offsets, 0, R, pool, [this, &fn](size_t i) {
+            std::string key;
+            for_each_in_bucket(i, key, fn);
+        });
+    }
+
+    std::vector<std::string> keys() const {
+        return keys_with_prefix("");
+    }
+
+    // all keys with prefix, in order; for "" (all keys) or a single letter
+    // the TSTs are walked on the pool, each into its slice of the result
+    std::vector<std::string> keys_with_prefix(const std::string &prefix,
+                                              ForkJoinPool &pool = ForkJoinPool::instance()) const {
+        std::vector<std::string> vs;
+        if (prefix.size() > 1) {
+            auto add = [&vs, &prefix](const std::string &suffix, const T&) {
+                vs.push_back(prefix.substr(0, 1) + suffix);
+            };
+            tsts[(uchar) prefix[0]].for_each_with_prefix(prefix.substr(1), add);
+            return vs;
+        }
+        size_t lo = prefix.empty() ? 0 : (uchar) prefix[0];
+        size_t hi = prefix.empty() ? R : lo + 1;
+        size_t offsets[R + 1] = {0};
+        for (size_t i = lo; i < hi; i++)
+            offsets[i + 1] = offsets[i] + (inlined_values[i] ? 1 : 0) + tsts[i].size();
+        vs.resize(offsets[hi]);
+        for_each_bucket(offsets, lo, hi, pool, [this, &vs, &offsets](size_t i) {
+            size_t j = offsets[i];
+            std::string key;
+            for_each_in_bucket(i, key, [&vs, &j](const std::string &k, const T&) { vs[j++] = k; });
+        });
+        return vs;
+    }
+
+    // keys within edit distance k of query, see TST::keys_within_distance()
+    std::vector<std::pair<std::string, int>> keys_within_distance(const std::string &query, int k,
+                                                                  bool transpositions = false) const {
+        std::vector<std::pair<std::string, int>> res;
+        auto add = [&res](const std::string &key, int dist) { res.emplace_back(key, dist); };
+        EditDistanceRows ed(query, k, transpositions);
+        for (size_t c = 0; c < R; c++) {
+            if (!inlined_values[c] && tsts[c].empty())
+                continue;
+            // the first letter is this level, the rest hang in tsts[c]
+            ed.push((char) c);
+            if (inlined_values[c] && ed.matches())
+                add(ed.key(), ed.distance());
+            tsts[c].for_each_within_distance(ed, add);
+            ed.pop();
+        }
+        return res;
+    }
+
     int height() const {
         int h[R] = {0};
-        for (size_t i = 0; i < R; i++) 
+        for (size_t i = 0; i < R; i++)
             h[i] = tsts[i].height();
         int max = *std::max_element(h, h+R);
         if (max == 0) {
@@ -62,6 +173,48 @@ public:
         }
         return 1 + max;
     }
+
+private:
+    // buckets smaller than this (in keys) aren't worth a task of their own
+    static const size_t ParallelGrain = 4096;
+
+    // calls task(i) for the buckets lo <= i < hi, splitting them into two
+    // halves of about the same no. of keys (offsets is their prefix sum)
+    // until they are small enough for one thread
+    template<typename Task>
+    static void for_each_bucket(const size_t *offsets, size_t lo, size_t hi, ForkJoinPool &pool, const Task &task) {
+        if (hi - lo == 1 || offsets[hi] - offsets[lo] < ParallelGrain || pool.size() == 1) {
+            for (size_t i = lo; i < hi; i++)
+                task(i);
+            return;
+        }
+        size_t half = offsets[lo] + (offsets[hi] - offsets[lo]) / 2;
+        size_t mid = std::upper_bound(offsets + lo + 1, offsets + hi, half) - offsets;
+        if (mid == hi) mid--;
+        pool.fork_join([&] { for_each_bucket(offsets, lo, mid, pool, task); },
+                       [&] { for_each_bucket(offsets, mid, hi, pool, task); });
+    }
+
+    template<typename ForwardIt>
+    void build_buckets(const std::vector<ForwardIt> &order, const size_t *offsets,
+                       size_t lo, size_t hi, ForkJoinPool &pool) {
+        for_each_bucket(offsets, lo, hi, pool, [this, &order, offsets](size_t i) {
+            for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+                insert(order[j]->first, order[j]->second);
+        });
+    }
+
+    // fn(key, val) for the keys starting with letter i, key is the buffer
+    template<typename Fn>
+    void for_each_in_bucket(size_t i, std::string &key, Fn &&fn) const {
+        key.assign(1, (char) i);
+        if (inlined_values[i])
+            fn(key, *inlined_values[i]);
+        tsts[i].for_each_with_prefix("", [&key, &fn](const std::string &suffix, const T &val) {
+            key.replace(1, std::string::npos, suffix);
+            fn(key, val);
+        });
+    }
 };
 
 } // namespace mySymbolTable
@@ -0,0 +1,197 @@
+/*
+ *  ordered symbol tables:
+ *  interval map, a red-black tree of closed intervals [lo, hi]
+ *  augmented with the max endpoint of every subtree
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/IntervalMap.h
+ *
+ *  usage:
+ *      mySymbolTable::IntervalMap<int, std::string> mp;
+ *      mp.insert(10, 20, "a"); mp.insert(15, 40, "b");
+ *      for (auto it : mp.overlapping(18, 25)) ...  // it->first.first/second, it->second
+ *      mp.stabbing(30);                            // intervals containing 30
+ */
+
+#ifndef INTERVALMAP_H
+#define INTERVALMAP_H 1
+
+#include "RBtree_impl.h"
+#include <memory>     // std::allocator
+#include <functional> // std::less
+#include <type_traits> // std::is_empty_v
+#include <stdexcept>  // std::invalid_argument
+#include <vector>
+#include <initializer_list>
+
+namespace mySymbolTable {
+
+// orders intervals by low endpoint, then by high endpoint
+template<typename Point, typename Compare>
+struct interval_compare {
+    Compare _comp;
+
+    bool operator()(const std::pair<Point, Point>& lhs, const std::pair<Point, Point>& rhs) const {
+        if (_comp(lhs.first, rhs.first)) return true;
+        if (_comp(rhs.first, lhs.first)) return false;
+        return _comp(lhs.second, rhs.second);
+    }
+};
+
+// keeps the max high endpoint of every subtree
+template<typename Point, typename Compare>
+struct interval_max_node_update {
+    using metadata_type = Point;
+
+    template<typename T>
+    static Point from_value(const std::pair<const std::pair<Point, Point>, T>& val) {
+        return val.first.second;
+    }
+
+    static Point combine(const Point& lhs, const Point& rhs) {
+        return Compare()(lhs, rhs) ? rhs : lhs;
+    }
+};
+
+// Several entries may share an interval. Queries are on closed intervals
+// and walk only the subtrees whose max high endpoint reaches the query, so
+// reporting k overlaps costs O(log n + k log(n/k)) rather than O(n).
+// Compare must be stateless, as node updates are static (see tree_policy.h)
+// and combine the subtree maxima with a default-constructed one.
+template<typename Point, typename T, typename Compare = std::less<Point>,
+         typename Alloc = std::allocator<std::pair<const std::pair<Point, Point>, T>>>
+class IntervalMap : public RBtree<std::pair<const std::pair<Point, Point>, T>, interval_compare<Point, Compare>, Alloc,
+                                  /*IsMap=*/true, /*IsMulti=*/true, interval_max_node_update<Point, Compare>> {
+    using _base = RBtree<std::pair<const std::pair<Point, Point>, T>, interval_compare<Point, Compare>, Alloc,
+                         /*IsMap=*/true, /*IsMulti=*/true, interval_max_node_update<Point, Compare>>;
+public:
+    using point_type = Point;
+    using interval_type = std::pair<Point, Point>;
+    using key_type = interval_type;
+    using mapped_type = T;
+    using value_type = std::pair<const interval_type, T>;
+    using key_compare = interval_compare<Point, Compare>;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = typename _base::iterator;
+    using const_iterator = typename _base::const_iterator;
+    using reverse_iterator = typename _base::reverse_iterator;
+    using const_reverse_iterator = typename _base::const_reverse_iterator;
+    using node_type = typename _base::node_type;
+
+    static_assert(std::is_empty_v<Compare>, "IntervalMap<P, T, Compare> requires a stateless Compare");
+
+    /* I */
+
+    // (1) a
+    IntervalMap() : _base() {}
+
+    // (1) b
+    explicit IntervalMap(const Alloc& alloc) : _base(alloc) {}
+
+    /* II */
+
+    // (2) a
+    template< class InputIt >
+    IntervalMap(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : IntervalMap(alloc)
+    {
+        insert(first, last);
+    }
+
+    /* III */
+
+    // (3) a
+    IntervalMap(std::initializer_list<value_type> init, const Alloc& alloc = Alloc()) : IntervalMap(alloc)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    /* modifiers */
+
+    using _base::insert;
+
+    iterator insert(const Point& lo, const Point& hi, const T& val) {
+        check_interval(lo, hi);
+        return _base::insert(value_type{ interval_type{ lo, hi }, val });
+    }
+
+    iterator insert(const value_type& val) {
+        check_interval(val.first.first, val.first.second);
+        return _base::insert(val);
+    }
+
+    // sorted (by lo, then hi) ranges are bulk loaded in linear time
+    template< class InputIt >
+    void insert(InputIt first, InputIt last) {
+        for (InputIt it = first; it != last; ++it) {
+            check_interval(it->first.first, it->first.second);
+        }
+        _base::insert(first, last);
+    }
+
+    /* interval queries, all intervals closed */
+
+    // any interval overlapping [lo, hi], end() if none, O(log n)
+    const_iterator find_any(const Point& lo, const Point& hi) const {
+        const_iterator x = this->root_node();
+        while (x != const_iterator()) {
+            if (overlaps(x, lo, hi)) return x;
+            const_iterator left = this->left_child(x);
+            // if the left subtree reaches lo, either it has an overlap
+            // or nothing in the right subtree can have one
+            if (left != const_iterator() && !_comp(this->subtree_metadata(left), lo))
+                x = left;
+            else
+                x = this->right_child(x);
+        }
+        return this->cend();
+    }
+
+    bool overlaps_any(const Point& lo, const Point& hi) const {
+        return find_any(lo, hi) != this->cend();
+    }
+
+    // calls f(const_iterator) on every interval overlapping [lo, hi], in order
+    template<typename F>
+    void for_each_overlapping(const Point& lo, const Point& hi, F f) const {
+        for_each_overlapping_aux(this->root_node(), lo, hi, f);
+    }
+
+    // all intervals overlapping [lo, hi], in order
+    std::vector<const_iterator> overlapping(const Point& lo, const Point& hi) const {
+        std::vector<const_iterator> res;
+        for_each_overlapping(lo, hi, [&res](const_iterator it) { res.push_back(it); });
+        return res;
+    }
+
+    // all intervals containing the point p, in order
+    std::vector<const_iterator> stabbing(const Point& p) const {
+        return overlapping(p, p);
+    }
+
+private:
+    void check_interval(const Point& lo, const Point& hi) const {
+        if (_comp(hi, lo)) throw std::invalid_argument("IntervalMap<P, T> interval with hi < lo");
+    }
+
+    bool overlaps(const_iterator x, const Point& lo, const Point& hi) const {
+        return !_comp(hi, x->first.first) && !_comp(x->first.second, lo);
+    }
+
+    template<typename F>
+    void for_each_overlapping_aux(const_iterator x, const Point& lo, const Point& hi, F& f) const {
+        // nothing in this subtree ends at or after lo
+        if (x == const_iterator() || _comp(this->subtree_metadata(x), lo)) return;
+        for_each_overlapping_aux(this->left_child(x), lo, hi, f);
+        // x and everything to its right start after hi
+        if (_comp(hi, x->first.first)) return;
+        if (!_comp(x->first.second, lo)) f(x);
+        for_each_overlapping_aux(this->right_child(x), lo, hi, f);
+    }
+
+    Compare _comp{};
+};
+
+} // namespace mySymbolTable
+
+#endif // !INTERVALMAP_H
@@ -0,0 +1,162 @@
+/*
+ *  monotonic (bump) arena for build-once, drop-all containers
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/MemPool/MonotonicArena.h
+ *
+ *  usage:
+ *      mySymbolTable::TST<int, mySymbolTable::MonotonicAllocator<int>> tst;
+ *      ... // build, query
+ *      // the destructor gives the chunks back without visiting a node
+ */
+
+#ifndef MONOTONICARENA_H
+#define MONOTONICARENA_H 1
+
+#include <memory>      // std::shared_ptr, std::allocator_traits
+#include <new>         // ::operator new, std::bad_alloc
+#include <cstdint>
+#include <cstddef>     // std::max_align_t
+#include <type_traits>
+#include <utility>     // std::move
+
+namespace mySymbolTable {
+
+// Like std::pmr::monotonic_buffer_resource: blocks are bumped off chunks that
+// double from 64 KiB up to 16 MiB, deallocation does nothing, and all chunks
+// are released together. Not thread-safe.
+class MonotonicArena {
+public:
+    static constexpr size_t MinChunkSize = 64 * 1024;
+    static constexpr size_t MaxChunkSize = 16 * 1024 * 1024;
+
+    MonotonicArena() = default;
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() { release(); }
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(_cur) + align - 1) & ~(uintptr_t)(align - 1);
+        if (_cur == nullptr || p + bytes > reinterpret_cast<uintptr_t>(_end)) {
+            new_chunk(bytes + align);
+            p = (reinterpret_cast<uintptr_t>(_cur) + align - 1) & ~(uintptr_t)(align - 1);
+        }
+        _cur = reinterpret_cast<char*>(p + bytes);
+        return reinterpret_cast<void*>(p);
+    }
+
+    void deallocate(void*, size_t) noexcept {}
+
+    // frees every chunk at once
+    void release() noexcept {
+        while (_chunks != nullptr) {
+            Chunk* next = _chunks->next;
+            ::operator delete(_chunks);
+            _chunks = next;
+        }
+        _cur = _end = nullptr;
+        _next_size = MinChunkSize;
+        _count = _bytes = 0;
+    }
+
+    // # of chunks and their total bytes obtained from ::operator new so far
+    size_t chunk_count() const noexcept { return _count; }
+
+    size_t reserved_bytes() const noexcept { return _bytes; }
+
+private:
+    // a chunk starts with this header, its blocks follow
+    struct alignas(std::max_align_t) Chunk {
+        Chunk* next;
+        size_t size;
+    };
+
+    // the rest of the current chunk is abandoned
+    void new_chunk(size_t at_least) {
+        size_t size = _next_size;
+        while (size - sizeof(Chunk) < at_least)
+            size *= 2;
+        Chunk* c = static_cast<Chunk*>(::operator new(size));
+        c->next = _chunks;
+        c->size = size;
+        _chunks = c;
+        _cur = reinterpret_cast<char*>(c + 1);
+        _end = reinterpret_cast<char*>(c) + size;
+        if (_next_size < MaxChunkSize)
+            _next_size *= 2;
+        _count++;
+        _bytes += size;
+    }
+
+    Chunk* _chunks = nullptr;
+    char*  _cur = nullptr;
+    char*  _end = nullptr;
+    size_t _next_size = MinChunkSize;
+    size_t _count = 0;
+    size_t _bytes = 0;
+};
+
+// A standard-conforming allocator on top of MonotonicArena. A default
+// constructed allocator brings its own arena and copies (and rebound copies)
+// share it, as with SlabAllocator. Blocks are packed at alignof(T), so a
+// 40-byte node takes 40 bytes rather than malloc's 48.
+template<typename T>
+class MonotonicAllocator {
+    template<typename U> friend class MonotonicAllocator;
+    std::shared_ptr<MonotonicArena> _arena;
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+    using is_monotonic = std::true_type; // see is_monotonic_allocator
+
+    MonotonicAllocator() : _arena(std::make_shared<MonotonicArena>()) {}
+
+    explicit MonotonicAllocator(std::shared_ptr<MonotonicArena> arena) noexcept : _arena(std::move(arena)) {}
+
+    template<typename U>
+    MonotonicAllocator(const MonotonicAllocator<U>& other) noexcept
+        : _arena(other._arena) {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T))
+            throw std::bad_alloc();
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    const MonotonicArena& arena() const noexcept { return *_arena; }
+
+    template<typename U>
+    friend bool operator==(const MonotonicAllocator& lhs, const MonotonicAllocator<U>& rhs) noexcept {
+        return &lhs.arena() == &rhs.arena();
+    }
+
+    template<typename U>
+    friend bool operator!=(const MonotonicAllocator& lhs, const MonotonicAllocator<U>& rhs) noexcept {
+        return &lhs.arena() != &rhs.arena();
+    }
+};
+
+// true if Alloc's deallocate() is known to be a no-op (Alloc::is_monotonic),
+// so that a container whose nodes need no destructor may drop them all
+// without visiting them
+template<typename Alloc, typename = void>
+struct is_monotonic_allocator : std::false_type {};
+
+template<typename Alloc>
+struct is_monotonic_allocator<Alloc, std::void_t<typename Alloc::is_monotonic>>
+    : Alloc::is_monotonic {};
+
+// whether a container can skip the node walk when dropping nodes of type
+// Node, holding values of type T, allocated through (a rebind of) Alloc
+template<typename Alloc, typename Node, typename T = Node>
+inline constexpr bool drops_without_walk_v = is_monotonic_allocator<Alloc>::value
+    && std::is_trivially_destructible_v<Node> && std::is_trivially_destructible_v<T>;
+
+} // namespace mySymbolTable
+
+#endif // !MONOTONICARENA_H
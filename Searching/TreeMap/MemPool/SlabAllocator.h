@@ -0,0 +1,342 @@
+/*
+ *  size-class slab allocator for node containers
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/MemPool/SlabAllocator.h
+ *
+ *  usage:
+ *      using Alloc = mySymbolTable::SlabAllocator<std::pair<const int, int>>;
+ *      mySymbolTable::RbMap<int, int, std::less<int>, Alloc> st;
+ *
+ *      // several containers on one arena
+ *      auto arena = std::make_shared<mySymbolTable::SlabArena>();
+ *      mySymbolTable::HashSet<int, std::hash<int>, std::equal_to<int>,
+ *                             mySymbolTable::SlabAllocator<int>> s1(mySymbolTable::SlabAllocator<int>{arena}), ...
+ */
+
+#ifndef SLABALLOCATOR_H
+#define SLABALLOCATOR_H 1
+
+#include <memory>      // std::shared_ptr, std::enable_shared_from_this
+#include <new>         // ::operator new, std::bad_alloc
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>     // std::max_align_t
+#include <type_traits> // std::true_type
+#include <utility>     // std::move
+#if defined(__linux__)
+#include <sys/mman.h>  // mmap, madvise
+#endif
+
+namespace mySymbolTable {
+
+// Generalizes the single-size, single-threaded QtMemPool (and SkipListArena)
+// to any node container:
+//  - blocks of up to MaxBlockSize bytes come in 32 size classes, 16 bytes
+//    apart up to 128 and then 4 classes per power of two (at most 25% slack),
+//    carved out of chunks that grow from 64 KiB to 2 MiB; 2 MiB chunks are
+//    mmap'ed on 2 MiB boundaries with MADV_HUGEPAGE so that nodes are
+//    backed by transparent huge pages where the kernel allows it.
+//  - each thread keeps a small cache of free blocks per class and per arena,
+//    refilled from and flushed to the central (mutex-guarded) free lists in
+//    batches, so an allocation or deallocation normally takes no lock.
+//  - all chunks are given back at once when the arena is destroyed, freed
+//    nodes or not. Larger blocks (e.g. bucket arrays) go to ::operator new.
+// Thread caches find their arena again through a weak_ptr, so an arena must
+// be owned by a shared_ptr (as SlabAllocator does) for them to be flushed
+// back at thread exit; otherwise the cached blocks just wait for the arena
+// to go away.
+class SlabArena : public std::enable_shared_from_this<SlabArena> {
+public:
+    static constexpr size_t Granularity = alignof(std::max_align_t);
+    static constexpr size_t NumClasses = 32;
+    static constexpr size_t MaxBlockSize = 8192; // size of the last class
+    static constexpr size_t MinChunkSize = 64 * 1024;
+    static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    SlabArena() : _id(next_id()) {}
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+    ~SlabArena() {
+        for (const Chunk& c : _chunks)
+            release_chunk(c);
+    }
+
+    void* allocate(size_t bytes) {
+        if (bytes > MaxBlockSize)
+            return ::operator new(bytes);
+        size_t cls = size_class(bytes);
+        CacheEntry& e = thread_cache().entry_of(this);
+        if (e.heads[cls] == nullptr)
+            refill(e, cls);
+        FreeBlock* blk = e.heads[cls];
+        e.heads[cls] = blk->next;
+        e.counts[cls]--;
+        return blk;
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (bytes > MaxBlockSize) {
+            ::operator delete(p);
+            return;
+        }
+        size_t cls = size_class(bytes);
+        CacheEntry& e = thread_cache().entry_of(this);
+        FreeBlock* blk = static_cast<FreeBlock*>(p);
+        blk->next = e.heads[cls];
+        e.heads[cls] = blk;
+        if (++e.counts[cls] >= 2 * batch_size(cls))
+            flush(e, cls, batch_size(cls));
+    }
+
+    // # of chunks and their total bytes obtained from the system so far
+    size_t chunk_count() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _chunks.size();
+    }
+
+    size_t reserved_bytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t bytes = 0;
+        for (const Chunk& c : _chunks)
+            bytes += c.size;
+        return bytes;
+    }
+
+    static size_t size_class(size_t bytes) noexcept {
+        if (bytes <= 128)
+            return bytes == 0 ? 0 : (bytes - 1) / 16;
+        size_t lg = floor_log2(bytes - 1); // >= 7
+        return 8 + (lg - 7) * 4 + ((bytes - 1) >> (lg - 2)) - 4;
+    }
+
+    static size_t class_size(size_t cls) noexcept {
+        if (cls < 8)
+            return (cls + 1) * 16;
+        size_t base = size_t(128) << ((cls - 8) / 4);
+        return base + ((cls - 8) % 4 + 1) * (base / 4);
+    }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    struct Chunk {
+        void* p;
+        size_t size;
+        bool mapped;
+    };
+
+    // the free blocks a thread holds for one arena
+    struct CacheEntry {
+        uint64_t id = 0;                 // of the arena, 0 if unused
+        std::weak_ptr<SlabArena> owner;
+        FreeBlock* heads[NumClasses] = {};
+        uint32_t counts[NumClasses] = {};
+    };
+
+    // A thread's caches, direct-mapped by arena id: an arena evicting
+    // another one flushes its blocks back first, if it is still alive.
+    struct ThreadCache {
+        static constexpr size_t Slots = 8;
+        CacheEntry entries[Slots];
+
+        CacheEntry& entry_of(SlabArena* arena) {
+            CacheEntry& e = entries[arena->_id % Slots];
+            if (e.id != arena->_id) {
+                evict(e);
+                e.id = arena->_id;
+                e.owner = arena->weak_from_this();
+            }
+            return e;
+        }
+
+        static void evict(CacheEntry& e) noexcept {
+            if (e.id != 0) {
+                if (auto arena = e.owner.lock()) {
+                    for (size_t cls = 0; cls < NumClasses; cls++)
+                        arena->flush(e, cls, e.counts[cls]);
+                }
+            }
+            e = CacheEntry();
+        }
+
+        ~ThreadCache() {
+            for (CacheEntry& e : entries)
+                evict(e);
+        }
+    };
+
+    static ThreadCache& thread_cache() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    static uint64_t next_id() noexcept {
+        static std::atomic<uint64_t> ids{ 0 };
+        return ++ids;
+    }
+
+    static size_t floor_log2(size_t x) noexcept {
+        size_t lg = 0;
+        while (x >>= 1)
+            lg++;
+        return lg;
+    }
+
+    // blocks moved between a thread cache and the central lists at a time,
+    // about 8 KiB worth
+    static size_t batch_size(size_t cls) noexcept {
+        size_t n = MaxBlockSize / class_size(cls);
+        return n < 2 ? 2 : n > 64 ? 64 : n;
+    }
+
+    // hands a batch of class cls to the thread cache (which is empty)
+    void refill(CacheEntry& e, size_t cls) {
+        size_t want = batch_size(cls), sz = class_size(cls);
+        std::lock_guard<std::mutex> lock(_mutex);
+        FreeBlock* head = _free_lists[cls];
+        size_t n = 0;
+        FreeBlock* tail = nullptr;
+        for (FreeBlock* blk = head; blk != nullptr && n < want; blk = blk->next) {
+            tail = blk;
+            n++;
+        }
+        if (tail != nullptr) {
+            _free_lists[cls] = tail->next;
+            tail->next = nullptr;
+        }
+        // carve the rest out of the current chunk
+        for (; n < want; n++) {
+            if (_left < sz)
+                new_chunk();
+            FreeBlock* blk = reinterpret_cast<FreeBlock*>(_cur);
+            _cur += sz; _left -= sz;
+            blk->next = head;
+            head = blk;
+        }
+        e.heads[cls] = head;
+        e.counts[cls] = static_cast<uint32_t>(n);
+    }
+
+    // gives the first n blocks of class cls of the thread cache back
+    void flush(CacheEntry& e, size_t cls, size_t n) noexcept {
+        if (n == 0)
+            return;
+        FreeBlock* head = e.heads[cls];
+        FreeBlock* tail = head;
+        for (size_t i = 1; i < n; i++)
+            tail = tail->next;
+        e.heads[cls] = tail->next;
+        e.counts[cls] -= static_cast<uint32_t>(n);
+        std::lock_guard<std::mutex> lock(_mutex);
+        tail->next = _free_lists[cls];
+        _free_lists[cls] = head;
+    }
+
+    // precondition: _mutex is held. The tail of the current chunk is
+    // simply abandoned, it's less than a block of the largest class.
+    void new_chunk() {
+        size_t size = _chunks.empty() ? MinChunkSize
+                    : _chunks.back().size < HugePageSize ? 2 * _chunks.back().size
+                    : HugePageSize;
+        Chunk c{ nullptr, size, false };
+#if defined(__linux__)
+        if (size >= HugePageSize) {
+            // over-map by a huge page and trim it to a 2 MiB boundary
+            char* raw = static_cast<char*>(mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE,
+                                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw != MAP_FAILED) {
+                uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+                char* aligned = raw + ((HugePageSize - addr % HugePageSize) % HugePageSize);
+                if (aligned != raw)
+                    munmap(raw, aligned - raw);
+                size_t tail = (raw + size + HugePageSize) - (aligned + size);
+                if (tail != 0)
+                    munmap(aligned + size, tail);
+#if defined(MADV_HUGEPAGE)
+                madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+                c.p = aligned;
+                c.mapped = true;
+            }
+        }
+#endif
+        if (c.p == nullptr)
+            c.p = ::operator new(size);
+        _chunks.push_back(c);
+        _cur = static_cast<char*>(c.p);
+        _left = size;
+    }
+
+    static void release_chunk(const Chunk& c) noexcept {
+#if defined(__linux__)
+        if (c.mapped) {
+            munmap(c.p, c.size);
+            return;
+        }
+#endif
+        ::operator delete(c.p);
+    }
+
+    const uint64_t _id;
+    mutable std::mutex _mutex; // guards the members below
+    std::vector<Chunk> _chunks;
+    FreeBlock* _free_lists[NumClasses] = {};
+    char*  _cur = nullptr;
+    size_t _left = 0;
+};
+
+// A standard-conforming allocator on top of SlabArena. A default constructed
+// allocator brings its own arena, copies (and rebound copies) share it, so
+// every container gets an arena of its own by default; pass an arena to
+// have several containers share one.
+template<typename T>
+class SlabAllocator {
+    template<typename U> friend class SlabAllocator;
+    std::shared_ptr<SlabArena> _arena;
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    static_assert(alignof(T) <= SlabArena::Granularity,
+                  "over-aligned types are not supported by SlabArena");
+
+    SlabAllocator() : _arena(std::make_shared<SlabArena>()) {}
+
+    explicit SlabAllocator(std::shared_ptr<SlabArena> arena) noexcept : _arena(std::move(arena)) {}
+
+    template<typename U>
+    SlabAllocator(const SlabAllocator<U>& other) noexcept
+        : _arena(other._arena) {}
+
+    T* allocate(size_t n) {
+        if (n > size_t(-1) / sizeof(T))
+            throw std::bad_alloc();
+        return static_cast<T*>(_arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        _arena->deallocate(p, n * sizeof(T));
+    }
+
+    const SlabArena& arena() const noexcept { return *_arena; }
+
+    template<typename U>
+    friend bool operator==(const SlabAllocator& lhs, const SlabAllocator<U>& rhs) noexcept {
+        return &lhs.arena() == &rhs.arena();
+    }
+
+    template<typename U>
+    friend bool operator!=(const SlabAllocator& lhs, const SlabAllocator<U>& rhs) noexcept {
+        return &lhs.arena() != &rhs.arena();
+    }
+};
+
+} // namespace mySymbolTable
+
+#endif // !SLABALLOCATOR_H
@@ -0,0 +1,514 @@
+/*
+ *  ordered symbol tables:
+ *  persistent (immutable) AVL map, and a cell to publish its versions
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/PersistentAvlMap.h
+ *
+ *  usage:
+ *      mySymbolTable::AtomicAvlMap<std::string, int> config;
+ *      config.update([](const auto& m) { return m.insert_or_assign("port", 8080); }); // writer
+ *      auto snap = config.snapshot(); // reader, lock-free
+ *      if (auto it = snap.find("port"); it != snap.end()) use(it->second);
+ */
+
+#ifndef PERSISTENTAVLMAP_H
+#define PERSISTENTAVLMAP_H 1
+
+#include <memory>     // std::allocator, std::allocator_traits
+#include <functional> // std::less
+#include <utility>    // std::pair, std::forward, std::move, std::exchange
+#include <iterator>   // std::forward_iterator_tag
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>  // std::out_of_range
+#include <initializer_list>
+#include <cassert>
+
+namespace mySymbolTable {
+
+// Nodes are never modified once built, so a new version shares all but the
+// O(log n) nodes on the updated path with the old one. Nodes are reference
+// counted (atomically, versions may live in different threads), thus any
+// version is a cheap O(1) copy and can be read concurrently with no locks.
+// The map itself is a value: updates return a new map, *this stays intact.
+template<typename Key, typename T, typename Compare = std::less<Key>,
+         typename Alloc = std::allocator<std::pair<const Key, T>>>
+class PersistentAvlMap {
+    struct node;
+    using node_ptr = const node*;
+    using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<node>;
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+    class const_iterator;
+    using iterator = const_iterator;
+
+    /* I */
+
+    PersistentAvlMap() = default;
+
+    explicit PersistentAvlMap(const Compare& comp, const Alloc& alloc = Alloc())
+        : _comp(comp), _alloc(alloc) {}
+
+    /* II */
+
+    PersistentAvlMap(std::initializer_list<value_type> init, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _comp(comp), _alloc(alloc)
+    {
+        for (const auto& val : init)
+            *this = insert(val.first, val.second);
+    }
+
+    /* III */
+
+    // O(1), the two maps share all their nodes
+    PersistentAvlMap(const PersistentAvlMap& other)
+        : _root(acquire(other._root)), _count(other._count), _comp(other._comp), _alloc(other._alloc) {}
+
+    PersistentAvlMap(PersistentAvlMap&& other) noexcept
+        : _root(other._root), _count(other._count), _comp(other._comp), _alloc(other._alloc)
+    {
+        other._root = nullptr;
+        other._count = 0;
+    }
+
+    PersistentAvlMap& operator=(PersistentAvlMap rhs) noexcept {
+        swap(rhs);
+        return *this;
+    }
+
+    ~PersistentAvlMap() { release(_root); }
+
+    /* iterators */
+
+    const_iterator begin() const { return const_iterator(_root); }
+    const_iterator end() const noexcept { return const_iterator(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    /* capacity */
+
+    bool empty() const noexcept { return _count == 0; }
+
+    size_t size() const noexcept { return _count; }
+
+    /* lookup */
+
+    const_iterator find(const Key& key) const {
+        const_iterator it;
+        for (node_ptr x = _root; x != nullptr; ) {
+            if (_comp(key, x->_val.first)) {
+                it._stack.push_back(x);
+                x = x->_left;
+            }
+            else if (_comp(x->_val.first, key)) x = x->_right;
+            else {
+                it._stack.push_back(x);
+                return it;
+            }
+        }
+        return end();
+    }
+
+    // like find() but without building an iterator, nullptr if not found
+    const T* lookup(const Key& key) const {
+        node_ptr x = find_node(key);
+        return x ? &x->_val.second : nullptr;
+    }
+
+    bool contains(const Key& key) const { return find_node(key) != nullptr; }
+
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    const T& at(const Key& key) const {
+        node_ptr x = find_node(key);
+        if (x == nullptr) throw std::out_of_range("PersistentAvlMap<K, T> key does not exist");
+        return x->_val.second;
+    }
+
+    /* modifiers, all of them leave *this unchanged */
+
+    // a new version with {key, obj} added, or *this if key already exists
+    template<typename M>
+    [[nodiscard]] PersistentAvlMap insert(const Key& key, M&& obj) const {
+        return update_aux(key, std::forward<M>(obj), /*assign=*/false);
+    }
+
+    // a new version with {key, obj} added or key's value replaced by obj
+    template<typename M>
+    [[nodiscard]] PersistentAvlMap insert_or_assign(const Key& key, M&& obj) const {
+        return update_aux(key, std::forward<M>(obj), /*assign=*/true);
+    }
+
+    // a new version without key
+    [[nodiscard]] PersistentAvlMap erase(const Key& key) const {
+        bool erased = false;
+        node_ptr root = erase_aux(_root, key, erased);
+        if (!erased) return *this;
+        return PersistentAvlMap(root, _count - 1, _comp, _alloc);
+    }
+
+    void clear() noexcept {
+        release(_root);
+        _root = nullptr;
+        _count = 0;
+    }
+
+    void swap(PersistentAvlMap& rhs) noexcept {
+        std::swap(_root, rhs._root);
+        std::swap(_count, rhs._count);
+        std::swap(_comp, rhs._comp);
+        std::swap(_alloc, rhs._alloc);
+    }
+
+    /* observers */
+
+    key_compare key_comp() const { return _comp; }
+
+    allocator_type get_allocator() const { return allocator_type(_alloc); }
+
+    // whether two maps are the very same version
+    bool shares_root_with(const PersistentAvlMap& other) const noexcept {
+        return _root == other._root;
+    }
+
+    /* tree height interface */
+
+    int height() const noexcept { return height(_root); }
+
+#ifndef NDEBUG
+    /* debug */
+
+    bool is_balanced() const {
+        size_t n = 0;
+        return check(_root, nullptr, nullptr, n) >= 0 && n == _count;
+    }
+#endif
+
+    class const_iterator {
+        friend class PersistentAvlMap;
+        // the path of nodes whose left subtree we're in, the top is current
+        std::vector<node_ptr> _stack;
+
+        void push_leftmost(node_ptr x) {
+            for (; x != nullptr; x = x->_left)
+                _stack.push_back(x);
+        }
+
+        explicit const_iterator(node_ptr root) { push_leftmost(root); }
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename PersistentAvlMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return _stack.back()->_val; }
+        pointer operator->() const { return &_stack.back()->_val; }
+
+        const_iterator& operator++() {
+            node_ptr x = _stack.back();
+            _stack.pop_back();
+            push_leftmost(x->_right);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            if (lhs._stack.empty() || rhs._stack.empty())
+                return lhs._stack.empty() && rhs._stack.empty();
+            return lhs._stack.back() == rhs._stack.back();
+        }
+
+        friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+    };
+
+private:
+    struct node {
+        mutable std::atomic<size_t> _refs{ 1 };
+        node_ptr _left, _right; // owned references
+        int _height;
+        value_type _val;
+
+        template<typename... Args>
+        node(node_ptr left, node_ptr right, Args&&... args)
+            : _left(left), _right(right),
+              _height(1 + max(PersistentAvlMap::height(left), PersistentAvlMap::height(right))),
+              _val(std::forward<Args>(args)...) {}
+    };
+
+    // takes over the reference of `root`
+    PersistentAvlMap(node_ptr root, size_t count, const Compare& comp, const NodeAl& alloc)
+        : _root(root), _count(count), _comp(comp), _alloc(alloc) {}
+
+    static node_ptr acquire(node_ptr x) noexcept {
+        if (x) x->_refs.fetch_add(1, std::memory_order_relaxed);
+        return x;
+    }
+
+    // drop a reference, destroying nodes that are no longer shared
+    void release(node_ptr x) const noexcept {
+        while (x && x->_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            node_ptr left = x->_left, right = x->_right;
+            node* p = const_cast<node*>(x);
+            p->~node();
+            _alloc.deallocate(p, 1);
+            release(left);
+            x = right; // loop rather than recurse on one side
+        }
+    }
+
+    // the new node takes over the references of left and right
+    template<typename... Args>
+    node_ptr new_node(node_ptr left, node_ptr right, Args&&... args) const {
+        node* p = _alloc.allocate(1);
+        try {
+            ::new ((void*)p) node(left, right, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            _alloc.deallocate(p, 1);
+            release(left);
+            release(right);
+            throw;
+        }
+        return p;
+    }
+
+    // a copy of x with new children
+    node_ptr copy_with(node_ptr x, node_ptr left, node_ptr right) const {
+        return new_node(left, right, x->_val);
+    }
+
+    static int height(node_ptr x) noexcept { return x ? x->_height : 0; }
+
+    static int max(int a, int b) noexcept { return a > b ? a : b; }
+
+    node_ptr find_node(const Key& key) const {
+        node_ptr x = _root;
+        while (x != nullptr) {
+            if      (_comp(key, x->_val.first)) x = x->_left;
+            else if (_comp(x->_val.first, key)) x = x->_right;
+            else return x;
+        }
+        return nullptr;
+    }
+
+    // A node made of x's value and the given (owned) subtrees, rebalanced
+    // with new nodes if they differ in height by 2. `x` itself is untouched.
+    // Like new_node(), it takes over l and r even if it throws.
+    node_ptr balance(node_ptr x, node_ptr l, node_ptr r) const {
+        int hl = height(l), hr = height(r);
+        if (hl <= hr + 1 && hr <= hl + 1)
+            return copy_with(x, l, r);
+        // references not handed over yet, released if anything throws
+        node_ptr tall = hl > hr ? l : r, other = hl > hr ? r : l, a = nullptr;
+        try {
+            node_ptr t;
+            if (tall == l) {
+                if (height(l->_left) >= height(l->_right)) { // single right rotation
+                    t = copy_with(x, acquire(l->_right), std::exchange(other, nullptr));
+                    t = copy_with(l, acquire(l->_left), t);
+                }
+                else { // left-right double rotation
+                    node_ptr lr = l->_right;
+                    a = copy_with(l, acquire(l->_left), acquire(lr->_left));
+                    t = copy_with(x, acquire(lr->_right), std::exchange(other, nullptr));
+                    t = copy_with(lr, std::exchange(a, nullptr), t);
+                }
+            }
+            else {
+                if (height(r->_right) >= height(r->_left)) { // single left rotation
+                    t = copy_with(x, std::exchange(other, nullptr), acquire(r->_left));
+                    t = copy_with(r, t, acquire(r->_right));
+                }
+                else { // right-left double rotation
+                    node_ptr rl = r->_left;
+                    a = copy_with(x, std::exchange(other, nullptr), acquire(rl->_left));
+                    t = copy_with(r, acquire(rl->_right), acquire(r->_right));
+                    t = copy_with(rl, std::exchange(a, nullptr), t);
+                }
+            }
+            release(tall);
+            return t;
+        }
+        catch (...) {
+            release(a);
+            release(other);
+            release(tall);
+            throw;
+        }
+    }
+
+    template<typename M>
+    PersistentAvlMap update_aux(const Key& key, M&& obj, bool assign) const {
+        int change = 0; // 0: nothing, 1: assigned, 2: inserted
+        node_ptr root = insert_aux(_root, key, obj, assign, change);
+        if (change == 0) return *this;
+        return PersistentAvlMap(root, _count + (change == 2), _comp, _alloc);
+    }
+
+    // returns an owned reference to the new subtree, or nullptr if unchanged
+    template<typename M>
+    node_ptr insert_aux(node_ptr x, const Key& key, M& obj, bool assign, int& change) const {
+        if (x == nullptr) {
+            change = 2;
+            return new_node(nullptr, nullptr, key, obj);
+        }
+        if (_comp(key, x->_val.first)) {
+            node_ptr l = insert_aux(x->_left, key, obj, assign, change);
+            return l ? balance(x, l, acquire(x->_right)) : nullptr;
+        }
+        if (_comp(x->_val.first, key)) {
+            node_ptr r = insert_aux(x->_right, key, obj, assign, change);
+            return r ? balance(x, acquire(x->_left), r) : nullptr;
+        }
+        if (!assign) return nullptr;
+        change = 1;
+        return new_node(acquire(x->_left), acquire(x->_right), key, obj);
+    }
+
+    // returns an owned reference to the new subtree (unspecified if not erased)
+    node_ptr erase_aux(node_ptr x, const Key& key, bool& erased) const {
+        if (x == nullptr) return nullptr;
+        if (_comp(key, x->_val.first)) {
+            node_ptr l = erase_aux(x->_left, key, erased);
+            return erased ? balance(x, l, acquire(x->_right)) : nullptr;
+        }
+        if (_comp(x->_val.first, key)) {
+            node_ptr r = erase_aux(x->_right, key, erased);
+            return erased ? balance(x, acquire(x->_left), r) : nullptr;
+        }
+        erased = true;
+        if (x->_left == nullptr) return acquire(x->_right);
+        if (x->_right == nullptr) return acquire(x->_left);
+        // replace x with its successor
+        node_ptr succ = x->_right;
+        while (succ->_left) succ = succ->_left;
+        node_ptr r = erase_min(x->_right);
+        return balance(succ, acquire(x->_left), r);
+    }
+
+    // returns an owned reference to x without its minimum
+    node_ptr erase_min(node_ptr x) const {
+        if (x->_left == nullptr) return acquire(x->_right);
+        node_ptr l = erase_min(x->_left);
+        return balance(x, l, acquire(x->_right));
+    }
+
+#ifndef NDEBUG
+    // height of x if it's a valid AVL tree with keys in (lo, hi), -1 otherwise
+    int check(node_ptr x, const Key* lo, const Key* hi, size_t& n) const {
+        if (x == nullptr) return 0;
+        ++n;
+        const Key& key = x->_val.first;
+        if ((lo && !_comp(*lo, key)) || (hi && !_comp(key, *hi))) return -1;
+        int hl = check(x->_left, lo, &key, n), hr = check(x->_right, &key, hi, n);
+        if (hl < 0 || hr < 0 || hl - hr > 1 || hr - hl > 1) return -1;
+        if (x->_height != 1 + max(hl, hr) || x->_refs.load() == 0) return -1;
+        return x->_height;
+    }
+#endif
+
+    node_ptr _root = nullptr;
+    size_t   _count = 0;
+    Compare  _comp{};
+    mutable NodeAl _alloc{}; // versions are const, yet allocate new ones
+};
+
+template<typename Key, typename T, typename Compare, typename Alloc>
+void swap(PersistentAvlMap<Key, T, Compare, Alloc>& lhs,
+          PersistentAvlMap<Key, T, Compare, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// Holds the current version of a PersistentAvlMap. Readers grab it with
+// snapshot(), which is lock-free and O(1), and keep it as long as they like;
+// writers are serialized and publish a new version with a single atomic
+// pointer swap.
+//
+// The only unsafe moment is between loading the root and taking a reference
+// on it, so readers announce themselves in `_readers` around those two
+// steps. A replaced root is retired rather than released right away, and
+// retired ones are released once a writer sees no reader in that window
+// after the swap (any later reader can only load a newer root).
+template<typename Key, typename T, typename Compare = std::less<Key>,
+         typename Alloc = std::allocator<std::pair<const Key, T>>>
+class AtomicAvlMap {
+public:
+    using map_type = PersistentAvlMap<Key, T, Compare, Alloc>;
+
+    AtomicAvlMap() : AtomicAvlMap(map_type()) {}
+
+    explicit AtomicAvlMap(map_type init) : _current(new map_type(std::move(init))) {}
+
+    AtomicAvlMap(const AtomicAvlMap&) = delete;
+    AtomicAvlMap& operator=(const AtomicAvlMap&) = delete;
+
+    ~AtomicAvlMap() {
+        delete _current.load();
+        for (map_type* m : _retired)
+            delete m;
+    }
+
+    // the current version
+    map_type snapshot() const {
+        _readers.fetch_add(1);
+        map_type m(*_current.load()); // just a reference count increment
+        _readers.fetch_sub(1);
+        return m;
+    }
+
+    void publish(map_type m) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        publish_locked(std::move(m));
+    }
+
+    // publish f(current version), atomically w.r.t. other writers
+    template<typename F>
+    void update(F&& f) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        publish_locked(f(*_current.load()));
+    }
+
+    // # of replaced versions still waiting for readers to leave
+    size_t retired_count() const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _retired.size();
+    }
+
+private:
+    void publish_locked(map_type m) {
+        map_type* old = _current.exchange(new map_type(std::move(m)));
+        _retired.push_back(old);
+        if (_readers.load() == 0) {
+            for (map_type* r : _retired)
+                delete r;
+            _retired.clear();
+        }
+    }
+
+    std::atomic<map_type*> _current;
+    mutable std::atomic<size_t> _readers{ 0 };
+    mutable std::mutex _mtx;
+    std::vector<map_type*> _retired; // guarded by _mtx
+};
+
+} // namespace mySymbolTable
+
+#endif // !PERSISTENTAVLMAP_H
@@ -12,26 +12,32 @@
 #include <type_traits> // std::enable_if
 #include <memory>   // std::addressof, std::allocator_tarits
 #include <utility>  // std::swap, std::pair
-#include <iterator> // std::reverse_iterator, std::distance
+#include <iterator> // std::reverse_iterator, std::distance, std::next
 #ifndef NDEBUG
 #include <iostream> // std::cout
 #include <string>
 #endif
 #include <cassert>
 #include "my_map_traits.h"  // myst::get_map_key_t
+#include "tree_policy.h"    // myst::null_node_update, myst::order_statistics_node_update
+#include "fork_join_pool.h" // myst::ForkJoinPool
+#include "batch_lookup.h"   // myst::interleave_lookups
 
 namespace mySymbolTable {
 
 enum class RBtree_color { red, black };
 
 // Red-black binary search trees, an isometry of 2-3-4 trees
-template<typename T, typename Compare, typename Alloc, bool IsMap, bool IsMulti>
+template<typename T, typename Compare, typename Alloc, bool IsMap, bool IsMulti,
+         typename NodeUpdate = null_node_update>
 class RBtree {
     struct RBtree_node;
     class RBtree_iter;
     class RBtree_const_iter;
-    using _self = RBtree<T, Compare, Alloc, IsMap, IsMulti>;
-    using node = RBtree_node;
+    using _self = RBtree<T, Compare, Alloc, IsMap, IsMulti, NodeUpdate>;
+    struct RBtree_compact_node;
+    static constexpr bool Compact = is_compact_layout_v<NodeUpdate>;
+    using node = std::conditional_t<Compact, RBtree_compact_node, RBtree_node>;
     using node_ptr = node*;
     using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<node>;
 public:
@@ -46,7 +52,8 @@ public:
     using const_iterator = RBtree_const_iter;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-    using node_type = RBtree_node;
+    using node_type = node;
+    using metadata_type = typename node_update_metadata<NodeUpdate>::type;
 
 private:
     // _header->_parent points to root node
@@ -58,6 +65,10 @@ private:
     Compare  _comp;
     NodeAl   _alloc;
 
+    static constexpr bool OrderStatistics = has_order_statistics_v<NodeUpdate>;
+    static constexpr bool Augmented = has_metadata_v<NodeUpdate>;
+    using Policy = typename remove_node_layout<NodeUpdate>::type;
+
 #define ROOT _header->_parent
 
     void set_default_header() noexcept {
@@ -69,8 +80,10 @@ private:
     // create & initialize the header node
     void create_header() {
         _header = _alloc.allocate(1); // may throw
+        if constexpr (Compact) // assignments keep the tag bit, so set it up first
+            ::new ((void*)std::addressof(_header->_parent)) tagged_parent<node, 1>();
         set_default_header();
-        _header->_color = RBtree_color::red;
+        color(_header) = RBtree_color::red;
         // leave the value field uninitialized
     }
 
@@ -200,6 +213,14 @@ public:
         return find(ROOT, key) != _header;
     }
 
+    // Writes find(key) of each key in the range to out[0], out[1], ... (a
+    // random access iterator to const_iterators), running the lookups
+    // interleaved so that their cache misses overlap, see batch_lookup.h.
+    template<typename KeyRange, typename RandomIt>
+    void find_batch(const KeyRange& keys, RandomIt out) const {
+        interleave_lookups(find_probe{ this }, std::begin(keys), std::end(keys), out);
+    }
+
     iterator lower_bound(const key_type& key) {
         return iterator(lower_bound(ROOT, key));
     }
@@ -224,6 +245,58 @@ public:
         return equal_range_aux(key);
     }
 
+    /* order statistics (order_statistics_node_update only) */
+
+    // # of elements less than key
+    size_t rank(const key_type& key) const {
+        static_assert(OrderStatistics, "rank() requires order_statistics_node_update");
+        return rank_aux</*Upper=*/false>(key);
+    }
+
+    // # of elements not greater than key
+    size_t upper_rank(const key_type& key) const {
+        static_assert(OrderStatistics, "upper_rank() requires order_statistics_node_update");
+        return rank_aux</*Upper=*/true>(key);
+    }
+
+    // the k-th (0-based) smallest element, end() if k >= size()
+    iterator select(size_t k) {
+        static_assert(OrderStatistics, "select() requires order_statistics_node_update");
+        return iterator(select_aux(k));
+    }
+
+    const_iterator select(size_t k) const {
+        static_assert(OrderStatistics, "select() requires order_statistics_node_update");
+        return const_iterator(select_aux(k));
+    }
+
+    // # of elements in [lo, hi]
+    size_t count_range(const key_type& lo, const key_type& hi) const {
+        static_assert(OrderStatistics, "count_range() requires order_statistics_node_update");
+        if (_comp(hi, lo)) return 0;
+        return rank_aux</*Upper=*/true>(hi) - rank_aux</*Upper=*/false>(lo);
+    }
+
+    /* augmentation (NodeUpdate with a metadata_type, see tree_policy.h) */
+
+    // summary of the elements with keys in [lo, hi), in O(log n)
+    metadata_type fold(const key_type& lo, const key_type& hi) const {
+        static_assert(Augmented, "fold() requires a NodeUpdate with a metadata_type");
+        return fold_aux(lo, hi);
+    }
+
+    // summary of all elements
+    metadata_type fold() const {
+        static_assert(Augmented, "fold() requires a NodeUpdate with a metadata_type");
+        return empty() ? Policy::identity() : ROOT->_meta;
+    }
+
+    // Brings the summaries up to date after the element at pos was
+    // changed in place (e.g. through operator[]) in a way that matters.
+    void refresh(const_iterator pos) noexcept {
+        update_path(pos.ptr());
+    }
+
     /* modifiers */
 
     void clear() noexcept {
@@ -234,8 +307,8 @@ public:
 
     std::conditional_t<!IsMulti, std::pair<iterator, bool>, iterator>
     insert(const T& val) {
-        if constexpr (!IsMulti) return insert_aux(&ROOT, val);
-        else return insert_aux(&ROOT, val).first;
+        if constexpr (!IsMulti) return insert_aux(val);
+        else return insert_aux(val).first;
     }
 
 private:
@@ -244,7 +317,7 @@ private:
         if (hint == _header) { // end()
             if (_comp(get_key(_header->_right), key)) // max < key
                 return insert_leaf_at(&_header->_right->_right, val, _header->_right);
-            else return insert_aux(&ROOT, val).first;
+            else return insert_aux(val).first;
         }
         else if (_comp(key, get_key(hint))) { // key < hint
             if (hint == _header->_left) // key < min
@@ -256,7 +329,7 @@ private:
                 else // otherwise hint->_left is null
                     return insert_leaf_at(&hint->_left, val, hint);
             }
-            return insert_aux(&ROOT, val).first;
+            return insert_aux(val).first;
         }
         else if (_comp(get_key(hint), key)) { // hint < key
             if (hint == _header->_right) // max < key
@@ -268,7 +341,7 @@ private:
                 else // otherwise hint->_right is null
                     return insert_leaf_at(&hint->_right, val, hint);
             }
-            return insert_aux(&ROOT, val).first;
+            return insert_aux(val).first;
         }
         else // equivalent keys
             return iterator(hint);
@@ -279,7 +352,7 @@ private:
         if (hint == _header) { // end()
             if (!_comp(key, get_key(_header->_right))) // key >= max
                 return insert_leaf_at(&_header->_right->_right, val, _header->_right);
-            else return insert_aux(&ROOT, val).first;
+            else return insert_aux(val).first;
         }
         else if (!_comp(get_key(hint), key)) { // key <= hint
             if (hint == _header->_left) // key <= min
@@ -291,7 +364,7 @@ private:
                 else // otherwise hint->_left is null
                     return insert_leaf_at(&hint->_left, val, hint);
             }
-            return insert_aux(&ROOT, val).first;
+            return insert_aux(val).first;
         }
         else { // hint < key
             if (hint == _header->_right) // max < key
@@ -303,7 +376,7 @@ private:
                 else // otherwise hint->_right is null
                     return insert_leaf_at(&hint->_right, val, hint);
             }
-            return insert_aux(&ROOT, val).first;
+            return insert_aux(val).first;
         }
     }
 
@@ -312,7 +385,7 @@ public:
     // Complexity: Amortized constant if the insertion happens in the position
     // just before the hint, logarithmic in the size of the container otherwise.
     iterator insert(const_iterator hint, const T& val) {
-        if (empty()) return insert_leaf_at(&ROOT, val, _header);
+        if (empty()) return insert_leaf_at(nullptr, val, _header);
         if constexpr (!IsMulti)
             return insert_hint_unique(hint.ptr(), val);
         else
@@ -321,8 +394,19 @@ public:
 
     template< typename InputIt >
     void insert(InputIt first, InputIt last) {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        using iter_key = std::remove_cv_t<std::remove_reference_t<decltype(key_of(*first))>>;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category> &&
+                      std::is_same_v<iter_key, std::remove_cv_t<key_type>>) {
+            if (empty() && is_sorted_range(first, last)) {
+                assign_sorted(first, last);
+                return;
+            }
+        }
+        // appending to the back costs only one comparison with the max,
+        // otherwise it falls back to the normal insertion
         while (first != last) {
-            insert(*first++);
+            insert(cend(), *first++);
         }
     }
 
@@ -330,9 +414,54 @@ public:
         return insert(ilist.begin(), ilist.end());
     }
 
+    // Replaces the contents with the sorted range [first, last), building
+    // a perfectly balanced tree bottom-up in linear time. For unique
+    // containers only the first of equivalent elements is kept.
+    template< typename InputIt >
+    void assign_sorted(InputIt first, InputIt last) {
+        clear();
+        // chain the nodes through _right first, then shape them into a tree
+        node_ptr head = nullptr, tail = nullptr;
+        size_t n = 0;
+        try {
+            for (; first != last; ++first) {
+                node_ptr x = new_node(*first, RBtree_color::black, nullptr);
+                if (tail) {
+                    assert(!_comp(get_key(x), get_key(tail)) && "range must be sorted");
+                    if (!IsMulti && !_comp(get_key(tail), get_key(x))) {
+                        delete_node(x);
+                        continue;
+                    }
+                    tail->_right = x;
+                }
+                else head = x;
+                tail = x;
+                ++n;
+            }
+        }
+        catch (...) {
+            while (head) {
+                node_ptr next = head->_right;
+                delete_node(head);
+                head = next;
+            }
+            throw;
+        }
+        if (n == 0) return;
+        // a perfectly balanced tree is a valid red-black tree if all nodes
+        // on its bottom level are red, unless that level is full
+        int red_depth = (n & (n + 1)) == 0 ? -1 : floor_log2(n);
+        node_ptr list = head;
+        ROOT = build_sorted(list, n, 0, red_depth);
+        ROOT->_parent = _header;
+        _header->_left  = head;
+        _header->_right = tail;
+        _count = n;
+    }
+
 protected:
     std::pair<iterator, bool> insert_or_assign(const T& val) {
-        return insert_aux(&ROOT, val, /*assign=*/true);
+        return insert_aux(val, /*assign=*/true);
     }
 
 public:
@@ -383,6 +512,68 @@ public:
         std::swap(_comp, rhs._comp);
     }
 
+    /* join-based bulk operations */
+
+    // Below, nodes are moved between trees rather than copied, so `rhs` must
+    // use the same allocator and it's left empty. The set operations take
+    // O(m log(n/m + 1)) time, m <= n being the sizes of the two trees, and
+    // split the work among the threads of ForkJoinPool::instance() for large
+    // trees, thus the allocator must be thread-safe (std::allocator is).
+
+    // append rhs, whose elements must all be greater than
+    // (for multi containers, not less than) those in *this
+    void join(_self&& rhs) {
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        if (rhs.empty()) return;
+        assert(empty() || (IsMulti ? !_comp(get_key(rhs._header->_left), get_key(_header->_right))
+                                   :  _comp(get_key(_header->_right), get_key(rhs._header->_left))));
+        size_t n = _count + rhs._count;
+        subtree t = join2(detach(), rhs.detach());
+        adopt(t, n);
+    }
+
+    // move all elements not less than key into `right` (its old elements are destroyed).
+    // O(log(n)) with order_statistics_node_update, otherwise O(n) as the
+    // nodes of the left half are counted to keep size() exact
+    void split(const key_type& key, _self& right) {
+        assert(_alloc == right._alloc && "allocator must be the same");
+        right.clear();
+        if (empty()) return;
+        size_t n = _count;
+        node_ptr found = nullptr;
+        split_result r = split_aux(detach(), key, found);
+        if (found) r.right = join_aux({ nullptr, 0 }, found, r.right);
+        adopt(r.left, count_nodes(r.left.root));
+        right.adopt(r.right, n - _count);
+    }
+
+    // *this = *this U rhs, values of *this win for equivalent keys
+    void set_union(_self&& rhs) {
+        static_assert(!IsMulti, "set operations require unique keys");
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        size_t n = _count + rhs._count, dropped = 0;
+        subtree t = union_aux(detach(), rhs.detach(), n, dropped);
+        adopt(t, n - dropped);
+    }
+
+    // *this = *this ^ rhs
+    void set_intersection(_self&& rhs) {
+        static_assert(!IsMulti, "set operations require unique keys");
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        size_t n = _count + rhs._count, dropped = 0;
+        subtree t = intersection_aux(detach(), rhs.detach(), n, dropped);
+        adopt(t, n - dropped);
+    }
+
+    // *this = *this - rhs
+    void set_difference(_self&& rhs) {
+        static_assert(!IsMulti, "set operations require unique keys");
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        size_t n = _count + rhs._count, dropped = 0;
+        subtree t = difference_aux(detach(), rhs.detach(), n, dropped);
+        adopt(t, n - dropped);
+    }
+
     /* tree height interface */
 
     // tree height (height of root),  i.e. the number of
@@ -407,8 +598,34 @@ private:
         return a > b ? a : b;
     }
 
+    // reference to the color of x, in the compact layout
+    // it's the tag bit of x's parent link (1: red)
+    class color_ref {
+        tagged_parent<node, 1>* _link;
+    public:
+        explicit color_ref(tagged_parent<node, 1>* link) noexcept : _link(link) {}
+
+        operator RBtree_color() const noexcept {
+            return _link->tag() ? RBtree_color::red : RBtree_color::black;
+        }
+
+        color_ref& operator=(RBtree_color c) noexcept {
+            _link->set_tag(c == RBtree_color::red);
+            return *this;
+        }
+
+        color_ref& operator=(const color_ref& rhs) noexcept {
+            return *this = static_cast<RBtree_color>(rhs);
+        }
+    };
+
+    static decltype(auto) color(node_ptr x) noexcept {
+        if constexpr (Compact) return color_ref(&x->_parent);
+        else return (x->_color);
+    }
+
     static bool is_red(node_ptr x) noexcept {
-        return x->_color == RBtree_color::red;
+        return color(x) == RBtree_color::red;
     }
 
 #ifndef NDEBUG
@@ -422,10 +639,21 @@ public:
 
     bool is_rb_tree() const {
         if (_count < 3) return true;
+        if constexpr (OrderStatistics) {
+            if (checked_size(ROOT) != _count) return false;
+        }
         return are_colors_ok(ROOT) && is_balanced(ROOT);
     }
 
 private:
+    // returns the actual size of x's subtree, or size_t(-1) if any is wrong
+    static size_t checked_size(node_ptr x) {
+        if (x == nullptr) return 0;
+        size_t l = checked_size(x->_left), r = checked_size(x->_right);
+        if (l == size_t(-1) || r == size_t(-1) || x->_size != l + r + 1) return size_t(-1);
+        return x->_size;
+    }
+
     static bool are_colors_ok(node_ptr x) {
         if (x == nullptr) return true;
         if (is_red(x) && ((x->_left && is_red(x->_left)) || (x->_right && is_red(x->_right))))
@@ -507,6 +735,7 @@ private:
             _alloc.deallocate(p, 1);
             throw;
         }
+        if constexpr (Augmented) update_node(p);
         return p;
     }
 
@@ -517,7 +746,9 @@ private:
 
     node_ptr copy_nodes(node_ptr x, node_ptr parent) {
         if (x != nullptr) {
-            node_ptr t = new_node(x->_val, x->_color, parent);
+            node_ptr t = new_node(x->_val, color(x), parent);
+            if constexpr (OrderStatistics) t->_size = x->_size;
+            if constexpr (Augmented) t->_meta = x->_meta;
             t->_left  = copy_nodes(x->_left,  t);
             t->_right = copy_nodes(x->_right, t);
             return t;
@@ -572,6 +803,38 @@ private:
         return _header; // end(), not found
     }
 
+    // find(ROOT, key) one level at a time, for find_batch()
+    struct find_probe {
+        const RBtree* _tree;
+
+        struct state_type {
+            node_ptr x;
+            const key_type* key;
+        };
+        using result_type = const_iterator;
+
+        bool start(const key_type& key, state_type& s) const {
+            s = { _tree->ROOT, &key };
+            if (s.x == _tree->_header) return false; // empty
+            batch_prefetch(s.x);
+            return true;
+        }
+
+        bool step(state_type& s) const {
+            if      (_tree->_comp(*s.key, get_key(s.x))) s.x = s.x->_left;
+            else if (_tree->_comp(get_key(s.x), *s.key)) s.x = s.x->_right;
+            else return false;
+            if (s.x == nullptr) {
+                s.x = _tree->_header; // end(), not found
+                return false;
+            }
+            batch_prefetch(s.x);
+            return true;
+        }
+
+        result_type result(const state_type& s) const { return const_iterator(s.x); }
+    };
+
     std::pair<node_ptr, node_ptr> equal_range_aux(const key_type& key) const {
         if constexpr (!IsMulti) {
             const_iterator first = lower_bound(key), second = first;
@@ -609,6 +872,118 @@ private:
         return parent; // _header if not found
     }
 
+    template<bool Upper>
+    size_t rank_aux(const key_type& key) const {
+        if (empty()) return 0;
+        size_t r = 0;
+        for (node_ptr x = ROOT; x != nullptr; ) {
+            if (Upper ? !_comp(key, get_key(x)) : _comp(get_key(x), key)) {
+                r += subtree_size(x->_left) + 1;
+                x = x->_right;
+            }
+            else x = x->_left;
+        }
+        return r;
+    }
+
+    node_ptr select_aux(size_t k) const {
+        if (k >= _count) return _header;
+        node_ptr x = ROOT;
+        for (;;) {
+            size_t left = subtree_size(x->_left);
+            if (k < left) x = x->_left;
+            else if (k == left) return x;
+            else {
+                k -= left + 1;
+                x = x->_right;
+            }
+        }
+    }
+
+    static size_t subtree_size(node_ptr x) noexcept {
+        return x ? x->_size : 0;
+    }
+
+    // recompute x's subtree size (summary) from its children
+    static void update_node(node_ptr x) noexcept {
+        if constexpr (OrderStatistics)
+            x->_size = 1 + subtree_size(x->_left) + subtree_size(x->_right);
+        if constexpr (Augmented) {
+            x->_meta = Policy::from_value(x->_val);
+            if (x->_left ) x->_meta = Policy::combine(x->_left->_meta, x->_meta);
+            if (x->_right) x->_meta = Policy::combine(x->_meta, x->_right->_meta);
+        }
+    }
+
+    // add `delta` (+1/-1) to the sizes of x and all its ancestors
+    void adjust_sizes_upwards(node_ptr x, int delta) noexcept {
+        if constexpr (OrderStatistics) {
+            for (; x != _header; x = x->_parent)
+                x->_size += delta;
+        }
+    }
+
+    // recompute the summaries of x and all its ancestors
+    void update_path(node_ptr x) noexcept {
+        if constexpr (Augmented) {
+            for (; x != _header; x = x->_parent)
+                update_node(x);
+        }
+    }
+
+    static metadata_type subtree_fold(node_ptr x) {
+        return x ? x->_meta : Policy::identity();
+    }
+
+    // Find the topmost node within [lo, hi), then the range is the part of
+    // its left subtree not less than lo, itself and the part of its right
+    // subtree less than hi. Going down towards lo, every node within the
+    // range comes with its whole right subtree, and symmetrically for hi.
+    metadata_type fold_aux(const key_type& lo, const key_type& hi) const {
+        node_ptr x = empty() ? nullptr : ROOT;
+        while (x != nullptr) {
+            if      (_comp(get_key(x), lo)) x = x->_right;
+            else if (!_comp(get_key(x), hi)) x = x->_left;
+            else break;
+        }
+        if (x == nullptr) return Policy::identity();
+        metadata_type left = Policy::identity(), right = Policy::identity();
+        for (node_ptr y = x->_left; y != nullptr; ) {
+            if (_comp(get_key(y), lo)) y = y->_right;
+            else {
+                left = Policy::combine(Policy::combine(Policy::from_value(y->_val), subtree_fold(y->_right)), left);
+                y = y->_left;
+            }
+        }
+        for (node_ptr y = x->_right; y != nullptr; ) {
+            if (!_comp(get_key(y), hi)) y = y->_left;
+            else {
+                right = Policy::combine(right, Policy::combine(subtree_fold(y->_left), Policy::from_value(y->_val)));
+                y = y->_right;
+            }
+        }
+        return Policy::combine(Policy::combine(left, Policy::from_value(x->_val)), right);
+    }
+
+protected:
+    // Walking an augmented tree, for the containers built on one (e.g.
+    // IntervalMap): a null const_iterator stands for an empty subtree.
+    const_iterator root_node() const noexcept {
+        return const_iterator(empty() ? nullptr : ROOT);
+    }
+
+    static const_iterator left_child(const_iterator pos) noexcept {
+        return const_iterator(pos.ptr()->_left);
+    }
+
+    static const_iterator right_child(const_iterator pos) noexcept {
+        return const_iterator(pos.ptr()->_right);
+    }
+
+    static const metadata_type& subtree_metadata(const_iterator pos) noexcept {
+        return pos.ptr()->_meta;
+    }
+
 protected:
     // I don't want to include the whole <tuple>,
     // plus using a struct is more convenient :)
@@ -622,8 +997,9 @@ protected:
     // is smaller than this lower bound (suggests the key doesn't exist) then we
     // can use this cool lower bound's 2nd return value and insert exactly there.
     lower_bound_result cool_lower_bound(const key_type& key) {
-        node** x = &ROOT;
-        if (*x == _header) return { end(), x, _header }; // empty container
+        if (empty()) return { end(), nullptr, _header };
+        node_ptr root = ROOT;
+        node** x = &root; // never written through, we go down at least once
         node_ptr parent = _header, x_parent = _header;
         while (*x != nullptr) {
             x_parent = *x;
@@ -636,13 +1012,18 @@ protected:
         return { iterator(parent), x, x_parent }; // end() if not found
     }
 
+    // x: the null link to fill in, unused if the tree is empty
     node_ptr insert_leaf_at(node** x, const T& val, node_ptr parent) {
+        if (empty()) {
+            node_ptr z = new_node(val, RBtree_color::black, _header);
+            _count = 1;
+            adjust_sizes_upwards(parent, +1);
+            return ROOT = _header->_left = _header->_right = z;
+        }
         *x = new_node(val, RBtree_color::red, parent);
         ++_count;
-        if (_count == 1) {
-            (*x)->_color = RBtree_color::black;
-            return _header->_parent = _header->_left = _header->_right = *x;
-        }
+        adjust_sizes_upwards(parent, +1);
+        update_path(parent);
         if      (*x == _header->_left->_left  ) _header->_left  = *x;
         else if (*x == _header->_right->_right) _header->_right = *x;
         node_ptr newnode = *x; // rebalancing may change the link *x
@@ -651,11 +1032,12 @@ protected:
     }
 
 private:
-    // precondition: *x != nullptr
-    std::pair<node_ptr, bool> insert_aux(node** x, const T& val, bool assign = false) {
-        if (empty()) return { insert_leaf_at(&ROOT, val, _header), true };
+    std::pair<node_ptr, bool> insert_aux(const T& val, bool assign = false) {
+        if (empty()) return { insert_leaf_at(nullptr, val, _header), true };
         const key_type& key = get_key(val);
-        node_ptr parent = (*x)->_parent;
+        node_ptr root = ROOT;
+        node** x = &root; // never written through, we go down at least once
+        node_ptr parent = _header;
         while (*x != nullptr) {
             parent = *x;
             if      (_comp(key, get_key(*x))) x = &(*x)->_left;
@@ -671,7 +1053,10 @@ private:
                 }
                 else {
                     if constexpr (IsMap) {
-                        if (assign)  (*x)->_val.second = val.second;
+                        if (assign) {
+                            (*x)->_val.second = val.second;
+                            update_path(*x);
+                        }
                     }
                     return { *x, false };
                 }
@@ -694,6 +1079,8 @@ private:
         replace(a, b);
         b->_left = a;
         a->_parent = b;
+        update_node(a);
+        update_node(b);
     }
 
     // mirror image of `rotate_left`
@@ -704,13 +1091,15 @@ private:
         replace(a, b);
         b->_right = a;
         a->_parent = b;
+        update_node(a);
+        update_node(b);
     }
 
     // x.color == BLACK, x.children.color == RED
     // flip their colors
     static void flip_colors(node_ptr x) noexcept {
-        x->_color = RBtree_color::red;
-        x->_left->_color = x->_right->_color = RBtree_color::black;
+        color(x) = RBtree_color::red;
+        color(x->_left) = color(x->_right) = RBtree_color::black;
     }
 
     void rebalance_after_inserting(node_ptr x) noexcept {
@@ -729,8 +1118,8 @@ private:
                         rotate_left(x);
                     }
                     rotate_right(x_pp);
-                    x->_parent->_color = RBtree_color::black;
-                    x_pp->_color = RBtree_color::red;
+                    color(x->_parent) = RBtree_color::black;
+                    color(x_pp) = RBtree_color::red;
                 }
             }
             else { // mirror image of previous big if-then statement
@@ -744,12 +1133,12 @@ private:
                         rotate_right(x);
                     }
                     rotate_left(x_pp);
-                    x->_parent->_color = RBtree_color::black;
-                    x_pp->_color = RBtree_color::red;
+                    color(x->_parent) = RBtree_color::black;
+                    color(x_pp) = RBtree_color::red;
                 }
             }
         }
-        ROOT->_color = RBtree_color::black;
+        color(ROOT) = RBtree_color::black;
     }
 
     // canonical implementation according to CLRS
@@ -757,7 +1146,7 @@ private:
         assert(z != _header && "cannot erase end() iterator");
         node_ptr next = tree_next(z); // for return
         node_ptr y = z, x = nullptr, x_parent = nullptr;
-        RBtree_color y_original_color = y->_color;
+        RBtree_color y_original_color = color(y);
 
         if (_count == 1 && z == ROOT) {
             set_default_header();
@@ -769,16 +1158,19 @@ private:
         if (!z->_left) { // z has at most one non-null child
             x = z->_right; // might be null
             x_parent = z->_parent;
+            adjust_sizes_upwards(x_parent, -1);
             replace(z, x);
         }
         else if (!z->_right) { // z has exactly one non-null child
             x = z->_left; // not null
             x_parent = z->_parent;
+            adjust_sizes_upwards(x_parent, -1);
             replace(z, x);
         }
         else { // has both children
             y = tree_min(z->_right); // node to be effectively deleted
-            y_original_color = y->_color;
+            y_original_color = color(y);
+            adjust_sizes_upwards(y->_parent, -1); // including z
             x = y->_right; // might be null, y's left is null
             if (y == z->_right) {
                 x_parent = y;
@@ -792,8 +1184,10 @@ private:
             replace(z, y);
             y->_left = z->_left;
             z->_left->_parent = y;
-            y->_color = z->_color;
+            color(y) = color(z);
+            if constexpr (OrderStatistics) y->_size = z->_size;
         }
+        update_path(x_parent); // before any rotation
 
         // rebalance
         if (y_original_color == RBtree_color::black) {
@@ -803,8 +1197,8 @@ private:
                     // case 1: w is red, then convert it to case 2-4 (w is black)
                     if (is_red(w)) {
                         rotate_left(x_parent);
-                        x_parent->_color = RBtree_color::red;
-                        w->_color = RBtree_color::black;
+                        color(x_parent) = RBtree_color::red;
+                        color(w) = RBtree_color::black;
                         w = x_parent->_right;
                     }
                     // case 2: both children of w are black (or null)
@@ -812,7 +1206,7 @@ private:
                         // Push one black off both x & w up to x.p and test x.p's color on the next round.
                         // If x.p's color is red-black (indicated by RED) then the loop terminates and we
                         // assign it's color to BLACK, otherwise (doubly black) keep going from x.p.
-                        w->_color = RBtree_color::red;
+                        color(w) = RBtree_color::red;
                         x = x_parent;
                         x_parent = x->_parent;
                     }
@@ -825,17 +1219,17 @@ private:
                             // (x.p's and w's right child's which's red) to black. In this way, we can think
                             // of it as one black out of x's double blacks is shifted to x.p and thus we are
                             // done. Tada :)
-                            w->_left->_color = RBtree_color::black; // should be performed before rotation
+                            color(w->_left) = RBtree_color::black; // should be performed before rotation
                                                                     // since w->_left changes as we rotate
-                            w->_color = RBtree_color::red;
+                            color(w) = RBtree_color::red;
                             rotate_right(w);
                             w = x_parent->_right;
                         }
                         // case 4: w's right child is red
                         rotate_left(x_parent);
-                        w->_color = x_parent->_color;
-                        x_parent->_color = RBtree_color::black;
-                        w->_right->_color = RBtree_color::black;
+                        color(w) = color(x_parent);
+                        color(x_parent) = RBtree_color::black;
+                        color(w->_right) = RBtree_color::black;
                         break;
                     }
                 }
@@ -844,34 +1238,34 @@ private:
                     // case 1: w is red, then convert it to case 2-4 (w is black)
                     if (is_red(w)) {
                         rotate_right(x_parent);
-                        x_parent->_color = RBtree_color::red;
-                        w->_color = RBtree_color::black;
+                        color(x_parent) = RBtree_color::red;
+                        color(w) = RBtree_color::black;
                         w = x_parent->_left;
                     }
                     // case 2: both children of w are black (or null)
                     if ((!w->_right || !is_red(w->_right)) && (!w->_left || !is_red(w->_left))) {
-                        w->_color = RBtree_color::red;
+                        color(w) = RBtree_color::red;
                         x = x_parent;
                         x_parent = x->_parent;
                     }
                     else {
                         // case 3: only w's left child is black, right child is red (thus non-null)
                         if (!w->_left || !is_red(w->_left)) {
-                            w->_right->_color = RBtree_color::black;
-                            w->_color = RBtree_color::red;
+                            color(w->_right) = RBtree_color::black;
+                            color(w) = RBtree_color::red;
                             rotate_left(w);
                             w = x_parent->_left;
                         }
                         // case 4: w's left child is red
                         rotate_right(x_parent);
-                        w->_color = x_parent->_color;
-                        x_parent->_color = RBtree_color::black;
-                        w->_left->_color = RBtree_color::black;
+                        color(w) = color(x_parent);
+                        color(x_parent) = RBtree_color::black;
+                        color(w->_left) = RBtree_color::black;
                         break;
                     }
                 }
             }
-            if (x) x->_color = RBtree_color::black;
+            if (x) color(x) = RBtree_color::black;
         }
 
     destroy_node:
@@ -880,6 +1274,319 @@ private:
         return next;
     }
 
+    /*
+     * Join-based algorithms, see Blelloch, Ferizovic & Sun, "Just Join for
+     * Parallel Ordered Sets" (SPAA 2016). They work on detached subtrees
+     * (whose root's parent link is meaningless) and everything is built on
+     *     join(L, k, R): a tree of L, node k, R, given L < k < R,
+     * which costs O(|bh(L) - bh(R)| + 1).
+     */
+
+    // a detached subtree with its black height, i.e. # of black nodes
+    // on any path from its root down to null, root included
+    struct subtree {
+        node_ptr root;
+        int bh;
+    };
+
+    struct split_result {
+        subtree left, right;
+    };
+
+    // subtrees smaller than this are processed sequentially
+    static constexpr size_t ParallelCutoff = 1 << 14;
+
+    static bool is_red_node(node_ptr x) noexcept {
+        return x && is_red(x);
+    }
+
+    static int black_height(node_ptr x) noexcept {
+        int bh = 0;
+        for (; x != nullptr; x = x->_left)
+            bh += !is_red(x);
+        return bh;
+    }
+
+    subtree detach() noexcept {
+        if (empty()) return { nullptr, 0 };
+        subtree t{ ROOT, black_height(ROOT) };
+        _count = 0;
+        set_default_header();
+        return t;
+    }
+
+    // precondition: *this is empty (detached)
+    void adopt(subtree t, size_t count) noexcept {
+        if (t.root == nullptr) return;
+        ROOT = t.root;
+        t.root->_parent = _header;
+        color(t.root) = RBtree_color::black;
+        _header->_left  = tree_min(t.root);
+        _header->_right = tree_max(t.root);
+        _count = count;
+    }
+
+    static size_t count_nodes(node_ptr x) noexcept {
+        if constexpr (OrderStatistics) return subtree_size(x);
+        else return x ? 1 + count_nodes(x->_left) + count_nodes(x->_right) : 0;
+    }
+
+    // make l and r the children of x
+    static void attach(node_ptr x, node_ptr l, node_ptr r) noexcept {
+        x->_left = l;
+        x->_right = r;
+        if (l) l->_parent = x;
+        if (r) r->_parent = x;
+        update_node(x);
+    }
+
+    static node_ptr rotate_left_detached(node_ptr a) noexcept {
+        node_ptr b = a->_right;
+        attach(a, a->_left, b->_left);
+        attach(b, a, b->_right);
+        return b;
+    }
+
+    static node_ptr rotate_right_detached(node_ptr a) noexcept {
+        node_ptr b = a->_left;
+        attach(a, b->_right, a->_right);
+        attach(b, b->_left, a);
+        return b;
+    }
+
+    // precondition: bh(t) >= bh(r)
+    // Descend the right spine of t to the first black node with the same
+    // black height as r and put k (red) there. The result has the black
+    // height of t, and the only possible violation is a red root with a red
+    // right child, others get fixed by a rotation at the next black node.
+    static node_ptr join_right(node_ptr t, int bht, node_ptr k, node_ptr r, int bhr) noexcept {
+        if (!is_red_node(t) && bht == bhr) {
+            color(k) = RBtree_color::red;
+            attach(k, t, r);
+            return k;
+        }
+        node_ptr c = join_right(t->_right, bht - !is_red(t), k, r, bhr);
+        attach(t, t->_left, c);
+        if (!is_red(t) && is_red(c) && is_red_node(c->_right)) {
+            color(c->_right) = RBtree_color::black;
+            return rotate_left_detached(t);
+        }
+        return t;
+    }
+
+    // mirror image of `join_right`
+    static node_ptr join_left(node_ptr l, int bhl, node_ptr k, node_ptr t, int bht) noexcept {
+        if (!is_red_node(t) && bht == bhl) {
+            color(k) = RBtree_color::red;
+            attach(k, l, t);
+            return k;
+        }
+        node_ptr c = join_left(l, bhl, k, t->_left, bht - !is_red(t));
+        attach(t, c, t->_right);
+        if (!is_red(t) && is_red(c) && is_red_node(c->_left)) {
+            color(c->_left) = RBtree_color::black;
+            return rotate_right_detached(t);
+        }
+        return t;
+    }
+
+    static subtree join_aux(subtree l, node_ptr k, subtree r) noexcept {
+        // the shorter tree goes below k, so it must have a black root
+        if (l.bh > r.bh && is_red_node(r.root)) {
+            color(r.root) = RBtree_color::black;
+            ++r.bh;
+        }
+        else if (l.bh < r.bh && is_red_node(l.root)) {
+            color(l.root) = RBtree_color::black;
+            ++l.bh;
+        }
+        if (l.bh > r.bh) {
+            node_ptr t = join_right(l.root, l.bh, k, r.root, r.bh);
+            if (is_red(t) && is_red_node(t->_right)) {
+                color(t) = RBtree_color::black;
+                return { t, l.bh + 1 };
+            }
+            return { t, l.bh };
+        }
+        if (l.bh < r.bh) {
+            node_ptr t = join_left(l.root, l.bh, k, r.root, r.bh);
+            if (is_red(t) && is_red_node(t->_left)) {
+                color(t) = RBtree_color::black;
+                return { t, r.bh + 1 };
+            }
+            return { t, r.bh };
+        }
+        bool both_black = !is_red_node(l.root) && !is_red_node(r.root);
+        color(k) = both_black ? RBtree_color::red : RBtree_color::black;
+        attach(k, l.root, r.root);
+        return { k, l.bh + !both_black };
+    }
+
+    // detach the largest node of t
+    static subtree split_last(subtree t, node_ptr& last) noexcept {
+        node_ptr x = t.root;
+        int bhc = t.bh - !is_red(x);
+        if (x->_right == nullptr) {
+            last = x;
+            return { x->_left, bhc };
+        }
+        subtree r = split_last({ x->_right, bhc }, last);
+        return join_aux({ x->_left, bhc }, x, r);
+    }
+
+    // join without a middle node
+    static subtree join2(subtree l, subtree r) noexcept {
+        if (l.root == nullptr) return r;
+        if (r.root == nullptr) return l;
+        node_ptr k;
+        l = split_last(l, k);
+        return join_aux(l, k, r);
+    }
+
+    // elements less than key go left, greater ones go right, and an
+    // equivalent one goes to `found` (for multi containers, equivalent
+    // ones go right, `found` remains null)
+    split_result split_aux(subtree t, const key_type& key, node_ptr& found) const noexcept {
+        node_ptr x = t.root;
+        if (x == nullptr) return { { nullptr, 0 }, { nullptr, 0 } };
+        int bhc = t.bh - !is_red(x);
+        subtree l{ x->_left, bhc }, r{ x->_right, bhc };
+        if (_comp(key, get_key(x)) || (IsMulti && !_comp(get_key(x), key))) {
+            split_result s = split_aux(l, key, found);
+            return { s.left, join_aux(s.right, x, r) };
+        }
+        if (_comp(get_key(x), key)) {
+            split_result s = split_aux(r, key, found);
+            return { join_aux(l, x, s.left), s.right };
+        }
+        found = x;
+        return { l, r };
+    }
+
+    // shape the first n nodes of the list (chained through _right) into
+    // a perfectly balanced tree, nodes at `red_depth` are colored red
+    static node_ptr build_sorted(node_ptr& list, size_t n, int depth, int red_depth) noexcept {
+        if (n == 0) return nullptr;
+        size_t nl = (n - 1) / 2;
+        node_ptr l = build_sorted(list, nl, depth + 1, red_depth);
+        node_ptr x = list;
+        list = list->_right;
+        node_ptr r = build_sorted(list, n - 1 - nl, depth + 1, red_depth);
+        color(x) = depth == red_depth ? RBtree_color::red : RBtree_color::black;
+        attach(x, l, r);
+        return x;
+    }
+
+    static int floor_log2(size_t n) noexcept {
+        int k = 0;
+        while (n >>= 1) ++k;
+        return k;
+    }
+
+    // like get_key() but for whatever the input iterators point to,
+    // e.g. std::pair<Key, T> rather than std::pair<const Key, T>
+    template< typename V >
+    static const auto& key_of(const V& val) noexcept {
+        if constexpr (IsMap) return val.first;
+        else return val;
+    }
+
+    template< typename InputIt >
+    bool is_sorted_range(InputIt first, InputIt last) const {
+        if (first == last) return true;
+        for (InputIt next = std::next(first); next != last; first = next++) {
+            if (_comp(key_of(*next), key_of(*first))) return false;
+        }
+        return true;
+    }
+
+    // destroy the whole subtree, returns # of nodes destroyed
+    size_t destroy(node_ptr x) noexcept {
+        if (x == nullptr) return 0;
+        size_t n = 1 + destroy(x->_left) + destroy(x->_right);
+        delete_node(x);
+        return n;
+    }
+
+    // run f and g, in parallel if there's enough work
+    template<typename F, typename G>
+    static void fork_join(size_t work, F&& f, G&& g) {
+        if (work >= ParallelCutoff)
+            ForkJoinPool::instance().fork_join(f, g);
+        else {
+            f(); g();
+        }
+    }
+
+    // `work` estimates the total size, `dropped` counts the destroyed nodes
+    subtree union_aux(subtree a, subtree b, size_t work, size_t& dropped) noexcept {
+        if (a.root == nullptr) return b;
+        if (b.root == nullptr) return a;
+        node_ptr k = a.root;
+        int bhc = a.bh - !is_red(k);
+        node_ptr found = nullptr;
+        split_result s = split_aux(b, get_key(k), found);
+        if (found) {
+            delete_node(found);
+            ++dropped;
+        }
+        subtree l, r;
+        size_t dl = 0, dr = 0;
+        fork_join(work,
+            [&] { l = union_aux({ k->_left,  bhc }, s.left,  work / 2, dl); },
+            [&] { r = union_aux({ k->_right, bhc }, s.right, work / 2, dr); });
+        dropped += dl + dr;
+        return join_aux(l, k, r);
+    }
+
+    subtree intersection_aux(subtree a, subtree b, size_t work, size_t& dropped) noexcept {
+        if (a.root == nullptr || b.root == nullptr) {
+            dropped += destroy(a.root) + destroy(b.root);
+            return { nullptr, 0 };
+        }
+        node_ptr k = a.root;
+        int bhc = a.bh - !is_red(k);
+        node_ptr found = nullptr;
+        split_result s = split_aux(b, get_key(k), found);
+        subtree l, r;
+        size_t dl = 0, dr = 0;
+        fork_join(work,
+            [&] { l = intersection_aux({ k->_left,  bhc }, s.left,  work / 2, dl); },
+            [&] { r = intersection_aux({ k->_right, bhc }, s.right, work / 2, dr); });
+        dropped += dl + dr + 1;
+        if (found) {
+            delete_node(found);
+            return join_aux(l, k, r);
+        }
+        delete_node(k);
+        return join2(l, r);
+    }
+
+    subtree difference_aux(subtree a, subtree b, size_t work, size_t& dropped) noexcept {
+        if (a.root == nullptr) {
+            dropped += destroy(b.root);
+            return { nullptr, 0 };
+        }
+        if (b.root == nullptr) return a;
+        node_ptr k = a.root;
+        int bhc = a.bh - !is_red(k);
+        node_ptr found = nullptr;
+        split_result s = split_aux(b, get_key(k), found);
+        subtree l, r;
+        size_t dl = 0, dr = 0;
+        fork_join(work,
+            [&] { l = difference_aux({ k->_left,  bhc }, s.left,  work / 2, dl); },
+            [&] { r = difference_aux({ k->_right, bhc }, s.right, work / 2, dr); });
+        dropped += dl + dr;
+        if (found) {
+            delete_node(found);
+            delete_node(k);
+            dropped += 2;
+            return join2(l, r);
+        }
+        return join_aux(l, k, r);
+    }
+
     // replace node x with node y
     static void replace(node_ptr x, node_ptr y) noexcept {
         node_ptr xp = x->_parent;
@@ -974,7 +1681,7 @@ private:
 #undef END
 #undef ROOT
 
-    struct RBtree_node {
+    struct RBtree_node : node_metadata<NodeUpdate> {
         T _val;
         RBtree_color _color;
         node_ptr _parent, _left, _right;
@@ -991,6 +1698,23 @@ private:
         }
     };
 
+    // compact_node_layout: the color is kept in the parent link
+    struct RBtree_compact_node : node_metadata<NodeUpdate> {
+        T _val;
+        tagged_parent<RBtree_compact_node, 1> _parent;
+        node_ptr _left, _right;
+
+        RBtree_compact_node(const T& val, RBtree_color color, node_ptr parent, node_ptr left, node_ptr right)
+            : _val(val), _parent(parent, color == RBtree_color::red), _left(left), _right(right) {}
+
+        T* val_ptr() {
+            return std::addressof(_val);
+        }
+        const T* val_ptr() const {
+            return std::addressof(_val);
+        }
+    };
+
     class RBtree_iter
     {
         using _self = RBtree_iter;
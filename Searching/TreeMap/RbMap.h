@@ -9,6 +9,7 @@
 #define RBMAP_H 1
 
 #include "RBtree_impl.h"
+#include "StaticOrderedMap.h"
 #include <memory>     // std::allocator
 #include <functional> // std::less
 #include <stdexcept>  // std::out_of_range
@@ -16,9 +17,10 @@
 
 namespace mySymbolTable {
 
-template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>>
-class RbMap : public RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false> {
-    using _base = RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false>;
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>,
+         typename NodeUpdate = null_node_update>
+class RbMap : public RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false, NodeUpdate> {
+    using _base = RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/false, NodeUpdate>;
 public:
     using key_type = Key;
     using mapped_type = T;
@@ -86,6 +88,18 @@ public:
     RbMap(std::initializer_list<value_type> init, const Alloc& alloc)
         : RbMap(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static RbMap from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        RbMap mp(comp, alloc);
+        mp.assign_sorted(first, last);
+        return mp;
+    }
+
     /* IV */
 
     RbMap(const RbMap& other) : _base(other) {}
@@ -155,6 +169,13 @@ public:
         _base::swap(rhs);
     }
 
+    /* read-only phases */
+
+    // a contiguous copy with faster lookups, see StaticOrderedMap.h
+    StaticOrderedMap<Key, T, Compare> freeze() const {
+        return StaticOrderedMap<Key, T, Compare>(this->begin(), this->end(), key_comp());
+    }
+
     /* observers */
 
     key_compare key_comp() const {
@@ -167,17 +188,18 @@ public:
 
 }; // class RbMap
 
-template <typename Key, typename T ,typename Compare, typename Alloc>
-void swap(RbMap<Key, T, Compare, Alloc>& lhs,
-          RbMap<Key, T, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename T, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(RbMap<Key, T, Compare, Alloc, NodeUpdate>& lhs,
+          RbMap<Key, T, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
 
-template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>>
-class RbMultimap : public RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true> {
-    using _base = RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true>;
+template<typename Key, typename T, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<const Key, T>>,
+         typename NodeUpdate = null_node_update>
+class RbMultimap : public RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true, NodeUpdate> {
+    using _base = RBtree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, /*IsMulti=*/true, NodeUpdate>;
 public:
     using key_type = Key;
     using mapped_type = T;
@@ -245,6 +267,18 @@ public:
     RbMultimap(std::initializer_list<value_type> init, const Alloc& alloc)
         : RbMultimap(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static RbMultimap from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        RbMultimap st(comp, alloc);
+        st.assign_sorted(first, last);
+        return st;
+    }
+
     /* IV */
 
     RbMultimap(const RbMultimap& other) : _base(other) {}
@@ -284,9 +318,9 @@ public:
 
 }; // class RbMultimap
 
-template <typename Key, typename T, typename Compare, typename Alloc>
-void swap(RbMultimap<Key, T, Compare, Alloc>& lhs,
-          RbMultimap<Key, T, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename T, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(RbMultimap<Key, T, Compare, Alloc, NodeUpdate>& lhs,
+          RbMultimap<Key, T, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
@@ -15,9 +15,10 @@
 
 namespace mySymbolTable {
 
-template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>>
-class RbSet : public RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false> {
-    using _base = RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false>;
+template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>,
+         typename NodeUpdate = null_node_update>
+class RbSet : public RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false, NodeUpdate> {
+    using _base = RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/false, NodeUpdate>;
 public:
     using key_type = Key;
     using value_type = Key;
@@ -74,6 +75,18 @@ public:
     RbSet(std::initializer_list<value_type> init, const Alloc& alloc)
         : RbSet(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static RbSet from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        RbSet st(comp, alloc);
+        st.assign_sorted(first, last);
+        return st;
+    }
+
     /* IV */
 
     RbSet(const RbSet& other) : _base(other) {}
@@ -107,17 +120,18 @@ public:
 
 }; // class RbSet
 
-template <typename Key, typename Compare, typename Alloc>
-void swap(RbSet<Key, Compare, Alloc>& lhs,
-          RbSet<Key, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(RbSet<Key, Compare, Alloc, NodeUpdate>& lhs,
+          RbSet<Key, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
 
-template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>>
-class RbMultiset : public RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true> {
-    using _base = RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true>;
+template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>,
+         typename NodeUpdate = null_node_update>
+class RbMultiset : public RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true, NodeUpdate> {
+    using _base = RBtree<Key, Compare, Alloc, /*IsMap=*/false, /*IsMulti=*/true, NodeUpdate>;
 public:
     using key_type = Key;
     using value_type = Key;
@@ -174,6 +188,18 @@ public:
     RbMultiset(std::initializer_list<value_type> init, const Alloc& alloc)
         : RbMultiset(init, Compare(), alloc) {}
 
+    /* sorted input */
+
+    // build from a sorted range in linear time
+    template< class InputIt >
+    static RbMultiset from_sorted(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc())
+    {
+        RbMultiset st(comp, alloc);
+        st.assign_sorted(first, last);
+        return st;
+    }
+
     /* IV */
 
     RbMultiset(const RbMultiset& other) : _base(other) {}
@@ -207,9 +233,9 @@ public:
 
 }; // class RbMultiset
 
-template <typename Key, typename Compare, typename Alloc>
-void swap(RbMultiset<Key, Compare, Alloc>& lhs,
-          RbMultiset<Key, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template <typename Key, typename Compare, typename Alloc, typename NodeUpdate>
+void swap(RbMultiset<Key, Compare, Alloc, NodeUpdate>& lhs,
+          RbMultiset<Key, Compare, Alloc, NodeUpdate>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
@@ -0,0 +1,269 @@
+/*
+ *  TST of scored keys with top-k completion for search-as-you-type
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/ScoredTST.h
+ *
+ *  usage:
+ *      ScoredTST<float> st;
+ *      st.insert_or_assign("shells", 3.5f);   // key -> score
+ *      st.insert_or_assign("shore", 7);
+ *      for (auto [key, score] : st.top_k_with_prefix("sh", 10)) ...   // highest first
+ */
+#ifndef SCOREDTST_H
+#define SCOREDTST_H 1
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <utility>   // std::pair
+#include <algorithm> // std::reverse_copy
+#include <limits>
+#include <stdexcept>
+
+namespace mySymbolTable {
+
+// Ternary search tree mapping keys to scores where every node also caches
+// the maximum score in its subtree (itself and its left, mid and right
+// links). The k best completions of a prefix are then found best-first:
+// a subtree is opened only if its max beats everything still pending, so
+// a query visits O(k * depth) nodes instead of every completion.
+template<typename Score = double>
+class ScoredTST {
+    enum class Link : char { LEFT, MID, RIGHT };
+
+    struct Node {
+        Node* parent = nullptr;
+        Node* left{}, * mid{}, * right{};
+        Score score{};      // valid if has_score
+        Score max;          // max score in the subtree rooted here
+        char ch;
+        Link pos;
+        bool has_score = false;
+
+        Node(char c, Link pos, Node* parent) : parent(parent), max(lowest()), ch(c), pos(pos) {}
+    };
+    using node_ptr = Node*;
+
+    node_ptr root;   // pointer to root node whose link is MID
+    size_t n;        // no. of keys in TST
+public:
+    using entry = std::pair<std::string, Score>;
+
+    ScoredTST() : root(nullptr), n(0) {}
+
+    ScoredTST(const ScoredTST&) = delete;
+    ScoredTST& operator=(const ScoredTST&) = delete;
+
+    ~ScoredTST() { clear(); }
+
+    void clear() { clear(root); root = nullptr; n = 0; }
+
+    size_t size() const noexcept { return n; }
+
+    bool empty() const noexcept { return n == 0; }
+
+    bool contains(const std::string& key) const {
+        if (key == "") throw std::invalid_argument("key to contains() cannot be null");
+        return find_aux(key) != nullptr;
+    }
+
+    Score at(const std::string& key) const {
+        if (key == "") throw std::invalid_argument("key to at() cannot be null");
+        node_ptr x = find_aux(key);
+        if (x == nullptr) throw std::out_of_range("invalid key to at()");
+        return x->score;
+    }
+
+    // highest score of all, lowest() if empty
+    Score max_score() const noexcept {
+        return root ? root->max : lowest();
+    }
+
+    // Sets the score of key, inserting it if absent, and brings the
+    // subtree maxima on its path up to date through the parent links.
+    void insert_or_assign(const std::string& key, Score score) {
+        if (key == "") throw std::invalid_argument("key to insert_or_assign() cannot be null");
+        node_ptr x = insert(key);
+        if (!x->has_score) {
+            x->has_score = true;
+            ++n;
+        }
+        x->score = score;
+        fix_max_upward(x);
+    }
+
+    // adds delta to the score of key (0 if absent), e.g. to count hits
+    void add_score(const std::string& key, Score delta) {
+        if (key == "") throw std::invalid_argument("key to add_score() cannot be null");
+        node_ptr x = insert(key);
+        if (!x->has_score) {
+            x->has_score = true;
+            x->score = Score{};
+            ++n;
+        }
+        x->score += delta;
+        fix_max_upward(x);
+    }
+
+    void erase(const std::string& key) {
+        if (key == "") throw std::invalid_argument("key to erase() cannot be null");
+        node_ptr x = find_aux(key);
+        if (x == nullptr) return;
+        x->has_score = false;
+        --n;
+        // prune the nodes left without keys below them, then fix the maxima
+        while (x != nullptr && is_leaf(x) && !x->has_score) {
+            node_ptr parent = x->parent;
+            link_of(x) = nullptr;
+            delete x;
+            x = parent;
+        }
+        if (x != nullptr) fix_max_upward(x);
+    }
+
+    // The k highest-scoring keys starting with prefix ("" for all keys),
+    // highest first (equal scores in no particular order).
+    std::vector<entry> top_k_with_prefix(const std::string& prefix, size_t k) const {
+        std::vector<entry> res;
+        if (prefix == "") {
+            top_k(root, nullptr, k, res);
+            return res;
+        }
+        node_ptr x = find_node(root, prefix, 0);
+        if (x != nullptr) top_k(x->mid, x->has_score ? x : nullptr, k, res);
+        return res;
+    }
+
+    std::vector<entry> top_k(size_t k) const {
+        return top_k_with_prefix("", k);
+    }
+
+    static constexpr Score lowest() noexcept {
+        return std::numeric_limits<Score>::lowest();
+    }
+
+private:
+    // a pending subtree (key == false) or key (key == true) of the search
+    struct candidate {
+        Score bound;   // subtree max, or the score of the key
+        node_ptr x;
+        bool key;
+
+        bool operator<(const candidate& rhs) const { return bound < rhs.bound; }
+    };
+
+    // Best-first search of the subtree rooted at x (a mid link node) and
+    // the key node first, either may be null: each pop either yields the next
+    // best key or opens one node, pushing its key and its three subtrees
+    // with their maxima as bounds. So a subtree is opened only when its max
+    // beats every key not yet reported, and the k results take O(k * depth)
+    // pops, the heap staying within 3 candidates per pop.
+    static void top_k(node_ptr x, node_ptr first, size_t k, std::vector<entry>& res) {
+        std::priority_queue<candidate> heap;
+        if (first != nullptr) heap.push({ first->score, first, true });
+        if (x != nullptr)     heap.push({ x->max, x, false });
+        while (!heap.empty() && res.size() < k) {
+            candidate c = heap.top();
+            heap.pop();
+            node_ptr y = c.x;
+            if (c.key) {
+                res.emplace_back(get_key(y), y->score);
+                continue;
+            }
+            if (y->has_score)        heap.push({ y->score, y, true });
+            if (y->left  != nullptr) heap.push({ y->left->max, y->left, false });
+            if (y->mid   != nullptr) heap.push({ y->mid->max, y->mid, false });
+            if (y->right != nullptr) heap.push({ y->right->max, y->right, false });
+        }
+    }
+
+    // precondition: x != nullptr
+    static bool is_leaf(node_ptr x) noexcept {
+        return !(x->left || x->mid || x->right);
+    }
+
+    // the link in the parent (or root) that points to x
+    node_ptr& link_of(node_ptr x) {
+        if (x->parent == nullptr)     return root;
+        if (x->pos == Link::LEFT)     return x->parent->left;
+        if (x->pos == Link::RIGHT)    return x->parent->right;
+        return x->parent->mid;
+    }
+
+    static Score subtree_max(node_ptr x) noexcept {
+        Score m = x->has_score ? x->score : lowest();
+        for (node_ptr c : { x->left, x->mid, x->right }) {
+            if (c != nullptr && m < c->max) m = c->max;
+        }
+        return m;
+    }
+
+    // recompute the max of x and its ancestors, stopping as soon as it
+    // doesn't change
+    static void fix_max_upward(node_ptr x) noexcept {
+        for (; x != nullptr; x = x->parent) {
+            Score m = subtree_max(x);
+            if (m == x->max) break;
+            x->max = m;
+        }
+    }
+
+    node_ptr find_aux(const std::string& key) const {
+        node_ptr x = find_node(root, key, 0);
+        return x != nullptr && x->has_score ? x : nullptr;
+    }
+
+    // return pointer to the node of key's last character, whether or not
+    // it holds a score, null if there's no such node
+    static node_ptr find_node(node_ptr x, const std::string& key, size_t d) {
+        while (x != nullptr) {
+            if      (key[d] < x->ch)    x = x->left;
+            else if (key[d] > x->ch)    x = x->right;
+            else if (d < key.length() - 1) { x = x->mid; ++d; }
+            else return x;
+        }
+        return nullptr;
+    }
+
+    // return the node of key, creating the missing ones
+    node_ptr insert(const std::string& key) {
+        node_ptr* cur = &root;
+        Link pos = Link::MID; // link value for root if it is null
+        node_ptr parent = nullptr;
+        for (size_t d = 0; ; ) {
+            if (*cur == nullptr) *cur = new Node(key[d], pos, parent);
+            parent = *cur;
+            if      (key[d] < (*cur)->ch) { cur = &(*cur)->left;  pos = Link::LEFT; }
+            else if (key[d] > (*cur)->ch) { cur = &(*cur)->right; pos = Link::RIGHT; }
+            else if (d < key.length() - 1) { cur = &(*cur)->mid;  pos = Link::MID; ++d; }
+            else return *cur;
+        }
+    }
+
+    static std::string get_key(node_ptr x) {
+        std::vector<char> str;
+        for (Link pos; x != nullptr; x = x->parent) {// root->parent == nullptr
+            str.push_back(x->ch);
+            pos = x->pos;
+            while (pos != Link::MID) {
+                x = x->parent;
+                pos = x->pos;
+            }
+        }
+        std::string key(str.size(), '\0');
+        std::reverse_copy(str.begin(), str.end(), key.begin());
+        return key;
+    }
+
+    void clear(node_ptr x) {
+        if (x == nullptr) return;
+        clear(x->left);
+        clear(x->mid);
+        clear(x->right);
+        delete x;
+    }
+};
+
+} // namespace mySymbolTable
+
+#endif // !SCOREDTST_H
@@ -0,0 +1,180 @@
+/*
+ *  ordered symbol tables:
+ *  splay tree map
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/SplayMap.h
+ *
+ *  usage:
+ *      mySymbolTable::SplayMap<std::string, int> mp;   // top-down splaying
+ *      mySymbolTable::SplayMap<std::string, int, std::less<std::string>,
+ *          std::allocator<std::pair<const std::string, int>>, mySymbolTable::semi_splay> mp2;
+ */
+
+#ifndef SPLAYMAP_H
+#define SPLAYMAP_H 1
+
+#include "SplayTree_impl.h"
+#include <memory>     // std::allocator
+#include <functional> // std::less
+#include <stdexcept>  // std::out_of_range
+#include <initializer_list>
+
+namespace mySymbolTable {
+
+template<typename Key, typename T, typename Compare = std::less<Key>,
+         typename Alloc = std::allocator<std::pair<const Key, T>>,
+         typename SplayMode = top_down_splay>
+class SplayMap : public SplayTree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, SplayMode> {
+    using _base = SplayTree<std::pair<const Key, T>, Compare, Alloc, /*IsMap=*/true, SplayMode>;
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = typename _base::iterator;
+    using const_iterator = typename _base::const_iterator;
+    using reverse_iterator = typename _base::reverse_iterator;
+    using const_reverse_iterator = typename _base::const_reverse_iterator;
+    using node_type = typename _base::node_type;
+
+    class value_compare {
+        Compare _key_comp;
+    public:
+        value_compare() : _key_comp(Compare()) {}
+        value_compare(const Compare& comp) : _key_comp(comp) {}
+
+        bool operator()(const value_type& lhs, const value_type& rhs) const {
+            return _key_comp(lhs.first, rhs.first);
+        }
+    };
+
+    /* I */
+
+    // (1) a
+    SplayMap() : _base() {}
+
+    // (1) b
+    explicit SplayMap(const Compare& comp, const Alloc& alloc = Alloc())
+        : _base(comp, alloc) {}
+
+    // (1) c
+    explicit SplayMap(const Alloc& alloc) : _base(alloc) {}
+
+    /* II */
+
+    // (2) a
+    template< class InputIt >
+    SplayMap(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(first, last);
+    }
+
+    // (2) b
+    template< class InputIt >
+    SplayMap(InputIt first, InputIt last, const Alloc& alloc)
+        : SplayMap(first, last, Compare(), alloc) {}
+
+    /* III */
+
+    // (3) a
+    SplayMap(std::initializer_list<value_type> init, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(init.begin(), init.end());
+    }
+
+    // (3) b
+    SplayMap(std::initializer_list<value_type> init, const Alloc& alloc)
+        : SplayMap(init, Compare(), alloc) {}
+
+    /* IV */
+
+    SplayMap(const SplayMap& other) : _base(other) {}
+
+    SplayMap& operator=(const SplayMap& other) {
+        _base::operator=(other);
+        return *this;
+    }
+
+    SplayMap& operator=(std::initializer_list<value_type> ilist) {
+        SplayMap tmp{ ilist };
+        this->swap(tmp);
+        return *this;
+    }
+
+    /* element access */
+
+    // splays key
+    T& at(const Key& key) {
+        iterator it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("SplayMap<K, T> key does not exist");
+        return it->second;
+    }
+
+    const T& at(const Key& key) const {
+        const_iterator it = this->find(key);
+        if (it == this->end()) throw std::out_of_range("SplayMap<K, T> key does not exist");
+        return it->second;
+    }
+
+    T& operator[](const Key& key) {
+        return _base::insert({ key, T() }).first->second;
+    }
+
+    /* unique insertion for map */
+
+    std::pair<iterator, bool> insert(const value_type& val) {
+        return _base::insert(val);
+    }
+
+    std::pair<iterator, bool> insert(const Key& key, const T& val) {
+        return _base::insert({ key, val });
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        return _base::insert(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        return _base::insert(ilist.begin(), ilist.end());
+    }
+
+    std::pair<iterator, bool> insert_or_assign(const value_type& val) {
+        return _base::insert_or_assign(val);
+    }
+
+    std::pair<iterator, bool> insert_or_assign(const Key& key, const T& val) {
+        return _base::insert_or_assign({ key, val });
+    }
+
+    void swap(SplayMap& rhs) {
+        _base::swap(rhs);
+    }
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+
+}; // class SplayMap
+
+template <typename Key, typename T, typename Compare, typename Alloc, typename SplayMode>
+void swap(SplayMap<Key, T, Compare, Alloc, SplayMode>& lhs,
+          SplayMap<Key, T, Compare, Alloc, SplayMode>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+} // namespace mySymbolTable
+
+#endif // !SPLAYMAP_H
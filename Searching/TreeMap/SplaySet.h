@@ -0,0 +1,135 @@
+/*
+ *  ordered symbol tables:
+ *  splay tree set
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/SplaySet.h
+ *
+ *  usage:
+ *      mySymbolTable::SplaySet<int> st;   // top-down splaying
+ *      mySymbolTable::SplaySet<int, std::less<int>, std::allocator<int>, mySymbolTable::semi_splay> st2;
+ */
+
+#ifndef SPLAYSET_H
+#define SPLAYSET_H 1
+
+#include "SplayTree_impl.h"
+#include <memory>     // std::allocator
+#include <functional> // std::less
+#include <initializer_list>
+
+namespace mySymbolTable {
+
+template<typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>,
+         typename SplayMode = top_down_splay>
+class SplaySet : public SplayTree<Key, Compare, Alloc, /*IsMap=*/false, SplayMode> {
+    using _base = SplayTree<Key, Compare, Alloc, /*IsMap=*/false, SplayMode>;
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = typename _base::iterator;
+    using const_iterator = typename _base::const_iterator;
+    using reverse_iterator = typename _base::reverse_iterator;
+    using const_reverse_iterator = typename _base::const_reverse_iterator;
+    using node_type = typename _base::node_type;
+
+    /* I */
+
+    // (1) a
+    SplaySet() : _base() {}
+
+    // (1) b
+    explicit SplaySet(const Compare& comp, const Alloc& alloc = Alloc())
+        : _base(comp, alloc) {}
+
+    // (1) c
+    explicit SplaySet(const Alloc& alloc) : _base(alloc) {}
+
+    /* II */
+
+    // (2) a
+    template< class InputIt >
+    SplaySet(InputIt first, InputIt last, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(first, last);
+    }
+
+    // (2) b
+    template< class InputIt >
+    SplaySet(InputIt first, InputIt last, const Alloc& alloc)
+        : SplaySet(first, last, Compare(), alloc) {}
+
+    /* III */
+
+    // (3) a
+    SplaySet(std::initializer_list<value_type> init, const Compare& comp = Compare(),
+        const Alloc& alloc = Alloc()) : _base(comp, alloc)
+    {
+        _base::insert(init.begin(), init.end());
+    }
+
+    // (3) b
+    SplaySet(std::initializer_list<value_type> init, const Alloc& alloc)
+        : SplaySet(init, Compare(), alloc) {}
+
+    /* IV */
+
+    SplaySet(const SplaySet& other) : _base(other) {}
+
+    SplaySet& operator=(const SplaySet& other) {
+        _base::operator=(other);
+        return *this;
+    }
+
+    SplaySet& operator=(std::initializer_list<value_type> ilist) {
+        SplaySet tmp{ ilist };
+        this->swap(tmp);
+        return *this;
+    }
+
+    /* unique insertion for set */
+
+    std::pair<iterator, bool> insert(const value_type& val) {
+        return _base::insert(val);
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        return _base::insert(first, last);
+    }
+
+    void insert(std::initializer_list<value_type> ilist) {
+        return _base::insert(ilist.begin(), ilist.end());
+    }
+
+    void swap(SplaySet& rhs) {
+        _base::swap(rhs);
+    }
+
+    key_compare key_comp() const {
+        return key_compare{};
+    }
+
+    value_compare value_comp() const {
+        return value_compare{};
+    }
+
+}; // class SplaySet
+
+template <typename Key, typename Compare, typename Alloc, typename SplayMode>
+void swap(SplaySet<Key, Compare, Alloc, SplayMode>& lhs,
+          SplaySet<Key, Compare, Alloc, SplayMode>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+} // namespace mySymbolTable
+
+#endif // !SPLAYSET_H
@@ -0,0 +1,1018 @@
+/*
+ *  internal header file for implementing
+ *  ordered symbol tables:
+ *  splay tree map/set
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/SplayTree_impl.h
+ */
+
+#ifndef SPLAYTREE_IMPL_H
+#define SPLAYTREE_IMPL_H 1
+
+#include <type_traits> // std::is_same
+#include <memory>   // std::addressof, std::allocator_tarits
+#include <utility>  // std::swap, std::pair
+#include <iterator> // std::reverse_iterator, std::distance
+#include <iostream> // std::cout
+#include <string>
+#include <vector>
+#include <cassert>
+#include "my_map_traits.h" // myst::get_map_key_t
+
+namespace mySymbolTable {
+
+// How a splay tree restructures itself on each access.
+// top_down_splay: Sleator & Tarjan's top-down splaying, the accessed node
+//                 becomes the root in a single pass down the search path.
+// semi_splay:     bottom-up semi-splaying, a zig-zig step only rotates the
+//                 parent and goes on from there. The accessed node ends up
+//                 about halfway up rather than at the root, for about half
+//                 the rotations (pointer writes) per access.
+struct top_down_splay {};
+struct semi_splay {};
+
+// Splay tree, a self-adjusting BST: every access moves the node towards
+// the root, so frequently (or recently) accessed keys stay near the top.
+// O(log n) amortized per operation, though a single one can take O(n).
+// Unlike the other trees, find() (and contains(), at(), operator[]) on a
+// non-const container restructures the tree; their const overloads and
+// lower_bound()/upper_bound() are plain read-only searches.
+template<typename T, typename Compare, typename Alloc, bool IsMap, typename SplayMode>
+class SplayTree {
+    struct SplayTree_node;
+    class SplayTree_iter;
+    class SplayTree_const_iter;
+    using _self = SplayTree<T, Compare, Alloc, IsMap, SplayMode>;
+    using node = SplayTree_node;
+    using node_ptr = node*;
+    using NodeAl = typename std::allocator_traits<Alloc>::template rebind_alloc<node>;
+public:
+    using value_type = T;
+    using key_type = typename get_map_key_t<T, IsMap>::key_type;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+    using iterator = SplayTree_iter;
+    using const_iterator = SplayTree_const_iter;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using node_type = SplayTree_node;
+
+private:
+    static_assert(std::is_same<SplayMode, top_down_splay>::value || std::is_same<SplayMode, semi_splay>::value,
+                  "SplayMode must be top_down_splay or semi_splay");
+    static constexpr bool TopDown = std::is_same<SplayMode, top_down_splay>::value;
+
+    // _header->_parent points to root node
+    // _header->_parent->_parent == _header
+    // _header->_left  points to the leftmost node
+    // _header->_right points to the rightmost node
+    node_ptr _header;
+    size_t   _count;
+    Compare  _comp;
+    NodeAl   _alloc;
+
+#define ROOT _header->_parent
+
+    void set_default_header() noexcept {
+        _header->_parent = _header;
+        _header->_left   = _header;
+        _header->_right  = _header;
+    }
+
+    // create & initialize the header node
+    void create_header() {
+        _header = _alloc.allocate(1); // may throw
+        set_default_header();
+        // leave the value field uninitialized
+    }
+
+    // clear old data only when rhs is empty
+    void copy(const _self& rhs) {
+        if (!rhs.empty()) {
+            ROOT = copy_nodes(rhs.ROOT, _header);
+            _count = rhs._count;
+            _header->_left  = tree_min(ROOT);
+            _header->_right = tree_max(ROOT);
+        }
+        else clear();
+    }
+public:
+    SplayTree() : _count(0), _comp(), _alloc() {
+        create_header();
+    }
+
+    explicit SplayTree(const Compare& comp, const Alloc& alloc = Alloc()) :
+        _count(0), _comp(comp), _alloc(alloc) {
+        create_header();
+    }
+
+    explicit SplayTree(const Alloc& alloc) : _count(0), _comp(), _alloc(alloc) {
+        create_header();
+    }
+
+    SplayTree(const _self& rhs) : _count(0), _comp(rhs._comp), _alloc(rhs._alloc) {
+        create_header();
+        try {
+            copy(rhs);
+        }
+        catch (...) {
+            _alloc.deallocate(_header, 1);
+            throw;
+        }
+    }
+
+    ~SplayTree() { clear(); _alloc.deallocate(_header, 1); }
+
+    _self& operator=(const _self& rhs) {
+        if (this == &rhs) return *this;
+        clear();
+        copy(rhs);
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return _alloc;
+    }
+
+    /* iterators */
+
+    iterator begin() noexcept {
+        return iterator(_header->_left);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(_header->_left);
+    }
+
+    iterator end() noexcept {
+        return iterator(_header);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(_header);
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /* capacity */
+
+    bool empty() const noexcept { return _count == 0; }
+
+    size_t size() const noexcept { return _count; }
+
+    size_t max_size() const noexcept {
+        return std::allocator_traits<NodeAl>::max_size(_alloc);
+    }
+
+    /* lookup */
+
+    size_t count(const key_type& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    // Splays key (or the last node on its search path) towards the root.
+    iterator find(const key_type& key) {
+        return iterator(access(key));
+    }
+
+    // read-only, doesn't restructure the tree
+    const_iterator find(const key_type& key) const {
+        return const_iterator(search(key));
+    }
+
+    bool contains(const key_type& key) {
+        return access(key) != _header;
+    }
+
+    bool contains(const key_type& key) const {
+        return search(key) != _header;
+    }
+
+    // Returns iterator pointing to the first element that is not less than key.
+    // Returns end() if not found.
+    iterator lower_bound(const key_type& key) {
+        return iterator(lower_bound_aux(key));
+    }
+
+    const_iterator lower_bound(const key_type& key) const {
+        return const_iterator(lower_bound_aux(key));
+    }
+
+    // Returns iterator pointing to the first element that is greater than key.
+    // Returns end() if not found.
+    iterator upper_bound(const key_type& key) {
+        return iterator(upper_bound_aux(key));
+    }
+
+    const_iterator upper_bound(const key_type& key) const {
+        return const_iterator(upper_bound_aux(key));
+    }
+
+    std::pair<iterator, iterator> equal_range(const key_type& key) {
+        return { lower_bound(key), upper_bound(key) };
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+        return { lower_bound(key), upper_bound(key) };
+    }
+
+    /* modifiers */
+
+    void clear() noexcept {
+        if (!empty()) {
+            clear_nodes(ROOT); _count = 0; set_default_header();
+        }
+    }
+
+protected:
+    std::pair<iterator, bool> insert(const T& val) {
+        const auto& [p, inserted] = insert_aux(val);
+        return { iterator(p), inserted };
+    }
+
+    template< typename InputIt >
+    void insert(InputIt first, InputIt last) {
+        while (first != last) {
+            insert(*first++);
+        }
+    }
+
+    // only for map
+    std::pair<iterator, bool> insert_or_assign(const T& val) {
+        const auto& [p, inserted] = insert_aux(val, /*assign=*/true);
+        return { iterator(p), inserted };
+    }
+
+public:
+    // References and iterators to the erased elements are invalidated.
+    // Other references and iterators are not affected.
+    // Retrurns iterator following the last removed element.
+    iterator erase(iterator pos) {
+        return iterator(erase(pos.ptr()));
+    }
+
+    iterator erase(const_iterator pos) {
+        return iterator(erase(pos.ptr()));
+    }
+
+    // Returns iterator following the last removed element.
+    iterator erase(const_iterator first, const_iterator last) {
+        if (first == begin() && last == end()) {
+            clear();
+            return end();
+        }
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator(first.ptr());
+    }
+
+    // Returns the number of elements removed.
+    size_t erase(const key_type& key) {
+        node_ptr x = search(key);
+        if (x == _header) return 0;
+        erase(x);
+        return 1;
+    }
+
+    void swap(SplayTree& rhs) noexcept(std::allocator_traits<Alloc>::is_always_equal::value
+                                &&     std::is_nothrow_swappable<Compare>::value)
+    {
+        assert(_alloc == rhs._alloc && "allocator must be the same");
+        if (std::allocator_traits<allocator_type>::propagate_on_container_swap::value) {
+            std::swap(_alloc, rhs._alloc);
+        } // otherwise the behavior is undefined
+
+        std::swap(_header, rhs._header);
+        std::swap(_count, rhs._count);
+        std::swap(_comp, rhs._comp);
+    }
+
+    /* visualization */
+
+    // print in a tree structure
+    void print(size_t level = 10) const { print(ROOT, level); }
+
+    /* tree height interface */
+
+    // tree height (height of root),  i.e. the number of
+    // edges on the longest path from root node to a leaf
+    int height() const {
+        if (empty()) return -1; // -1 suggests it's empty
+        return height(ROOT) - 1;
+    }
+
+    int height(const_iterator pos) const {
+        if (pos == end()) return -1;
+        return height(pos.ptr()) - 1;
+    }
+
+    // # of edges from the root to pos, i.e. what an access to it costs
+    int depth(const_iterator pos) const {
+        if (pos == end()) return -1;
+        int d = 0;
+        for (node_ptr x = pos.ptr(); x != ROOT; x = x->_parent)
+            ++d;
+        return d;
+    }
+
+private:
+    // A splay tree can degenerate into a path of length n (e.g. after
+    // inserting sorted keys), so nothing here recurses on the tree shape.
+    static int height(node_ptr x) {
+        std::vector<std::pair<node_ptr, int>> stack{ { x, 1 } };
+        int h = 0;
+        while (!stack.empty()) {
+            auto [y, d] = stack.back();
+            stack.pop_back();
+            if (d > h) h = d;
+            if (y->_left ) stack.push_back({ y->_left,  d + 1 });
+            if (y->_right) stack.push_back({ y->_right, d + 1 });
+        }
+        return h;
+    }
+
+    // When using greater<T> (operator>) for comp, the
+    // leftmost node is on the contrary the largest.
+    // precondition: x != nullptr && x != _header
+    static node_ptr tree_min(node_ptr x) noexcept {
+        while (x->_left != nullptr)
+            x = x->_left;
+        return x;
+    }
+
+    // precondition: x != nullptr && x != _header
+    static node_ptr tree_max(node_ptr x) noexcept {
+        while (x->_right != nullptr)
+            x = x->_right;
+        return x;
+    }
+
+    // precondition: x != nullptr && x != _header
+    static node_ptr tree_next(node_ptr x) noexcept {
+        if (x->_right != nullptr)
+            return tree_min(x->_right);
+        // ROOT being rightmost, go to _header
+        if (x == x->_parent->_parent) return x->_parent;
+        node_ptr parent = x->_parent;// root->_parent == _header
+        while (x == parent->_right) {// root == _header->_parent
+            x = parent;
+            parent = x->_parent;
+        }
+        return parent; // _header if x points to the rightmost node
+    }
+
+    // precondition: x != nullptr && x != _header
+    static node_ptr tree_prev(node_ptr x) noexcept {
+        if (x->_left != nullptr)
+            return tree_max(x->_left);
+        // ROOT being leftmost, go to _header
+        if (x == x->_parent->_parent) return x->_parent;
+        node_ptr parent = x->_parent;// root->_parent == _header
+        while (x == parent->_left) { // root == _header->_parent
+            x = parent;
+            parent = x->_parent;
+        }
+        return parent; // _header if x points to the leftmost node
+    }
+
+    // equivalent to `new node(val, parent, left = 0, right = 0)`
+    node_ptr new_node(const T& val, node_ptr parent, node_ptr left  = nullptr,
+                                                     node_ptr right = nullptr)
+    {
+        node_ptr p = _alloc.allocate(1);
+        try {
+            ::new ((void*)p) node(val, parent, left, right);
+        }
+        catch (...) {
+            _alloc.deallocate(p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void delete_node(node_ptr x) noexcept {
+        x->~node(); // don't forget
+        _alloc.deallocate(x, 1);
+    }
+
+    // preorder walk along the parent links, a copied node's
+    // (non-null) children tell where we have been
+    node_ptr copy_nodes(node_ptr x, node_ptr parent) {
+        node_ptr root = new_node(x->_val, parent), t = root;
+        try {
+            for (;;) {
+                if (x->_left != nullptr && t->_left == nullptr) {
+                    t->_left = new_node(x->_left->_val, t);
+                    x = x->_left; t = t->_left;
+                }
+                else if (x->_right != nullptr && t->_right == nullptr) {
+                    t->_right = new_node(x->_right->_val, t);
+                    x = x->_right; t = t->_right;
+                }
+                else if (t == root) break;
+                else {
+                    x = x->_parent; t = t->_parent;
+                }
+            }
+        }
+        catch (...) {
+            clear_nodes(root);
+            throw;
+        }
+        return root;
+    }
+
+    // rotate left children up until there is none, then the
+    // top node can go and its right subtree comes next
+    void clear_nodes(node_ptr x) noexcept {
+        while (x != nullptr) {
+            if (node_ptr y = x->_left) {
+                x->_left = y->_right;
+                y->_right = x;
+                x = y;
+            }
+            else {
+                node_ptr next = x->_right;
+                delete_node(x);
+                x = next;
+            }
+        }
+    }
+
+    // map
+    static const key_type& get_key_via_ptr(node_ptr x, std::true_type) {
+        return (x->_val).first;
+    }
+
+    // set
+    static const key_type& get_key_via_ptr(node_ptr x, std::false_type) {
+        return x->_val;
+    }
+
+    static const key_type& get_key(node_ptr x) {
+        return get_key_via_ptr(x, std::bool_constant<IsMap>{});
+    }
+
+    // map
+    static const key_type& get_key_via_t(const T& val, std::true_type) {
+        return val.first;
+    }
+
+    // set
+    static const key_type& get_key_via_t(const T& val, std::false_type) {
+        return val;
+    }
+
+    static const key_type& get_key(const T& val) {
+        return get_key_via_t(val, std::bool_constant<IsMap>{});
+    }
+
+    bool equal(const key_type& key, node_ptr x) const {
+        return !_comp(key, get_key(x)) && !_comp(get_key(x), key);
+    }
+
+    // plain BST search, _header if not found
+    node_ptr search(const key_type& key) const {
+        node_ptr x = empty() ? nullptr : ROOT;
+        while (x != nullptr) {
+            if      (_comp(key, get_key(x))) x = x->_left;
+            else if (_comp(get_key(x), key)) x = x->_right;
+            else return x;
+        }
+        return _header;
+    }
+
+    node_ptr lower_bound_aux(const key_type& key) const {
+        node_ptr x = empty() ? nullptr : ROOT, parent = _header;
+        while (x != nullptr) {
+            if (_comp(get_key(x), key)) x = x->_right;
+            else {// x.key >= key
+                parent = x;
+                x = x->_left;
+            }
+        }
+        return parent; // _header if not found
+    }
+
+    node_ptr upper_bound_aux(const key_type& key) const {
+        node_ptr x = empty() ? nullptr : ROOT, parent = _header;
+        while (x != nullptr) {
+            if (!_comp(key, get_key(x))) x = x->_right;
+            else {// x.key > key
+                parent = x;
+                x = x->_left;
+            }
+        }
+        return parent; // _header if not found
+    }
+
+    // Splays the tree around key, returns the node holding it or _header.
+    node_ptr access(const key_type& key) {
+        if (empty()) return _header;
+        if constexpr (TopDown) {
+            ROOT = splay(ROOT, key);
+            ROOT->_parent = _header;
+            return equal(key, ROOT) ? ROOT : _header;
+        }
+        else {
+            node_ptr x = ROOT, last = ROOT;
+            while (x != nullptr) {
+                last = x;
+                if      (_comp(key, get_key(x))) x = x->_left;
+                else if (_comp(get_key(x), key)) x = x->_right;
+                else break;
+            }
+            semi_splay_up(last);
+            return x != nullptr ? x : _header;
+        }
+    }
+
+    /*
+       Top-down splaying [Sleator & Tarjan 1985]. On the way down, nodes
+       less than key are hung on the right spine of a left tree L, nodes
+       greater than key on the left spine of a right tree R, rotating once
+       first for a zig-zig. When key (or a null link) is reached, its node
+       t is reassembled as the root of L + t + R:
+
+              L     t      R                   t
+                   / \            ==>        /   \
+                  A   B                     L     R
+                                             \   /
+                                              A B
+
+       _header serves as the node that L and R hang off (_header->_right and
+       _header->_left), its links are restored before returning. Returns the
+       new root of subtree t, its parent link is up to the caller.
+    */
+    node_ptr splay(node_ptr t, const key_type& key) noexcept {
+        node_ptr leftmost = _header->_left, rightmost = _header->_right;
+        node_ptr l = _header, r = _header;
+        _header->_left = _header->_right = nullptr;
+        for (;;) {
+            if (_comp(key, get_key(t))) {
+                node_ptr y = t->_left;
+                if (y == nullptr) break;
+                if (_comp(key, get_key(y))) { // zig-zig, rotate right
+                    t->_left = y->_right;
+                    if (y->_right) y->_right->_parent = t;
+                    y->_right = t;
+                    t->_parent = y;
+                    t = y;
+                    if (t->_left == nullptr) break;
+                }
+                r->_left = t; // link right
+                t->_parent = r;
+                r = t;
+                t = t->_left;
+            }
+            else if (_comp(get_key(t), key)) {
+                node_ptr y = t->_right;
+                if (y == nullptr) break;
+                if (_comp(get_key(y), key)) { // zag-zag, rotate left
+                    t->_right = y->_left;
+                    if (y->_left) y->_left->_parent = t;
+                    y->_left = t;
+                    t->_parent = y;
+                    t = y;
+                    if (t->_right == nullptr) break;
+                }
+                l->_right = t; // link left
+                t->_parent = l;
+                l = t;
+                t = t->_right;
+            }
+            else break;
+        }
+        // assemble
+        l->_right = t->_left;
+        if (l->_right) l->_right->_parent = l;
+        r->_left = t->_right;
+        if (r->_left) r->_left->_parent = r;
+        t->_left = _header->_right;
+        if (t->_left) t->_left->_parent = t;
+        t->_right = _header->_left;
+        if (t->_right) t->_right->_parent = t;
+        _header->_left = leftmost;
+        _header->_right = rightmost;
+        return t;
+    }
+
+    // x goes up one level
+    void rotate(node_ptr x) noexcept {
+        node_ptr y = x->_parent, z = y->_parent;
+        if (x == y->_left) {
+            y->_left = x->_right;
+            if (x->_right) x->_right->_parent = y;
+            x->_right = y;
+        }
+        else {
+            y->_right = x->_left;
+            if (x->_left) x->_left->_parent = y;
+            x->_left = y;
+        }
+        y->_parent = x;
+        x->_parent = z;
+        if (z == _header) ROOT = x; // _header->_left may well be y
+        else if (z->_left == y) z->_left = x;
+        else z->_right = x;
+    }
+
+    /*
+       Bottom-up semi-splaying [Sleator & Tarjan 1985, section 5]:
+
+          zig-zig: rotate y, go on from y      zig-zag: rotate x twice, go on from x
+                z                y                   z                 x
+               / \             /   \                / \              /   \
+              y   D    ==>    x     z              y   D    ==>     y     z
+             / \             / \   / \            / \              / \   / \
+            x   C           A   B C   D          A   x            A   B C   D
+           / \                                      / \
+          A   B                                    B   C
+
+       Each step roughly halves the depth of the nodes on the path like a
+       full splay does, but x itself is left at y's place in a zig-zig.
+    */
+    void semi_splay_up(node_ptr x) noexcept {
+        while (x != ROOT && x->_parent != ROOT) {
+            node_ptr y = x->_parent, z = y->_parent;
+            if ((x == y->_left) == (y == z->_left)) {
+                rotate(y);
+                x = y;
+            }
+            else {
+                rotate(x);
+                rotate(x);
+            }
+        }
+    }
+
+    // the new node becomes the leftmost/rightmost if it's less/greater than them
+    void update_extremes(node_ptr z) {
+        if      (_comp(get_key(z), get_key(_header->_left ))) _header->_left  = z;
+        else if (_comp(get_key(_header->_right), get_key(z))) _header->_right = z;
+    }
+
+    std::pair<node_ptr, bool> insert_aux(const T& val, bool assign = false) {
+        if (empty()) {
+            node_ptr z = new_node(val, _header);
+            _count = 1;
+            return { ROOT = _header->_left = _header->_right = z, true };
+        }
+        const key_type& key = get_key(val);
+        if constexpr (TopDown) {
+            node_ptr t = splay(ROOT, key);
+            t->_parent = _header;
+            ROOT = t;
+            if (equal(key, t)) {
+                if constexpr (IsMap) {
+                    if (assign)  t->_val.second = val.second;
+                }
+                return { t, false };
+            }
+            // split at t: the new node becomes the root
+            node_ptr z = new_node(val, _header);
+            if (_comp(key, get_key(t))) {
+                z->_left = t->_left;
+                z->_right = t;
+                t->_left = nullptr;
+            }
+            else {
+                z->_right = t->_right;
+                z->_left = t;
+                t->_right = nullptr;
+            }
+            if (z->_left ) z->_left->_parent  = z;
+            if (z->_right) z->_right->_parent = z;
+            ROOT = z;
+            ++_count;
+            update_extremes(z);
+            return { z, true };
+        }
+        else {
+            node_ptr x = ROOT, parent = _header;
+            while (x != nullptr) {
+                parent = x;
+                if      (_comp(key, get_key(x))) x = x->_left;
+                else if (_comp(get_key(x), key)) x = x->_right;
+                else {
+                    if constexpr (IsMap) {
+                        if (assign)  x->_val.second = val.second;
+                    }
+                    semi_splay_up(x);
+                    return { x, false };
+                }
+            }
+            node_ptr z = new_node(val, parent);
+            if (_comp(key, get_key(parent))) parent->_left = z;
+            else parent->_right = z;
+            ++_count;
+            update_extremes(z);
+            semi_splay_up(z);
+            return { z, true };
+        }
+    }
+
+    // replace node x with node y
+    void replace(node_ptr x, node_ptr y) noexcept {
+        if      (x == ROOT)               ROOT = y == nullptr ? _header : y;
+        else if (x == x->_parent->_left ) x->_parent->_left = y;
+        else                              x->_parent->_right = y;
+        if (y) y->_parent = x->_parent;
+    }
+
+    // precondition: x != nulllptr
+    node_ptr erase(node_ptr x) {
+        assert(x != _header && "cannot erase end() iterator");
+        node_ptr next = tree_next(x), prev = tree_prev(x); // for return & _header
+        if constexpr (TopDown) {
+            // splay x to the root, then splay its predecessor to the top of
+            // its left subtree (where it has no right child) and join them
+            const key_type& key = get_key(x);
+            ROOT = splay(ROOT, key);
+            node_ptr t;
+            if (x->_left == nullptr) t = x->_right;
+            else {
+                t = splay(x->_left, key);
+                t->_right = x->_right;
+                if (x->_right) x->_right->_parent = t;
+            }
+            if (t) t->_parent = _header;
+            ROOT = t == nullptr ? _header : t;
+        }
+        else {
+            node_ptr p; // where to splay from
+            if      (!x->_left ) { p = x->_parent; replace(x, x->_right); }
+            else if (!x->_right) { p = x->_parent; replace(x, x->_left ); }
+            else {
+                node_ptr r_min = tree_min(x->_right);
+                if (r_min != x->_right) {
+                    replace(r_min, r_min->_right);
+                    r_min->_right = x->_right;
+                    x->_right->_parent = r_min;
+                }
+                replace(x, r_min);
+                r_min->_left = x->_left;
+                x->_left->_parent = r_min;
+                p = r_min;
+            }
+            if (p != _header) semi_splay_up(p);
+        }
+        if (x == _header->_left ) _header->_left  = next;
+        if (x == _header->_right) _header->_right = prev;
+        delete_node(x);
+        if (--_count == 0) set_default_header();
+        return next;
+    }
+
+    // print with a max level
+    void print(node_ptr dir, size_t max_level) const {
+        if (empty()) return; // to prevent infinite loop
+        if (max_level == 0) {
+            std::cout << "Invalid level, must be greater than 0.\n";
+            return;
+        }
+        print_val_is_dir(dir, true);
+        size_t dir_count = 0, file_count = 0, curr_level = 1;
+        dfs_print(dir, "", dir_count, file_count, curr_level, max_level);
+        std::cout << '\n' << dir_count << " directories, " << file_count << " files\n";
+    }
+
+#define BLUE    "\033[1;34m"
+#define BROWN   "\033[0;33m"
+#define END     "\033[0m"
+
+    // map
+    static void print_val_via_ptr(node_ptr x, bool is_dir, std::true_type) {
+        if (is_dir) { // brown color for directories
+            std::cout << BROWN << '{' << (x->_val).first << ", " << (x->_val).second << '}' << END << '\n';
+        }             // default color for files
+        else std::cout << '{' << (x->_val).first << ", " << (x->_val).second << "}\n";
+    }
+
+    // set
+    static void print_val_via_ptr(node_ptr x, bool is_dir, std::false_type) {
+        if (is_dir) {
+            std::cout << BROWN << x->_val << END << '\n';
+        }
+        else std::cout << x->_val << '\n';
+    }
+
+    static void print_val_is_dir(node_ptr x, bool is_dir) {
+        print_val_via_ptr(x, is_dir, std::bool_constant<IsMap>{});
+    }
+
+    static void dfs_print_aux(node_ptr curr, bool is_last_child, const std::string& children_prefix,
+        size_t& dir_count, size_t& file_count, size_t curr_level, size_t max_level)
+    {
+        std::string link_shape = !is_last_child ? "├── " : "└── ";
+        std::string prefix_shape = !is_last_child ? "|   " : "    ";
+
+        std::cout << children_prefix << link_shape;
+        if (curr == nullptr) {
+            std::cout << BLUE << "null" << END << '\n';
+            return;
+        }
+        if (has_children(curr)) {
+            ++dir_count;
+            print_val_is_dir(curr, true);
+            if (curr_level < max_level)
+                dfs_print(curr, children_prefix + prefix_shape, dir_count, file_count, curr_level + 1, max_level);
+        }
+        else {
+            ++file_count;
+            print_val_is_dir(curr, false);
+        }
+    }
+
+    // precondition: dir = ROOT != _header or size() > 0
+    static void dfs_print(node_ptr dir, const std::string& children_prefix, size_t& dir_count,
+        size_t& file_count, size_t curr_level, size_t max_level)
+    {
+        if (dir == nullptr) return;
+        dfs_print_aux(dir->_left, false, children_prefix, dir_count, file_count, curr_level, max_level);
+        dfs_print_aux(dir->_right, true, children_prefix, dir_count, file_count, curr_level, max_level);
+    }
+
+    // precondition: dir != nullptr
+    static bool has_children(node_ptr dir) noexcept {
+        return dir->_left != nullptr || dir->_right != nullptr;
+    }
+
+#undef BLUE
+#undef BROWN
+#undef END
+#undef ROOT
+
+    struct SplayTree_node {
+        T _val;
+        node_ptr _parent, _left, _right;
+
+        SplayTree_node(const T& val, node_ptr parent, node_ptr left = nullptr, node_ptr right = nullptr) :
+            _val(val), _parent(parent), _left(left), _right(right) {}
+
+        // in case operator& is overloaded
+        T* val_ptr() {
+            return std::addressof(_val); // return &_val;
+        }
+        const T* val_ptr() const {
+            return std::addressof(_val);
+        }
+    };
+
+    static bool is_header(node_ptr x) {
+        if (x->_left == x) return true; // container's empty
+        if (x->_left == nullptr || x->_right == nullptr) return false;
+        return x->_left->_parent != x;
+    }
+
+    class SplayTree_iter
+    {
+        using _self = SplayTree_iter;
+        node_ptr _ptr;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        SplayTree_iter() noexcept : _ptr(nullptr) {}
+        SplayTree_iter(node_ptr ptr) noexcept : _ptr(ptr) {}
+
+        node_ptr ptr() const noexcept { return _ptr; }
+
+        reference operator*() const {
+            return *_ptr->val_ptr();
+        }
+
+        pointer operator->() const {
+            return _ptr->val_ptr();
+        }
+
+        _self& operator++() {
+            _ptr = tree_next(_ptr);
+            return *this;
+        }
+
+        _self operator++(int) {
+            _self tmp{ *this };
+            _ptr = tree_next(_ptr);
+            return tmp;
+        }
+
+        _self& operator--() {
+            if (is_header(_ptr)) _ptr = _ptr->_right;
+            else                 _ptr = tree_prev(_ptr);
+            return *this;
+        }
+
+        _self operator--(int) {
+            _self tmp{ *this };
+            --*this;
+            return tmp;
+        }
+
+        friend bool operator==(const _self& lhs, const _self& rhs) {
+            return lhs._ptr == rhs._ptr;
+        }
+
+        friend bool operator!=(const _self& lhs, const _self& rhs) {
+            return lhs._ptr != rhs._ptr;
+        }
+    };
+
+    class SplayTree_const_iter
+    {
+        using _self = SplayTree_const_iter;
+        node_ptr _ptr;
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        SplayTree_const_iter() : _ptr(nullptr) {}
+        SplayTree_const_iter(node_ptr ptr) : _ptr(ptr) {}
+        SplayTree_const_iter(const SplayTree_iter& other) : _ptr(other.ptr()) {}
+
+        node_ptr ptr() const noexcept { return _ptr; }
+
+        reference operator*() const {
+            return *_ptr->val_ptr();
+        }
+
+        pointer operator->() const {
+            return _ptr->val_ptr();
+        }
+
+        _self& operator++() {
+            _ptr = tree_next(_ptr);
+            return *this;
+        }
+
+        _self operator++(int) {
+            _self tmp{ *this };
+            _ptr = tree_next(_ptr);
+            return tmp;
+        }
+
+        _self& operator--() {
+            if (is_header(_ptr)) _ptr = _ptr->_right;
+            else                 _ptr = tree_prev(_ptr);
+            return *this;
+        }
+
+        _self operator--(int) {
+            _self tmp{ *this };
+            --*this;
+            return tmp;
+        }
+
+        friend bool operator==(const _self& lhs, const _self& rhs) {
+            return lhs._ptr == rhs._ptr;
+        }
+
+        friend bool operator!=(const _self& lhs, const _self& rhs) {
+            return lhs._ptr != rhs._ptr;
+        }
+    };
+}; // class SplayTree
+
+} // namespace mySymbolTable
+
+#endif // !SPLAYTREE_IMPL_H
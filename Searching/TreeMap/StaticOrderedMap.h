@@ -0,0 +1,242 @@
+/*
+ *  ordered symbol tables:
+ *  static (read-only) ordered map with an Eytzinger search layout
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/StaticOrderedMap.h
+ *
+ *  usage:
+ *      mySymbolTable::RbMap<int, std::string> mp = ...;
+ *      auto frozen = mp.freeze(); // StaticOrderedMap<int, std::string>
+ *      auto it = frozen.lower_bound(42);
+ */
+
+#ifndef STATICORDEREDMAP_H
+#define STATICORDEREDMAP_H 1
+
+#include <vector>
+#include <utility>    // std::pair
+#include <functional> // std::less
+#include <algorithm>  // std::adjacent_find, std::stable_sort
+#include <iterator>   // std::distance, std::iterator_traits
+#include <type_traits> // std::is_base_of_v
+#include <stdexcept>  // std::out_of_range
+#include <cstdint>    // std::uintptr_t
+#include <initializer_list>
+
+namespace mySymbolTable {
+
+// An immutable map for read-mostly phases. The elements sit in one sorted
+// array, so iteration and ranges are plain pointer increments, while the
+// search goes through a copy of the keys in Eytzinger (BFS) order:
+// keys[1] is the root and node k has children 2k and 2k+1. The top levels
+// of that array stay hot in cache, and since the search is branchless we
+// can prefetch the cache line holding the descendants a few levels ahead.
+// The sorted position of a node follows from its index alone (see rank()),
+// so a lookup touches nothing but _keys before it lands in _data.
+template<typename Key, typename T, typename Compare = std::less<Key>>
+class StaticOrderedMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using key_compare = Compare;
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+    using iterator = const_iterator;
+    using const_reverse_iterator = typename std::vector<value_type>::const_reverse_iterator;
+    using reverse_iterator = const_reverse_iterator;
+
+    /* I */
+
+    StaticOrderedMap() : StaticOrderedMap(Compare()) {}
+
+    explicit StaticOrderedMap(const Compare& comp) : _comp(comp) {}
+
+    /* II */
+
+    // Sorts the range if it isn't already (e.g. when frozen from a tree map
+    // it is), for equivalent keys only the first one is kept.
+    template< class InputIt >
+    StaticOrderedMap(InputIt first, InputIt last, const Compare& comp = Compare())
+        : _comp(comp)
+    {
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        auto less = [this](const auto& a, const auto& b) { return _comp(a.first, b.first); };
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            if (std::adjacent_find(first, last, [&](const auto& a, const auto& b) { return !less(a, b); }) == last) {
+                _data.reserve(std::distance(first, last));
+                for (; first != last; ++first)
+                    _data.emplace_back(*first);
+                build();
+                return;
+            }
+        }
+        std::vector<std::pair<Key, T>> tmp(first, last);
+        std::stable_sort(tmp.begin(), tmp.end(), less);
+        _data.reserve(tmp.size());
+        for (auto& kv : tmp) {
+            if (_data.empty() || _comp(_data.back().first, kv.first))
+                _data.emplace_back(std::move(kv.first), std::move(kv.second));
+        }
+        build();
+    }
+
+    /* III */
+
+    StaticOrderedMap(std::initializer_list<value_type> init, const Compare& comp = Compare())
+        : StaticOrderedMap(init.begin(), init.end(), comp) {}
+
+    /* iterators, in key order */
+
+    const_iterator begin() const noexcept { return _data.cbegin(); }
+    const_iterator end() const noexcept { return _data.cend(); }
+    const_iterator cbegin() const noexcept { return _data.cbegin(); }
+    const_iterator cend() const noexcept { return _data.cend(); }
+    const_reverse_iterator rbegin() const noexcept { return _data.crbegin(); }
+    const_reverse_iterator rend() const noexcept { return _data.crend(); }
+
+    /* capacity */
+
+    bool empty() const noexcept { return _data.empty(); }
+
+    size_t size() const noexcept { return _data.size(); }
+
+    /* lookup */
+
+    const_iterator find(const Key& key) const {
+        const_iterator it = lower_bound(key);
+        return it != end() && !_comp(key, it->first) ? it : end();
+    }
+
+    bool contains(const Key& key) const { return find(key) != end(); }
+
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    const T& at(const Key& key) const {
+        const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("StaticOrderedMap<K, T> key does not exist");
+        return it->second;
+    }
+
+    // first element not less than key
+    const_iterator lower_bound(const Key& key) const {
+        return begin() + rank(search</*Upper=*/false>(key));
+    }
+
+    // first element greater than key
+    const_iterator upper_bound(const Key& key) const {
+        return begin() + rank(search</*Upper=*/true>(key));
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        const_iterator it = lower_bound(key);
+        if (it != end() && !_comp(key, it->first)) return { it, it + 1 };
+        return { it, it };
+    }
+
+    // the k-th (0-based) smallest element
+    const_iterator nth(size_t k) const { return begin() + k; }
+
+    /* observers */
+
+    key_compare key_comp() const { return _comp; }
+
+    // total bytes of the arrays, not counting what the elements own
+    size_t memory_usage() const noexcept {
+        return _data.capacity() * sizeof(value_type) + _keys.capacity() * sizeof(Key);
+    }
+
+private:
+    // # of keys in a cache line, a power of 2 (for 4-byte keys, 16),
+    // i.e. the # of descendants log2(KeysPerLine) levels below a node
+    static constexpr size_t KeysPerLine = sizeof(Key) >= 64 ? 1 : sizeof(Key) > 32 ? 2 :
+                                          sizeof(Key) > 16 ? 4 : sizeof(Key) > 8 ? 8 : 16;
+
+    static void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#else
+        (void)p;
+#endif
+    }
+
+    // Index (into _keys) of the first key not less than (Upper: greater
+    // than) `key`, 0 if none. Going right appends a 1 bit to k, left a 0,
+    // so the answer is where we last went left: strip the trailing 1s
+    // plus the 0 before them.
+    template<bool Upper>
+    size_t search(const Key& key) const {
+        const size_t n = _data.size();
+        const Key* keys = _keys.data();
+        size_t k = 1;
+        while (k <= n) {
+            // the node KeysPerLine * k is where the search will be in log2(KeysPerLine) steps;
+            // computed as an integer as it may well be past the end
+            prefetch(reinterpret_cast<const void*>(
+                reinterpret_cast<std::uintptr_t>(keys) + k * KeysPerLine * sizeof(Key)));
+            if constexpr (Upper) k = 2 * k + !_comp(key, keys[k]);
+            else                 k = 2 * k + _comp(keys[k], key);
+        }
+        return k >> trailing_ones(k) >> 1;
+    }
+
+    // Index in _data of node k, n if k is 0. The levels above the last one,
+    // H = floor(log2(n)), are full; in a perfect tree of height H node k on
+    // level d would be the r-th (1-based) in order, r = (2(k - 2^d) + 1) 2^(H-d).
+    // Before it come r/2 slots of the last level, those past the m = n - 2^H + 1
+    // that exist are missing and don't count.
+    size_t rank(size_t k) const noexcept {
+        const size_t n = _data.size();
+        if (k == 0) return n;
+        const int h = floor_log2(n), d = floor_log2(k);
+        const size_t r = (2 * (k - (size_t(1) << d)) + 1) << (h - d);
+        const size_t m = n - (size_t(1) << h) + 1;
+        const size_t missing = r / 2 > m ? r / 2 - m : 0;
+        return r - 1 - missing;
+    }
+
+    static int floor_log2(size_t k) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(static_cast<unsigned long long>(k));
+#else
+        int c = -1;
+        for (; k; k >>= 1) ++c;
+        return c;
+#endif
+    }
+
+    static int trailing_ones(size_t k) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(~static_cast<unsigned long long>(k));
+#else
+        int c = 0;
+        for (; k & 1; k >>= 1) ++c;
+        return c;
+#endif
+    }
+
+    // lay out the keys in Eytzinger order by an in-order walk of the implicit tree
+    void build() {
+        size_t n = _data.size();
+        if (n == 0) return;
+        _keys.assign(n + 1, _data[0].first); // _keys[0] is unused
+        size_t i = 0;
+        build(1, i);
+    }
+
+    void build(size_t k, size_t& i) {
+        if (k > _data.size()) return;
+        build(2 * k, i);
+        _keys[k] = _data[i++].first;
+        build(2 * k + 1, i);
+    }
+
+    Compare _comp;
+    std::vector<value_type> _data; // sorted
+    std::vector<Key> _keys;        // Eytzinger order, 1-based
+};
+
+} // namespace mySymbolTable
+
+#endif // !STATICORDEREDMAP_H
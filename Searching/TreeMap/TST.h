@@ -12,7 +12,13 @@
 #include <algorithm> // std::reverse_copy
 #include <iostream>  // std::cerr, std::cout
 #include <stdexcept>
+#include <limits>    // std::numeric_limits
+#include <type_traits>
+#include <memory>    // std::allocator_traits
 #include <cassert>
+#include "batch_lookup.h" // myst::interleave_lookups
+#include "MemPool/MonotonicArena.h" // myst::drops_without_walk_v
+#include "../../DynamicProgramming/EditDistance/ed_rows.h"
 
 namespace mySymbolTable {
 
@@ -30,12 +36,17 @@ namespace mySymbolTable {
 #endif
 
 // Ternary Search Tree symbol table: key=string -> T
-template<typename T>
+// Nodes and values come from Alloc rebound to them. With a monotonic one
+// (e.g. MonotonicAllocator) and trivially destructible values, clear() and
+// the destructor leave the nodes to the arena instead of visiting them.
+template<typename T, typename Alloc = std::allocator<T>>
 class TST {
     class Tst_iter;
     class Tst_const_iter;
     class Tst_reverse_iter;
     class Tst_const_reverse_iter;
+    class Tst_prefix_iter;
+    class Tst_prefix_range;
 
     enum class Link : char { LEFT, MID, RIGHT };
 
@@ -50,23 +61,37 @@ class TST {
         Node() {}
         Node(char c) : ch(c) {}
         Node(char c, Link pos, Node* parent) : ch(c), pos(pos), parent(parent) {}
-        ~Node() { delete pval; }
     };
     using node_ptr = Node*;
+    using node_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using value_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+    using node_traits = std::allocator_traits<node_alloc>;
+    using value_traits = std::allocator_traits<value_alloc>;
 
     node_ptr root;   // pointer to root node whose link is MID
     size_t n;        // no. of keys in TST
+    node_alloc nalloc;
+    value_alloc valloc;
 public:
+    using allocator_type = Alloc;
     using iterator = Tst_iter;
     using const_iterator = Tst_const_iter;
     using reverse_iterator = Tst_reverse_iter;
     using const_reverse_iterator = Tst_const_reverse_iter;
+    using prefix_iterator = Tst_prefix_iter;
 
-    TST() : root(nullptr), n(0) {}
+    TST() : TST(Alloc()) {}
+
+    explicit TST(const Alloc& alloc) : root(nullptr), n(0), nalloc(alloc), valloc(alloc) {}
+
+    TST(const TST&) = delete;
+    TST& operator=(const TST&) = delete;
 
     ~TST() { clear(); }
 
-    void clear() { clear(root); root = nullptr; }
+    void clear() { clear(root); root = nullptr; n = 0; }
+
+    allocator_type get_allocator() const { return allocator_type(valloc); }
 
     T& operator[](const std::string& key) {
         if (key == "") throw std::invalid_argument("key to operator[] cannot be null");
@@ -148,30 +173,86 @@ public:
     }
 
     std::vector<std::string> keys() const {
-        std::vector<std::string> vs;
-        collect(root, "", vs);
-        return vs; // it'll be totally fine to return large object thanks to RVO
+        return keys_with_prefix("");
     }
 
     std::vector<std::string> keys_with_prefix(const std::string& prefix) const {
-        if (prefix == "") return keys();
         std::vector<std::string> vs;
-        node_ptr x = find_aux(prefix);
-        if (x == nullptr) return vs; // no matches, return empty vector
-        if (x->pval != nullptr)    vs.push_back(prefix);
-        collect(x->mid, prefix, vs);
+        for_each_with_prefix(prefix, [&vs](const std::string& key, const T&) { vs.push_back(key); });
         return vs; // it'll be totally fine to return large object due to RVO
     }
 
     // using wildcard ? to represent any single character
     // e.g. file?.h matches first two in {file1.h, file2.h, file3.cc}
     std::vector<std::string> keys_that_match(const std::string& pattern) const {
-        if (pattern == "") throw std::invalid_argument("pattern to keys_that_match() cannot be null");
         std::vector<std::string> vs;
-        collect(root, "", pattern, 0, vs);
+        for_each_that_match(pattern, [&vs](const std::string& key, const T&) { vs.push_back(key); });
         return vs;
     }
 
+    // Calls fn(key, val) for the keys starting with prefix ("" for all keys) in
+    // order, without materializing them: the key is built in a single buffer
+    // that is only valid during the call. fn may return false to stop early,
+    // and at most limit keys are visited. Returns the number of keys visited.
+    template<typename Fn>
+    size_t for_each_with_prefix(const std::string& prefix, Fn fn,
+                                size_t limit = std::numeric_limits<size_t>::max()) const {
+        key_visitor<Fn> visit{ fn, limit, 0 };
+        std::string key(prefix);
+        node_ptr x = root;
+        if (prefix != "") {
+            x = find_node(root, prefix, 0);
+            if (x == nullptr) return 0;
+            if (x->pval != nullptr && !visit(key, *x->pval)) return visit.count;
+            x = x->mid;
+        }
+        collect(x, key, visit);
+        return visit.count;
+    }
+
+    // the same as above for the keys that match pattern, see keys_that_match()
+    template<typename Fn>
+    size_t for_each_that_match(const std::string& pattern, Fn fn,
+                               size_t limit = std::numeric_limits<size_t>::max()) const {
+        if (pattern == "") throw std::invalid_argument("pattern to for_each_that_match() cannot be null");
+        key_visitor<Fn> visit{ fn, limit, 0 };
+        std::string key;
+        key.reserve(pattern.length());
+        collect(root, key, pattern, 0, visit);
+        return visit.count;
+    }
+
+    // Lazy range of the keys starting with prefix ("" for all keys), e.g.
+    //     for (auto [key, val] : tst.prefix_range("sh")) ...
+    // Its forward iterators keep the current key in a buffer that they
+    // update as they move, so walking them doesn't allocate per key.
+    Tst_prefix_range prefix_range(const std::string& prefix) const {
+        if (prefix == "") return Tst_prefix_range(prefix_iterator(nullptr, prefix, this), this);
+        node_ptr x = find_node(root, prefix, 0);
+        if (x == nullptr) return Tst_prefix_range(prefix_iterator(this), this);
+        return Tst_prefix_range(prefix_iterator(x, prefix, this), this);
+    }
+
+    // keys within edit distance k of query ("did you mean"), in order, with
+    // their distances; with transpositions, swapping two adjacent characters
+    // is one edit too
+    std::vector<std::pair<std::string, int>> keys_within_distance(const std::string& query, int k,
+                                                                  bool transpositions = false) const {
+        std::vector<std::pair<std::string, int>> res;
+        EditDistanceRows ed(query, k, transpositions);
+        for_each_within_distance(ed, [&res](const std::string& key, int dist) { res.emplace_back(key, dist); });
+        return res;
+    }
+
+    // Calls fn(key, dist) for the keys within distance of the query of ed,
+    // walking the tree with one DP row per depth and skipping the subtrees
+    // that are out of reach (see ed_rows.h). The keys are appended to
+    // ed.key(), so that a TST can also hang below some other trie level.
+    template<typename Fn>
+    void for_each_within_distance(EditDistanceRows& ed, Fn fn) const {
+        if (ed.viable()) collect(root, ed, fn);
+    }
+
     std::string longest_prefix_of(const std::string& query) {
         if (query == "") throw std::invalid_argument("query to longest_prefix_of() cannot be null");
         size_t len = max_len(root, query, 0, 0); // 0 if no substring of query
@@ -183,6 +264,12 @@ public:
         return insert(root, key, val, 0);
     }
 
+    // insert(key.substr(pos), val) without making the copy
+    node_ptr insert(const std::string& key, size_t pos, const T& val) {
+        if (pos >= key.length()) throw std::invalid_argument("key to insert() cannot be null");
+        return insert(root, key, val, pos);
+    }
+
     node_ptr insert_or_assign(const std::string& key, const T& val) {
         if (key == "") throw std::invalid_argument("key to insert_or_assign() cannot be null");
         return insert(root, key, val, 0, /*assign=*/true);
@@ -204,6 +291,26 @@ public:
         return const_iterator(find_aux(key), this);
     }
 
+    // find(key.substr(pos)) without making the copy, e.g. for keys whose
+    // first pos characters are implied by the container of this TST
+    iterator find(const std::string& key, size_t pos) {
+        if (pos >= key.length()) throw std::invalid_argument("key to find() cannot be null");
+        return iterator(find_aux(root, key, pos), this);
+    }
+
+    const_iterator find(const std::string& key, size_t pos) const {
+        if (pos >= key.length()) throw std::invalid_argument("key to find() cannot be null");
+        return const_iterator(find_aux(root, key, pos), this);
+    }
+
+    // Writes find(key) of each key in the range to out[0], out[1], ... (a
+    // random access iterator to const_iterators), running the lookups
+    // interleaved so that their cache misses overlap, see batch_lookup.h.
+    template<typename KeyRange, typename RandomIt>
+    void find_batch(const KeyRange& keys, RandomIt out) const {
+        interleave_lookups(find_probe{ this }, std::begin(keys), std::end(keys), out);
+    }
+
     static std::string key(iterator iter) {
         return get_key(iter.ptr());
     }
@@ -412,17 +519,59 @@ private:
 
     // return pointer to key node, null if not found
     static node_ptr find_aux(node_ptr x, const std::string& key, size_t d) {
+        x = find_node(x, key, d);
+        // the node may be present, but not contain a value
+        return x != nullptr && x->pval != nullptr ? x : nullptr;
+    }
+
+    // return pointer to the node of key's last character, whether or not
+    // it holds a value, null if there's no such node
+    static node_ptr find_node(node_ptr x, const std::string& key, size_t d) {
         while (x != nullptr) {
             if      (key[d] < x->ch)    x = x->left;
             else if (key[d] > x->ch)    x = x->right;
             else if (d < key.length() - 1) { x = x->mid; ++d; }
-            else { // the node is present, but it may not contain a value
-                return x->pval ? x : nullptr;
-            }
+            else return x;
         }
         return nullptr;
     }
 
+    // find_aux(root, key, 0) one node at a time, for find_batch()
+    struct find_probe {
+        const TST* tst;
+
+        struct state_type {
+            node_ptr x;
+            const std::string* key;
+            size_t d;
+        };
+        using result_type = const_iterator;
+
+        bool start(const std::string& key, state_type& s) const {
+            if (key == "") throw std::invalid_argument("key to find_batch() cannot be null");
+            s = { tst->root, &key, 0 };
+            if (s.x == nullptr) return false;
+            batch_prefetch(s.x);
+            return true;
+        }
+
+        bool step(state_type& s) const {
+            const std::string& key = *s.key;
+            if      (key[s.d] < s.x->ch)    s.x = s.x->left;
+            else if (key[s.d] > s.x->ch)    s.x = s.x->right;
+            else if (s.d < key.length() - 1) { s.x = s.x->mid; ++s.d; }
+            else { // the node is present, but it may not contain a value
+                if (s.x->pval == nullptr) s.x = nullptr;
+                return false;
+            }
+            if (s.x == nullptr) return false;
+            batch_prefetch(s.x);
+            return true;
+        }
+
+        result_type result(const state_type& s) const { return const_iterator(s.x, tst); }
+    };
+
     // return the pointer to the newly inserted or overwritten node
     // using reference so that root pointer will be set on first insertion
     node_ptr insert(node_ptr& x, const std::string& key, const T& val,
@@ -432,14 +581,14 @@ private:
         Link pos = Link::MID; // link value for root if it is null
         node_ptr parent = nullptr;
         for (;;) {
-            if (*cur == nullptr) *cur = new Node(key[d], pos, parent);
+            if (*cur == nullptr) *cur = new_node(key[d], pos, parent);
             parent = *cur;
             if      (key[d] < (*cur)->ch) { cur = & (*cur)->left;  pos = Link::LEFT; }
             else if (key[d] > (*cur)->ch) { cur = & (*cur)->right; pos = Link::RIGHT; }
             else if (d < key.length() - 1) { cur = & (*cur)->mid;  pos = Link::MID; ++d; }
             else { // found
                 if ((*cur)->pval == nullptr) {
-                    (*cur)->pval = new T(val);
+                    (*cur)->pval = new_value(val);
                     ++n;
                 }
                 else if (assign) { // overwrite
@@ -474,49 +623,145 @@ private:
         else if (d < key.length() - 1) erase(x->mid, key, d + 1);
         else {
             if (x->pval != nullptr) { // found
-                delete x->pval;    --n;
+                delete_value(x->pval);    --n;
                 x->pval = nullptr;
             }
         }
 
         if (is_leaf(x) && x->pval == nullptr) {
-            delete x; x = nullptr;
+            delete_node(x); x = nullptr;
+        }
+    }
+
+    node_ptr new_node(char c, Link pos, node_ptr parent) {
+        node_ptr x = node_traits::allocate(nalloc, 1);
+        node_traits::construct(nalloc, x, c, pos, parent);
+        return x;
+    }
+
+    // precondition: x->pval == nullptr
+    void delete_node(node_ptr x) {
+        node_traits::destroy(nalloc, x);
+        node_traits::deallocate(nalloc, x, 1);
+    }
+
+    T* new_value(const T& val) {
+        T* p = value_traits::allocate(valloc, 1);
+        try {
+            value_traits::construct(valloc, p, val);
+        }
+        catch (...) {
+            value_traits::deallocate(valloc, p, 1);
+            throw;
         }
+        return p;
     }
 
+    void delete_value(T* p) {
+        value_traits::destroy(valloc, p);
+        value_traits::deallocate(valloc, p, 1);
+    }
+
+    // Frees the subtree rooted at x without recursion, so that no depth
+    // can overflow the stack: a left or mid child is rotated up over x (x
+    // takes over the child's right subtree in its place) until x has
+    // neither, then x is freed and we go on to its right. Every rotation
+    // adds a node to the right spine we walk down, so it's O(n) time and
+    // O(1) space.
     void clear(node_ptr x) {
-        if (x == nullptr) return;
-        clear(x->left);
-        clear(x->mid);
-        clear(x->right);
-        delete x;
+        if constexpr (drops_without_walk_v<Alloc, Node, T>) return;
+        while (x != nullptr) {
+            node_ptr y;
+            if (x->left != nullptr) {
+                y = x->left;
+                x->left = y->right;
+            }
+            else if (x->mid != nullptr) {
+                y = x->mid;
+                x->mid = y->right;
+            }
+            else {
+                y = x->right;
+                if (x->pval != nullptr) delete_value(x->pval);
+                delete_node(x);
+                x = y;
+                continue;
+            }
+            y->right = x;
+            x = y;
+        }
     }
 
-    // collect keys in TST rooted at x with given prefix
+    // hands keys to the callback of for_each_*(), counting them
+    template<typename Fn>
+    struct key_visitor {
+        Fn& fn;
+        size_t limit;
+        size_t count;
+
+        // false if no more keys are wanted
+        bool operator()(const std::string& key, const T& val) {
+            if (count == limit) return false;
+            ++count;
+            if constexpr (std::is_void_v<decltype(fn(key, val))>) {
+                fn(key, val);
+                return count < limit;
+            }
+            else {
+                return fn(key, val) && count < limit;
+            }
+        }
+    };
+
+    // visit keys in TST rooted at x, where key holds the prefix of x
+    // (it is extended and restored in place), false if visit stopped
     // note that x points to the mid link node of prefix node (if any)
-    void collect(node_ptr x, const std::string& prefix, std::vector<std::string>& vs) const {
-        if (x == nullptr) return;
-        collect(x->left, prefix, vs);
-        if (x->pval != nullptr) vs.push_back(prefix + x->ch);
-        collect(x->mid, prefix + x->ch, vs);
-        collect(x->right, prefix, vs);
+    template<typename Visitor>
+    static bool collect(node_ptr x, std::string& key, Visitor& visit) {
+        for (; x != nullptr; x = x->right) { // loop on the right link
+            if (!collect(x->left, key, visit)) return false;
+            key.push_back(x->ch);
+            bool more = (x->pval == nullptr || visit(key, *x->pval)) && collect(x->mid, key, visit);
+            key.pop_back();
+            if (!more) return false;
+        }
+        return true;
     }
 
     // precondition: pattern != "" (null string)
     // note that x points to the mid link node of prefix node (if any)
-    void collect(node_ptr x, const std::string& prefix, const std::string& pattern,
-        size_t i, std::vector<std::string>& vs) const {
+    template<typename Visitor>
+    static bool collect(node_ptr x, std::string& key, const std::string& pattern,
+        size_t i, Visitor& visit) {
         // e.g. collect  file?.h  in {file1.h, file2.h, file3.cc}
-        if (x == nullptr) return;
         assert(i < pattern.length());
-
         char curr = pattern[i];
-        if (curr < x->ch || curr == '?') collect(x->left, prefix, pattern, i, vs);
-        if (curr == x->ch || curr == '?') {
-            if (i == pattern.length() - 1 && x->pval != nullptr) vs.push_back(prefix + x->ch);
-            if (i < pattern.length() - 1) collect(x->mid, prefix + x->ch, pattern, i + 1, vs);
+        while (x != nullptr) {
+            if ((curr < x->ch || curr == '?') && !collect(x->left, key, pattern, i, visit)) return false;
+            if (curr == x->ch || curr == '?') {
+                key.push_back(x->ch);
+                bool more = i == pattern.length() - 1 ? x->pval == nullptr || visit(key, *x->pval)
+                                                      : collect(x->mid, key, pattern, i + 1, visit);
+                key.pop_back();
+                if (!more) return false;
+            }
+            if (curr > x->ch || curr == '?') x = x->right;
+            else break;
+        }
+        return true;
+    }
+
+    // visit keys in TST rooted at x within the distance bound of ed
+    // note that x points to the mid link node of prefix node (if any)
+    template<typename Fn>
+    static void collect(node_ptr x, EditDistanceRows& ed, Fn& fn) {
+        for (; x != nullptr; x = x->right) { // loop on the right link
+            collect(x->left, ed, fn);
+            bool viable = ed.push(x->ch);
+            if (x->pval != nullptr && ed.matches()) fn(ed.key(), ed.distance());
+            if (viable) collect(x->mid, ed, fn);
+            ed.pop();
         }
-        if (curr > x->ch || curr == '?') collect(x->right, prefix, pattern, i, vs);
     }
 
     class Tst_iter
@@ -678,6 +923,134 @@ private:
         const TST* _ptree;
     };
 
+    // Forward iterator over the keys below a node (see prefix_range()). Rather
+    // than rebuilding the key from parent links on each dereference, it keeps
+    // the current key in _key, pushing and popping characters as it crosses
+    // mid links, and it stops when it climbs back to the prefix node.
+    class Tst_prefix_iter
+    {
+        using _self = Tst_prefix_iter;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const std::string&, const T&>;
+        using difference_type = ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type;
+
+        Tst_prefix_iter() : _ptr(nullptr), _stop(nullptr), _ptree(nullptr) {}
+        explicit Tst_prefix_iter(const TST* ptree) : _ptr(nullptr), _stop(nullptr), _ptree(ptree) {}
+
+        // first key below the prefix node stop (inclusive), whose key is prefix,
+        // or the first key in the tree if stop is null
+        Tst_prefix_iter(node_ptr stop, std::string prefix, const TST* ptree)
+            : _ptr(nullptr), _stop(stop), _key(std::move(prefix)), _ptree(ptree) {
+            node_ptr first = stop != nullptr ? stop->mid : ptree->root;
+            if (stop != nullptr && stop->pval != nullptr) _ptr = stop;
+            else if (first != nullptr) descend(first, true);
+        }
+
+        const value_type operator*() const {
+            _assert(_ptr != nullptr, "cannot dereference end() iterator");
+            return value_type(_key, *(_ptr->pval));
+        }
+
+        _self& operator++() {
+            _assert(_ptr != nullptr, "cannot increment end() iterator");
+            advance();
+            return *this;
+        }
+
+        _self operator++(int) {
+            _assert(_ptr != nullptr, "cannot increment end() iterator");
+            _self tmp{ *this };
+            advance();
+            return tmp;
+        }
+
+        friend bool operator==(const _self& lhs, const _self& rhs) {
+            _assert(lhs._ptree == rhs._ptree, "iterators incompatible");
+            return lhs._ptr == rhs._ptr;
+        }
+
+        friend bool operator!=(const _self& lhs, const _self& rhs) {
+            _assert(lhs._ptree == rhs._ptree, "iterators incompatible");
+            return lhs._ptr != rhs._ptr;
+        }
+
+        // auxiliary functions
+        node_ptr ptr() const noexcept { return _ptr; }
+        const TST* cont() const noexcept { return _ptree; }
+
+        // the ordinary iterator at the same key
+        const_iterator base() const noexcept { return const_iterator(_ptr, _ptree); }
+
+        // valid until the iterator moves
+        const std::string& key() const {
+            _assert(_ptr != nullptr, "cannot get the key of end() iterator");
+            return _key;
+        }
+
+        const T& val() const {
+            _assert(_ptr != nullptr, "cannot get the value of end() iterator");
+            return *(_ptr->pval);
+        }
+    private:
+        // the same walk as leftmost(), x is a mid link child if new_level
+        void descend(node_ptr x, bool new_level) {
+            if (new_level) _key.push_back('\0');
+            for (;;) {
+                if (x->left != nullptr) { x = x->left; continue; }
+                _key.back() = x->ch;
+                if (x->pval != nullptr) break;
+                if (x->mid != nullptr) { _key.push_back('\0'); x = x->mid; }
+                else x = x->right;
+            }
+            _ptr = x;
+        }
+
+        // the same walk as tree_next(), but ends at _stop
+        void advance() {
+            node_ptr x = _ptr;
+            if (x->mid != nullptr)                   return descend(x->mid, true);
+            if (x != _stop && x->right != nullptr)   return descend(x->right, false);
+            for (Link pos; x != _stop; /* empty */) {
+                pos = x->pos;
+                x = x->parent;
+                if (x == _stop) break;
+                if (pos == Link::LEFT) {
+                    _key.back() = x->ch;
+                    if (x->pval  != nullptr) { _ptr = x; return; }
+                    if (x->mid   != nullptr) return descend(x->mid, true);
+                    if (x->right != nullptr) return descend(x->right, false);
+                }
+                else if (pos == Link::MID) {
+                    _key.pop_back();
+                    if (x->right != nullptr) return descend(x->right, false);
+                }
+                // else pos == Link::RIGHT, keep going up
+            }
+            _ptr = nullptr;
+        }
+
+        node_ptr _ptr;
+        node_ptr _stop;   // prefix node, null for the whole tree
+        std::string _key; // key of _ptr
+        const TST* _ptree;
+    };
+
+    class Tst_prefix_range
+    {
+    public:
+        Tst_prefix_range(prefix_iterator first, const TST* ptree) : _first(std::move(first)), _ptree(ptree) {}
+
+        prefix_iterator begin() const { return _first; }
+        prefix_iterator end() const { return prefix_iterator(_ptree); }
+        bool empty() const { return _first.ptr() == nullptr; }
+    private:
+        prefix_iterator _first;
+        const TST* _ptree;
+    };
+
     class Tst_reverse_iter : public std::reverse_iterator<iterator> {
         using _base = std::reverse_iterator<iterator>;
     public:
@@ -0,0 +1,98 @@
+/*
+ *  interleaved batch lookups for pointer-chasing containers
+ *  (RBtree/AVLtree/TST/SkipList find_batch)
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/batch_lookup.h
+ *
+ *  usage:
+ *      std::vector<int> keys = ...;
+ *      std::vector<mySymbolTable::RbMap<int, int>::const_iterator> out(keys.size());
+ *      mp.find_batch(keys, out.begin()); // out[i] == mp.find(keys[i])
+ */
+
+#ifndef BATCH_LOOKUP_H
+#define BATCH_LOOKUP_H 1
+
+#include <cstddef> // size_t
+
+namespace mySymbolTable {
+
+// # of lookups kept in flight, enough to cover a DRAM miss with the
+// ~10 line fill buffers of a core without thrashing the L1
+constexpr size_t BatchLookupWidth = 16;
+
+inline void batch_prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+// A single find() walking a tree stalls on one dependent cache miss per
+// level. With many independent keys at hand we can instead run the lookups
+// as small state machines and switch to another one right after issuing a
+// prefetch for the next node, so up to Width misses overlap (AMAC,
+// "asynchronous memory access chaining", Kocberber et al., VLDB 2015).
+//
+// A probe describes one container's lookup:
+//
+//     struct probe {
+//         using state_type = ...;  // where a lookup is, trivially copyable
+//         using result_type = ...;
+//         // set up the lookup of key, prefetching the first node,
+//         // false if it is already over (e.g. the container is empty)
+//         bool start(const Key& key, state_type& s) const;
+//         // one level down: look at the (prefetched) current node, move on
+//         // and prefetch the next one, false once the lookup is over
+//         bool step(state_type& s) const;
+//         result_type result(const state_type& s) const;
+//     };
+//
+// The result of the i-th key goes to out[i], which thus has to be a random
+// access iterator, and the keys have to stay put during the call.
+template<size_t Width = BatchLookupWidth, typename Probe, typename ForwardIt, typename RandomIt>
+void interleave_lookups(const Probe& probe, ForwardIt first, ForwardIt last, RandomIt out)
+{
+    static_assert(Width > 0, "at least one lookup has to be in flight");
+    struct slot {
+        typename Probe::state_type state;
+        size_t idx;
+    };
+    slot slots[Width];
+    size_t active = 0, next_idx = 0;
+
+    // the next lookup that isn't over right away, false if none is left
+    auto start_next = [&](slot& s) {
+        for (; first != last; ++first) {
+            size_t idx = next_idx++;
+            if (probe.start(*first, s.state)) {
+                s.idx = idx;
+                ++first;
+                return true;
+            }
+            out[idx] = probe.result(s.state);
+        }
+        return false;
+    };
+
+    while (active < Width && start_next(slots[active])) {
+        ++active;
+    }
+    for (size_t k = 0; active != 0; ) {
+        slot& s = slots[k];
+        if (!probe.step(s.state)) {
+            out[s.idx] = probe.result(s.state);
+            if (!start_next(s)) {
+                s = slots[--active]; // fill the hole with the last one, step it next
+                if (k >= active) k = 0;
+                continue;
+            }
+        }
+        if (++k >= active) k = 0;
+    }
+}
+
+} // namespace mySymbolTable
+
+#endif // !BATCH_LOOKUP_H
@@ -0,0 +1,168 @@
+/*
+ *  a minimal fork-join thread pool for the
+ *  divide-and-conquer tree algorithms
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/fork_join_pool.h
+ *
+ *  usage:
+ *      mySymbolTable::ForkJoinPool::instance().fork_join(
+ *          [&] { left  = solve(lhs); },
+ *          [&] { right = solve(rhs); });
+ */
+
+#ifndef FORK_JOIN_POOL_H
+#define FORK_JOIN_POOL_H 1
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>   // std::exception_ptr
+#include <deque>
+#include <vector>
+#include <algorithm>   // std::find
+#include <iterator>    // std::next
+#include <type_traits> // std::remove_reference_t
+
+namespace mySymbolTable {
+
+// fork_join(f, g) runs f on the calling thread and offers g to the workers.
+// When f is done the caller takes g back if nobody has picked it up yet,
+// otherwise it runs other pending tasks until g completes, so nested
+// fork_join calls never block a thread that could be doing useful work
+// (and can't deadlock however deep the recursion goes).
+// If f or g throws, fork_join still waits for g before rethrowing, f's
+// exception winning if both do.
+class ForkJoinPool {
+public:
+    // `nthreads` threads in total, including the calling one
+    explicit ForkJoinPool(unsigned nthreads = std::thread::hardware_concurrency()) {
+        for (unsigned i = 1; i < nthreads; ++i)
+            _workers.emplace_back([this] { work(); });
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    ~ForkJoinPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _stop = true;
+        }
+        _cv.notify_all();
+        for (auto& t : _workers)
+            t.join();
+    }
+
+    // # of threads that may run tasks, including the calling one
+    unsigned size() const noexcept { return static_cast<unsigned>(_workers.size()) + 1; }
+
+    template<typename F, typename G>
+    void fork_join(F&& f, G&& g) {
+        if (_workers.empty()) {
+            f(); g();
+            return;
+        }
+        Task t{ [](void* p) { (*static_cast<std::remove_reference_t<G>*>(p))(); }, &g };
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _tasks.push_back(&t);
+        }
+        _cv.notify_one();
+
+        try {
+            f();
+        }
+        catch (...) {
+            // t lives on this frame, it must be off the queue before we leave
+            if (!take_back(&t)) wait(&t);
+            throw;
+        }
+
+        if (take_back(&t)) { // not started yet, run it ourselves
+            g();
+            return;
+        }
+        wait(&t);
+        if (t.error) std::rethrow_exception(t.error);
+    }
+
+    // the pool shared by all containers
+    static ForkJoinPool& instance() {
+        static ForkJoinPool pool;
+        return pool;
+    }
+
+private:
+    struct Task {
+        void (*invoke)(void*);
+        void* arg;
+        std::atomic<bool> done{ false };
+        std::exception_ptr error; // thrown by invoke, written before done
+
+        Task(void (*f)(void*), void* a) : invoke(f), arg(a) {}
+    };
+
+    // workers take the oldest (thus biggest) tasks,
+    // waiting threads help with the newest (smallest) ones
+    Task* pop_newest() {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_tasks.empty()) return nullptr;
+        Task* t = _tasks.back();
+        _tasks.pop_back();
+        return t;
+    }
+
+    // removes t from the queue if nobody has started it
+    bool take_back(Task* t) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto it = std::find(_tasks.rbegin(), _tasks.rend(), t);
+        if (it == _tasks.rend()) return false;
+        _tasks.erase(std::next(it).base());
+        return true;
+    }
+
+    // runs other pending tasks until t completes
+    void wait(const Task* t) {
+        while (!t->done.load(std::memory_order_acquire)) {
+            if (Task* other = pop_newest())
+                run(other);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    static void run(Task* t) noexcept {
+        try {
+            t->invoke(t->arg);
+        }
+        catch (...) {
+            t->error = std::current_exception();
+        }
+        t->done.store(true, std::memory_order_release);
+    }
+
+    void work() {
+        for (;;) {
+            Task* t;
+            {
+                std::unique_lock<std::mutex> lock(_mtx);
+                _cv.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                if (_stop) return;
+                t = _tasks.front();
+                _tasks.pop_front();
+            }
+            run(t);
+        }
+    }
+
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::deque<Task*> _tasks;
+    std::vector<std::thread> _workers;
+    bool _stop = false;
+};
+
+} // namespace mySymbolTable
+
+#endif // !FORK_JOIN_POOL_H
@@ -0,0 +1,80 @@
+#include "../BTreeSet.h"
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+int main()
+{
+    // tiny nodes so that we can see a few levels
+    //using BT = myst::BTreeSet<int, less<int>, allocator<int>, 64>;
+    using BT = myst::BTreeMultiset<int, less<int>, allocator<int>, 64>;
+    try {
+        BT st = { 10,50,80,40,30,90,60,20,70 };
+        // insert duplicates
+        st.insert(50);
+        st.insert(60);
+        st.insert(60);
+        st.insert(60);
+        st.insert(60);
+        st.insert(60);
+
+        cout << "st:\n";
+        for (auto it : st) {
+            cout << it << "  ";
+        }
+        cout << "\n\nst printed by lines: \n";
+        st.print();
+        cout << "height: " << st.height() << '\n';
+
+        BT st2 = st;
+        cout << "\n\nst2=st, in reverse order:\n";
+        for (auto i = st2.rbegin(); i != st2.crend(); ++i) {
+            cout << *i << "  ";
+        }
+        cout << '\n';
+
+        size_t count1 = st.erase(50);
+        size_t count2 = st.erase(60);
+#ifndef NDEBUG
+        if (!st.is_btree()) {
+            std::cout << "Not a B+ tree\n";
+            return -1;
+        }
+#endif
+        cout << "\nst, after removing 50 and 60: \n" << "there are \""
+            << count1 << "\" 50 and \"" << count2 << "\" 60 being removed\n";
+
+        for (auto it : st) {
+            cout << it << "  ";
+        }
+        cout << "\n\n";
+        st.print();
+        cout << "height: " << st.height() << '\n';
+
+        // sorted input fills the leaves up
+        BT big;
+        for (int i = 0; i < 1000; ++i)
+            big.insert(big.end(), i);
+        cout << "\n1000 sorted keys, " << big.leaf_capacity() << " per leaf, "
+            << big.internal_capacity() << " children per internal node, height: "
+            << big.height() << '\n';
+
+        myst::swap(st, st2);
+        cout << "\n\nst, after swapping with st2: \n";
+        for (auto it : st) {
+            cout << it << "  ";
+        }
+        cout << "\n\n";
+        st.print();
+        cout << "height: " << st.height() << '\n';
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
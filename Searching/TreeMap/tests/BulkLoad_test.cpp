@@ -0,0 +1,85 @@
+#include "../RbMap.h"
+#include "../AvlMap.h"
+#include <map>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+static double ms_since(clk::time_point t0)
+{
+    return chrono::duration<double, milli>(clk::now() - t0).count();
+}
+
+template<typename Map>
+bool check(const Map& mp, size_t n)
+{
+    if (mp.size() != n || mp.begin()->first != 0 || (--mp.end())->first != static_cast<int>(n - 1))
+        return false;
+#ifndef NDEBUG
+    if constexpr (is_same_v<Map, myst::RbMap<int, int>>) return mp.is_rb_tree();
+    else return mp.is_balanced();
+#else
+    return true;
+#endif
+}
+
+// load n sorted keys: one by one, via insert(first, last) and from_sorted()
+template<typename Map>
+bool time_bulk_load(const char* name, const vector<pair<int, int>>& kv)
+{
+    cout << name << ":\n";
+    auto t0 = clk::now();
+    Map m1;
+    for (const auto& p : kv) {
+        m1.insert(p);
+    }
+    cout << "  insert one by one:    " << ms_since(t0) << " ms, height " << m1.height() << '\n';
+
+    t0 = clk::now();
+    Map m2;
+    m2.insert(kv.begin(), kv.end());
+    cout << "  insert(first, last):  " << ms_since(t0) << " ms, height " << m2.height() << '\n';
+
+    t0 = clk::now();
+    Map m3 = Map::from_sorted(kv.begin(), kv.end());
+    cout << "  from_sorted:          " << ms_since(t0) << " ms, height " << m3.height() << '\n';
+
+    return check(m1, kv.size()) && check(m2, kv.size()) && check(m3, kv.size());
+}
+
+// run: ./BulkLoad_test [N=10000000]
+int main(int argc, char* argv[])
+{
+    try {
+        size_t n = argc > 1 ? stoul(argv[1]) : 10'000'000;
+        vector<pair<int, int>> kv(n);
+        for (size_t i = 0; i < n; ++i) {
+            kv[i] = { static_cast<int>(i), static_cast<int>(i) };
+        }
+        cout << "loading " << n << " sorted keys\n";
+
+        auto t0 = clk::now();
+        map<int, int> std_map(kv.begin(), kv.end());
+        cout << "std::map(first, last):  " << ms_since(t0) << " ms\n";
+
+        if (!time_bulk_load<myst::RbMap<int, int>>("RbMap", kv) ||
+            !time_bulk_load<myst::AvlMap<int, int>>("AvlMap", kv)) {
+            cout << "bulk loading went wrong!\n";
+            return -1;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
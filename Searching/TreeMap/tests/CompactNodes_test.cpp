@@ -0,0 +1,86 @@
+#include "../RbMap.h"
+#include "../AvlMap.h"
+#include "../BstMap.h"
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+using Alloc = allocator<pair<const int, int>>;
+using Compact = myst::compact_node_layout<>;
+
+template<typename Map>
+bool valid(const Map& mp)
+{
+#ifndef NDEBUG
+    if constexpr (is_same_v<Map, myst::RbMap<int, int>> || is_same_v<Map, myst::RbMap<int, int, less<int>, Alloc, Compact>>)
+        return mp.is_rb_tree();
+    else if constexpr (is_same_v<Map, myst::BstMap<int, int>>)
+        return true;
+    else
+        return mp.is_balanced();
+#else
+    (void)mp;
+    return true;
+#endif
+}
+
+// bytes per node and ns per random find() in a map of the given keys
+template<typename Map>
+bool report(const char* name, const vector<int>& keys, const vector<int>& queries)
+{
+    Map mp;
+    for (int k : keys) {
+        mp[k] = k;
+    }
+    size_t hits = 0;
+    auto t0 = clk::now();
+    for (int q : queries) {
+        hits += mp.find(q) != mp.end();
+    }
+    double ns = chrono::duration<double, nano>(clk::now() - t0).count() / queries.size();
+    printf("  %-22s %3zu bytes/node %8.1f ns/find  (height %zu, %zu hits)\n",
+           name, sizeof(typename Map::node_type), ns, static_cast<size_t>(mp.height()), hits);
+    return mp.size() == keys.size() && valid(mp);
+}
+
+// run: ./CompactNodes_test [N=1000000]
+int main(int argc, char* argv[])
+{
+    try {
+        size_t n = argc > 1 ? stoul(argv[1]) : 1'000'000;
+        vector<int> keys(n), queries(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = static_cast<int>(2 * i); // queries hit about half of the time
+        }
+        mt19937 gen(2021);
+        shuffle(keys.begin(), keys.end(), gen);
+        uniform_int_distribution<int> dist(0, static_cast<int>(2 * n));
+        for (auto& q : queries) q = dist(gen);
+
+        cout << n << " random keys, map<int, int>:\n";
+        bool ok = report<myst::BstMap<int, int>>("BstMap", keys, queries)
+               && report<myst::RbMap<int, int>>("RbMap", keys, queries)
+               && report<myst::RbMap<int, int, less<int>, Alloc, Compact>>("RbMap (compact)", keys, queries)
+               && report<myst::AvlMap<int, int>>("AvlMap", keys, queries)
+               && report<myst::AvlMap<int, int, less<int>, Alloc, Compact>>("AvlMap (compact)", keys, queries);
+        if (!ok) {
+            cout << "something went wrong!\n";
+            return -1;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "../RbMap.h"
+#include "../AvlMap.h"
+#include "../TST.h"
+#include "../../Randomized/SkiplistMap.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+// ns per key of find() one by one vs find_batch(), false if they disagree
+template<typename Map, typename Key>
+bool report(const char* name, const Map& mp, const vector<Key>& queries)
+{
+    vector<typename Map::const_iterator> one(queries.size()), batch(queries.size());
+    auto t0 = clk::now();
+    for (size_t i = 0; i < queries.size(); ++i) {
+        one[i] = mp.find(queries[i]);
+    }
+    auto t1 = clk::now();
+    mp.find_batch(queries, batch.begin());
+    auto t2 = clk::now();
+    double ns_one = chrono::duration<double, nano>(t1 - t0).count() / queries.size();
+    double ns_batch = chrono::duration<double, nano>(t2 - t1).count() / queries.size();
+    printf("  %-12s %8.1f ns/find %8.1f ns/find_batch  (%.2fx)\n", name, ns_one, ns_batch, ns_one / ns_batch);
+    return one == batch;
+}
+
+string random_word(mt19937& gen)
+{
+    uniform_int_distribution<int> len(4, 12), ch('a', 'z');
+    string s(len(gen), ' ');
+    for (auto& c : s) c = static_cast<char>(ch(gen));
+    return s;
+}
+
+// run: ./FindBatch_test [N=4000000]
+int main(int argc, char* argv[])
+{
+    try {
+        myst::RbMap<int, string> small = { {1, "one"}, {3, "three"}, {5, "five"} };
+        vector<int> keys = { 5, 2, 1 };
+        vector<myst::RbMap<int, string>::const_iterator> res(keys.size());
+        small.find_batch(keys, res.begin());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            cout << "find_batch " << keys[i] << ": " << (res[i] == small.end() ? "not found" : res[i]->second) << "\n";
+        }
+
+        // trees well out of cache, queried in random order, hitting about half of the time
+        size_t n = argc > 1 ? stoul(argv[1]) : 4'000'000;
+        mt19937 gen(2021);
+        vector<int> ints(n);
+        for (size_t i = 0; i < n; ++i) ints[i] = static_cast<int>(2 * i);
+        shuffle(ints.begin(), ints.end(), gen);
+        vector<int> queries(n);
+        uniform_int_distribution<int> dist(0, static_cast<int>(2 * n));
+        for (auto& q : queries) q = dist(gen);
+
+        cout << "\n" << n << " int keys:\n";
+        bool ok = true;
+        {
+            myst::RbMap<int, int> mp;
+            for (int k : ints) mp[k] = k;
+            ok = report("RbMap", mp, queries) && ok;
+        }
+        {
+            myst::AvlMap<int, int> mp;
+            for (int k : ints) mp[k] = k;
+            ok = report("AvlMap", mp, queries) && ok;
+        }
+        {
+            myst::SkiplistMap<int, int> mp;
+            for (int k : ints) mp[k] = k;
+            ok = report("SkiplistMap", mp, queries) && ok;
+        }
+
+        size_t m = n / 4;
+        cout << m << " random words:\n";
+        {
+            myst::TST<int> tst;
+            vector<string> words(m);
+            for (size_t i = 0; i < m; ++i) {
+                words[i] = random_word(gen);
+                tst[words[i]] = static_cast<int>(i);
+            }
+            for (size_t i = 0; i < m; i += 2) words[i] = random_word(gen); // misses
+            shuffle(words.begin(), words.end(), gen);
+            ok = report("TST", tst, words) && ok;
+        }
+        if (!ok) {
+            cout << "something went wrong!\n";
+            return -1;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
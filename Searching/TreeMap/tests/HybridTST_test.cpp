@@ -0,0 +1,108 @@
+#include "../HybridTST.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <atomic>
+#include <cstdio>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+double seconds_since(clk::time_point t0)
+{
+    return chrono::duration<double>(clk::now() - t0).count();
+}
+
+// keys spread unevenly over the first letters, like words or URLs
+vector<pair<string, int>> make_pairs(size_t n)
+{
+    mt19937 gen(2021);
+    geometric_distribution<int> first(0.15);
+    uniform_int_distribution<int> len(4, 12), ch('a', 'z');
+    vector<pair<string, int>> kvs(n);
+    for (size_t i = 0; i < n; ++i) {
+        string s(len(gen), ' ');
+        for (auto& c : s) c = static_cast<char>(ch(gen));
+        s[0] = static_cast<char>('a' + first(gen) % 26);
+        kvs[i] = { move(s), static_cast<int>(i) };
+    }
+    return kvs;
+}
+
+// run: ./HybridTST_test shellsST.txt [N=50000000]
+int main(int argc, char* argv[])
+{
+    if (argc < 2) { cerr << "lack of filename" << endl; return 1; }
+    string filename{ argv[1] };
+    ifstream ifs{ filename };
+    if (!ifs.is_open()) { cerr << "Error opening file " << filename << endl; return 2; }
+    try {
+        vector<pair<string, int>> words;
+        int i = 0;
+        for (string word; ifs >> word; ) {
+            words.emplace_back(word, i++);
+        }
+        myst::RWayTST<int> st;
+        st.bulk_insert(words.begin(), words.end());
+        st.for_each([](const string& key, const int& val) { cout << key << " : " << val << '\n'; });
+        cout << "keys with prefix \"s\": ";
+        for (const auto& key : st.keys_with_prefix("s")) cout << key << "  ";
+        cout << "\nkeys with prefix \"sh\": ";
+        for (const auto& key : st.keys_with_prefix("sh")) cout << key << "  ";
+        cout << "\n\n";
+
+        size_t n = argc > 2 ? stoul(argv[2]) : 50'000'000;
+        auto kvs = make_pairs(n);
+        printf("%zu keys, %u hardware threads\n", n, thread::hardware_concurrency());
+
+        auto t0 = clk::now();
+        auto seq = make_unique<myst::RWayTST<int>>();
+        for (const auto& [key, val] : kvs) seq->insert(key, val);
+        double seq_s = seconds_since(t0);
+        printf("  insert() one by one   %7.2f s\n", seq_s);
+        size_t keys = seq->size();
+        seq.reset();
+
+        bool ok = true;
+        for (unsigned threads : { 1, 2, 4, 8, 16, 32 }) {
+            myst::ForkJoinPool pool(threads);
+            t0 = clk::now();
+            auto st = make_unique<myst::RWayTST<int>>();
+            st->bulk_insert(kvs.begin(), kvs.end(), pool);
+            double build_s = seconds_since(t0);
+
+            t0 = clk::now();
+            vector<string> all = st->keys_with_prefix("", pool);
+            double keys_s = seconds_since(t0);
+
+            t0 = clk::now();
+            atomic<long long> sum{ 0 };
+            st->parallel_for_each([&sum](const string&, const int& val) {
+                sum.fetch_add(val, memory_order_relaxed);
+            }, pool);
+            double iter_s = seconds_since(t0);
+
+            printf("  %2u threads: bulk_insert %7.2f s (%.2fx)  keys() %6.2f s  parallel_for_each %6.2f s\n",
+                   threads, build_s, seq_s / build_s, keys_s, iter_s);
+            ok = ok && all.size() == keys && is_sorted(all.begin(), all.end()) && st->size() == keys;
+        }
+        if (!ok) {
+            cout << "something went wrong!\n";
+            return -1;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "../IntervalMap.h"
+#include "../RbMap.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+struct Interval {
+    int lo, hi;
+};
+
+// us per query of [lo, lo + len] with f returning the # of overlaps
+template<typename F>
+double us_per_query(const vector<int>& starts, int len, F f, size_t& sink)
+{
+    auto t0 = clk::now();
+    for (int lo : starts) {
+        sink += f(lo, lo + len);
+    }
+    return chrono::duration<double, micro>(clk::now() - t0).count() / starts.size();
+}
+
+// run: ./IntervalMap_test [N=10000000]
+int main(int argc, char* argv[])
+{
+    try {
+        myst::IntervalMap<int, string> mp = { {{15, 20}, "a"}, {{10, 30}, "b"}, {{17, 19}, "c"},
+                                              {{5, 20}, "d"}, {{12, 15}, "e"}, {{30, 40}, "f"} };
+        mp.insert(26, 26, "g");
+        cout << "intervals:  ";
+        for (const auto& it : mp) {
+            cout << "[" << it.first.first << ", " << it.first.second << "] " << it.second << "  ";
+        }
+        cout << "\noverlapping [21, 29]:  ";
+        for (auto it : mp.overlapping(21, 29)) {
+            cout << it->second << "  ";
+        }
+        cout << "\nstabbing 15:  ";
+        for (auto it : mp.stabbing(15)) {
+            cout << it->second << "  ";
+        }
+        cout << "\noverlaps [41, 50]: " << boolalpha << mp.overlaps_any(41, 50) << "\n";
+        try {
+            mp.insert(3, 2, "bad");
+        }
+        catch (const invalid_argument& e) {
+            cout << "insert(3, 2): " << e.what() << "\n";
+        }
+
+        myst::RbMap<int, long, less<int>, allocator<pair<const int, long>>,
+                    myst::range_sum_node_update<long>> sums;
+        for (int i = 1; i <= 100; ++i) sums[i] = i;
+        sums.erase(50);
+        sums.insert_or_assign(10, 1000);
+        cout << "sum of values with keys in [1, 101): " << sums.fold(1, 101)
+             << ", in [10, 60): " << sums.fold(10, 60) << "\n\n";
+
+        // N random intervals of length up to 100 over [0, 10N),
+        // i.e. ~5 of them overlap a given point
+        size_t n = argc > 1 ? stoul(argv[1]) : 10'000'000;
+        const int span = static_cast<int>(10 * n);
+        mt19937 gen(2021);
+        uniform_int_distribution<int> start(0, span), length(0, 100);
+        vector<Interval> ivs(n);
+        for (auto& iv : ivs) {
+            iv.lo = start(gen);
+            iv.hi = iv.lo + length(gen);
+        }
+        sort(ivs.begin(), ivs.end(), [](const Interval& a, const Interval& b) {
+            return a.lo < b.lo || (a.lo == b.lo && a.hi < b.hi);
+        });
+
+        auto t0 = clk::now();
+        vector<pair<pair<int, int>, int>> sorted;
+        sorted.reserve(n);
+        for (size_t i = 0; i < n; ++i) sorted.push_back({ { ivs[i].lo, ivs[i].hi }, static_cast<int>(i) });
+        myst::IntervalMap<int, int> tree(sorted.begin(), sorted.end()); // sorted: bulk loaded
+        sorted = {};
+        printf("%zu intervals loaded in %.0f ms\n", n,
+               chrono::duration<double, milli>(clk::now() - t0).count());
+
+        size_t sink = 0;
+        auto linear = [&](int lo, int hi) {
+            size_t k = 0;
+            for (const auto& iv : ivs) k += iv.lo <= hi && iv.hi >= lo;
+            return k;
+        };
+        auto count_tree = [&](int lo, int hi) {
+            size_t k = 0;
+            tree.for_each_overlapping(lo, hi, [&k](auto) { ++k; });
+            return k;
+        };
+        printf("%18s %16s %16s %12s\n", "query length", "linear scan", "IntervalMap", "avg k");
+        for (int len : { 0, 1000, 100000 }) {
+            vector<int> few(20), many(len < 100000 ? 100'000 : 1000);
+            for (auto& q : few) q = start(gen);
+            for (auto& q : many) q = start(gen);
+            size_t k0 = sink;
+            double t_scan = us_per_query(few, len, linear, sink);
+            size_t k = sink - k0;
+            double t_tree = us_per_query(many, len, count_tree, sink);
+            bool same = true;
+            for (int q : few) same = same && linear(q, q + len) == count_tree(q, q + len);
+            if (!same) {
+                cout << "something went wrong!\n";
+                return -1;
+            }
+            printf("%18d %13.1f us %13.2f us %12.1f\n", len, t_scan, t_tree, double(k) / few.size());
+        }
+        cout << "(hits: " << sink << ")\n";
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "../MemPool/MonotonicArena.h"
+#include "../TST.h"
+#include "../../../String/Trie/Trie.h"
+#include "../../../String/StringSearch/AhoCorasick/AhoCorasick.h"
+#include "../../RankTree/rolling_rank.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+double seconds_since(clk::time_point t0)
+{
+    return chrono::duration<double>(clk::now() - t0).count();
+}
+
+// search-engine-like queries: words made of a few common syllables
+vector<string> make_words(size_t n)
+{
+    static const char* syllables[] = { "a", "an", "ar", "be", "ca", "co", "de", "di", "en", "er", "es", "in",
+        "ing", "io", "is", "la", "le", "ma", "me", "na", "ne", "ni", "on", "or", "ra", "re", "ri", "ro", "sa",
+        "se", "st", "ta", "te", "ti", "to", "tion", "un", "ur", "ve", "y" };
+    mt19937 gen(2021);
+    uniform_int_distribution<int> len(2, 8), syl(0, sizeof(syllables) / sizeof(*syllables) - 1);
+    vector<string> words(n);
+    for (auto& w : words) {
+        for (int k = len(gen); k > 0; --k) w += syllables[syl(gen)];
+    }
+    return words;
+}
+
+// Times build(), which returns the container in a unique_ptr, and then
+// the container's destruction.
+template<typename Build>
+void measure(const char* name, Build build)
+{
+    auto t0 = clk::now();
+    auto c = build();
+    double build_s = seconds_since(t0);
+    t0 = clk::now();
+    c.reset();
+    double drop_s = seconds_since(t0);
+    printf("  %-40s build %7.2f s   teardown %7.3f s\n", name, build_s, drop_s);
+}
+
+template<typename Alloc>
+using tst = myst::TST<int, Alloc>;
+
+template<typename Alloc>
+using trie = myst::Trie<int, Alloc>;
+
+template<typename Alloc>
+using rank_tree = myRankingAlgo::RankTree<int, less<int>, Alloc>;
+
+template<typename Alloc>
+using ac_trie = myStringAlgo::ACTrie<Alloc>;
+
+// run: ./MonotonicArena_test [N=10000000]
+int main(int argc, char* argv[])
+{
+    try {
+        size_t n = argc > 1 ? stoul(argv[1]) : 10'000'000;
+        vector<string> words = make_words(n);
+        // Trie and ACTrie nodes are 2 KiB each, only a slice of the words
+        vector<string> few(words.begin(), words.begin() + min<size_t>(n, 100'000));
+        using std_alloc = allocator<int>;
+        using mono = myst::MonotonicAllocator<int>;
+        printf("%zu words:\n", n);
+        auto fill_tst = [&words](auto st) {
+            for (size_t i = 0; i < words.size(); ++i) st->insert(words[i], static_cast<int>(i));
+            return st;
+        };
+        measure("TST", [&] { return fill_tst(make_unique<tst<std_alloc>>()); });
+        measure("TST + MonotonicAllocator", [&] { return fill_tst(make_unique<tst<mono>>()); });
+
+        auto fill_rank = [n](auto rt) {
+            mt19937 gen(2021);
+            for (size_t i = 0; i < n; ++i) rt->insert(static_cast<int>(gen()));
+            return rt;
+        };
+        measure("RankTree", [&] { return fill_rank(make_unique<rank_tree<std_alloc>>()); });
+        measure("RankTree + MonotonicAllocator", [&] { return fill_rank(make_unique<rank_tree<mono>>()); });
+
+        printf("%zu words:\n", few.size());
+        auto fill_trie = [&few](auto st) {
+            for (size_t i = 0; i < few.size(); ++i) st->insert_or_assign(few[i], static_cast<int>(i));
+            return st;
+        };
+        measure("Trie", [&] { return fill_trie(make_unique<trie<std_alloc>>()); });
+        measure("Trie + MonotonicAllocator", [&] { return fill_trie(make_unique<trie<mono>>()); });
+        measure("ACTrie", [&] { return make_unique<ac_trie<std_alloc>>(few); });
+        measure("ACTrie + MonotonicAllocator", [&] { return make_unique<ac_trie<mono>>(few); });
+
+        // a key as deep as the recursive destructor used to overflow on
+        {
+            myst::TST<int> deep;
+            deep.insert(string(1'000'000, 'a'), 1);
+            deep.insert(string(1'000'000, 'b'), 2);
+            if (deep.size() != 2) {
+                cout << "something went wrong!\n";
+                return -1;
+            }
+        }
+        cout << "1M-deep TST destroyed\n";
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
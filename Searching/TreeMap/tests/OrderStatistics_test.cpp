@@ -0,0 +1,72 @@
+#include "../RbSet.h"
+#include "../AvlMap.h"
+#include <string>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+int main()
+{
+    using OST = myst::RbMultiset<int, less<int>, allocator<int>, myst::order_statistics_node_update>;
+    using OSM = myst::AvlMap<int, string, less<int>, allocator<pair<const int, string>>,
+                             myst::order_statistics_node_update>;
+    try {
+        OST st = { 10,50,80,40,30,90,60,20,70 };
+        st.insert(60);
+        st.insert(60);
+
+        cout << "st:\n";
+        for (auto it : st) {
+            cout << it << "  ";
+        }
+        cout << "\n\nrank(60) = " << st.rank(60) << ", upper_rank(60) = " << st.upper_rank(60)
+            << ", rank(65) = " << st.rank(65) << ", rank(5) = " << st.rank(5) << '\n';
+
+        cout << "select(k), k = 0.." << st.size() - 1 << ":\n";
+        for (size_t k = 0; k < st.size(); ++k) {
+            cout << *st.select(k) << "  ";
+        }
+        cout << "\nselect(size()) == end(): " << boolalpha << (st.select(st.size()) == st.end()) << '\n';
+
+        cout << "count_range(30, 60) = " << st.count_range(30, 60)
+            << ", count_range(61, 69) = " << st.count_range(61, 69) << '\n';
+
+        st.erase(60);
+        st.erase(st.select(0)); // the smallest
+#ifndef NDEBUG
+        if (!st.is_rb_tree()) {
+            std::cout << "Not a red-black tree (or wrong subtree sizes)\n";
+            return -1;
+        }
+#endif
+        cout << "\nafter removing 60 and the smallest one:\n";
+        for (auto it : st) {
+            cout << it << "  ";
+        }
+        cout << "\nrank(70) = " << st.rank(70) << ", select(3) = " << *st.select(3) << "\n\n";
+
+        // sorted insertion, which an unbalanced rank tree can't cope with
+        OSM mp;
+        for (int i = 0; i < 1000; ++i) {
+            mp.insert(mp.end(), { i, to_string(i) });
+        }
+#ifndef NDEBUG
+        if (!mp.is_balanced()) {
+            std::cout << "Not an AVL tree (or wrong subtree sizes)\n";
+            return -1;
+        }
+#endif
+        cout << "mp: 0..999, height: " << mp.height() << ", median: "
+            << mp.select(mp.size() / 2)->second << ", rank(250) = " << mp.rank(250)
+            << ", count_range(100, 199) = " << mp.count_range(100, 199) << '\n';
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "../PersistentAvlMap.h"
+#include "../AvlMap.h"
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+template<typename Map>
+void print_map(const char* name, const Map& mp)
+{
+    cout << name << ":  ";
+    for (const auto& it : mp) {
+        cout << "{" << it.first << ", " << it.second << "}  ";
+    }
+    cout << '\n';
+}
+
+// what we used to do: copy the whole map on every publish
+class CopyOnWriteAvlMap {
+    shared_ptr<const myst::AvlMap<int, int>> _current;
+    mutex _mtx; // serializes writers
+public:
+    explicit CopyOnWriteAvlMap(const myst::AvlMap<int, int>& init)
+        : _current(make_shared<const myst::AvlMap<int, int>>(init)) {}
+
+    shared_ptr<const myst::AvlMap<int, int>> snapshot() const { return atomic_load(&_current); }
+
+    void insert_or_assign(int key, int val) {
+        lock_guard<mutex> lock(_mtx);
+        auto copy = make_shared<myst::AvlMap<int, int>>(*_current);
+        copy->insert_or_assign(key, val);
+        atomic_store(&_current, shared_ptr<const myst::AvlMap<int, int>>(std::move(copy)));
+    }
+};
+
+// For `interval_ms`, one writer keeps publishing new versions while
+// `nreaders` threads keep taking snapshots and looking up a key in them.
+template<typename Cell>
+void time_publish(const char* name, Cell& cell, int n, int interval_ms, int nreaders)
+{
+    atomic<bool> stop{ false };
+    atomic<size_t> reads{ 0 };
+    vector<thread> readers;
+    for (int r = 0; r < nreaders; ++r) {
+        readers.emplace_back([&, r] {
+            mt19937 gen(r);
+            size_t cnt = 0, found = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                auto snap = cell.snapshot();
+                if constexpr (is_same_v<Cell, CopyOnWriteAvlMap>)
+                    found += snap->contains(static_cast<int>(gen() % n));
+                else
+                    found += snap.contains(static_cast<int>(gen() % n));
+                ++cnt;
+            }
+            reads += cnt + (found > cnt); // keep `found` alive
+        });
+    }
+
+    mt19937 gen(2021);
+    double max_us = 0;
+    int updates = 0;
+    auto t0 = clk::now(), deadline = t0 + chrono::milliseconds(interval_ms);
+    for (auto t = t0; t < deadline; ++updates) {
+        int key = static_cast<int>(gen() % n);
+        if constexpr (is_same_v<Cell, CopyOnWriteAvlMap>)
+            cell.insert_or_assign(key, updates);
+        else
+            cell.update([&](const auto& mp) { return mp.insert_or_assign(key, updates); });
+        auto now = clk::now();
+        max_us = max(max_us, chrono::duration<double, micro>(now - t).count());
+        t = now;
+    }
+    stop = true;
+    double total_ms = chrono::duration<double, milli>(clk::now() - t0).count();
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    cout << "  " << name << ": " << updates << " publishes, avg " << total_ms * 1000 / updates
+         << " us, max " << max_us << " us; readers " << reads / total_ms * 1000 << " snapshot+find/s\n";
+}
+
+int main()
+{
+    try {
+        myst::PersistentAvlMap<string, int> v1 = { {"port", 80}, {"workers", 4} };
+        auto v2 = v1.insert_or_assign("port", 8080);
+        auto v3 = v2.insert("timeout", 30).erase("workers");
+        print_map("v1", v1);
+        print_map("v2", v2);
+        print_map("v3", v3);
+        cout << "v3.at(\"timeout\") = " << v3.at("timeout") << ", v1 still has "
+             << v1.size() << " entries, port = " << v1.at("port") << "\n\n";
+#ifndef NDEBUG
+        if (!v1.is_balanced() || !v2.is_balanced() || !v3.is_balanced()) {
+            cout << "Not an AVL tree\n";
+            return -1;
+        }
+#endif
+
+        const int N = 100'000, INTERVAL_MS = 1000, READERS = 2;
+        myst::AvlMap<int, int> init;
+        myst::PersistentAvlMap<int, int> pinit;
+        for (int i = 0; i < N; ++i) {
+            init.insert({ i, i });
+            pinit = pinit.insert(i, i);
+        }
+        cout << "publishing single-key updates to a map of " << N << " keys for "
+             << INTERVAL_MS << " ms, " << READERS << " readers:\n";
+        CopyOnWriteAvlMap cow(init);
+        time_publish("AvlMap copy-on-write", cow, N, INTERVAL_MS, READERS);
+        myst::AtomicAvlMap<int, int> cell(pinit);
+        time_publish("PersistentAvlMap   ", cell, N, INTERVAL_MS, READERS);
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
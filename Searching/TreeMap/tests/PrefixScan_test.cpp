@@ -0,0 +1,129 @@
+#include "../TST.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#if defined(__GLIBC__)
+#include <malloc.h> // mallinfo2
+#endif
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+// heap bytes in use, allocator overhead and mmap'ed blocks included
+size_t heap_bytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    auto mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#else
+    return 0; // n/a
+#endif
+}
+
+double ms_since(clk::time_point t0)
+{
+    return chrono::duration<double, milli>(clk::now() - t0).count();
+}
+
+string random_word(mt19937& gen)
+{
+    uniform_int_distribution<int> len(4, 12), ch('a', 'z');
+    string s(len(gen), ' ');
+    for (auto& c : s) c = static_cast<char>(ch(gen));
+    return s;
+}
+
+// time (and heap held) to go over the keys with prefix, or just the first
+// limit of them, as a vector, with the visitor and with the lazy range;
+// false if they disagree
+bool report(const myst::TST<int>& tst, const string& prefix, size_t limit)
+{
+    size_t chars[3] = {};
+    size_t before = heap_bytes();
+    auto t0 = clk::now();
+    vector<string> vs = tst.keys_with_prefix(prefix);
+    size_t held = heap_bytes() - before;
+    size_t keys = vs.size();
+    for (size_t i = 0; i < vs.size() && i < limit; ++i) chars[0] += vs[i].size();
+    double ms_vector = ms_since(t0);
+    vs = {};
+
+    t0 = clk::now();
+    size_t visited = tst.for_each_with_prefix(prefix,
+        [&chars](const string& key, const int&) { chars[1] += key.size(); }, limit);
+    double ms_visit = ms_since(t0);
+
+    t0 = clk::now();
+    size_t ranged = 0;
+    for (auto [key, val] : tst.prefix_range(prefix)) {
+        if (ranged++ == limit) break;
+        chars[2] += key.size();
+    }
+    double ms_range = ms_since(t0);
+
+    string name = "\"" + prefix + "\"";
+    if (limit < keys) name += " first " + to_string(limit);
+    printf("  %-18s %8zu keys  vector %8.2f ms (%6.1f MB)  for_each %8.2f ms  prefix_range %8.2f ms\n",
+           name.c_str(), min(keys, limit), ms_vector, held / 1e6, ms_visit, ms_range);
+    return visited == min(keys, limit) && chars[0] == chars[1] && chars[1] == chars[2];
+}
+
+// run: ./PrefixScan_test shellsST.txt [N=2000000]
+int main(int argc, char* argv[])
+{
+    if (argc < 2) { cerr << "lack of filename" << endl; return 1; }
+    string filename{ argv[1] };
+    ifstream ifs{ filename };
+    if (!ifs.is_open()) { cerr << "Error opening file " << filename << endl; return 2; }
+    try {
+        myst::TST<int> tst;
+        int i = 0;
+        for (string word; ifs >> word; ) {
+            tst[word] = i++;
+        }
+
+        cout << "keys with prefix \"s\": ";
+        for (auto [key, val] : tst.prefix_range("s")) {
+            cout << key << " : " << val << "  ";
+        }
+        cout << "\nfirst 2 keys with prefix \"sh\": ";
+        tst.for_each_with_prefix("sh", [](const string& key, const int&) { cout << key << "  "; }, 2);
+        cout << "\nkeys with prefix \"s\" up to \"shells\": ";
+        tst.for_each_with_prefix("s", [](const string& key, const int&) {
+            cout << key << "  ";
+            return key != "shells";
+        });
+        cout << "\nkeys that match \"?he?l?\": ";
+        tst.for_each_that_match("?he?l?", [](const string& key, const int& val) { cout << key << " : " << val << "  "; });
+        cout << "\n\n";
+
+        size_t n = argc > 2 ? stoul(argv[2]) : 2'000'000;
+        mt19937 gen(2021);
+        myst::TST<int> big;
+        for (size_t k = 0; k < n; ++k) big[random_word(gen)] = static_cast<int>(k);
+        cout << big.size() << " random words:" << endl;
+        bool ok = true;
+        for (const char* prefix : { "", "a", "ab", "abc" }) {
+            ok = report(big, prefix, static_cast<size_t>(-1)) && ok;
+        }
+        ok = report(big, "a", 10) && ok; // e.g. autocompletion
+        if (!ok) {
+            cout << "something went wrong!\n";
+            return -1;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
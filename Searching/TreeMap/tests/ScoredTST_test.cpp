@@ -0,0 +1,148 @@
+#include "../ScoredTST.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#if defined(__GLIBC__)
+#include <malloc.h> // mallinfo2
+#endif
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+using entry = pair<string, float>;
+
+// heap bytes in use, allocator overhead and mmap'ed blocks included
+size_t heap_bytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    auto mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#else
+    return 0; // n/a
+#endif
+}
+
+// search-engine-like queries: words made of a few common syllables
+string random_word(mt19937& gen)
+{
+    static const char* syllables[] = { "a", "an", "ar", "be", "ca", "co", "de", "di", "en", "er", "es", "in",
+        "ing", "io", "is", "la", "le", "ma", "me", "na", "ne", "ni", "on", "or", "ra", "re", "ri", "ro", "sa",
+        "se", "st", "ta", "te", "ti", "to", "tion", "un", "ur", "ve", "y" };
+    uniform_int_distribution<int> len(2, 7), syl(0, sizeof(syllables) / sizeof(*syllables) - 1);
+    string w;
+    for (int k = len(gen); k > 0; --k) w += syllables[syl(gen)];
+    return w;
+}
+
+// p50/p99/max of a latency sample in microseconds
+void print_latency(const char* name, vector<double>& us)
+{
+    sort(us.begin(), us.end());
+    auto pct = [&us](double p) { return us[min(us.size() - 1, static_cast<size_t>(p * us.size()))]; };
+    printf("  %-22s p50 %9.1f us   p99 %9.1f us   max %9.1f us\n", name, pct(0.5), pct(0.99), us.back());
+}
+
+// top k by a scan of all completions in the sorted dictionary
+vector<entry> scan_top_k(const vector<entry>& sorted, const string& prefix, size_t k)
+{
+    auto first = lower_bound(sorted.begin(), sorted.end(), entry(prefix, 0.0f));
+    auto last = first;
+    while (last != sorted.end() && last->first.compare(0, prefix.size(), prefix) == 0) ++last;
+    vector<entry> res(first, last);
+    auto by_score = [](const entry& a, const entry& b) { return a.second > b.second; };
+    size_t m = min(k, res.size());
+    partial_sort(res.begin(), res.begin() + m, res.end(), by_score);
+    res.resize(m);
+    return res;
+}
+
+// run: ./ScoredTST_test [N=10000000]
+int main(int argc, char* argv[])
+{
+    try {
+        myst::ScoredTST<float> st;
+        for (auto [key, score] : { entry("she", 6), entry("sells", 1), entry("sea", 2), entry("shells", 3),
+                                   entry("by", 4), entry("the", 5), entry("shore", 7), entry("shear", 8) }) {
+            st.insert_or_assign(key, score);
+        }
+        auto print = [&st](const string& prefix, size_t k) {
+            cout << "top " << k << " with prefix \"" << prefix << "\": ";
+            for (const auto& [key, score] : st.top_k_with_prefix(prefix, k)) cout << key << " (" << score << ")  ";
+            cout << '\n';
+        };
+        print("sh", 3);
+        print("", 4);
+        st.add_score("shells", 10);
+        st.erase("shear");
+        cout << "after shells += 10 and erasing shear:\n";
+        print("sh", 3);
+        print("s", 10);
+
+        // a dictionary of queries with Zipf-like popularity
+        size_t n = argc > 1 ? stoul(argv[1]) : 10'000'000;
+        mt19937 gen(2021);
+        size_t before = heap_bytes();
+        auto t0 = clk::now();
+        myst::ScoredTST<float> big;
+        while (big.size() < n) {
+            string w = random_word(gen);
+            big.insert_or_assign(w, 1e6f / static_cast<float>(gen() % n + 1));
+        }
+        double build_s = chrono::duration<double>(clk::now() - t0).count();
+        printf("\n%zu keys, %.1f bytes/key, built in %.1f s\n", big.size(),
+               double(heap_bytes() - before) / big.size(), build_s);
+
+        // the same entries sorted by key, for the scan
+        vector<entry> sorted = big.top_k(big.size());
+        sort(sorted.begin(), sorted.end());
+
+        const size_t k = 10;
+        bool ok = true;
+        for (size_t len = 1; len <= 3; ++len) {
+            vector<double> tst_us, scan_us;
+            size_t completions = 0;
+            for (int q = 0; q < 1000; ++q) {
+                string prefix = sorted[gen() % sorted.size()].first.substr(0, len);
+                auto t1 = clk::now();
+                auto top = big.top_k_with_prefix(prefix, k);
+                auto t2 = clk::now();
+                auto expected = scan_top_k(sorted, prefix, k);
+                auto t3 = clk::now();
+                tst_us.push_back(chrono::duration<double, micro>(t2 - t1).count());
+                scan_us.push_back(chrono::duration<double, micro>(t3 - t2).count());
+                completions += distance(lower_bound(sorted.begin(), sorted.end(), entry(prefix, 0.0f)),
+                                        lower_bound(sorted.begin(), sorted.end(), entry(prefix + '\x7f', 0.0f)));
+                ok = ok && top.size() == expected.size();
+                for (size_t i = 0; ok && i < top.size(); ++i) ok = top[i].second == expected[i].second;
+            }
+            printf("top %zu, %zu-char prefixes (%.0f completions on average):\n", k, len, double(completions) / 1000);
+            print_latency("top_k_with_prefix", tst_us);
+            print_latency("scan + partial_sort", scan_us);
+        }
+
+        // popularity updates propagate the subtree maxima upwards
+        vector<string> hits(1'000'000);
+        for (auto& h : hits) h = sorted[gen() % sorted.size()].first;
+        t0 = clk::now();
+        for (const auto& h : hits) big.add_score(h, 1.0f);
+        printf("add_score: %.0f ns/update\n", chrono::duration<double, nano>(clk::now() - t0).count() / hits.size());
+
+        if (!ok) {
+            cout << "something went wrong!\n";
+            return -1;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
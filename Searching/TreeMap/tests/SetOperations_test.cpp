@@ -0,0 +1,199 @@
+#include "../RbSet.h"
+#include "../AvlSet.h"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <atomic>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+template<typename Set>
+void print_set(const char* name, const Set& st)
+{
+    cout << name << ":  ";
+    for (auto it : st) {
+        cout << it << "  ";
+    }
+    cout << '\n';
+}
+
+template<typename Set>
+bool check(const Set& st)
+{
+#ifndef NDEBUG
+    if constexpr (is_same_v<Set, myst::RbSet<int>> ||
+                  is_same_v<Set, myst::RbSet<int, less<int>, allocator<int>, myst::order_statistics_node_update>>)
+        return st.is_rb_tree();
+    else return st.is_balanced();
+#else
+    (void)st;
+    return true;
+#endif
+}
+
+// reconcile two big sets: tree-vs-tree set operations against
+// inserting/erasing the elements of one tree into the other one by one
+template<typename Set>
+bool time_set_operations(const char* name, size_t n)
+{
+    mt19937 gen(2021);
+    uniform_int_distribution<int> dist(0, static_cast<int>(n * 2));
+    vector<int> a(n), b(n);
+    for (auto& x : a) x = dist(gen);
+    for (auto& x : b) x = dist(gen);
+    const Set sa(a.begin(), a.end()), sb(b.begin(), b.end());
+
+    using clock = chrono::steady_clock;
+    auto ms = [](clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+    bool ok = true;
+
+    auto run = [&](const char* op, auto join_based, auto one_by_one) {
+        Set x1 = sa, y1 = sb, x2 = sa, y2 = sb;
+        auto t0 = clock::now();
+        join_based(x1, y1);
+        auto t1 = clock::now();
+        one_by_one(x2, y2);
+        auto t2 = clock::now();
+        ok = ok && x1.size() == x2.size() && equal(x1.begin(), x1.end(), x2.begin()) && check(x1);
+        cout << "  " << op << ": " << x1.size() << " keys, join-based " << ms(t1 - t0)
+             << " ms, one by one " << ms(t2 - t1) << " ms\n";
+    };
+
+    cout << name << ", two sets of " << n << " random keys ("
+         << myst::ForkJoinPool::instance().size() << " threads):\n";
+    run("union",
+        [](Set& x, Set& y) { x.set_union(std::move(y)); },
+        [](Set& x, Set& y) { x.insert(y.begin(), y.end()); });
+    run("intersection",
+        [](Set& x, Set& y) { x.set_intersection(std::move(y)); },
+        [](Set& x, Set& y) {
+            for (auto it = x.begin(); it != x.end(); )
+                it = y.find(*it) == y.end() ? x.erase(it) : ++it;
+        });
+    run("difference",
+        [](Set& x, Set& y) { x.set_difference(std::move(y)); },
+        [](Set& x, Set& y) { for (auto k : y) x.erase(k); });
+    return ok;
+}
+
+// split at random keys and join back: O(log(n)) each with order
+// statistics, otherwise split counts the nodes of the left half
+template<typename Set>
+bool time_split(const char* name, size_t n, size_t rounds)
+{
+    Set st;
+    for (size_t i = 0; i < n; ++i) st.insert(static_cast<int>(i));
+    mt19937 gen(2021);
+    uniform_int_distribution<int> dist(0, static_cast<int>(n));
+    bool ok = true;
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; ++i) {
+        Set right;
+        st.split(dist(gen), right);
+        st.join(std::move(right));
+    }
+    auto t1 = chrono::steady_clock::now();
+    {
+        int key = dist(gen);
+        Set right;
+        st.split(key, right);
+        ok = st.size() == size_t(key) && right.size() == n - key && check(st) && check(right);
+        // erase the left half down to nothing and refill it
+        while (!st.empty()) st.erase(st.begin());
+        ok = ok && st.size() == 0;
+        st.insert(-1);
+        st.join(std::move(right));
+        ok = ok && st.size() == n - key + 1;
+    }
+    cout << name << ", " << n << " keys: split + join "
+         << chrono::duration<double, micro>(t1 - t0).count() / rounds << " us\n";
+    return ok;
+}
+
+// exceptions thrown by either side of fork_join reach the caller, and g
+// is done or dropped by the time it returns
+bool check_fork_join_exceptions(size_t rounds)
+{
+    myst::ForkJoinPool pool(4);
+    size_t caught = 0;
+    for (size_t i = 0; i < rounds; ++i) {
+        atomic<int> finished{ 0 };
+        try {
+            pool.fork_join([&] { if (i % 2 == 0) throw runtime_error("f"); ++finished; },
+                           [&] { for (volatile int k = 0; k < 1000; ++k) {} ++finished;
+                                 if (i % 2 == 1) throw runtime_error("g"); });
+        }
+        catch (const runtime_error& e) {
+            caught += e.what() == string(i % 2 == 0 ? "f" : "g");
+        }
+        // g is dropped if f throws before a worker picks it up
+        if (i % 2 == 0 ? finished > 1 : finished != 2) return false;
+    }
+    cout << "fork_join: " << caught << " of " << rounds << " exceptions rethrown\n";
+    return caught == rounds;
+}
+
+int main()
+{
+    try {
+        myst::RbSet<int> st = { 10,50,80,40,30,90,60,20,70 }, other = { 5,15,30,60,75 };
+        myst::RbSet<int> right;
+        print_set("st", st);
+        print_set("other", other);
+
+        st.split(50, right);
+        cout << "\nafter st.split(50, right):\n";
+        print_set("st", st);
+        print_set("right", right);
+        st.join(std::move(right));
+        print_set("st.join(right)", st);
+
+        auto tmp = st;
+        tmp.set_union(myst::RbSet<int>(other));
+        print_set("\nunion", tmp);
+        tmp = st;
+        tmp.set_intersection(myst::RbSet<int>(other));
+        print_set("intersection", tmp);
+        tmp = st;
+        tmp.set_difference(myst::RbSet<int>(other));
+        print_set("difference", tmp);
+        if (!check(tmp)) {
+            cout << "Not a red-black tree\n";
+            return -1;
+        }
+        cout << '\n';
+
+        const size_t N = 1'000'000;
+        if (!time_set_operations<myst::RbSet<int>>("RbSet", N) ||
+            !time_set_operations<myst::AvlSet<int>>("AvlSet", N)) {
+            cout << "set operations went wrong!\n";
+            return -1;
+        }
+        cout << '\n';
+        using OsRbSet = myst::RbSet<int, less<int>, allocator<int>, myst::order_statistics_node_update>;
+        using OsAvlSet = myst::AvlSet<int, less<int>, allocator<int>, myst::order_statistics_node_update>;
+        if (!time_split<myst::RbSet<int>>("RbSet", N, 100) ||
+            !time_split<myst::AvlSet<int>>("AvlSet", N, 100) ||
+            !time_split<OsRbSet>("RbSet (order statistics)", N, 10000) ||
+            !time_split<OsAvlSet>("AvlSet (order statistics)", N, 10000)) {
+            cout << "split went wrong!\n";
+            return -1;
+        }
+        cout << '\n';
+        if (!check_fork_join_exceptions(10000)) {
+            cout << "fork_join lost an exception!\n";
+            return -1;
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "../MemPool/SlabAllocator.h"
+#include "../RbMap.h"
+#include "../AvlMap.h"
+#include "../../HashMap/HashMap.h"
+#include "../../Randomized/SkiplistMap.h"
+#include "../../RankTree/rolling_rank.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <cstdio>
+#if defined(__linux__)
+#include <unistd.h>   // fork, sysconf
+#include <sys/wait.h> // waitpid
+#endif
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+using kv = pair<const int, int>;
+
+// resident set size in MiB, from /proc/self/statm
+double rss_mib()
+{
+#if defined(__linux__)
+    long pages = 0, resident = 0;
+    if (FILE* f = fopen("/proc/self/statm", "r")) {
+        if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        fclose(f);
+    }
+    return double(resident) * sysconf(_SC_PAGESIZE) / (1 << 20);
+#else
+    return 0; // n/a
+#endif
+}
+
+// Each measurement runs in a child process of its own, so that the memory
+// the previous one left to malloc neither flatters nor spoils its RSS.
+void isolated(const function<void()>& fn)
+{
+    fflush(stdout);
+#if defined(__linux__)
+    if (pid_t pid = fork(); pid == 0) {
+        fn();
+        fflush(stdout);
+        _exit(0);
+    } else if (pid > 0) {
+        waitpid(pid, nullptr, 0);
+        return;
+    }
+#endif
+    fn();
+}
+
+// Fills the container with n keys, then does `ops` random erase + insert
+// pairs, the allocation pattern of a long-lived index: with keys drawn from
+// [0, 2n] the size stays around n.
+template<typename Map>
+void churn(Map& st, size_t n, size_t ops, unsigned seed)
+{
+    mt19937 gen(seed);
+    uniform_int_distribution<int> key(0, static_cast<int>(2 * n));
+    while (st.size() < n) st.insert({ key(gen), 0 });
+    for (size_t i = 0; i < ops; ++i) {
+        st.erase(key(gen));
+        st.insert({ key(gen), static_cast<int>(i) });
+    }
+}
+
+template<typename Map>
+void measure(const char* name, size_t n, size_t ops, unsigned threads)
+{
+    isolated([=] {
+        double rss0 = rss_mib(), peak = 0;
+        auto t0 = clk::now();
+        vector<thread> ts;
+        vector<double> peaks(threads);
+        for (unsigned t = 0; t < threads; ++t) {
+            ts.emplace_back([&, t] {
+                Map st;
+                churn(st, n / threads, ops / threads, t + 1);
+                peaks[t] = rss_mib();
+            });
+        }
+        for (auto& t : ts) t.join();
+        double s = chrono::duration<double>(clk::now() - t0).count();
+        for (double p : peaks) peak = max(peak, p);
+        printf("  %-36s %7.0f ns/op   RSS %7.1f MiB, %7.1f MiB after destruction\n", name,
+               s * 1e9 / (n + 2 * ops), peak - rss0, rss_mib() - rss0);
+    });
+}
+
+// RankTree has no erase by key and only insert(value)
+struct RankTreeSlab {
+    myRankingAlgo::RankTree<int, less<int>, myst::SlabAllocator<int>> tree;
+    size_t size() const { return tree.size(); }
+    void insert(const kv& x) { tree.insert(x.first); }
+    void erase(int key) { tree.remove(key); }
+};
+
+struct RankTreeStd {
+    myRankingAlgo::RankTree<int> tree;
+    size_t size() const { return tree.size(); }
+    void insert(const kv& x) { tree.insert(x.first); }
+    void erase(int key) { tree.remove(key); }
+};
+
+template<typename Alloc>
+using hash_map = myst::HashMap<int, int, hash<int>, equal_to<int>, Alloc>;
+
+void run(size_t n, size_t ops, unsigned threads)
+{
+    using slab = myst::SlabAllocator<kv>;
+    printf("%zu keys, %zu erase + insert, %u thread(s), a container per thread:\n", n, ops, threads);
+    measure<myst::RbMap<int, int>>("RbMap", n, ops, threads);
+    measure<myst::RbMap<int, int, less<int>, slab>>("RbMap + SlabAllocator", n, ops, threads);
+    measure<myst::AvlMap<int, int>>("AvlMap", n, ops, threads);
+    measure<myst::AvlMap<int, int, less<int>, slab>>("AvlMap + SlabAllocator", n, ops, threads);
+    measure<hash_map<allocator<kv>>>("HashMap", n, ops, threads);
+    measure<hash_map<slab>>("HashMap + SlabAllocator", n, ops, threads);
+    measure<myst::SkiplistMap<int, int>>("SkiplistMap", n, ops, threads);
+    measure<myst::SkiplistMap<int, int, less<int>, slab>>("SkiplistMap + SlabAllocator", n, ops, threads);
+    measure<RankTreeStd>("RankTree", n, ops, threads);
+    measure<RankTreeSlab>("RankTree + SlabAllocator", n, ops, threads);
+}
+
+// run: ./SlabAllocator_test [N=1000000] [threads=4]
+int main(int argc, char* argv[])
+{
+    try {
+        // one arena shared by containers of different node types
+        auto arena = make_shared<myst::SlabArena>();
+        {
+            myst::RbMap<int, int, less<int>, myst::SlabAllocator<kv>> rb{ myst::SlabAllocator<kv>(arena) };
+            myst::SkiplistMap<int, int, less<int>, myst::SlabAllocator<kv>> sl{ myst::SlabAllocator<kv>(arena) };
+            for (int i = 0; i < 100000; ++i) {
+                rb[i] = i;
+                sl[i] = i;
+            }
+            auto copy = rb;
+            for (int i = 0; i < 100000; i += 2) {
+                rb.erase(i);
+                sl.erase(i);
+            }
+            if (rb.size() != 50000 || sl.size() != 50000 || copy.size() != 100000) {
+                cout << "something went wrong!\n";
+                return -1;
+            }
+            printf("shared arena: %zu chunks, %.1f MiB\n\n", arena->chunk_count(),
+                   double(arena->reserved_bytes()) / (1 << 20));
+        }
+
+        size_t n = argc > 1 ? stoul(argv[1]) : 1'000'000;
+        unsigned threads = argc > 2 ? stoul(argv[2]) : 4;
+        run(n, 2 * n, 1);
+        if (threads > 1) {
+            cout << '\n';
+            run(n, 2 * n, threads);
+        }
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
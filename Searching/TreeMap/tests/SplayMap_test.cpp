@@ -0,0 +1,62 @@
+#include "../SplayMap.h"
+#include <string>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+template<typename Map>
+void print_map(std::string_view comment, const Map& m)
+{
+    std::cout << comment;
+    for (const auto& [key, value] : m) {
+        std::cout << '{' << key << ", " << value << "} ";
+    }
+}
+
+int main()
+{
+    using Splay = myst::SplayMap<int, string>;
+    //using Splay = myst::SplayMap<int, string, less<int>, allocator<pair<const int, string>>, myst::semi_splay>;
+    try {
+        Splay st = { {10, "ten"}, {50, "five"}, {80, "eight"}, {40, "four"},
+            {30, "three"}, {90, "nine"}, {60, "six"}, {20, "two"}, {70, "seven"} };
+
+        st.insert_or_assign(60, "six * six");
+        st[100] = "hundred";
+
+        print_map("st:\n", st);
+        cout << "\n\nst printed by lines (the last inserted key is at the root): \n";
+        st.print();
+        cout << "height: " << st.height() << '\n';
+
+        cout << "\n\nst.at(30) = " << st.at(30) << ", now 30 is at depth "
+             << st.depth(st.find(30)) << ":\n";
+        st.print();
+
+        const Splay st2 = st;
+        cout << "\n\nconst st2=st, st2.find(90) doesn't move 90, depth "
+             << st2.depth(st2.find(90)) << ", in reverse order:\n";
+        for (auto i = st2.rbegin(); i != st2.crend(); ++i) {
+            cout << '{' << i->first << ", " << i->second << "} ";
+        }
+
+        size_t count1 = st.erase(50);
+        size_t count2 = st.erase(55);
+        cout << "\n\nst, after removing 50 and 55: \n" << "there are \""
+            << count1 << "\" 50 and \"" << count2 << "\" 55 being removed\n";
+
+        print_map("", st);
+        cout << "\n\n";
+        st.print();
+        cout << "height: " << st.height() << '\n';
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "../SplaySet.h"
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+template<typename Set>
+void demo(const char* name)
+{
+    Set st;
+    for (int i = 1; i <= 15; ++i) {
+        st.insert(i); // sorted input degenerates into a path
+    }
+    cout << name << ", after inserting 1..15 in order, height " << st.height() << ":\n";
+    st.print();
+
+    st.find(1);
+    cout << "\nafter find(1), height " << st.height() << ":\n";
+    st.print();
+
+    st.erase(8);
+    cout << "\nafter erase(8):\n";
+    for (auto it : st) {
+        cout << it << "  ";
+    }
+    cout << "\n\n";
+}
+
+int main()
+{
+    try {
+        demo<myst::SplaySet<int>>("top-down splaying");
+        demo<myst::SplaySet<int, less<int>, allocator<int>, myst::semi_splay>>("semi-splaying");
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "../SplayMap.h"
+#include "../RbMap.h"
+#include "../../HashMap/HashMap.h"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+using SemiSplayMap = myst::SplayMap<int, int, less<int>, allocator<pair<const int, int>>, myst::semi_splay>;
+
+// q keys drawn from n keys with P(rank k) ~ 1/k^s; the ranks are
+// shuffled so the hot keys are scattered over the key space
+vector<int> zipf_stream(const vector<int>& keys, double s, size_t q, mt19937& gen)
+{
+    vector<double> cdf(keys.size());
+    double sum = 0;
+    for (size_t k = 0; k < keys.size(); ++k) {
+        sum += 1 / pow(k + 1.0, s);
+        cdf[k] = sum;
+    }
+    uniform_real_distribution<double> u(0, sum);
+    vector<int> stream(q);
+    for (auto& key : stream) {
+        size_t k = upper_bound(cdf.begin(), cdf.end(), u(gen)) - cdf.begin();
+        key = keys[min(k, keys.size() - 1)];
+    }
+    return stream;
+}
+
+// average ns per find() over the stream
+template<typename Map>
+double ns_per_find(Map& mp, const vector<int>& stream, size_t& sink)
+{
+    auto t0 = clk::now();
+    for (int key : stream) {
+        sink += mp.find(key)->second;
+    }
+    return chrono::duration<double, nano>(clk::now() - t0).count() / stream.size();
+}
+
+// run: ./SplayZipf_test [N=1000000] [LOOKUPS=5000000]
+int main(int argc, char* argv[])
+{
+    try {
+        size_t n = argc > 1 ? stoul(argv[1]) : 1'000'000;
+        size_t q = argc > 2 ? stoul(argv[2]) : 5'000'000;
+        mt19937 gen(2021);
+        vector<int> keys(n);
+        iota(keys.begin(), keys.end(), 0);
+        shuffle(keys.begin(), keys.end(), gen); // keys[k]: the key of rank k
+
+        myst::SplayMap<int, int> splay;
+        SemiSplayMap semi;
+        myst::RbMap<int, int> rb;
+        myst::HashMap<int, int> hash;
+        for (int key : keys) {
+            splay.insert(key, key);
+            semi.insert(key, key);
+            rb.insert(key, key);
+            hash.insert(key, key);
+        }
+
+        cout << n << " keys, " << q << " lookups per run (ns/find)\n";
+        printf("%6s %12s %14s %10s %10s %10s\n", "s", "top 300", "SplayMap", "semi", "RbMap", "HashMap");
+        size_t sink = 0;
+        for (double s : { 0.8, 1.0, 1.2, 1.4 }) {
+            vector<int> stream = zipf_stream(keys, s, q, gen);
+            double hot = 0, all = 0;
+            for (size_t k = 0; k < n; ++k) {
+                (k < 300 ? hot : all) += 1 / pow(k + 1.0, s);
+            }
+            printf("%6.1f %11.1f%% %14.1f %10.1f %10.1f %10.1f\n", s, 100 * hot / (hot + all),
+                   ns_per_find(splay, stream, sink), ns_per_find(semi, stream, sink),
+                   ns_per_find(rb, stream, sink), ns_per_find(hash, stream, sink));
+        }
+        cout << "(checksum " << sink << ")\n";
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
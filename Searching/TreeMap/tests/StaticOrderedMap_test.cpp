@@ -0,0 +1,109 @@
+#include "../RbMap.h"
+#include "../StaticOrderedMap.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <climits>
+#include <stdexcept>
+#include <iostream>
+
+using namespace std;
+namespace myst = mySymbolTable;
+
+using clk = chrono::steady_clock;
+
+// average ns per call of f(query) over all queries
+template<typename F>
+double ns_per_lookup(const vector<int>& queries, F f, size_t& sink)
+{
+    auto t0 = clk::now();
+    for (int q : queries) {
+        sink += f(q);
+    }
+    return chrono::duration<double, nano>(clk::now() - t0).count() / queries.size();
+}
+
+// run: ./StaticOrderedMap_test [LOG2_MAX_KEYS=22]
+// 2^10 keys fit in L1, each 4-byte key costs ~12 bytes in a StaticOrderedMap,
+// so LOG2_MAX_KEYS=29 is a ~6 GB dataset; the RbMap is only built up to 2^24 keys
+int main(int argc, char* argv[])
+{
+    try {
+        myst::RbMap<int, string> mp = { {5, "five"}, {1, "one"}, {9, "nine"}, {3, "three"}, {7, "seven"} };
+        auto frozen = mp.freeze();
+        cout << "frozen:  ";
+        for (const auto& it : frozen) {
+            cout << "{" << it.first << ", " << it.second << "}  ";
+        }
+        cout << "\nlower_bound(4): " << frozen.lower_bound(4)->second
+             << ", upper_bound(5): " << frozen.upper_bound(5)->second
+             << ", at(9): " << frozen.at(9) << ", contains(2): " << boolalpha << frozen.contains(2)
+             << "\nkeys in [2, 8]:  ";
+        for (auto it = frozen.lower_bound(2); it != frozen.upper_bound(8); ++it) {
+            cout << it->first << "  ";
+        }
+        cout << "\n";
+
+        // every shape of the last level: lower/upper_bound vs. the sorted array
+        for (int n = 0; n <= 300; ++n) {
+            vector<pair<int, int>> kv(n);
+            for (int i = 0; i < n; ++i) kv[i] = { 2 * i, i };
+            myst::StaticOrderedMap<int, int> som(kv.begin(), kv.end());
+            for (int q = -1; q <= 2 * n; ++q) {
+                auto lb = lower_bound(kv.begin(), kv.end(), make_pair(q, INT_MIN)) - kv.begin();
+                auto ub = lower_bound(kv.begin(), kv.end(), make_pair(q + 1, INT_MIN)) - kv.begin();
+                if (som.lower_bound(q) - som.begin() != lb || som.upper_bound(q) - som.begin() != ub)
+                    throw runtime_error("wrong bound for " + to_string(q) + " in " + to_string(n) + " keys");
+            }
+        }
+        cout << "lower_bound/upper_bound checked for 0..300 keys\n\n";
+
+        int log2_max = argc > 1 ? stoi(argv[1]) : 22;
+        const size_t Q = 1'000'000;
+        mt19937 gen(2021);
+        size_t sink = 0;
+        printf("%12s %14s %18s %20s\n", "keys", "RbMap::find", "std::lower_bound", "StaticOrderedMap");
+        for (int lg = 10; lg <= log2_max; lg += 2) {
+            size_t n = size_t(1) << lg;
+            vector<int> keys(n);
+            for (size_t i = 0; i < n; ++i) {
+                keys[i] = static_cast<int>(2 * i); // queries hit about half of the time
+            }
+            vector<int> queries(Q);
+            uniform_int_distribution<int> dist(0, static_cast<int>(2 * n));
+            for (auto& q : queries) q = dist(gen);
+
+            vector<pair<int, int>> kv(n);
+            for (size_t i = 0; i < n; ++i) kv[i] = { keys[i], static_cast<int>(i) };
+            myst::StaticOrderedMap<int, int> som(kv.begin(), kv.end());
+            kv = {};
+
+            double t_tree = -1;
+            if (lg <= 24) {
+                myst::RbMap<int, int> tree;
+                for (size_t i = 0; i < n; ++i) tree.insert(tree.end(), { keys[i], static_cast<int>(i) });
+                t_tree = ns_per_lookup(queries, [&](int q) { return tree.find(q) != tree.end(); }, sink);
+            }
+            double t_bin = ns_per_lookup(queries, [&](int q) {
+                auto it = lower_bound(keys.begin(), keys.end(), q);
+                return it != keys.end() && *it == q;
+            }, sink);
+            double t_som = ns_per_lookup(queries, [&](int q) { return som.find(q) != som.end(); }, sink);
+
+            if (t_tree < 0) printf("%12zu %14s %15.1f ns %17.1f ns\n", n, "-", t_bin, t_som);
+            else printf("%12zu %11.1f ns %15.1f ns %17.1f ns\n", n, t_tree, t_bin, t_som);
+        }
+        cout << "(hits: " << sink << ")\n";
+    }
+    catch (const exception& e) {
+        cout << e.what() << endl;
+    }
+    catch (...) {
+        cout << "Some unknown error happened" << endl;
+    }
+
+    return 0;
+}
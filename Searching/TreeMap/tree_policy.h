@@ -0,0 +1,161 @@
+/*
+ *  node update policies for the balanced search trees
+ *  (RBtree/AVLtree), naming borrowed from GNU pb_ds
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/Searching/TreeMap/tree_policy.h
+ *
+ *  usage:
+ *      mySymbolTable::RbSet<int, std::less<int>, std::allocator<int>,
+ *                           mySymbolTable::order_statistics_node_update> st;
+ *      st.rank(42); st.select(0); st.count_range(10, 20);
+ *
+ *      mySymbolTable::AvlMap<int, int, std::less<int>, std::allocator<std::pair<const int, int>>,
+ *                            mySymbolTable::compact_node_layout<>> mp; // smaller nodes
+ *
+ *      mySymbolTable::RbMap<int, long, std::less<int>, std::allocator<std::pair<const int, long>>,
+ *                           mySymbolTable::range_sum_node_update<long>> sums;
+ *      sums.fold(10, 20); // sum of the values with keys in [10, 20)
+ */
+
+#ifndef TREE_POLICY_H
+#define TREE_POLICY_H 1
+
+#include <cstddef>     // size_t
+#include <cstdint>     // std::uintptr_t
+#include <type_traits> // std::is_same, std::void_t
+#include <utility>     // std::pair
+
+namespace mySymbolTable {
+
+// default, nodes carry nothing but the value and the links
+struct null_node_update {};
+
+// Every node also records the size of its subtree, which costs one word per
+// node and a walk up to the root on each insertion/erasure, in exchange for
+// O(log n) rank(key), select(k) and count_range(lo, hi).
+struct order_statistics_node_update {};
+
+// Custom augmentation: every node keeps a summary of its subtree, e.g.
+// the max of some field or the sum of the values, maintained through
+// insertions, erasures and rotations. A policy for it looks like
+//
+//     struct my_node_update {
+//         using metadata_type = M;
+//         // summary of a single element
+//         static M from_value(const value_type& val);
+//         // summary of two adjacent runs of elements, associative and nothrow
+//         static M combine(const M& lhs, const M& rhs);
+//         // summary of no elements, only needed by fold()
+//         static M identity();
+//     };
+//
+// The summary of a node is then combine(left, from_value(val), right),
+// missing children left out. If it depends on the mapped values, change
+// them with insert_or_assign() or call refresh(pos) after doing it in place.
+template<typename NodeUpdate, typename = void>
+struct has_metadata : std::false_type {};
+
+template<typename NodeUpdate>
+struct has_metadata<NodeUpdate, std::void_t<typename NodeUpdate::metadata_type>> : std::true_type {};
+
+// extra fields a node needs for a given policy, as a base class
+// of the node so that null_node_update takes up no space
+template<typename NodeUpdate, typename = void>
+struct node_metadata {};
+
+template<typename NodeUpdate>
+struct node_metadata<NodeUpdate, std::void_t<typename NodeUpdate::metadata_type>> {
+    typename NodeUpdate::metadata_type _meta{}; // summary of this subtree
+};
+
+template<>
+struct node_metadata<order_statistics_node_update> {
+    size_t _size = 1; // # of nodes in this subtree
+};
+
+// Opt-in compact node layout for another policy: the red-black color (1 bit)
+// or the AVL balance factor (3 bits) is kept in the low bits of the parent
+// pointer, which are always 0 as nodes are aligned, instead of a field of
+// its own that padding grows to a whole word. Costs a mask on each parent
+// access, e.g. compact_node_layout<order_statistics_node_update>.
+template<typename NodeUpdate = null_node_update>
+struct compact_node_layout {};
+
+template<typename NodeUpdate>
+struct node_metadata<compact_node_layout<NodeUpdate>> : node_metadata<NodeUpdate> {};
+
+template<typename NodeUpdate>
+struct remove_node_layout { using type = NodeUpdate; };
+
+template<typename NodeUpdate>
+struct remove_node_layout<compact_node_layout<NodeUpdate>> { using type = NodeUpdate; };
+
+template<typename NodeUpdate>
+constexpr bool has_order_statistics_v =
+    std::is_same<typename remove_node_layout<NodeUpdate>::type, order_statistics_node_update>::value;
+
+template<typename NodeUpdate>
+constexpr bool has_metadata_v = has_metadata<typename remove_node_layout<NodeUpdate>::type>::value;
+
+// NodeUpdate::metadata_type, an empty struct if there is none
+template<typename NodeUpdate, bool = has_metadata_v<NodeUpdate>>
+struct node_update_metadata { using type = null_node_update; };
+
+template<typename NodeUpdate>
+struct node_update_metadata<NodeUpdate, true> {
+    using type = typename remove_node_layout<NodeUpdate>::type::metadata_type;
+};
+
+template<typename NodeUpdate>
+constexpr bool is_compact_layout_v =
+    !std::is_same<typename remove_node_layout<NodeUpdate>::type, NodeUpdate>::value;
+
+// Sum of the mapped values (of the keys for sets) in every subtree, for
+// O(log n) range sums with fold(lo, hi).
+template<typename Sum>
+struct range_sum_node_update {
+    using metadata_type = Sum;
+
+    template<typename Key, typename T>
+    static Sum from_value(const std::pair<Key, T>& val) { return val.second; }
+
+    template<typename Key>
+    static Sum from_value(const Key& key) { return key; }
+
+    static Sum combine(const Sum& lhs, const Sum& rhs) { return lhs + rhs; }
+
+    static Sum identity() { return Sum(); }
+};
+
+// A parent pointer with its `Bits` low bits used as a tag. It converts to
+// and is assigned from a plain Node*, keeping the tag untouched, so the
+// tree algorithms read the same whichever layout they run on.
+template<typename Node, int Bits>
+class tagged_parent {
+    static constexpr std::uintptr_t TagMask = (std::uintptr_t(1) << Bits) - 1;
+    std::uintptr_t _bits;
+public:
+    tagged_parent(Node* p = nullptr, unsigned tag = 0) noexcept
+        : _bits(reinterpret_cast<std::uintptr_t>(p) | tag) {}
+
+    tagged_parent& operator=(Node* p) noexcept {
+        _bits = reinterpret_cast<std::uintptr_t>(p) | (_bits & TagMask);
+        return *this;
+    }
+
+    // copies the pointer only, the tag belongs to the node
+    tagged_parent& operator=(const tagged_parent& rhs) noexcept {
+        return *this = rhs.get();
+    }
+
+    Node* get() const noexcept { return reinterpret_cast<Node*>(_bits & ~TagMask); }
+    operator Node*() const noexcept { return get(); }
+    Node* operator->() const noexcept { return get(); }
+
+    unsigned tag() const noexcept { return static_cast<unsigned>(_bits & TagMask); }
+    void set_tag(unsigned tag) noexcept { _bits = (_bits & ~TagMask) | tag; }
+};
+
+} // namespace mySymbolTable
+
+#endif // !TREE_POLICY_H
@@ -6,6 +6,8 @@
 #   include "TreeMap/BstMap.h"
 #elif defined(USE_RBT)
 #   include "TreeMap/RbMap.h"
+#elif defined(USE_BTREE)
+#   include "TreeMap/BTreeMap.h"
 #elif defined(USE_TST)
 #   include "TreeMap/TST.h"
 #elif defined(USE_MYHT)
@@ -136,6 +138,9 @@ int main(int argc, char* argv[])
 #elif defined(USE_RBT)
         mySymbolTable::RbMap<string, size_t> mp{};
         method = "myst::RBtree";
+#elif defined(USE_BTREE)
+        mySymbolTable::BTreeMap<string, size_t> mp{};
+        method = "myst::BTree";
 #elif defined(USE_TST)
         mySymbolTable::TST<size_t> mp{};
         method = "myst::TST";
@@ -235,7 +240,8 @@ int main(int argc, char* argv[])
              << "iter time:  " << iter_time << " ms\n";
 
         [[maybe_unused]] int height = 0;
-#if defined(USE_BST) || defined(USE_AVL) || defined(USE_RBT) || defined(USE_TST)
+#if defined(USE_BST) || defined(USE_AVL) || defined(USE_RBT) || defined(USE_TST) || \
+    defined(USE_BTREE)
         cout << "\ntree size: " << mp.size()
              << "\ntree height: " << (height = mp.height()) << '\n';
 #elif defined(USE_SKIPLIST)
@@ -250,7 +256,7 @@ int main(int argc, char* argv[])
             << sort_time << " ms | " << find_time << " ms | "
             << query_time << " ms | " << iter_time << " ms |"
 #if defined(USE_BST) || defined(USE_AVL) || defined(USE_RBT) || \
-    defined(USE_TST) || defined(USE_SKIPLIST)
+    defined(USE_TST) || defined(USE_SKIPLIST) || defined(USE_BTREE)
             << ' ' << height << " |"
 #endif
             << '\n';
@@ -4,6 +4,9 @@
 #include <string_view>
 #include <vector>
 #include <queue>
+#include <memory>
+
+#include "../../../Searching/TreeMap/MemPool/MonotonicArena.h"
 
 namespace myStringAlgo {
 
@@ -25,14 +28,34 @@ struct ACTrieNode {
     bool is_word_ = false;  // is this node the last character of some pattern word?
 };
 
+// the nodes come from Alloc (rebound to ACTrieNode); with the default,
+// `ACTrie ac(patterns);` still deduces ACTrie<>. With a monotonic one (e.g.
+// mySymbolTable::MonotonicAllocator) the destructor leaves them to the arena.
+template <typename Alloc = std::allocator<ACTrieNode>>
 class ACTrie {
+    using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<ACTrieNode>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    NodeAlloc alloc_;
     ACTrieNode *root_;  // the 0 state
     std::vector<std::string_view> patterns_;
 
-    void init_root() { root_ = new ACTrieNode(); }
+    void init_root() { root_ = new_node(); }
+
+    ACTrieNode *new_node() {
+        ACTrieNode *x = NodeTraits::allocate(alloc_, 1);
+        NodeTraits::construct(alloc_, x);
+        return x;
+    }
+
+    void delete_node(ACTrieNode *x) {
+        NodeTraits::destroy(alloc_, x);
+        NodeTraits::deallocate(alloc_, x, 1);
+    }
 
 public:
-    ACTrie(const std::string *patterns, size_t num) : patterns_(patterns, patterns + num) {
+    ACTrie(const std::string *patterns, size_t num, const Alloc &alloc = Alloc())
+        : alloc_(alloc), patterns_(patterns, patterns + num) {
         init_root();
         for (size_t i = 0; i < num; i++) {
             insert(patterns[i].c_str(), i);
@@ -40,7 +63,11 @@ public:
         construct_failure_links();
     }
 
-    ACTrie(const std::vector<std::string> &patterns) : ACTrie(patterns.data(), patterns.size()) {}
+    ACTrie(const std::vector<std::string> &patterns, const Alloc &alloc = Alloc())
+        : ACTrie(patterns.data(), patterns.size(), alloc) {}
+
+    ACTrie(const ACTrie &) = delete;
+    ACTrie &operator=(const ACTrie &) = delete;
 
     ~ACTrie() { destroy(root_); }
 
@@ -73,12 +100,24 @@ public:
     }
 
 private:
+    // iterative, a long pattern must not overflow the stack
     void destroy(ACTrieNode *x) {
-        if (x) {
+        if constexpr (mySymbolTable::drops_without_walk_v<Alloc, ACTrieNode>) {
+            return;
+        }
+        if (!x) {
+            return;
+        }
+        std::vector<ACTrieNode *> pending{x};
+        while (!pending.empty()) {
+            x = pending.back();
+            pending.pop_back();
             for (int c = 0; c < Radix; c++) {
-                destroy(x->goto_[c]);
+                if (x->goto_[c]) {
+                    pending.push_back(x->goto_[c]);
+                }
             }
-            delete x;
+            delete_node(x);
         }
     }
 
@@ -92,7 +131,7 @@ private:
             if (cur->goto_[*c]) {
                 cur = cur->goto_[*c];
             } else {
-                ACTrieNode *node = new ACTrieNode;
+                ACTrieNode *node = new_node();
                 cur->goto_[*c] = node;
                 cur = node;
             }
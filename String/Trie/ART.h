@@ -0,0 +1,777 @@
+/*
+ *  symbol table with key specialized as string:
+ *  adaptive radix tree (Leis et al., ICDE 2013)
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/String/Trie/ART.h
+ */
+
+#ifndef ART_H
+#define ART_H 1
+
+#include <string>
+#include <vector>
+#include <new>       // ::operator new, placement new
+#include <cstdint>
+#include <cstring>   // std::memcmp, std::memcpy, std::memmove
+#include <algorithm> // std::min, std::max
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mySymbolTable {
+
+// Adaptive Radix Tree symbol table: key=string -> value, keys in the same
+// (byte-wise) order as Trie. Instead of Trie's 256 links per node, an inner
+// node takes the smallest of 4 layouts that holds its children:
+//   Node4:   up to 4 sorted key bytes and 4 links,
+//   Node16:  up to 16 sorted key bytes and 16 links, searched with SSE2,
+//   Node48:  a 256-byte index into 48 links,
+//   Node256: 256 links, as in Trie.
+// Chains of one-child nodes are collapsed into the node below (path
+// compression, the first MaxPrefix bytes of the path are kept in the node
+// and the rest checked at the leaf), and a key that has no siblings below
+// some depth is stored as a single leaf holding the whole key (lazy
+// expansion), so a node is only created where keys branch.
+template<typename T>
+class ART {
+private:
+	typedef unsigned char uchar;
+	static constexpr size_t MaxPrefix = 8; // bytes of a compressed path kept in its node
+
+	enum class Type : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+	struct Node {
+		Type type;
+		Node(Type t) : type(t) {}
+	};
+
+	// followed by the len bytes of the key in the same allocation
+	struct Leaf : Node {
+		T val;
+		size_t len;
+
+		Leaf(const T& v, size_t n) : Node(Type::LEAF), val(v), len(n) {}
+		const char* key() const { return reinterpret_cast<const char*>(this + 1); }
+		char* key() { return reinterpret_cast<char*>(this + 1); }
+	};
+
+	struct Inner : Node {
+		uint16_t count = 0;             // # of children
+		uint32_t prefix_len = 0;        // length of the compressed path above the children
+		uchar prefix[MaxPrefix] = {};   // its first MaxPrefix bytes
+		Leaf* term = nullptr;           // the key that ends right after the compressed path
+
+		Inner(Type t) : Node(t) {}
+	};
+
+	struct Node4 : Inner {
+		uchar keys[4] = {};
+		Node* child[4] = {};
+		Node4() : Inner(Type::NODE4) {}
+	};
+
+	struct Node16 : Inner {
+		uchar keys[16] = {};
+		Node* child[16] = {};
+		Node16() : Inner(Type::NODE16) {}
+	};
+
+	struct Node48 : Inner {
+		uchar index[256] = {}; // index[c]: 1 + slot of the link for byte c, 0 if none
+		Node* child[48] = {};
+		Node48() : Inner(Type::NODE48) {}
+	};
+
+	struct Node256 : Inner {
+		Node* child[256] = {};
+		Node256() : Inner(Type::NODE256) {}
+	};
+
+	Node* root;	// pointer to root node
+	size_t n;	// no. of keys in ART
+public:
+	ART() : root(nullptr), n(0) {}
+
+	ART(const ART&) = delete;
+	ART& operator=(const ART&) = delete;
+
+	~ART() { clear(); }
+
+	void clear() { clear(root); root = nullptr; n = 0; }
+
+	T& operator[](const std::string& key) {
+		if (key == "") throw std::invalid_argument("key to operator[] cannot be null");
+		return insert(key, T(), false)->val;
+	}
+
+	const T& at(const std::string& key) const {
+		if (key == "") throw std::invalid_argument("key to at() cannot be null");
+		const Leaf* x = find(key);
+		if (x == nullptr) throw std::out_of_range("invalid key to at()");
+		return x->val;
+	}
+
+	T& at(const std::string& key) {
+		return const_cast<T&>(static_cast<const ART*>(this)->at(key));
+	}
+
+	// nullptr if key does not exist
+	const T* get(const std::string& key) const {
+		if (key == "") throw std::invalid_argument("key to get() cannot be null");
+		const Leaf* x = find(key);
+		return x ? &x->val : nullptr;
+	}
+
+	T* get(const std::string& key) {
+		return const_cast<T*>(static_cast<const ART*>(this)->get(key));
+	}
+
+	// same as insert_or_assign()
+	void put(const std::string& key, const T& val) {
+		insert_or_assign(key, val);
+	}
+
+	size_t size() const noexcept { return n; }
+
+	bool empty() const noexcept { return n == 0; }
+
+	bool contains(const std::string& key) const {
+		if (key == "") throw std::invalid_argument("key to contains() cannot be null");
+		return find(key) != nullptr;
+	}
+
+	std::vector<std::string> keys() const {
+		std::vector<std::string> vs;
+		collect(root, vs);
+		return vs;
+	}
+
+	std::vector<std::string> keys_with_prefix(const std::string& prefix) const {
+		std::vector<std::string> vs;
+		const Node* x = root;
+		size_t d = 0;
+		while (x != nullptr) {
+			if (x->type == Type::LEAF) {
+				const Leaf* l = static_cast<const Leaf*>(x);
+				if (l->len >= prefix.size() && std::memcmp(l->key(), prefix.data(), prefix.size()) == 0)
+					vs.emplace_back(l->key(), l->len);
+				break;
+			}
+			const Inner* in = static_cast<const Inner*>(x);
+			size_t p = prefix_mismatch(in, prefix, d);
+			if (d + p == prefix.size()) { // the prefix ends within (or right after) the path
+				collect(in, vs);
+				break;
+			}
+			if (p < in->prefix_len) break; // no matches
+			d += in->prefix_len;
+			Node* const* c = find_child(in, prefix[d++]);
+			x = c ? *c : nullptr;
+		}
+		return vs;
+	}
+
+	// using wildcard ? to represent any single character
+	// e.g. file?.h matches first two in {file1.h, file2.h, file3.cc}
+	std::vector<std::string> keys_that_match(const std::string& pattern) const {
+		if (pattern == "") throw std::invalid_argument("pattern to keys_that_match() cannot be null");
+		std::vector<std::string> vs;
+		collect(root, pattern, 0, vs);
+		return vs;
+	}
+
+	std::string longest_prefix_of(const std::string& query) const {
+		if (query == "") throw std::invalid_argument("query to longest_prefix_of() cannot be null");
+		size_t len = 0; // 0 if no substring of query
+		const Node* x = root;
+		size_t d = 0;
+		while (x != nullptr) {
+			if (x->type == Type::LEAF) {
+				if (is_prefix_of(static_cast<const Leaf*>(x), query))
+					len = static_cast<const Leaf*>(x)->len;
+				break;
+			}
+			const Inner* in = static_cast<const Inner*>(x);
+			if (!optimistic_match(in, query, d)) break;
+			d += in->prefix_len;
+			if (in->term != nullptr && is_prefix_of(in->term, query)) len = d;
+			if (d == query.length()) break;
+			Node* const* c = find_child(in, query[d++]);
+			x = c ? *c : nullptr;
+		}
+		return query.substr(0, len);
+	}
+
+	// no overwriting if key already exists
+	T& insert(const std::string& key, const T& val) {
+		if (key == "") throw std::invalid_argument("key to insert() cannot be null");
+		return insert(key, val, false)->val;
+	}
+
+	// overwrite if key already exists
+	T& insert_or_assign(const std::string& key, const T& val) {
+		if (key == "") throw std::invalid_argument("key to insert_or_assign() cannot be null");
+		return insert(key, val, true)->val;
+	}
+
+	void erase(const std::string& key) {
+		if (key == "") throw std::invalid_argument("key to erase() cannot be null");
+		erase(root, key, 0);
+	}
+
+	// bytes taken by the nodes and leaves, not counting what the values own
+	size_t memory_usage() const {
+		return memory_usage(root);
+	}
+
+protected:
+	/* nodes */
+
+	static Leaf* new_leaf(const std::string& key, const T& val) {
+		void* mem = ::operator new(sizeof(Leaf) + key.size());
+		Leaf* l;
+		try {
+			l = new (mem) Leaf(val, key.size());
+		}
+		catch (...) {
+			::operator delete(mem);
+			throw;
+		}
+		std::memcpy(l->key(), key.data(), key.size());
+		return l;
+	}
+
+	static void delete_leaf(Leaf* l) {
+		l->~Leaf();
+		::operator delete(l);
+	}
+
+	static void delete_inner(Inner* x) {
+		switch (x->type) {
+		case Type::NODE4:	delete static_cast<Node4*>(x); break;
+		case Type::NODE16:	delete static_cast<Node16*>(x); break;
+		case Type::NODE48:	delete static_cast<Node48*>(x); break;
+		default:			delete static_cast<Node256*>(x); break;
+		}
+	}
+
+	static void copy_header(Inner* to, const Inner* from) {
+		to->count = from->count;
+		to->prefix_len = from->prefix_len;
+		std::memcpy(to->prefix, from->prefix, MaxPrefix);
+		to->term = from->term;
+	}
+
+	// calls f(c, child) for every child in order of c
+	template<typename F>
+	static void for_each_child(const Inner* x, F f) {
+		switch (x->type) {
+		case Type::NODE4: {
+			const Node4* y = static_cast<const Node4*>(x);
+			for (size_t i = 0; i < y->count; ++i) f(y->keys[i], y->child[i]);
+			break;
+		}
+		case Type::NODE16: {
+			const Node16* y = static_cast<const Node16*>(x);
+			for (size_t i = 0; i < y->count; ++i) f(y->keys[i], y->child[i]);
+			break;
+		}
+		case Type::NODE48: {
+			const Node48* y = static_cast<const Node48*>(x);
+			for (size_t c = 0; c < 256; ++c)
+				if (y->index[c]) f(static_cast<uchar>(c), y->child[y->index[c] - 1]);
+			break;
+		}
+		default: {
+			const Node256* y = static_cast<const Node256*>(x);
+			for (size_t c = 0; c < 256; ++c)
+				if (y->child[c]) f(static_cast<uchar>(c), y->child[c]);
+			break;
+		}
+		}
+	}
+
+	// the link for byte c, null if none
+	static Node* const* find_child(const Inner* x, char ch) {
+		uchar c = static_cast<uchar>(ch);
+		switch (x->type) {
+		case Type::NODE4: {
+			const Node4* y = static_cast<const Node4*>(x);
+			for (size_t i = 0; i < y->count; ++i)
+				if (y->keys[i] == c) return &y->child[i];
+			return nullptr;
+		}
+		case Type::NODE16: {
+			const Node16* y = static_cast<const Node16*>(x);
+#if defined(__SSE2__)
+			// compare all 16 key bytes at once
+			__m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(c)),
+			                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(y->keys)));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(eq)) & ((1u << y->count) - 1);
+			return mask ? &y->child[__builtin_ctz(mask)] : nullptr;
+#else
+			for (size_t i = 0; i < y->count; ++i)
+				if (y->keys[i] == c) return &y->child[i];
+			return nullptr;
+#endif
+		}
+		case Type::NODE48: {
+			const Node48* y = static_cast<const Node48*>(x);
+			return y->index[c] ? &y->child[y->index[c] - 1] : nullptr;
+		}
+		default: {
+			const Node256* y = static_cast<const Node256*>(x);
+			return y->child[c] ? &y->child[c] : nullptr;
+		}
+		}
+	}
+
+	static Node** find_child(Inner* x, char ch) {
+		return const_cast<Node**>(find_child(static_cast<const Inner*>(x), ch));
+	}
+
+	// keys[0, count) sorted, make room for c
+	static size_t insert_pos(uchar* keys, Node** child, size_t count, uchar c) {
+		size_t i = 0;
+		while (i < count && keys[i] < c) ++i;
+		std::memmove(keys + i + 1, keys + i, count - i);
+		std::memmove(child + i + 1, child + i, (count - i) * sizeof(Node*));
+		return i;
+	}
+
+	// adds a link for byte c (which has none), growing the node x
+	// referenced by ref into the next layout if it is full
+	static void add_child(Node*& ref, char ch, Node* child) {
+		uchar c = static_cast<uchar>(ch);
+		Inner* x = static_cast<Inner*>(ref);
+		switch (x->type) {
+		case Type::NODE4: {
+			Node4* y = static_cast<Node4*>(x);
+			if (y->count < 4) {
+				size_t i = insert_pos(y->keys, y->child, y->count, c);
+				y->keys[i] = c;
+				y->child[i] = child;
+				++y->count;
+				return;
+			}
+			Node16* z = new Node16();
+			copy_header(z, y);
+			std::memcpy(z->keys, y->keys, 4);
+			std::memcpy(z->child, y->child, 4 * sizeof(Node*));
+			ref = z;
+			delete y;
+			break;
+		}
+		case Type::NODE16: {
+			Node16* y = static_cast<Node16*>(x);
+			if (y->count < 16) {
+				size_t i = insert_pos(y->keys, y->child, y->count, c);
+				y->keys[i] = c;
+				y->child[i] = child;
+				++y->count;
+				return;
+			}
+			Node48* z = new Node48();
+			copy_header(z, y);
+			for (size_t i = 0; i < 16; ++i) {
+				z->index[y->keys[i]] = static_cast<uchar>(i + 1);
+				z->child[i] = y->child[i];
+			}
+			ref = z;
+			delete y;
+			break;
+		}
+		case Type::NODE48: {
+			Node48* y = static_cast<Node48*>(x);
+			if (y->count < 48) {
+				size_t slot = 0;
+				while (y->child[slot] != nullptr) ++slot; // slots get freed by erase()
+				y->index[c] = static_cast<uchar>(slot + 1);
+				y->child[slot] = child;
+				++y->count;
+				return;
+			}
+			Node256* z = new Node256();
+			copy_header(z, y);
+			for (size_t i = 0; i < 256; ++i)
+				if (y->index[i]) z->child[i] = y->child[y->index[i] - 1];
+			ref = z;
+			delete y;
+			break;
+		}
+		default: {
+			Node256* y = static_cast<Node256*>(x);
+			y->child[c] = child;
+			++y->count;
+			return;
+		}
+		}
+		add_child(ref, ch, child);
+	}
+
+	// removes the link for byte c, shrinking the node x referenced by
+	// ref into the previous layout once it is (well) below its capacity
+	static void remove_child(Node*& ref, char ch) {
+		uchar c = static_cast<uchar>(ch);
+		Inner* x = static_cast<Inner*>(ref);
+		switch (x->type) {
+		case Type::NODE4:
+		case Type::NODE16: {
+			uchar* keys = x->type == Type::NODE4 ? static_cast<Node4*>(x)->keys : static_cast<Node16*>(x)->keys;
+			Node** child = x->type == Type::NODE4 ? static_cast<Node4*>(x)->child : static_cast<Node16*>(x)->child;
+			size_t i = 0;
+			while (keys[i] != c) ++i;
+			std::memmove(keys + i, keys + i + 1, x->count - i - 1);
+			std::memmove(child + i, child + i + 1, (x->count - i - 1) * sizeof(Node*));
+			--x->count;
+			if (x->type == Type::NODE16 && x->count <= 3) {
+				Node16* y = static_cast<Node16*>(x);
+				Node4* z = new Node4();
+				copy_header(z, y);
+				std::memcpy(z->keys, y->keys, y->count);
+				std::memcpy(z->child, y->child, y->count * sizeof(Node*));
+				ref = z;
+				delete y;
+			}
+			break;
+		}
+		case Type::NODE48: {
+			Node48* y = static_cast<Node48*>(x);
+			y->child[y->index[c] - 1] = nullptr;
+			y->index[c] = 0;
+			--y->count;
+			if (y->count <= 12) {
+				Node16* z = new Node16();
+				copy_header(z, y);
+				size_t i = 0;
+				for (size_t k = 0; k < 256; ++k) {
+					if (y->index[k]) {
+						z->keys[i] = static_cast<uchar>(k);
+						z->child[i++] = y->child[y->index[k] - 1];
+					}
+				}
+				ref = z;
+				delete y;
+			}
+			break;
+		}
+		default: {
+			Node256* y = static_cast<Node256*>(x);
+			y->child[c] = nullptr;
+			--y->count;
+			if (y->count <= 37) {
+				Node48* z = new Node48();
+				copy_header(z, y);
+				size_t slot = 0;
+				for (size_t k = 0; k < 256; ++k) {
+					if (y->child[k]) {
+						z->index[k] = static_cast<uchar>(slot + 1);
+						z->child[slot++] = y->child[k];
+					}
+				}
+				ref = z;
+				delete y;
+			}
+			break;
+		}
+		}
+	}
+
+	// a Node4 left with no children becomes its terminal leaf (or nothing),
+	// one left with a single child and no terminal leaf is merged into it
+	static void compact(Node*& ref) {
+		if (ref->type != Type::NODE4) return;
+		Node4* x = static_cast<Node4*>(ref);
+		if (x->count == 0) {
+			ref = x->term;
+			delete x;
+		}
+		else if (x->count == 1 && x->term == nullptr) {
+			Node* child = x->child[0];
+			if (child->type != Type::LEAF) {
+				// the child's path becomes x's path + the byte to the child + its own
+				Inner* y = static_cast<Inner*>(child);
+				uchar buf[MaxPrefix];
+				size_t k = std::min<size_t>(x->prefix_len, MaxPrefix);
+				std::memcpy(buf, x->prefix, k);
+				if (k < MaxPrefix) buf[k++] = x->keys[0];
+				for (size_t i = 0; k < MaxPrefix && i < y->prefix_len; ++i) buf[k++] = y->prefix[i];
+				std::memcpy(y->prefix, buf, k);
+				y->prefix_len += x->prefix_len + 1;
+			}
+			ref = child;
+			delete x;
+		}
+	}
+
+	/* keys */
+
+	static bool equals(const Leaf* l, const std::string& key) {
+		return l->len == key.size() && std::memcmp(l->key(), key.data(), l->len) == 0;
+	}
+
+	static bool is_prefix_of(const Leaf* l, const std::string& query) {
+		return l->len <= query.size() && std::memcmp(l->key(), query.data(), l->len) == 0;
+	}
+
+	// any leaf below x, they all share the path down to x
+	static const Leaf* any_leaf(const Node* x) {
+		while (x->type != Type::LEAF) {
+			const Inner* in = static_cast<const Inner*>(x);
+			if (in->term != nullptr) return in->term;
+			for_each_child(in, [&x](uchar, const Node* child) { x = child; });
+		}
+		return static_cast<const Leaf*>(x);
+	}
+
+	// # of leading bytes of x's path that match key from depth d on,
+	// reading the bytes beyond MaxPrefix from a leaf
+	static size_t prefix_mismatch(const Inner* x, const std::string& key, size_t d) {
+		size_t stored = std::min<size_t>(x->prefix_len, MaxPrefix);
+		size_t i = 0;
+		for (; i < stored; ++i) {
+			if (d + i >= key.size() || x->prefix[i] != static_cast<uchar>(key[d + i])) return i;
+		}
+		if (x->prefix_len > MaxPrefix) {
+			const char* full = any_leaf(x)->key();
+			for (; i < x->prefix_len; ++i) {
+				if (d + i >= key.size() || full[d + i] != key[d + i]) return i;
+			}
+		}
+		return x->prefix_len;
+	}
+
+	// whether key has room for x's path from depth d on and matches its
+	// stored bytes, the rest is left to the final comparison with a leaf
+	static bool optimistic_match(const Inner* x, const std::string& key, size_t d) {
+		return d + x->prefix_len <= key.size() &&
+			std::memcmp(x->prefix, key.data() + d, std::min<size_t>(x->prefix_len, MaxPrefix)) == 0;
+	}
+
+	const Leaf* find(const std::string& key) const {
+		const Node* x = root;
+		size_t d = 0;
+		while (x != nullptr) {
+			if (x->type == Type::LEAF) {
+				const Leaf* l = static_cast<const Leaf*>(x);
+				return equals(l, key) ? l : nullptr;
+			}
+			const Inner* in = static_cast<const Inner*>(x);
+			if (!optimistic_match(in, key, d)) return nullptr;
+			d += in->prefix_len;
+			if (d == key.size()) return in->term && equals(in->term, key) ? in->term : nullptr;
+			Node* const* c = find_child(in, key[d++]);
+			x = c ? *c : nullptr;
+		}
+		return nullptr;
+	}
+
+	// return pointer to new inserted leaf or key leaf
+	Leaf* insert(const std::string& key, const T& val, bool assign) {
+		Node** ref = &root;
+		size_t d = 0;
+		for (;;) {
+			Node* x = *ref;
+			if (x == nullptr) {
+				Leaf* l = new_leaf(key, val);
+				*ref = l; ++n;
+				return l;
+			}
+			if (x->type == Type::LEAF) {
+				Leaf* l = static_cast<Leaf*>(x);
+				if (equals(l, key)) {
+					if (assign) l->val = val;
+					return l;
+				}
+				Leaf* nl = new_leaf(key, val);
+				try {
+					split_leaf(*ref, nl, d);
+				}
+				catch (...) {
+					delete_leaf(nl);
+					throw;
+				}
+				++n;
+				return nl;
+			}
+			Inner* in = static_cast<Inner*>(x);
+			size_t p = prefix_mismatch(in, key, d);
+			if (p < in->prefix_len || d + p == key.size()) {
+				if (p == in->prefix_len) { // key ends right after the path
+					if (in->term != nullptr) {
+						if (assign) in->term->val = val;
+						return in->term;
+					}
+					in->term = new_leaf(key, val); ++n;
+					return in->term;
+				}
+				Leaf* nl = new_leaf(key, val);
+				try {
+					split_prefix(*ref, p, d, nl);
+				}
+				catch (...) {
+					delete_leaf(nl);
+					throw;
+				}
+				++n;
+				return nl;
+			}
+			d += in->prefix_len;
+			Node** c = find_child(in, key[d]);
+			if (c == nullptr) {
+				Leaf* nl = new_leaf(key, val);
+				try {
+					add_child(*ref, key[d], nl);
+				}
+				catch (...) {
+					delete_leaf(nl);
+					throw;
+				}
+				++n;
+				return nl;
+			}
+			ref = c; ++d;
+		}
+	}
+
+	// replaces the leaf at ref (at depth d) with a node telling it from nl
+	static void split_leaf(Node*& ref, Leaf* nl, size_t d) {
+		Leaf* l = static_cast<Leaf*>(ref);
+		size_t i = d;
+		while (i < l->len && i < nl->len && l->key()[i] == nl->key()[i]) ++i;
+		Node4* y = new Node4();
+		y->prefix_len = static_cast<uint32_t>(i - d);
+		std::memcpy(y->prefix, l->key() + d, std::min<size_t>(i - d, MaxPrefix));
+		Node* yref = y;
+		for (Leaf* z : { l, nl }) {
+			if (z->len == i) y->term = z;
+			else add_child(yref, z->key()[i], z);
+		}
+		ref = y;
+	}
+
+	// the path of the node at ref (at depth d) differs from nl's key at
+	// its p-th byte: put a node branching there above it
+	static void split_prefix(Node*& ref, size_t p, size_t d, Leaf* nl) {
+		Inner* x = static_cast<Inner*>(ref);
+		Node4* y = new Node4();
+		y->prefix_len = static_cast<uint32_t>(p);
+		std::memcpy(y->prefix, x->prefix, std::min<size_t>(p, MaxPrefix));
+		// x keeps what follows the byte at p
+		const char* full = x->prefix_len > MaxPrefix ? any_leaf(x)->key() + d : nullptr;
+		auto byte = [&](size_t i) { return i < MaxPrefix ? x->prefix[i] : static_cast<uchar>(full[i]); };
+		uchar c = byte(p);
+		uchar buf[MaxPrefix];
+		size_t rest = x->prefix_len - p - 1;
+		for (size_t i = 0; i < std::min<size_t>(rest, MaxPrefix); ++i) buf[i] = byte(p + 1 + i);
+		std::memcpy(x->prefix, buf, std::min<size_t>(rest, MaxPrefix));
+		x->prefix_len = static_cast<uint32_t>(rest);
+		Node* yref = y;
+		add_child(yref, static_cast<char>(c), x);
+		if (nl->len == d + p) y->term = nl;
+		else add_child(yref, nl->key()[d + p], nl);
+		ref = y;
+	}
+
+	// return true if key was found and removed
+	bool erase(Node*& ref, const std::string& key, size_t d) {
+		Node* x = ref;
+		if (x == nullptr) return false;
+		if (x->type == Type::LEAF) {
+			if (!equals(static_cast<Leaf*>(x), key)) return false;
+			delete_leaf(static_cast<Leaf*>(x));
+			ref = nullptr; --n;
+			return true;
+		}
+		Inner* in = static_cast<Inner*>(x);
+		if (!optimistic_match(in, key, d)) return false;
+		d += in->prefix_len;
+		if (d == key.size()) {
+			if (in->term == nullptr || !equals(in->term, key)) return false;
+			delete_leaf(in->term);
+			in->term = nullptr; --n;
+		}
+		else {
+			Node** c = find_child(in, key[d]);
+			if (c == nullptr || !erase(*c, key, d + 1)) return false;
+			if (*c == nullptr) remove_child(ref, key[d]);
+		}
+		compact(ref);
+		return true;
+	}
+
+	void clear(Node* x) {
+		if (x == nullptr) return;
+		if (x->type == Type::LEAF) {
+			delete_leaf(static_cast<Leaf*>(x));
+			return;
+		}
+		Inner* in = static_cast<Inner*>(x);
+		if (in->term) delete_leaf(in->term);
+		for_each_child(in, [this](uchar, Node* child) { clear(child); });
+		delete_inner(in);
+	}
+
+	size_t memory_usage(const Node* x) const {
+		if (x == nullptr) return 0;
+		if (x->type == Type::LEAF) return sizeof(Leaf) + static_cast<const Leaf*>(x)->len;
+		const Inner* in = static_cast<const Inner*>(x);
+		size_t bytes = in->type == Type::NODE4 ? sizeof(Node4) : in->type == Type::NODE16 ? sizeof(Node16) :
+		               in->type == Type::NODE48 ? sizeof(Node48) : sizeof(Node256);
+		bytes += memory_usage(in->term);
+		for_each_child(in, [&](uchar, const Node* child) { bytes += memory_usage(child); });
+		return bytes;
+	}
+
+	// leaves hold whole keys, so collecting them builds no intermediate strings
+	static void collect(const Node* x, std::vector<std::string>& vs) {
+		if (x == nullptr) return;
+		if (x->type == Type::LEAF) {
+			const Leaf* l = static_cast<const Leaf*>(x);
+			vs.emplace_back(l->key(), l->len);
+			return;
+		}
+		const Inner* in = static_cast<const Inner*>(x);
+		collect(in->term, vs);
+		for_each_child(in, [&vs](uchar, const Node* child) { collect(child, vs); });
+	}
+
+	static bool matches(const Leaf* l, const std::string& pattern) {
+		if (l->len != pattern.size()) return false;
+		for (size_t i = 0; i < l->len; ++i) {
+			if (pattern[i] != '?' && pattern[i] != l->key()[i]) return false;
+		}
+		return true;
+	}
+
+	static void collect(const Node* x, const std::string& pattern, size_t d, std::vector<std::string>& vs) {
+		// e.g. collect  file?.h  in {file1.h, file2.h, file3.cc}
+		if (x == nullptr) return;
+		if (x->type == Type::LEAF) {
+			const Leaf* l = static_cast<const Leaf*>(x);
+			if (matches(l, pattern)) vs.emplace_back(l->key(), l->len);
+			return;
+		}
+		const Inner* in = static_cast<const Inner*>(x);
+		if (d + in->prefix_len > pattern.size()) return;
+		for (size_t i = 0; i < std::min<size_t>(in->prefix_len, MaxPrefix); ++i) {
+			if (pattern[d + i] != '?' && static_cast<uchar>(pattern[d + i]) != in->prefix[i]) return;
+		}
+		d += in->prefix_len;
+		if (d == pattern.size()) {
+			if (in->term && matches(in->term, pattern)) vs.emplace_back(in->term->key(), in->term->len);
+			return;
+		}
+		if (pattern[d] == '?') { // wildcard that matches any single character
+			for_each_child(in, [&](uchar, const Node* child) { collect(child, pattern, d + 1, vs); });
+		}
+		else if (Node* const* c = find_child(in, pattern[d])) {
+			collect(*c, pattern, d + 1, vs);
+		}
+	}
+};
+
+} // mySymbolTable
+
+#endif // !ART_H
@@ -0,0 +1,181 @@
+#include "ART.h"
+#include "Trie.h"
+#include "../../Searching/TreeMap/HybridTST.h" // also brings in the TST with iterators
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+#if defined(__GLIBC__)
+#include <malloc.h> // mallinfo2
+#endif
+
+// heap bytes in use, allocator overhead included
+size_t heap_bytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return mallinfo2().uordblks;
+#else
+	return 0; // n/a
+#endif
+}
+
+// synthetic crawl: a few thousand hosts, paths drawn from a skewed vocabulary
+std::vector<std::string> make_urls(size_t n)
+{
+	std::mt19937 gen(2021);
+	auto word = [&gen](size_t min_len, size_t max_len) {
+		std::uniform_int_distribution<size_t> len(min_len, max_len);
+		std::uniform_int_distribution<int> ch('a', 'z');
+		std::string s(len(gen), ' ');
+		for (auto& c : s) c = static_cast<char>(ch(gen));
+		return s;
+	};
+	std::vector<std::string> hosts(4000), vocab(20000);
+	const char* tlds[] = { ".com", ".org", ".net", ".io", ".de" };
+	for (auto& h : hosts) h = "https://www." + word(4, 12) + tlds[gen() % 5];
+	for (auto& w : vocab) w = word(3, 10);
+	std::geometric_distribution<int> depth(0.4);
+	std::uniform_real_distribution<double> u(0, 1);
+	std::vector<std::string> urls(n);
+	for (auto& url : urls) {
+		url = hosts[static_cast<size_t>(hosts.size() * u(gen) * u(gen))]; // popular hosts have more pages
+		for (int d = 1 + depth(gen); d > 0; --d) url += "/" + vocab[static_cast<size_t>(vocab.size() * u(gen) * u(gen))];
+		if (gen() % 3 == 0) url += "?id=" + std::to_string(gen() % 1000000);
+	}
+	std::sort(urls.begin(), urls.end());
+	urls.erase(std::unique(urls.begin(), urls.end()), urls.end());
+	std::shuffle(urls.begin(), urls.end(), gen);
+	return urls;
+}
+
+// bytes/key and lookups/s (half of them misses) of a symbol table built from keys
+template<typename ST, typename Put, typename Get>
+void report(const char* name, const std::vector<std::string>& keys, const std::vector<std::string>& queries,
+			Put put, Get get)
+{
+	size_t before = heap_bytes();
+	auto t0 = std::chrono::steady_clock::now();
+	auto st = std::make_unique<ST>();
+	for (size_t i = 0; i < keys.size(); ++i) put(*st, keys[i], static_cast<int>(i));
+	auto t1 = std::chrono::steady_clock::now();
+	size_t bytes = heap_bytes() - before;
+	size_t hits = 0;
+	for (const auto& q : queries) hits += get(*st, q);
+	auto t2 = std::chrono::steady_clock::now();
+	double build_s = std::chrono::duration<double>(t1 - t0).count();
+	double find_s = std::chrono::duration<double>(t2 - t1).count();
+	printf("  %-10s %10.1f bytes/key %8.2f M lookups/s  (built in %.2f s, %zu hits)\n",
+		   name, double(bytes) / keys.size(), queries.size() / find_s / 1e6, build_s, hits);
+}
+
+void benchmark(const std::string& title, const std::vector<std::string>& keys, bool with_trie)
+{
+	using namespace mySymbolTable;
+	std::vector<std::string> queries(keys);
+	for (size_t i = 0; i < queries.size(); i += 2) queries[i] += "#"; // misses
+	std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+
+	size_t chars = 0;
+	for (const auto& k : keys) chars += k.size();
+	printf("%s: %zu keys, %.1f bytes/key on average\n", title.c_str(), keys.size(), double(chars) / keys.size());
+	report<ART<int>>("ART", keys, queries,
+		[](ART<int>& st, const std::string& k, int v) { st.insert_or_assign(k, v); },
+		[](const ART<int>& st, const std::string& k) { return st.get(k) != nullptr; });
+	if (with_trie) {
+		report<Trie<int>>("Trie", keys, queries,
+			[](Trie<int>& st, const std::string& k, int v) { st.insert_or_assign(k, v); },
+			[](const Trie<int>& st, const std::string& k) { return st.contains(k); });
+	}
+	else {
+		printf("  %-10s %10s (2 KiB per node, won't fit)\n", "Trie", "-");
+	}
+	report<TST<int>>("TST", keys, queries,
+		[](TST<int>& st, const std::string& k, int v) { st[k] = v; },
+		[](const TST<int>& st, const std::string& k) { return st.contains(k); });
+	report<RWayTST<int>>("HybridTST", keys, queries,
+		[](RWayTST<int>& st, const std::string& k, int v) { st[k] = v; },
+		[](RWayTST<int>& st, const std::string& k) { return st.get(k) != nullptr; });
+}
+
+// run: ./ART_test shellsST.txt [N_URLS=1000000 | urls.txt]
+int main(int argc, char* argv[])
+{
+	using namespace std;
+	using namespace mySymbolTable;
+	std::ios_base::sync_with_stdio(false);
+
+	if (argc < 2) { cerr << "lack of filename" << endl; return 1; }
+	string filename{ argv[1] };
+	ifstream ifs{ filename };
+	if (!ifs.is_open()) { cerr << "Error opening file " << filename << endl; return 2; }
+	try {
+		ART<int> art;
+		vector<string> words;
+		int i = 0;
+		for (string word; ifs >> word; ) {
+			art[word] = i++; // art.insert_or_assign(word, i++);
+			words.push_back(word);
+		}
+
+		for (const auto& word : art.keys()) {
+			cout << word << " : " << art.at(word) << '\n';
+		}
+
+		cout << "\nlongest prefix of \"shellsort\": ";
+		cout << art.longest_prefix_of("shellsort") << '\n';
+		cout << "longest prefix of \"quicksort\": ";
+		cout << art.longest_prefix_of("quicksort") << '\n';
+
+		cout << "\nkeys with prefix \"sh\": ";
+		for (const auto& word : art.keys_with_prefix("sh")) {
+			cout << word << "  ";
+		}
+
+		cout << "\n\nkeys that match \"?he?l?\": ";
+		for (const auto& word : art.keys_that_match("?he?l?")) {
+			cout << word << "  ";
+		}
+
+		cout << "\n\nAfter removing \"shells\": ";
+		art.erase("shells");
+		cout << '\n';
+		for (const auto& word : art.keys()) {
+			cout << word << " : " << art.at(word) << '\n';
+		}
+		cout << '\n';
+
+		sort(words.begin(), words.end());
+		words.erase(unique(words.begin(), words.end()), words.end());
+		benchmark(filename, words, true);
+
+		vector<string> urls;
+		string corpus = argc > 2 ? argv[2] : "1000000";
+		if (all_of(corpus.begin(), corpus.end(), ::isdigit)) {
+			urls = make_urls(stoul(corpus));
+			corpus = "synthetic URLs";
+		}
+		else {
+			ifstream in{ corpus };
+			if (!in.is_open()) { cerr << "Error opening file " << corpus << endl; return 2; }
+			for (string url; getline(in, url); ) if (!url.empty()) urls.push_back(url);
+			sort(urls.begin(), urls.end());
+			urls.erase(unique(urls.begin(), urls.end()), urls.end());
+			shuffle(urls.begin(), urls.end(), mt19937(2021));
+		}
+		benchmark(corpus + " (first 5000)", vector<string>(urls.begin(), urls.begin() + min<size_t>(5000, urls.size())), true);
+		benchmark(corpus, urls, false);
+	}
+	catch (const exception& e) {
+		cout << e.what() << endl;
+	}
+	catch (...) {
+		cout << "Some unknown error happened" << endl;
+	}
+
+	return 0;
+}
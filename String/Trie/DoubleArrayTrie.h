@@ -0,0 +1,400 @@
+/*
+ *  static symbol table with key specialized as string:
+ *  double-array trie with tail compression (Aoe, 1989)
+ *  see the following link for the latest version
+ *  https://github.com/How-u-doing/DataStructures/tree/master/String/Trie/DoubleArrayTrie.h
+ *
+ *  usage:
+ *      mySymbolTable::TST<int> tst = ...; // or Trie<int>, ART<int>
+ *      auto dat = mySymbolTable::DoubleArrayTrie<int>::build(tst);
+ *      dat.save("dict.dat");
+ *      auto mapped = mySymbolTable::DoubleArrayTrie<int>::load("dict.dat"); // mmap'ed
+ *      const int* v = mapped.find("shells");
+ */
+
+#ifndef DOUBLEARRAYTRIE_H
+#define DOUBLEARRAYTRIE_H 1
+
+#include <string>
+#include <vector>
+#include <utility>     // std::pair, std::move
+#include <algorithm>   // std::stable_sort, std::is_sorted, std::unique
+#include <cstdint>
+#include <cstring>     // std::memcmp, std::memcpy
+#include <cstdio>      // std::FILE
+#include <type_traits> // std::is_trivially_copyable
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>     // open
+#include <unistd.h>    // close
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#define DOUBLEARRAYTRIE_MMAP 1
+#endif
+
+namespace mySymbolTable {
+
+// A read-only trie in two integer arrays: the child of state s on byte c is
+// t = base[s] + c + 1, valid iff check[t] == s, so a lookup costs a couple
+// of array accesses per byte whatever the fan-out. Code 0 is the end-of-key
+// transition. Once a single key is left below a state, the rest of it is
+// stored as a string in the tail instead of as a chain of states (tail
+// compression), and the state becomes a leaf: base < 0 refers to an entry
+// with the tail and the value. Values are copied bytewise into the arrays,
+// which is what lets save() write them out and load() map them back as is.
+template<typename T>
+class DoubleArrayTrie {
+	static_assert(std::is_trivially_copyable<T>::value, "values are saved and mmap'ed as raw bytes");
+	typedef unsigned char uchar;
+
+	struct Unit {
+		int32_t base;  // offset of the children, -(entry + 1) for a leaf
+		int32_t check; // parent state, -1 if the unit is free (-2 for the root)
+	};
+
+	struct Entry {
+		uint32_t tail;     // offset of the rest of the key in _tail
+		uint32_t tail_len;
+		T val;
+	};
+	static_assert(alignof(Entry) <= 8, "sections of a saved trie are 8-byte aligned");
+
+	struct FileHeader {
+		char magic[8];
+		uint64_t units, entries, tail_bytes, value_size;
+	};
+
+	// contents when built, _units etc. point either here or into the mapped file
+	std::vector<Unit> _unit_vec;
+	std::vector<Entry> _entry_vec;
+	std::vector<char> _tail_vec;
+
+	const Unit* _units = nullptr;
+	size_t _nunits = 0;
+	const Entry* _entries = nullptr;
+	size_t _nentries = 0;
+	const char* _tail = nullptr;
+	void* _map = nullptr;
+	size_t _map_len = 0;
+
+	// building only
+	size_t _first_free = 1;
+	const std::vector<std::pair<std::string, T>>* _kvs = nullptr;
+
+public:
+	DoubleArrayTrie() { reset_views(); }
+
+	// sorted or not, for equal keys only the first one is kept
+	explicit DoubleArrayTrie(std::vector<std::pair<std::string, T>> kvs) {
+		auto less = [](const auto& a, const auto& b) { return a.first < b.first; };
+		if (!std::is_sorted(kvs.begin(), kvs.end(), less))
+			std::stable_sort(kvs.begin(), kvs.end(), less);
+		kvs.erase(std::unique(kvs.begin(), kvs.end(),
+			[](const auto& a, const auto& b) { return a.first == b.first; }), kvs.end());
+		for (const auto& kv : kvs) {
+			if (kv.first == "") throw std::invalid_argument("key to DoubleArrayTrie cannot be null");
+		}
+		_kvs = &kvs;
+		_unit_vec.assign(256, Unit{ 0, -1 });
+		_unit_vec[0].check = -2; // root, taken but no one's child
+		_entry_vec.reserve(kvs.size());
+		if (!kvs.empty()) build(0, 0, kvs.size(), 0);
+		_kvs = nullptr;
+		size_t last = _unit_vec.size();
+		while (last > 1 && _unit_vec[last - 1].check < 0) --last;
+		_unit_vec.resize(last);
+		_unit_vec.shrink_to_fit();
+		reset_views();
+	}
+
+	// compiles any string symbol table with keys() and at(), e.g. Trie, TST or ART
+	template<typename SymbolTable>
+	static DoubleArrayTrie build(const SymbolTable& st) {
+		std::vector<std::pair<std::string, T>> kvs;
+		for (auto& key : st.keys()) {
+			const T& val = st.at(key);
+			kvs.emplace_back(std::move(key), val);
+		}
+		return DoubleArrayTrie(std::move(kvs));
+	}
+
+	DoubleArrayTrie(const DoubleArrayTrie&) = delete;
+	DoubleArrayTrie& operator=(const DoubleArrayTrie&) = delete;
+
+	DoubleArrayTrie(DoubleArrayTrie&& rhs) noexcept { *this = std::move(rhs); }
+
+	DoubleArrayTrie& operator=(DoubleArrayTrie&& rhs) noexcept {
+		if (this == &rhs) return *this;
+		unmap();
+		// moving a vector keeps its buffer, so the views stay valid
+		_unit_vec = std::move(rhs._unit_vec);
+		_entry_vec = std::move(rhs._entry_vec);
+		_tail_vec = std::move(rhs._tail_vec);
+		_units = rhs._units; _nunits = rhs._nunits;
+		_entries = rhs._entries; _nentries = rhs._nentries;
+		_tail = rhs._tail;
+		_map = rhs._map; _map_len = rhs._map_len;
+		rhs._map = nullptr;
+		rhs.reset_views();
+		return *this;
+	}
+
+	~DoubleArrayTrie() { unmap(); }
+
+	size_t size() const noexcept { return _nentries; }
+
+	bool empty() const noexcept { return _nentries == 0; }
+
+	// nullptr if key does not exist
+	const T* find(const std::string& key) const {
+		size_t s = 0;
+		for (size_t d = 0; ; ++d) {
+			int32_t base = _units[s].base;
+			if (base < 0) {
+				const Entry& e = _entries[-base - 1];
+				return tail_equals(e, key, d) ? &e.val : nullptr;
+			}
+			size_t t = static_cast<size_t>(base) + (d == key.size() ? 0 : static_cast<uchar>(key[d]) + 1);
+			if (t >= _nunits || _units[t].check != static_cast<int32_t>(s)) return nullptr;
+			if (d == key.size()) return &_entries[-_units[t].base - 1].val;
+			s = t;
+		}
+	}
+
+	bool contains(const std::string& key) const { return find(key) != nullptr; }
+
+	const T& at(const std::string& key) const {
+		const T* p = find(key);
+		if (p == nullptr) throw std::out_of_range("invalid key to at()");
+		return *p;
+	}
+
+	// calls f(len, val) for every key that is a prefix of query, shortest first
+	template<typename F>
+	void for_each_prefix_of(const std::string& query, F f) const {
+		size_t s = 0;
+		for (size_t d = 0; ; ++d) {
+			int32_t base = _units[s].base;
+			if (base < 0) {
+				const Entry& e = _entries[-base - 1];
+				if (d + e.tail_len <= query.size() && std::memcmp(_tail + e.tail, query.data() + d, e.tail_len) == 0)
+					f(d + e.tail_len, e.val);
+				return;
+			}
+			size_t end = static_cast<size_t>(base); // end-of-key child, if a key ends here
+			if (end < _nunits && _units[end].check == static_cast<int32_t>(s))
+				f(d, _entries[-_units[end].base - 1].val);
+			if (d == query.size()) return;
+			size_t t = static_cast<size_t>(base) + static_cast<uchar>(query[d]) + 1;
+			if (t >= _nunits || _units[t].check != static_cast<int32_t>(s)) return;
+			s = t;
+		}
+	}
+
+	// (length, value) of every key that is a prefix of query, shortest first
+	std::vector<std::pair<size_t, T>> common_prefix_search(const std::string& query) const {
+		std::vector<std::pair<size_t, T>> res;
+		for_each_prefix_of(query, [&res](size_t len, const T& val) { res.emplace_back(len, val); });
+		return res;
+	}
+
+	// (length, value) of the longest key that is a prefix of query, (0, nullptr) if none
+	std::pair<size_t, const T*> longest_prefix_match(const std::string& query) const {
+		std::pair<size_t, const T*> res{ 0, nullptr };
+		for_each_prefix_of(query, [&res](size_t len, const T& val) { res = { len, &val }; });
+		return res;
+	}
+
+	std::string longest_prefix_of(const std::string& query) const {
+		return query.substr(0, longest_prefix_match(query).first);
+	}
+
+	// bytes of the arrays
+	size_t memory_usage() const noexcept {
+		return _nunits * sizeof(Unit) + _nentries * sizeof(Entry) + tail_bytes();
+	}
+
+	void save(const std::string& path) const {
+		std::FILE* fp = std::fopen(path.c_str(), "wb");
+		if (fp == nullptr) throw std::runtime_error("cannot open " + path + " for writing");
+		FileHeader h = { { 'D', 'A', 'T', 'R', 'I', 'E', '0', '1' }, _nunits, _nentries, tail_bytes(), sizeof(T) };
+		const char zeros[8] = {};
+		bool ok = std::fwrite(&h, sizeof(h), 1, fp) == 1;
+		auto write = [&](const void* p, size_t bytes) {
+			ok = ok && (bytes == 0 || std::fwrite(p, 1, bytes, fp) == bytes)
+			        && std::fwrite(zeros, 1, pad(bytes), fp) == pad(bytes);
+		};
+		write(_units, _nunits * sizeof(Unit));
+		write(_entries, _nentries * sizeof(Entry));
+		write(_tail, tail_bytes());
+		ok = std::fclose(fp) == 0 && ok;
+		if (!ok) throw std::runtime_error("error writing " + path);
+	}
+
+	// maps a file written by save() read-only (reads it in where there is no mmap)
+	static DoubleArrayTrie load(const std::string& path) {
+		DoubleArrayTrie dat;
+		const char* p;
+		size_t len;
+#ifdef DOUBLEARRAYTRIE_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) throw std::runtime_error("cannot open " + path);
+		struct stat st;
+		void* map = MAP_FAILED;
+		if (::fstat(fd, &st) == 0 && st.st_size > 0)
+			map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (map == MAP_FAILED) throw std::runtime_error("cannot map " + path);
+		dat._map = map;
+		dat._map_len = len = st.st_size;
+		p = static_cast<const char*>(map);
+#else
+		std::FILE* fp = std::fopen(path.c_str(), "rb");
+		if (fp == nullptr) throw std::runtime_error("cannot open " + path);
+		std::vector<char> buf;
+		char chunk[1 << 16];
+		for (size_t k; (k = std::fread(chunk, 1, sizeof(chunk), fp)) > 0; ) buf.insert(buf.end(), chunk, chunk + k);
+		std::fclose(fp);
+		// keep the data 8-byte aligned, in the Unit vector
+		dat._unit_vec.resize((buf.size() + sizeof(Unit) - 1) / sizeof(Unit));
+		std::memcpy(dat._unit_vec.data(), buf.data(), buf.size());
+		p = reinterpret_cast<const char*>(dat._unit_vec.data());
+		len = buf.size();
+#endif
+		FileHeader h;
+		if (len < sizeof(h)) throw std::runtime_error(path + " is not a DoubleArrayTrie file");
+		std::memcpy(&h, p, sizeof(h));
+		size_t need = sizeof(h) + h.units * sizeof(Unit) + pad(h.units * sizeof(Unit))
+		            + h.entries * sizeof(Entry) + pad(h.entries * sizeof(Entry)) + h.tail_bytes;
+		if (std::memcmp(h.magic, "DATRIE01", 8) != 0 || h.value_size != sizeof(T) || h.units == 0 || len < need)
+			throw std::runtime_error(path + " is not a DoubleArrayTrie<T> file");
+		p += sizeof(h);
+		dat._units = reinterpret_cast<const Unit*>(p);
+		dat._nunits = h.units;
+		p += h.units * sizeof(Unit) + pad(h.units * sizeof(Unit));
+		dat._entries = reinterpret_cast<const Entry*>(p);
+		dat._nentries = h.entries;
+		p += h.entries * sizeof(Entry) + pad(h.entries * sizeof(Entry));
+		dat._tail = p;
+		return dat;
+	}
+
+private:
+	static size_t pad(size_t bytes) noexcept { return (8 - bytes % 8) % 8; }
+
+	size_t tail_bytes() const noexcept {
+		return _nentries == 0 ? 0 : _entries[_nentries - 1].tail + _entries[_nentries - 1].tail_len;
+	}
+
+	void reset_views() noexcept {
+		_units = _unit_vec.data();
+		_nunits = _unit_vec.size();
+		_entries = _entry_vec.data();
+		_nentries = _entry_vec.size();
+		static const char no_tail = '\0';
+		_tail = _tail_vec.empty() ? &no_tail : _tail_vec.data(); // never null for memcmp
+		_map_len = 0;
+		if (_nunits == 0) { // empty trie: a root without children
+			static const Unit root = { 0, -2 };
+			_units = &root;
+			_nunits = 1;
+		}
+	}
+
+	void unmap() noexcept {
+#ifdef DOUBLEARRAYTRIE_MMAP
+		if (_map) ::munmap(_map, _map_len);
+#endif
+		_map = nullptr;
+	}
+
+	bool tail_equals(const Entry& e, const std::string& key, size_t d) const {
+		return key.size() - d == e.tail_len && std::memcmp(_tail + e.tail, key.data() + d, e.tail_len) == 0;
+	}
+
+	// state s becomes a leaf for the i-th key, whose first d bytes lead to s
+	void make_leaf(size_t s, size_t i, size_t d) {
+		const auto& kv = (*_kvs)[i];
+		size_t len = kv.first.size() - d;
+		_entry_vec.push_back({ static_cast<uint32_t>(_tail_vec.size()), static_cast<uint32_t>(len), kv.second });
+		_tail_vec.insert(_tail_vec.end(), kv.first.begin() + d, kv.first.end());
+		if (_tail_vec.size() > UINT32_MAX) throw std::length_error("DoubleArrayTrie tail too long");
+		_unit_vec[s].base = -static_cast<int32_t>(_entry_vec.size());
+	}
+
+	// the sorted keys [lo, hi) share their first d bytes, which lead to state s
+	void build(size_t s, size_t lo, size_t hi, size_t d) {
+		const auto& kvs = *_kvs;
+		if (hi - lo == 1) {
+			make_leaf(s, lo, d);
+			return;
+		}
+		// (code, first key) of each child, the key ending here (if any) sorts first
+		std::vector<std::pair<size_t, size_t>> children;
+		for (size_t i = lo; i < hi; ) {
+			if (kvs[i].first.size() == d) {
+				children.emplace_back(0, i++);
+				continue;
+			}
+			size_t c = static_cast<uchar>(kvs[i].first[d]) + 1;
+			children.emplace_back(c, i);
+			while (i < hi && static_cast<size_t>(static_cast<uchar>(kvs[i].first[d])) + 1 == c) ++i;
+		}
+		size_t base = find_base(children);
+		_unit_vec[s].base = static_cast<int32_t>(base);
+		for (const auto& ch : children) {
+			_unit_vec[base + ch.first].check = static_cast<int32_t>(s);
+		}
+		for (size_t k = 0; k < children.size(); ++k) {
+			size_t first = children[k].second;
+			size_t last = k + 1 < children.size() ? children[k + 1].second : hi;
+			size_t t = base + children[k].first;
+			if (children[k].first == 0) make_leaf(t, first, d);
+			else build(t, first, last, d + 1);
+		}
+	}
+
+	// the first base (> 0) where all the codes land on free units, scanning
+	// from the first free unit on, which moves on once the units before the
+	// current position are nearly all taken
+	size_t find_base(const std::vector<std::pair<size_t, size_t>>& children) {
+		size_t lo_code = children.front().first, hi_code = children.back().first;
+		size_t p = std::max(_first_free, lo_code + 1), taken = 0;
+		bool first = true;
+		for (;; ++p) {
+			if (p >= _unit_vec.size()) grow(p + 1);
+			if (_unit_vec[p].check >= 0) {
+				++taken;
+				continue;
+			}
+			if (first) {
+				_first_free = p;
+				first = false;
+			}
+			size_t base = p - lo_code;
+			if (base + hi_code >= _unit_vec.size()) grow(base + hi_code + 1);
+			bool fits = true;
+			for (const auto& ch : children) {
+				if (_unit_vec[base + ch.first].check >= 0) {
+					fits = false;
+					break;
+				}
+			}
+			if (fits) {
+				if (taken * 20 >= (p - _first_free + 1) * 19) _first_free = p + 1;
+				if (base + hi_code > INT32_MAX) throw std::length_error("DoubleArrayTrie too large");
+				return base;
+			}
+		}
+	}
+
+	void grow(size_t n) {
+		size_t cap = _unit_vec.size();
+		while (cap < n) cap *= 2;
+		_unit_vec.resize(cap, Unit{ 0, -1 });
+	}
+};
+
+} // mySymbolTable
+
+#endif // !DOUBLEARRAYTRIE_H
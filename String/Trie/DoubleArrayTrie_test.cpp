@@ -0,0 +1,185 @@
+#include "DoubleArrayTrie.h"
+#include "TST.h"
+#include "Trie.h"
+#include "ART.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+#if defined(__GLIBC__)
+#include <malloc.h> // mallinfo2
+#endif
+
+using clk = std::chrono::steady_clock;
+
+// heap bytes in use, allocator overhead included
+size_t heap_bytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return mallinfo2().uordblks;
+#else
+	return 0; // n/a
+#endif
+}
+
+double seconds_since(clk::time_point t0)
+{
+	return std::chrono::duration<double>(clk::now() - t0).count();
+}
+
+// tokenizer-like vocabulary: words made of a few common syllables
+std::vector<std::string> make_words(size_t n)
+{
+	std::mt19937 gen(2021);
+	const char* syllables[] = { "a", "an", "ar", "be", "ca", "co", "de", "di", "en", "er", "es", "in", "ing",
+		"io", "is", "la", "le", "ma", "me", "na", "ne", "ni", "on", "or", "ra", "re", "ri", "ro", "sa", "se",
+		"st", "ta", "te", "ti", "to", "tion", "un", "ur", "ve", "y" };
+	std::uniform_int_distribution<int> len(1, 6), syl(0, sizeof(syllables) / sizeof(*syllables) - 1);
+	std::vector<std::string> words;
+	while (words.size() < n) {
+		std::string w;
+		for (int k = len(gen); k > 0; --k) w += syllables[syl(gen)];
+		words.push_back(w);
+		if (words.size() == n) {
+			std::sort(words.begin(), words.end());
+			words.erase(std::unique(words.begin(), words.end()), words.end());
+		}
+	}
+	std::shuffle(words.begin(), words.end(), gen);
+	return words;
+}
+
+// ns per exact lookup and per greedy longest-match tokenization step over text
+template<typename Find, typename Longest>
+void report(const char* name, size_t bytes, size_t keys, double build_s,
+			const std::vector<std::string>& queries, const std::string& text, Find find, Longest longest)
+{
+	size_t hits = 0;
+	auto t0 = clk::now();
+	for (const auto& q : queries) hits += find(q);
+	double find_ns = seconds_since(t0) * 1e9 / queries.size();
+	t0 = clk::now();
+	size_t tokens = 0;
+	for (size_t pos = 0; pos < text.size(); ++tokens) {
+		size_t len = longest(text.substr(pos, 32));
+		pos += len ? len : 1;
+	}
+	double token_ns = seconds_since(t0) * 1e9 / tokens;
+	printf("  %-18s %8.1f bytes/key  build %6.2f s  %7.1f ns/find  %7.1f ns/token  (%zu hits, %zu tokens)\n",
+		   name, double(bytes) / keys, build_s, find_ns, token_ns, hits, tokens);
+}
+
+// run: ./DoubleArrayTrie_test shellsST.txt [N=500000]
+int main(int argc, char* argv[])
+{
+	using namespace std;
+	using namespace mySymbolTable;
+	std::ios_base::sync_with_stdio(false);
+
+	if (argc < 2) { cerr << "lack of filename" << endl; return 1; }
+	string filename{ argv[1] };
+	ifstream ifs{ filename };
+	if (!ifs.is_open()) { cerr << "Error opening file " << filename << endl; return 2; }
+	try {
+		TST<int> tst;
+		int i = 0;
+		for (string word; ifs >> word; ) {
+			tst[word] = i++;
+		}
+		auto dat = DoubleArrayTrie<int>::build(tst);
+		for (const auto& word : tst.keys()) {
+			cout << word << " : " << dat.at(word) << '\n';
+		}
+		cout << "\nlongest prefix of \"shellsort\": " << dat.longest_prefix_of("shellsort") << '\n';
+		cout << "keys that are prefixes of \"shellsort\": ";
+		for (const auto& m : dat.common_prefix_search("shellsort")) {
+			cout << string("shellsort").substr(0, m.first) << " (" << m.second << ")  ";
+		}
+		dat.save("shellsST.dat");
+		auto mapped = DoubleArrayTrie<int>::load("shellsST.dat");
+		cout << "\nmapped from shellsST.dat: " << mapped.size() << " keys, \"sea\" : " << mapped.at("sea")
+			 << ", contains \"sh\": " << boolalpha << mapped.contains("sh") << "\n\n";
+		remove("shellsST.dat");
+
+		size_t n = argc > 2 ? stoul(argv[2]) : 500'000;
+		vector<string> words = make_words(n);
+		vector<string> queries(words);
+		for (size_t k = 0; k < queries.size(); k += 2) queries[k] += "q"; // misses
+		shuffle(queries.begin(), queries.end(), mt19937(42));
+		string text;
+		mt19937 gen(7);
+		while (text.size() < 4'000'000) text += words[gen() % words.size()];
+		size_t chars = 0;
+		for (const auto& w : words) chars += w.size();
+		printf("%zu words, %.1f bytes/word on average\n", words.size(), double(chars) / words.size());
+
+		// the source structures
+		size_t before = heap_bytes();
+		auto t0 = clk::now();
+		auto big_tst = make_unique<TST<int>>();
+		for (size_t k = 0; k < words.size(); ++k) (*big_tst)[words[k]] = static_cast<int>(k);
+		double tst_s = seconds_since(t0);
+		report("TST", heap_bytes() - before, words.size(), tst_s, queries, text,
+			[&](const string& q) { return big_tst->contains(q); },
+			[&](const string& q) { return big_tst->longest_prefix_of(q).size(); });
+
+		before = heap_bytes();
+		t0 = clk::now();
+		auto art = make_unique<ART<int>>();
+		for (size_t k = 0; k < words.size(); ++k) (*art)[words[k]] = static_cast<int>(k);
+		double art_s = seconds_since(t0);
+		report("ART", heap_bytes() - before, words.size(), art_s, queries, text,
+			[&](const string& q) { return art->contains(q); },
+			[&](const string& q) { return art->longest_prefix_of(q).size(); });
+		art.reset();
+
+		// Trie takes 2 KiB per node, only a slice of the words
+		size_t m = min<size_t>(words.size(), 20'000);
+		before = heap_bytes();
+		t0 = clk::now();
+		auto trie = make_unique<Trie<int>>();
+		for (size_t k = 0; k < m; ++k) (*trie)[words[k]] = static_cast<int>(k);
+		double trie_s = seconds_since(t0);
+		report("Trie (20000 keys)", heap_bytes() - before, m, trie_s, queries, text,
+			[&](const string& q) { return trie->contains(q); },
+			[&](const string& q) { return trie->longest_prefix_of(q).size(); });
+		trie.reset();
+
+		// compiled from the TST
+		t0 = clk::now();
+		auto big_dat = DoubleArrayTrie<int>::build(*big_tst);
+		double dat_s = seconds_since(t0);
+		report("DoubleArrayTrie", big_dat.memory_usage(), words.size(), dat_s, queries, text,
+			[&](const string& q) { return big_dat.contains(q); },
+			[&](const string& q) { return big_dat.longest_prefix_match(q).first; });
+
+		big_dat.save("words.dat");
+		t0 = clk::now();
+		auto big_mapped = DoubleArrayTrie<int>::load("words.dat");
+		double map_s = seconds_since(t0);
+		report("  (mmap'ed)", big_mapped.memory_usage(), words.size(), map_s, queries, text,
+			[&](const string& q) { return big_mapped.contains(q); },
+			[&](const string& q) { return big_mapped.longest_prefix_match(q).first; });
+		remove("words.dat");
+
+		for (const auto& w : words) {
+			if (*big_mapped.find(w) != big_tst->at(w)) {
+				cout << "something went wrong!\n";
+				return -1;
+			}
+		}
+	}
+	catch (const exception& e) {
+		cout << e.what() << endl;
+	}
+	catch (...) {
+		cout << "Some unknown error happened" << endl;
+	}
+
+	return 0;
+}
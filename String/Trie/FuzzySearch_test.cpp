@@ -0,0 +1,173 @@
+#include "Trie.h"
+#include "../../Searching/TreeMap/HybridTST.h" // also brings in the TST with iterators
+#include "../../DynamicProgramming/EditDistance/ed.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+using matches = std::vector<std::pair<std::string, int>>;
+
+double ms_since(clk::time_point t0)
+{
+	return std::chrono::duration<double, std::milli>(clk::now() - t0).count();
+}
+
+// tokenizer-like vocabulary: words made of a few common syllables
+std::vector<std::string> make_words(size_t n)
+{
+	std::mt19937 gen(2021);
+	const char* syllables[] = { "a", "an", "ar", "be", "ca", "co", "de", "di", "en", "er", "es", "in", "ing",
+		"io", "is", "la", "le", "ma", "me", "na", "ne", "ni", "on", "or", "ra", "re", "ri", "ro", "sa", "se",
+		"st", "ta", "te", "ti", "to", "tion", "un", "ur", "ve", "y" };
+	std::uniform_int_distribution<int> len(1, 6), syl(0, sizeof(syllables) / sizeof(*syllables) - 1);
+	std::vector<std::string> words;
+	while (words.size() < n) {
+		std::string w;
+		for (int k = len(gen); k > 0; --k) w += syllables[syl(gen)];
+		words.push_back(w);
+		if (words.size() == n) {
+			std::sort(words.begin(), words.end());
+			words.erase(std::unique(words.begin(), words.end()), words.end());
+		}
+	}
+	return words; // sorted
+}
+
+// a word with a couple of typos
+std::string misspell(std::string w, std::mt19937& gen)
+{
+	for (int typos = 1 + gen() % 2; typos > 0; --typos) {
+		size_t i = gen() % (w.size() + 1);
+		char c = static_cast<char>('a' + gen() % 26);
+		switch (gen() % 4) {
+		case 0: w.insert(w.begin() + i, c); break;
+		case 1: if (i < w.size()) w.erase(w.begin() + i); break;
+		case 2: if (i < w.size()) w[i] = c; break;
+		default: if (i + 1 < w.size()) std::swap(w[i], w[i + 1]);
+		}
+	}
+	return w;
+}
+
+// the "did you mean" we had: edit_distance() against every word
+matches scan(const std::vector<std::string>& words, const std::string& query, int k)
+{
+	matches res;
+	for (const auto& w : words) {
+		int d = edit_distance(w, query);
+		if (d <= k) res.emplace_back(w, d);
+	}
+	return res;
+}
+
+// ms per query of fuzzy, false if it disagrees with scan()
+template<typename Fuzzy>
+bool report(const char* name, const std::vector<std::string>& words, const std::vector<std::string>& queries,
+			int k, double scan_ms, const std::vector<matches>& expected, Fuzzy fuzzy)
+{
+	bool ok = true;
+	size_t found = 0;
+	auto t0 = clk::now();
+	for (size_t i = 0; i < queries.size(); ++i) {
+		matches res = fuzzy(queries[i], k);
+		found += res.size();
+		ok = ok && res == expected[i];
+	}
+	double ms = ms_since(t0) / queries.size();
+	printf("  k=%d %-10s %9.3f ms/query  (%5.0fx, %.1f matches/query)\n", k, name, ms, scan_ms / ms,
+		   double(found) / queries.size());
+	return ok;
+}
+
+bool benchmark(const std::vector<std::string>& words, size_t num_queries, bool with_trie)
+{
+	using namespace mySymbolTable;
+	std::mt19937 gen(42);
+	std::vector<std::string> queries(num_queries);
+	for (auto& q : queries) q = misspell(words[gen() % words.size()], gen);
+
+	auto tst = std::make_unique<TST<int>>();
+	auto hybrid = std::make_unique<RWayTST<int>>();
+	std::unique_ptr<Trie<int>> trie;
+	if (with_trie) trie = std::make_unique<Trie<int>>();
+	for (size_t i = 0; i < words.size(); ++i) {
+		(*tst)[words[i]] = static_cast<int>(i);
+		(*hybrid)[words[i]] = static_cast<int>(i);
+		if (trie) (*trie)[words[i]] = static_cast<int>(i);
+	}
+
+	printf("%zu words, %zu misspelled queries:\n", words.size(), queries.size());
+	bool ok = true;
+	for (int k = 1; k <= 3; ++k) {
+		std::vector<matches> expected(queries.size());
+		auto t0 = clk::now();
+		for (size_t i = 0; i < queries.size(); ++i) expected[i] = scan(words, queries[i], k);
+		double scan_ms = ms_since(t0) / queries.size();
+		printf("  k=%d %-10s %9.3f ms/query\n", k, "scan", scan_ms);
+		ok = report("TST", words, queries, k, scan_ms, expected,
+			[&](const std::string& q, int k) { return tst->keys_within_distance(q, k); }) && ok;
+		ok = report("HybridTST", words, queries, k, scan_ms, expected,
+			[&](const std::string& q, int k) { return hybrid->keys_within_distance(q, k); }) && ok;
+		if (trie) {
+			ok = report("Trie", words, queries, k, scan_ms, expected,
+				[&](const std::string& q, int k) { return trie->keys_within_distance(q, k); }) && ok;
+		}
+	}
+	return ok;
+}
+
+// run: ./FuzzySearch_test shellsST.txt [N=1000000]
+int main(int argc, char* argv[])
+{
+	using namespace std;
+	using namespace mySymbolTable;
+
+	if (argc < 2) { cerr << "lack of filename" << endl; return 1; }
+	string filename{ argv[1] };
+	ifstream ifs{ filename };
+	if (!ifs.is_open()) { cerr << "Error opening file " << filename << endl; return 2; }
+	try {
+		Trie<int> trie;
+		int i = 0;
+		for (string word; ifs >> word; ) {
+			trie[word] = i++;
+		}
+		for (const char* query : { "shel", "sae", "hsore" }) {
+			cout << "within 1 of \"" << query << "\": ";
+			for (const auto& [word, dist] : trie.keys_within_distance(query, 1)) {
+				cout << word << " (" << dist << ")  ";
+			}
+			cout << "\n          with transpositions: ";
+			for (const auto& [word, dist] : trie.keys_within_distance(query, 1, /*transpositions=*/true)) {
+				cout << word << " (" << dist << ")  ";
+			}
+			cout << '\n';
+		}
+		cout << endl;
+
+		size_t n = argc > 2 ? stoul(argv[2]) : 1'000'000;
+		vector<string> words = make_words(n);
+		// Trie takes 2 KiB per node, only a slice of the words
+		bool ok = benchmark(vector<string>(words.begin(), words.begin() + min<size_t>(words.size(), 20'000)), 200, true);
+		ok = benchmark(words, 20, false) && ok;
+		if (!ok) {
+			cout << "something went wrong!\n";
+			return -1;
+		}
+	}
+	catch (const exception& e) {
+		cout << e.what() << endl;
+	}
+	catch (...) {
+		cout << "Some unknown error happened" << endl;
+	}
+
+	return 0;
+}
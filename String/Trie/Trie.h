@@ -10,11 +10,16 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <utility>
+#include <memory>
+#include "../../DynamicProgramming/EditDistance/ed_rows.h"
+#include "../../Searching/TreeMap/MemPool/MonotonicArena.h"
 
 namespace mySymbolTable {
 
 // Trie Symbol Table: key=string -> value
-template<typename T>
+// Nodes and values come from Alloc, see TST for monotonic allocators.
+template<typename T, typename Alloc = std::allocator<T>>
 class Trie {
 private:
 	typedef unsigned char uchar;
@@ -25,19 +30,32 @@ private:
 		Node* next[R] = {};
 
 		Node() {}
-		Node(const T& val) : pval(new T(val)) {}
-		~Node() { delete pval; }
 	};
 	using node_ptr = Node*;
+	using node_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+	using value_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+	using node_traits = std::allocator_traits<node_alloc>;
+	using value_traits = std::allocator_traits<value_alloc>;
 
 	node_ptr root;	// pointer to root node
 	size_t n;		// no. of keys in trie
+	node_alloc nalloc;
+	value_alloc valloc;
 public:
-	Trie() : root(nullptr), n(0) {}
+	using allocator_type = Alloc;
+
+	Trie() : Trie(Alloc()) {}
+
+	explicit Trie(const Alloc& alloc) : root(nullptr), n(0), nalloc(alloc), valloc(alloc) {}
+
+	Trie(const Trie&) = delete;
+	Trie& operator=(const Trie&) = delete;
 
 	~Trie() { clear(); }
 
-	void clear() { clear(root); root = nullptr; }
+	void clear() { clear(root); root = nullptr; n = 0; }
+
+	allocator_type get_allocator() const { return allocator_type(valloc); }
 	
 	// or simply: return *(insert(key, T())->pval);
 	T& operator[](const std::string& key) {
@@ -45,8 +63,10 @@ public:
 		node_ptr x = find(key);
 		if (x == nullptr) // e.g. find "shell" in "she"
 			return *(insert(key, T())->pval);
-		else if (x->pval == nullptr) // e.g. find "she" in "shell"
-			x->pval = new T();		 // set it a default value
+		else if (x->pval == nullptr) { // e.g. find "she" in "shell"
+			x->pval = new_value(T());	 // set it a default value
+			++n;
+		}
 		return *(x->pval);
 	}
 
@@ -96,6 +116,18 @@ public:
 		return vs;
 	}
 
+	// keys within edit distance k of query ("did you mean"), with their distances
+	// walks down with one DP row per depth, skipping the subtries that are out of
+	// reach (see ed_rows.h); with transpositions, swapping two adjacent characters
+	// is one edit too
+	std::vector<std::pair<std::string, int>> keys_within_distance(const std::string& query, int k,
+																  bool transpositions = false) const {
+		std::vector<std::pair<std::string, int>> res;
+		EditDistanceRows ed(query, k, transpositions);
+		collect(root, ed, res);
+		return res;
+	}
+
 	std::string longest_prefix_of(const std::string& query) {
 		if (query == "") throw std::invalid_argument("query to longest_prefix_of() cannot be null");
 		size_t len = max_len(root, query, 0, 0); // 0 if no substring of query
@@ -151,11 +183,44 @@ protected:
 		return max_len(x->next[(uchar)query[d]], query, d + 1, len);
 	}
 
+	node_ptr new_node() {
+		node_ptr x = node_traits::allocate(nalloc, 1);
+		node_traits::construct(nalloc, x);
+		return x;
+	}
+
+	// precondition: x->pval == nullptr
+	void delete_node(node_ptr x) {
+		node_traits::destroy(nalloc, x);
+		node_traits::deallocate(nalloc, x, 1);
+	}
+
+	T* new_value(const T& val) {
+		T* p = value_traits::allocate(valloc, 1);
+		try { value_traits::construct(valloc, p, val); }
+		catch (...) { value_traits::deallocate(valloc, p, 1); throw; }
+		return p;
+	}
+
+	void delete_value(T* p) {
+		value_traits::destroy(valloc, p);
+		value_traits::deallocate(valloc, p, 1);
+	}
+
+	// frees the subtrie at x with a stack of pending nodes rather than
+	// recursion, which could overflow on long keys
 	void clear(node_ptr x) {
+		if constexpr (drops_without_walk_v<Alloc, Node, T>) return;
 		if (x == nullptr) return;
-		for (size_t c = 0; c < R; ++c)
-			clear(x->next[c]);
-		delete x;
+		std::vector<node_ptr> pending{ x };
+		while (!pending.empty()) {
+			x = pending.back();
+			pending.pop_back();
+			for (size_t c = 0; c < R; ++c)
+				if (x->next[c] != nullptr) pending.push_back(x->next[c]);
+			if (x->pval != nullptr) delete_value(x->pval);
+			delete_node(x);
+		}
 	}
 
 	void collect(node_ptr x, const std::string& prefix, std::vector<std::string>& vs) const {
@@ -182,14 +247,25 @@ protected:
 		else	collect(x->next[ch], prefix + (char)ch, pattern, vs);
 	}
 
+	void collect(node_ptr x, EditDistanceRows& ed, std::vector<std::pair<std::string, int>>& res) const {
+		// e.g. collect "shell" and "shells" for "shel" within 1
+		if (x == nullptr) return;
+		if (x->pval != nullptr && ed.matches()) res.emplace_back(ed.key(), ed.distance());
+		for (size_t c = 0; c < R; ++c) {
+			if (x->next[c] == nullptr) continue;
+			if (ed.push((char)c)) collect(x->next[c], ed, res);
+			ed.pop();
+		}
+	}
+
 	// no overwriting if key already exists
 	// return pointer to new inserted node or key node
 	node_ptr insert(node_ptr& x, const std::string& key, const T& val, size_t d) {
 		// e.g. insert "shell" in "she"
-		if (x == nullptr) x = new Node();
+		if (x == nullptr) x = new_node();
 		if (d == key.length()) {
 			if (x->pval == nullptr) {
-				x->pval = new T(val); ++n;
+				x->pval = new_value(val); ++n;
 			} // else do nothing
 			return x;
 		}
@@ -200,10 +276,10 @@ protected:
 	// return pointer to new inserted or overwritten node
 	node_ptr insert_or_assign(node_ptr& x, const std::string& key, const T& val, size_t d) {
 		// e.g. insert "shell" in "she"
-		if (x == nullptr) x = new Node();
+		if (x == nullptr) x = new_node();
 		if (d == key.length()) {
 			if (x->pval == nullptr) {
-				x->pval = new T(val); ++n;
+				x->pval = new_value(val); ++n;
 			}
 			else *(x->pval) = val; // overwrite
 			return x;
@@ -217,14 +293,14 @@ protected:
 		if (x == nullptr) return;
 		if (d == key.length()) {
 			if (x->pval != nullptr) { // found
-				delete x->pval;	--n;
+				delete_value(x->pval);	--n;
 				x->pval = nullptr;
 			}
 		}
 		else erase(x->next[(uchar)key[d]], key, d + 1);
 
 		if (is_leaf(x) && x->pval == nullptr) {
-			delete x; x = nullptr;
+			delete_node(x); x = nullptr;
 		}
 	}
 };
@@ -0,0 +1,75 @@
+// Several rolling quantiles of one window: RollingMultiQuantile (one sorted
+// window) vs. a RollingQuantile (two heaps) run per quantile.
+//
+// build: make bench
+// run:   ./build/rolling_multi_quantile [N=1000000] [window=1000]
+#include "../src/rolling_no_nulls.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rolling_no_nulls;
+
+template <typename Fn>
+double time_ms(Fn fn) {
+    auto t1 = std::chrono::steady_clock::now();
+    fn();
+    auto t2 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+size_t unequal_size(const std::vector<double> &res1, const std::vector<double> &res2) {
+    size_t unequal = 0;
+    for (size_t i = 0; i < res1.size(); ++i) {
+        if (res1[i] != res2[i] && !(std::isnan(res1[i]) && std::isnan(res2[i])))
+            ++unequal;
+    }
+    return unequal;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t n = argc > 1 ? std::atol(argv[1]) : 1'000'000;
+    const uint32_t window = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const std::vector<double> qs{0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+    const size_t k = qs.size();
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(0, 1'000'000);
+    std::vector<double> x(n);
+    for (auto &v : x)
+        v = dist(gen);
+
+    std::cout << "N = " << n << ", window = " << window << ", " << k << " quantiles\n";
+    for (QuantileMethod method : {QuantileMethod::Linear, QuantileMethod::Nearest}) {
+        // n x k, row-major like the result of ops.rolling_multi_quantile()
+        std::vector<double> res_heaps(n * k), res_multi(n * k);
+
+        double t_heaps = time_ms([&] {
+            for (size_t j = 0; j < k; j++) {
+                RollingQuantile<double> rq(window, qs[j], method);
+                for (size_t i = 0; i < n; i++) {
+                    rq.update(x[i]);
+                    res_heaps[i * k + j] = rq.get();
+                }
+            }
+        });
+
+        double t_multi = time_ms([&] {
+            RollingMultiQuantile<double> rq(window, qs, method);
+            for (size_t i = 0; i < n; i++) {
+                rq.update(x[i]);
+                rq.get(&res_multi[i * k]);
+            }
+        });
+
+        std::cout << '\n'
+                  << (method == QuantileMethod::Linear ? "linear" : "nearest") << ":\n"
+                  << "RollingQuantile x " << k << "     " << t_heaps << " ms\n"
+                  << "RollingMultiQuantile  " << t_multi << " ms"
+                  << " (unequal size = " << unequal_size(res_heaps, res_multi) << ")\n";
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+// Thread scaling of the chunked rolling kernels (rolling_parallel.h), and how
+// far they are from the plain one-row-at-a-time loop ops.cc used to run.
+//
+// build: make bench
+// run:   ./build/rolling_parallel [N=100000000] [window=1000] [max_threads=#cores]
+#include "../src/rolling_nulls.h"
+#include "../src/rolling_parallel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rolling_nulls;
+
+template <typename Fn>
+double time_ms(Fn fn) {
+    auto t1 = std::chrono::steady_clock::now();
+    fn();
+    auto t2 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+size_t unequal_size(const std::vector<double> &res1, const std::vector<double> &res2) {
+    size_t unequal = 0;
+    for (size_t i = 0; i < res1.size(); ++i) {
+        if (res1[i] != res2[i] && !(std::isnan(res1[i]) && std::isnan(res2[i])))
+            ++unequal;
+    }
+    return unequal;
+}
+
+double max_rel_diff(const std::vector<double> &res1, const std::vector<double> &res2) {
+    double diff = 0;
+    for (size_t i = 0; i < res1.size(); ++i) {
+        if (res1[i] != res2[i] && res1[i] != 0)
+            diff = std::max(diff, std::abs((res1[i] - res2[i]) / res1[i]));
+    }
+    return diff;
+}
+
+// the single-threaded loop the chunks are checked against
+template <typename R, typename X>
+void rolling_apply_serial(const X *x, size_t n, double *res, uint32_t window, uint32_t min_obs) {
+    R r(window, min_obs);
+    for (size_t i = 0; i < n; i++) {
+        r.update(x[i]);
+        res[i] = r.get();
+    }
+}
+
+template <typename R, typename Apply>
+void run(const char *name, size_t n, unsigned max_threads, const std::vector<double> &serial,
+         Apply apply) {
+    std::vector<double> res1(n), res(n);
+    double t1 = time_ms([&] { apply(res1.data(), 1u); });
+    printf("%-16s %2u thread(s) %9.1f ms   vs. serial loop: %zu unequal, max rel. diff %.2g\n",
+           name, 1u, t1, unequal_size(serial, res1), max_rel_diff(serial, res1));
+    for (unsigned threads = 2; threads <= max_threads; threads *= 2) {
+        double t = time_ms([&] { apply(res.data(), threads); });
+        printf("%-16s %2u thread(s) %9.1f ms   x%.2f, unequal to 1 thread: %zu\n", name, threads, t,
+               t1 / t, unequal_size(res1, res));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const size_t n = argc > 1 ? std::atol(argv[1]) : 100'000'000;
+    const uint32_t window = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const unsigned max_threads =
+        argc > 3 ? std::atoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(0, 1'000'000);
+    std::vector<double> x(n);
+    for (auto &v : x)
+        v = dist(gen);
+    for (size_t i = 0; i < n; i += 100)
+        x[i] = NAN;
+    // ms timestamps, a row every 0-3 ms
+    std::vector<uint32_t> t(n);
+    for (size_t i = 1; i < n; i++)
+        t[i] = t[i - 1] + gen() % 4;
+
+    printf("N = %zu, window = %u rows / %u ms\n", n, window, window);
+    std::vector<double> serial(n);
+
+    using Sum = RollingSum<double, double>;
+    // min_obs = 1: with the default (the window), every window holds a NaN
+    rolling_apply_serial<Sum>(x.data(), n, serial.data(), window, 1);
+    run<Sum>("rolling_sum", n, max_threads, serial, [&](double *res, unsigned threads) {
+        rolling_apply_chunked<Sum>(x.data(), n, res, window, 1, threads);
+    });
+
+    using Max = RollingMax<double>;
+    rolling_apply_serial<Max>(x.data(), n, serial.data(), window, 1);
+    run<Max>("rolling_max", n, max_threads, serial, [&](double *res, unsigned threads) {
+        rolling_apply_chunked<Max>(x.data(), n, res, window, 1, threads);
+    });
+
+    using TsMean = TsRollingMean<double, double>;
+    TsMean r(window, 1);
+    for (size_t i = 0; i < n; i++) {
+        r.update({t[i], x[i]});
+        serial[i] = r.get();
+    }
+    run<TsMean>("ts_rolling_mean", n, max_threads, serial, [&](double *res, unsigned threads) {
+        ts_rolling_apply_chunked<TsMean>(t.data(), x.data(), n, res, window, 1, threads);
+    });
+
+    // an exception in a chunk reaches the caller (as a MemoryError in Python)
+    try {
+        for_each_chunk(n, RollingChunkRows, max_threads, [&](size_t begin, size_t) {
+            if (begin >= n / 2)
+                throw std::bad_alloc();
+        });
+        printf("for_each_chunk swallowed an exception\n");
+        return EXIT_FAILURE;
+    } catch (const std::bad_alloc &) {
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+// Rolling quantile/rank: indexable skip list vs. two heaps (RollingQuantile),
+// rank tree (myRankingAlgo::RankTree) and, for rank, the offline Fenwick tree
+// (myRankingAlgo::rolling_rank_batch).
+//
+// build: make bench
+// run:   ./build/rolling_skiplist [N=1000000] [window=1000] [q=0.2]
+#include "../src/rolling_no_nulls.h"
+#include "../src/rolling_skiplist.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace rolling_no_nulls;
+
+template <typename Fn>
+double time_ms(Fn fn) {
+    auto t1 = std::chrono::steady_clock::now();
+    fn();
+    auto t2 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t2 - t1).count();
+}
+
+size_t unequal_size(const std::vector<double> &res1, const std::vector<double> &res2) {
+    size_t unequal = 0;
+    for (size_t i = 0; i < res1.size(); ++i) {
+        if (res1[i] != res2[i] && !(std::isnan(res1[i]) && std::isnan(res2[i])))
+            ++unequal;
+    }
+    return unequal;
+}
+
+int main(int argc, char *argv[]) {
+    const size_t n = argc > 1 ? std::atol(argv[1]) : 1'000'000;
+    const uint32_t window = argc > 2 ? std::atoi(argv[2]) : 1000;
+    const double q = argc > 3 ? std::atof(argv[3]) : 0.2;
+
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(0, 1'000'000);
+    std::vector<double> x(n);
+    for (auto &v : x)
+        v = dist(gen);
+
+    std::vector<double> res_heap(n), res_sl(n), res_tree(n), res_sl_rank(n);
+
+    double t_heap = time_ms([&] {
+        RollingQuantile<double> rq(window, q, QuantileMethod::Linear);
+        for (size_t i = 0; i < n; i++) {
+            rq.update(x[i]);
+            res_heap[i] = rq.get();
+        }
+    });
+
+    double t_sl = time_ms([&] {
+        RollingSkiplistQuantile<double> rq(window, q, QuantileMethod::Linear);
+        for (size_t i = 0; i < n; i++) {
+            rq.update(x[i]);
+            res_sl[i] = rq.get();
+        }
+    });
+
+    double t_tree = time_ms([&] {
+        myRankingAlgo::rolling_rank<double>(res_tree.data(), RankMethod::Average, x.data(), n,
+                                            window);
+    });
+
+    double t_sl_rank = time_ms([&] {
+        RollingSkiplistRank<double> rr(window, RankMethod::Average);
+        for (size_t i = 0; i < n; i++) {
+            rr.update(x[i]);
+            res_sl_rank[i] = rr.get();
+        }
+    });
+    std::vector<double> res_batch;
+    double t_batch = time_ms([&] {
+        res_batch = myRankingAlgo::rolling_rank_batch<double>(x.data(), n, window,
+                                                              RankMethod::Average);
+    });
+
+    // rolling_rank() marks the warm-up with -1 instead of NaN
+    for (uint32_t i = 0; i + 1 < window && i < n; i++)
+        res_sl_rank[i] = -1;
+
+    std::cout << "N = " << n << ", window = " << window << ", q = " << q << "\n\n"
+              << "quantile: RollingQuantile (two heaps) " << t_heap << " ms\n"
+              << "quantile: RollingSkiplistQuantile     " << t_sl << " ms"
+              << " (unequal size = " << unequal_size(res_heap, res_sl) << ")\n"
+              << "rank:     RankTree                    " << t_tree << " ms\n"
+              << "rank:     RollingSkiplistRank         " << t_sl_rank << " ms"
+              << " (unequal size = " << unequal_size(res_tree, res_sl_rank) << ")\n"
+              << "rank:     rolling_rank_batch          " << t_batch << " ms"
+              << " (unequal size = " << unequal_size(res_tree, res_batch) << ")\n";
+
+    try {
+        RollingSkiplistQuantile<double> rq(0, q, QuantileMethod::Linear);
+        std::cout << "window = 0 wasn't rejected\n";
+        return EXIT_FAILURE;
+    } catch (const std::invalid_argument &) {
+    }
+    x[n / 2] = NAN;
+    try {
+        myRankingAlgo::rolling_rank_batch<double>(x.data(), n, window, RankMethod::Average);
+        std::cout << "NaN wasn't rejected by rolling_rank_batch\n";
+        return EXIT_FAILURE;
+    } catch (const std::invalid_argument &) {
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,10 +1,13 @@
 #include "statistics.h"
 #include "rolling_no_nulls.h"
 #include "rolling_nulls.h"
+#include "rolling_parallel.h"
+#include "rolling_skiplist.h"
 #include <vector>
 
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 
 namespace py = pybind11;
 
@@ -23,18 +26,21 @@ using TsMinF64 = rolling_nulls::TsRollingMin<double>;
 using TsMaxU32 = rolling_nulls::TsRollingMax<uint32_t>;
 using TsMaxF64 = rolling_nulls::TsRollingMax<double>;
 
+// The rows are computed on `threads` threads (0: one per hardware thread)
+// without the GIL, see rolling_parallel.h.
 template <typename X, typename R>
-static py::array_t<double> rolling_apply(py::array_t<X> x, uint32_t window, uint32_t min_obs = 0) {
+static py::array_t<double> rolling_apply(py::array_t<X> x, uint32_t window, uint32_t min_obs = 0,
+                                         unsigned threads = 0) {
     py::buffer_info buf_info = x.request();
     const X *x_data = static_cast<const X *>(buf_info.ptr);
 
     py::array_t<double> res(buf_info.size);
     double *res_data = static_cast<double *>(res.request().ptr);
 
-    R r(window, min_obs);
-    for (py::ssize_t i = 0; i < buf_info.size; i++) {
-        r.update(x_data[i]);
-        res_data[i] = r.get();
+    {
+        py::gil_scoped_release release;
+        rolling_nulls::rolling_apply_chunked<R>(x_data, buf_info.size, res_data, window, min_obs,
+                                                threads);
     }
 
     return res;
@@ -42,7 +48,8 @@ static py::array_t<double> rolling_apply(py::array_t<X> x, uint32_t window, uint
 
 template <typename X, typename R>
 static py::array_t<double> ts_rolling_apply(py::array_t<uint32_t> t, py::array_t<X> x,
-                                            uint32_t window_ms, uint32_t min_obs = 1) {
+                                            uint32_t window_ms, uint32_t min_obs = 1,
+                                            unsigned threads = 0) {
     py::buffer_info buf_info = t.request();
     const uint32_t *t_data = static_cast<const uint32_t *>(buf_info.ptr);
     const X *x_data = static_cast<const X *>(x.request().ptr);
@@ -50,10 +57,10 @@ static py::array_t<double> ts_rolling_apply(py::array_t<uint32_t> t, py::array_t
     py::array_t<double> res(buf_info.size);
     double *res_data = static_cast<double *>(res.request().ptr);
 
-    R r(window_ms, min_obs);
-    for (py::ssize_t i = 0; i < buf_info.size; i++) {
-        r.update({t_data[i], x_data[i]});
-        res_data[i] = r.get();
+    {
+        py::gil_scoped_release release;
+        rolling_nulls::ts_rolling_apply_chunked<R>(t_data, x_data, buf_info.size, res_data,
+                                                   window_ms, min_obs, threads);
     }
 
     return res;
@@ -103,6 +110,82 @@ static py::array_t<double> rolling_quantile(
     return res;
 }
 
+// one row per element of x, one column per quantile of qs
+static py::array_t<double> rolling_multi_quantile(
+    py::array_t<double> x, uint32_t window, const std::vector<double> &qs,
+    stats::QuantileMethod method = stats::QuantileMethod::Linear) {
+    py::buffer_info buf_info = x.request();
+    const double *x_data = static_cast<const double *>(x.request().ptr);
+
+    const py::ssize_t k = static_cast<py::ssize_t>(qs.size());
+    py::array_t<double> res({buf_info.size, k});
+    double *res_data = static_cast<double *>(res.request().ptr);
+
+    rolling_no_nulls::RollingMultiQuantile<double> rq(window, qs, method);
+
+    for (py::ssize_t i = 0; i < buf_info.size; i++) {
+        rq.update(x_data[i]);
+        rq.get(res_data + i * k);
+    }
+
+    return res;
+}
+
+static py::array_t<double> rolling_quantile_skiplist(
+    py::array_t<double> x, uint32_t window, double q,
+    stats::QuantileMethod method = stats::QuantileMethod::Linear) {
+    py::buffer_info buf_info = x.request();
+    const double *x_data = static_cast<const double *>(x.request().ptr);
+
+    py::array_t<double> res(buf_info.size);
+    double *res_data = static_cast<double *>(res.request().ptr);
+
+    rolling_no_nulls::RollingSkiplistQuantile<double> rq(window, q, method);
+
+    for (py::ssize_t i = 0; i < buf_info.size; i++) {
+        rq.update(x_data[i]);
+        res_data[i] = rq.get();
+    }
+
+    return res;
+}
+
+static py::array_t<double> rolling_rank(py::array_t<double> x, uint32_t window,
+                                        myRankingAlgo::RankMethod method) {
+    py::buffer_info buf_info = x.request();
+    const double *x_data = static_cast<const double *>(x.request().ptr);
+
+    py::array_t<double> res(buf_info.size);
+    double *res_data = static_cast<double *>(res.request().ptr);
+
+    rolling_no_nulls::RollingSkiplistRank<double> rr(window, method);
+
+    for (py::ssize_t i = 0; i < buf_info.size; i++) {
+        rr.update(x_data[i]);
+        res_data[i] = rr.get();
+    }
+
+    return res;
+}
+
+// the whole column at once, see myRankingAlgo::rolling_rank_batch()
+static py::array_t<double> rolling_rank_batch(py::array_t<double> x, uint32_t window,
+                                              myRankingAlgo::RankMethod method) {
+    py::buffer_info buf_info = x.request();
+    const double *x_data = static_cast<const double *>(x.request().ptr);
+
+    std::vector<double> ranks = myRankingAlgo::rolling_rank_batch<double>(
+        x_data, static_cast<size_t>(buf_info.size), window, method);
+
+    py::array_t<double> res(buf_info.size);
+    double *res_data = static_cast<double *>(res.request().ptr);
+
+    for (py::ssize_t i = 0; i < buf_info.size; i++)
+        res_data[i] = i + 1 < window ? NAN : ranks[i];
+
+    return res;
+}
+
 PYBIND11_MODULE(ops, m) {
     py::enum_<stats::QuantileMethod>(m, "QuantileMethod")
         .value("Nearest", stats::QuantileMethod::Nearest)
@@ -111,6 +194,11 @@ PYBIND11_MODULE(ops, m) {
         .value("Midpoint", stats::QuantileMethod::Midpoint)
         .value("Linear", stats::QuantileMethod::Linear);
 
+    py::enum_<myRankingAlgo::RankMethod>(m, "RankMethod")
+        .value("Min", myRankingAlgo::RankMethod::Min)
+        .value("Max", myRankingAlgo::RankMethod::Max)
+        .value("Average", myRankingAlgo::RankMethod::Average);
+
     m.def("median", &median, py::arg("x"));
     m.def("quantile", &quantile, py::arg("x"), py::arg("q"),
           py::arg("method") = stats::QuantileMethod::Linear);
@@ -121,40 +209,52 @@ PYBIND11_MODULE(ops, m) {
     m.def("rolling_quantile", &rolling_quantile, py::arg("x"), py::arg("window"), py::arg("q"),
           py::arg("method") = stats::QuantileMethod::Linear);
 
+    m.def("rolling_multi_quantile", &rolling_multi_quantile, py::arg("x"), py::arg("window"),
+          py::arg("qs"), py::arg("method") = stats::QuantileMethod::Linear);
+
+    m.def("rolling_quantile_skiplist", &rolling_quantile_skiplist, py::arg("x"), py::arg("window"),
+          py::arg("q"), py::arg("method") = stats::QuantileMethod::Linear);
+
+    m.def("rolling_rank", &rolling_rank, py::arg("x"), py::arg("window"),
+          py::arg("method") = myRankingAlgo::RankMethod::Average);
+
+    m.def("rolling_rank_batch", &rolling_rank_batch, py::arg("x"), py::arg("window"),
+          py::arg("method") = myRankingAlgo::RankMethod::Average);
+
     m.def("rolling_sum", &rolling_apply<double, SumF64>, py::arg("x"), py::arg("window"),
-          py::arg("min_obs") = 0);
+          py::arg("min_obs") = 0, py::arg("threads") = 0);
 
     m.def("rolling_mean", &rolling_apply<double, MeanF64>, py::arg("x"), py::arg("window"),
-          py::arg("min_obs") = 0);
+          py::arg("min_obs") = 0, py::arg("threads") = 0);
 
     m.def("rolling_min", &rolling_apply<double, MinF64>, py::arg("x"), py::arg("window"),
-          py::arg("min_obs") = 0);
+          py::arg("min_obs") = 0, py::arg("threads") = 0);
 
     m.def("rolling_max", &rolling_apply<double, MaxF64>, py::arg("x"), py::arg("window"),
-          py::arg("min_obs") = 0);
+          py::arg("min_obs") = 0, py::arg("threads") = 0);
 
     // time series
     m.def("ts_rolling_sum", &ts_rolling_apply<uint32_t, TsSumU32>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 
     m.def("ts_rolling_sum", &ts_rolling_apply<double, TsSumF64>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 
     m.def("ts_rolling_mean", &ts_rolling_apply<uint32_t, TsMeanU32>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 
     m.def("ts_rolling_mean", &ts_rolling_apply<double, TsMeanF64>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 
     m.def("ts_rolling_min", &ts_rolling_apply<uint32_t, TsMinU32>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 
     m.def("ts_rolling_min", &ts_rolling_apply<double, TsMinF64>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 
     m.def("ts_rolling_max", &ts_rolling_apply<uint32_t, TsMaxU32>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 
     m.def("ts_rolling_max", &ts_rolling_apply<double, TsMaxF64>, py::arg("t"), py::arg("x"),
-          py::arg("window_ms"), py::arg("min_obs") = 1);
+          py::arg("window_ms"), py::arg("min_obs") = 1, py::arg("threads") = 0);
 }
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "statistics.h"
+#include <algorithm>
 #include <deque>
 #include <functional>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -313,7 +315,8 @@ public:
 private:
     void max_heap_propagate_up(uint32_t pos) {
         bool hit_top = max_heap_sift_up(pos);
-        if (hit_top && get_max_heap_top() > get_min_heap_top()) {
+        // the min heap is empty if q_idx_ is the last index (e.g. q = 1)
+        if (hit_top && q_idx_ + 1 < window_ && get_max_heap_top() > get_min_heap_top()) {
             heap_xchg(0, q_idx_ + 1);
             min_heap_sift_down(q_idx_ + 1);
         }
@@ -399,4 +402,134 @@ private:
     std::vector<uint32_t> h_;
 };
 
+/*
+ * Several quantiles of one window at once, e.g. p1/p5/p25/p50/p75/p95/p99 for
+ * a risk report, in one pass over the input.
+ *
+ * The window is kept as a sorted array next to the ring buffer: a step is two
+ * binary searches and a memmove of the values between the old and the new
+ * one, and a quantile is a lookup, whatever the # of quantiles. The shift is
+ * O(window) though, while a RollingQuantile step is O(log(window)) per
+ * quantile, so past SortedWindowPerQuantile values per quantile (the
+ * crossover measured on random data) this runs a RollingQuantile per
+ * quantile instead.
+ */
+template <typename T>
+class RollingMultiQuantile {
+public:
+    static constexpr uint32_t SortedWindowPerQuantile = 768;
+
+    RollingMultiQuantile(uint32_t window, const std::vector<double> &qs, QuantileMethod method)
+        : window_(window),
+          method_(method),
+          use_heaps_(window > SortedWindowPerQuantile * qs.size()) {
+        if (window == 0)
+            throw std::invalid_argument("window must be positive");
+        if (qs.empty())
+            throw std::invalid_argument("qs must not be empty");
+        if (use_heaps_) {
+            for (double q : qs)
+                heaps_.emplace_back(window, q, method);
+            return;
+        }
+
+        for (double q : qs) {
+            q = std::clamp(q, 0.0, 1.0);
+            const double float_idx = (window - 1) * q;
+            uint32_t q_idx;
+            if (method == QuantileMethod::Nearest)
+                q_idx = static_cast<uint32_t>(std::round(float_idx));
+            else if (method == QuantileMethod::Higher)
+                q_idx = static_cast<uint32_t>(std::ceil(float_idx));
+            else  // Lower | Midpoint | Linear
+                q_idx = static_cast<uint32_t>(float_idx);
+            idx_.push_back({float_idx, q_idx});
+        }
+        ringbuf_.resize(window_);
+        sorted_.reserve(window_);
+    }
+
+    // # of quantiles
+    size_t size() const { return use_heaps_ ? heaps_.size() : idx_.size(); }
+
+    void update(T x) {
+        if (use_heaps_) {
+            for (auto &rq : heaps_)
+                rq.update(x);
+            return;
+        }
+
+        if (sorted_.size() < window_) {
+            sorted_.insert(std::upper_bound(sorted_.begin(), sorted_.end(), x), x);
+        } else {
+            // shift the values between the old one and x by one place,
+            // rather than erase and insert, which would shift twice as many
+            const T old = ringbuf_[curr_index_];
+            auto pos = std::lower_bound(sorted_.begin(), sorted_.end(), old);
+            if (old < x) {
+                auto last = std::lower_bound(pos + 1, sorted_.end(), x);
+                std::move(pos + 1, last, pos);
+                *(last - 1) = x;
+            } else {
+                auto first = std::upper_bound(sorted_.begin(), pos, x);
+                std::move_backward(first, pos, pos + 1);
+                *first = x;
+            }
+        }
+        ringbuf_[curr_index_] = x;
+        advance_index();
+    }
+
+    // writes the quantiles, in the order they were given, to res[0..size()),
+    // NaN until the window is full
+    void get(double *res) const {
+        if (use_heaps_) {
+            for (size_t i = 0; i < heaps_.size(); i++)
+                res[i] = heaps_[i].get();
+            return;
+        }
+
+        for (size_t i = 0; i < idx_.size(); i++) {
+            if (sorted_.size() < window_) {
+                res[i] = NAN;
+                continue;
+            }
+            const auto [float_idx, q_idx] = idx_[i];
+            const double lo = sorted_[q_idx];
+            if (q_idx == static_cast<uint32_t>(std::ceil(float_idx))) {
+                res[i] = lo;
+            } else if (method_ == QuantileMethod::Midpoint || method_ == QuantileMethod::Linear) {
+                // q_idx < float_idx < q_idx + 1 <= window_ - 1
+                double g = (method_ == QuantileMethod::Linear) ? (float_idx - q_idx) : 0.5;
+                res[i] = stats::linear_interpolation(lo, sorted_[q_idx + 1], g);
+            } else {
+                res[i] = lo;
+            }
+        }
+    }
+
+private:
+    void advance_index() {
+        curr_index_++;
+        if (curr_index_ == window_)
+            curr_index_ = 0;
+    }
+
+    // where a quantile falls in sorted_, as in RollingQuantile
+    struct QuantileIndex {
+        double float_idx;
+        uint32_t q_idx;
+    };
+
+    uint32_t window_;
+    QuantileMethod method_;
+    // a RollingQuantile per quantile rather than the sorted window
+    bool use_heaps_;
+    std::vector<QuantileIndex> idx_;
+    uint32_t curr_index_ = 0;
+    std::vector<T> ringbuf_;
+    std::vector<T> sorted_;
+    std::vector<RollingQuantile<T>> heaps_;
+};
+
 }  // namespace rolling_no_nulls
@@ -90,9 +90,11 @@ public:
     explicit TsRollingSum(uint32_t window_ms, uint32_t min_obs = 1)
         : window_ms_(window_ms), min_obs_(min_obs) {}
 
+    // precondition: t is no less than any time seen so far
     void expire(uint32_t t) {
-        // right closed: (t - window_ms, t]
-        while (!buf_.empty() && buf_.front().first <= t - window_ms_) {
+        // right closed: (t - window_ms, t], without t - window_ms wrapping
+        // around for t < window_ms
+        while (!buf_.empty() && t - buf_.front().first >= window_ms_) {
             if (!is_null(buf_.front().second))
                 SumTraits::sub(sum_, buf_.front().second, compensation_sub_);
             else
@@ -224,15 +226,17 @@ public:
     explicit TsRollingMinMax(uint32_t window_ms, uint32_t min_obs = 1, Compare cmp = Compare{})
         : window_ms_(window_ms), min_obs_(min_obs), cmp_(cmp) {}
 
+    // precondition: t is no less than any time seen so far
     void expire(uint32_t t) {
-        // right closed: (t - window_ms, t]
-        while (!is_null_.empty() && is_null_.front().first <= t - window_ms_) {
+        // right closed: (t - window_ms, t], without t - window_ms wrapping
+        // around for t < window_ms
+        while (!is_null_.empty() && t - is_null_.front().first >= window_ms_) {
             if (is_null_.front().second)
                 null_cnt_--;
             is_null_.pop_front();
         }
 
-        while (!dq_.empty() && dq_.front().first <= t - window_ms_)
+        while (!dq_.empty() && t - dq_.front().first >= window_ms_)
             dq_.pop_front();
     }
 
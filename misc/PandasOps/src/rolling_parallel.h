@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rolling_nulls {
+
+/*
+ * Multi-threaded drivers for the rolling classes above.
+ *
+ * The rows are cut into chunks on a fixed grid, i.e. one that doesn't depend on
+ * the # of threads, and every chunk is computed by a rolling state of its own,
+ * warmed up on the rows before the chunk that are still in its first window.
+ * The results are the same for any # of threads: a Kahan sum, whose running
+ * compensation depends on all rows seen so far, starts over at each chunk in
+ * the serial (threads = 1) case as well. Starting over also keeps the rounding
+ * error of the add/subtract sums from building up over a long column.
+ */
+
+// rows per chunk, at least; chunks are also >= 16 windows long (for a time
+// window, 16 times the most rows found in one) so that warming up costs at
+// most about 1/16 more
+constexpr size_t RollingChunkRows = size_t(1) << 18;
+
+// calls task(begin, end) for the chunks [begin, end) of [0, n), in order on
+// each of (up to) `threads` threads, 0 meaning one per hardware thread.
+// The first exception thrown by a task (or by starting a thread) is rethrown
+// once all the threads are joined; the other threads stop at their next chunk.
+template <typename Task>
+void for_each_chunk(size_t n, size_t chunk, unsigned threads, const Task &task) {
+    const size_t chunks = (n + chunk - 1) / chunk;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(chunks, 1)));
+
+    std::mutex mtx;
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto fail = [&] {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!error)
+            error = std::current_exception();
+        failed = true;
+    };
+
+    // worker w takes a contiguous run of the chunks
+    auto work = [&](unsigned w) {
+        try {
+            for (size_t c = chunks * w / threads; c < chunks * (w + 1) / threads; c++) {
+                if (failed.load(std::memory_order_relaxed))
+                    return;
+                task(c * chunk, std::min(n, (c + 1) * chunk));
+            }
+        } catch (...) {
+            fail();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    try {
+        workers.reserve(threads - 1);
+        for (unsigned w = 1; w < threads; w++)
+            workers.emplace_back(work, w);
+    } catch (...) {
+        fail();
+    }
+    work(0);
+    for (auto &t : workers)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+// res[i] = R's get() after update(x[i]), R being e.g. RollingSum
+template <typename R, typename X>
+void rolling_apply_chunked(const X *x, size_t n, double *res, uint32_t window, uint32_t min_obs,
+                           unsigned threads = 0) {
+    const size_t chunk = std::max(RollingChunkRows, 16 * static_cast<size_t>(window));
+    for_each_chunk(n, chunk, threads, [&](size_t begin, size_t end) {
+        R r(window, min_obs);
+        for (size_t i = begin - std::min<size_t>(begin, window); i < begin; i++)
+            r.update(x[i]);
+        for (size_t i = begin; i < end; i++) {
+            r.update(x[i]);
+            res[i] = r.get();
+        }
+    });
+}
+
+// first row of the time window (t[i] - window_ms, t[i]], t being non-decreasing
+inline size_t ts_window_begin(const uint32_t *t, size_t i, uint32_t window_ms) {
+    if (t[i] < window_ms)
+        return 0;
+    return std::upper_bound(t, t + i, t[i] - window_ms) - t;
+}
+
+// the same for the time windows (TsRollingSum, ...), t being non-decreasing
+template <typename R, typename X>
+void ts_rolling_apply_chunked(const uint32_t *t, const X *x, size_t n, double *res,
+                              uint32_t window_ms, uint32_t min_obs, unsigned threads = 0) {
+    // the rows in a window, sampled every RollingChunkRows rows
+    size_t window_rows = 0;
+    for (size_t i = 0; i < n; i += RollingChunkRows)
+        window_rows = std::max(window_rows, i + 1 - ts_window_begin(t, i, window_ms));
+    const size_t chunk = std::max(RollingChunkRows, 16 * window_rows);
+
+    for_each_chunk(n, chunk, threads, [&](size_t begin, size_t end) {
+        R r(window_ms, min_obs);
+        // the rows before begin still in its window
+        for (size_t i = ts_window_begin(t, begin, window_ms); i < begin; i++)
+            r.update({t[i], x[i]});
+        for (size_t i = begin; i < end; i++) {
+            r.update({t[i], x[i]});
+            res[i] = r.get();
+        }
+    });
+}
+
+}  // namespace rolling_nulls
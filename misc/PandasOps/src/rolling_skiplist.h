@@ -0,0 +1,142 @@
+#pragma once
+
+#include "statistics.h"
+#include "../../../Searching/Randomized/SkiplistSet.h"
+#include "../../../Searching/RankTree/rolling_rank.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <cmath>
+#include <cstdint>
+
+namespace rolling_no_nulls {
+
+using stats::QuantileMethod;
+using myRankingAlgo::RankMethod;
+
+/*
+ * Rolling quantile/rank backed by an indexable skip list, which is what pandas
+ * uses for rolling().quantile() and rolling().rank() (pandas/_libs/src/skiplist.h).
+ *
+ * Each link of the skip list knows how many elements it jumps over, so both
+ * "the i-th smallest in the window" and "how many are less than x" are
+ * O(log(window)) without any heap juggling. Unlike RollingQuantile, one
+ * window state can answer any number of quantiles or ranks.
+ */
+template <typename T>
+class RollingSkiplist {
+public:
+    explicit RollingSkiplist(uint32_t window) : window_(window) {
+        if (window == 0)
+            throw std::invalid_argument("window must be positive");
+        ringbuf_.resize(window_);
+    }
+
+    void update(T x) {
+        if (count_ == window_)
+            sl_.erase_one(ringbuf_[curr_index_]);
+        else
+            count_++;
+
+        ringbuf_[curr_index_] = x;
+        sl_.insert(x);
+        last_ = x;
+
+        curr_index_++;
+        if (curr_index_ == window_)
+            curr_index_ = 0;
+    }
+
+    bool full() const { return count_ == window_; }
+
+    uint32_t count() const { return count_; }
+
+    // the k-th (0-based) smallest value in the window
+    T kth(uint32_t k) const { return *sl_.nth(k); }
+
+    double quantile(double q, QuantileMethod method) const {
+        q = std::clamp(q, 0.0, 1.0);
+        const double float_idx = (count_ - 1) * q;
+        uint32_t q_idx;
+        if (method == QuantileMethod::Nearest)
+            q_idx = static_cast<uint32_t>(std::round(float_idx));
+        else if (method == QuantileMethod::Higher)
+            q_idx = static_cast<uint32_t>(std::ceil(float_idx));
+        else  // Lower | Midpoint | Linear
+            q_idx = static_cast<uint32_t>(float_idx);
+
+        auto it = sl_.nth(q_idx);
+        if (q_idx == static_cast<uint32_t>(std::ceil(float_idx)))
+            return *it;
+
+        // q_idx < float_idx < q_idx + 1 <= count_ - 1
+        if (method == QuantileMethod::Midpoint || method == QuantileMethod::Linear) {
+            double lo = *it;
+            double next = *++it;
+            double g = (method == QuantileMethod::Linear) ? (float_idx - q_idx) : 0.5;
+            return stats::linear_interpolation(lo, next, g);
+        }
+
+        return *it;
+    }
+
+    // rank (1-based) of the most recently added value within the window
+    double rank(RankMethod method) const {
+        switch (method) {
+        case RankMethod::Min:
+            return sl_.rank(last_) + 1;
+        case RankMethod::Max:
+            return sl_.upper_rank(last_);
+        case RankMethod::Average: {
+            const double rank_min = sl_.rank(last_) + 1;
+            const double rank_max = sl_.upper_rank(last_);
+            return rank_min + (rank_max - rank_min) / 2.0;
+        }
+        default:
+            return NAN;
+        }
+    }
+
+private:
+    uint32_t window_;
+    uint32_t curr_index_ = 0;
+    uint32_t count_ = 0;
+    T last_{};
+    std::vector<T> ringbuf_;
+    mySymbolTable::SkiplistMultiset<T> sl_;
+};
+
+// drop-in counterpart of RollingQuantile
+template <typename T>
+class RollingSkiplistQuantile {
+public:
+    explicit RollingSkiplistQuantile(uint32_t window, double q, QuantileMethod method)
+        : sl_(window), q_(q), method_(method) {}
+
+    void update(T x) { sl_.update(x); }
+
+    double get() const { return sl_.full() ? sl_.quantile(q_, method_) : NAN; }
+
+private:
+    RollingSkiplist<T> sl_;
+    double q_;
+    QuantileMethod method_;
+};
+
+template <typename T>
+class RollingSkiplistRank {
+public:
+    explicit RollingSkiplistRank(uint32_t window, RankMethod method)
+        : sl_(window), method_(method) {}
+
+    void update(T x) { sl_.update(x); }
+
+    double get() const { return sl_.full() ? sl_.rank(method_) : NAN; }
+
+private:
+    RollingSkiplist<T> sl_;
+    RankMethod method_;
+};
+
+}  // namespace rolling_no_nulls